@@ -0,0 +1,320 @@
+#include "AppConfig.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <utility>
+
+namespace {
+
+// 与设置对话框里 QSpinBox 的范围一致
+void clampValue(int &value, int lo, int hi) { value = qBound(lo, value, hi); }
+
+void clampRange(int &min, int &max, int lo, int hi) {
+  clampValue(min, lo, hi);
+  clampValue(max, lo, hi);
+  if (min > max)
+    std::swap(min, max);
+}
+
+} // namespace
+
+QStringList ListMonitorSettings::urlList() const {
+  QStringList result;
+  for (const QString &line : urls.split('\n')) {
+    QString url = line.trimmed();
+    if (!url.isEmpty() && url.startsWith("http")) {
+      result.append(url);
+    }
+  }
+  return result;
+}
+
+QStringList CollectorSettings::ignoredHandleList() const {
+  QStringList result;
+  for (const QString &line : ignoredHandles.split('\n')) {
+    QString handle = line.trimmed();
+    if (handle.startsWith('@'))
+      handle.remove(0, 1);
+    if (!handle.isEmpty()) {
+      result.append(handle);
+    }
+  }
+  return result;
+}
+
+AppConfig::AppConfig(const QString &filePath, QObject *parent)
+    : QObject(parent), m_filePath(filePath), m_dirty(false) {
+  m_saveTimer = new QTimer(this);
+  m_saveTimer->setSingleShot(true);
+  m_saveTimer->setInterval(500);
+  connect(m_saveTimer, &QTimer::timeout, this, [this]() { save(); });
+
+  load();
+}
+
+AppConfig::~AppConfig() { flush(); }
+
+QString AppConfig::defaultFilePath() {
+  return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) +
+         "/config.json";
+}
+
+void AppConfig::setCollector(const CollectorSettings &value) {
+  if (m_settings.collector == value)
+    return;
+  m_settings.collector = value;
+  scheduleSave();
+  emit collectorChanged();
+}
+
+void AppConfig::setReciprocator(const ReciprocatorSettings &value) {
+  if (m_settings.reciprocator == value)
+    return;
+  m_settings.reciprocator = value;
+  scheduleSave();
+  emit reciprocatorChanged();
+}
+
+void AppConfig::setListMonitor(const ListMonitorSettings &value) {
+  if (m_settings.listMonitor == value)
+    return;
+  m_settings.listMonitor = value;
+  scheduleSave();
+  emit listMonitorChanged();
+}
+
+void AppConfig::setView(const ViewSettings &value) {
+  if (m_settings.view == value)
+    return;
+  m_settings.view = value;
+  scheduleSave();
+  emit viewChanged();
+}
+
+void AppConfig::setStorage(const StorageSettings &value) {
+  if (m_settings.storage == value)
+    return;
+  m_settings.storage = value;
+  scheduleSave();
+  emit storageChanged();
+}
+
+void AppConfig::flush() {
+  if (!m_dirty)
+    return;
+  m_saveTimer->stop();
+  save();
+}
+
+void AppConfig::scheduleSave() {
+  m_dirty = true;
+  m_saveTimer->start(); // restart: coalesce bursts into one write
+}
+
+void AppConfig::load() {
+  QFile file(m_filePath);
+  if (!file.exists()) {
+    // 首次启动：从旧版 QSettings 迁移一次
+    importLegacySettings();
+    normalize();
+    m_dirty = true;
+    save();
+    return;
+  }
+
+  if (!file.open(QIODevice::ReadOnly)) {
+    qWarning() << "[AppConfig] Cannot read" << m_filePath;
+    return;
+  }
+  QJsonParseError error;
+  QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+  if (!doc.isObject()) {
+    qWarning() << "[AppConfig] Invalid config, using defaults:"
+               << error.errorString();
+    return;
+  }
+  fromJson(doc.object());
+  if (normalize()) {
+    qWarning() << "[AppConfig] Out-of-range values clamped in" << m_filePath;
+    scheduleSave();
+  }
+}
+
+// 手改的配置文件或旧版设置可能越界或最小值大于最大值；载入时统一修正。
+// 返回是否有改动
+bool AppConfig::normalize() {
+  CollectorSettings c = m_settings.collector;
+  clampValue(c.maxPages, 1, 50);
+  clampRange(c.refreshMin, c.refreshMax, 10, 600);
+
+  ReciprocatorSettings r = m_settings.reciprocator;
+  clampRange(r.scrollMin, r.scrollMax, 1, 60);
+  clampRange(r.likeWaitMin, r.likeWaitMax, 1, 120);
+  clampRange(r.browseMin, r.browseMax, 1, 120);
+  clampRange(r.restMin, r.restMax, 1, 120);
+
+  ListMonitorSettings l = m_settings.listMonitor;
+  clampRange(l.likeMin, l.likeMax, 5, 300);
+  clampRange(l.scrollMin, l.scrollMax, 1, 60);
+  clampRange(l.stayMin, l.stayMax, 1, 60);
+  clampValue(l.maxLikes, 1, 500);
+  clampRange(l.restMin, l.restMax, 1, 120);
+  clampRange(l.cooldownMin, l.cooldownMax, 60, 3600);
+
+  bool changed = c != m_settings.collector ||
+                 r != m_settings.reciprocator || l != m_settings.listMonitor;
+  m_settings.collector = c;
+  m_settings.reciprocator = r;
+  m_settings.listMonitor = l;
+  return changed;
+}
+
+void AppConfig::importLegacySettings() {
+  QSettings s("XSocialLedger", "XSocialLedger");
+
+  CollectorSettings &c = m_settings.collector;
+  c.maxPages = s.value("maxPages", c.maxPages).toInt();
+  c.refreshMin = s.value("refreshMin", c.refreshMin).toInt();
+  c.refreshMax = s.value("refreshMax", c.refreshMax).toInt();
+
+  ReciprocatorSettings &r = m_settings.reciprocator;
+  r.scrollMin = s.value("scrollMin", r.scrollMin).toInt();
+  r.scrollMax = s.value("scrollMax", r.scrollMax).toInt();
+  r.likeWaitMin = s.value("likeWaitMin", r.likeWaitMin).toInt();
+  r.likeWaitMax = s.value("likeWaitMax", r.likeWaitMax).toInt();
+  r.browseMin = s.value("browseMin", r.browseMin).toInt();
+  r.browseMax = s.value("browseMax", r.browseMax).toInt();
+  r.restMin = s.value("restMin", r.restMin).toInt();
+  r.restMax = s.value("restMax", r.restMax).toInt();
+
+  ListMonitorSettings &l = m_settings.listMonitor;
+  l.urls = s.value("listUrls", l.urls).toString();
+  l.likeMin = s.value("listLikeMin", l.likeMin).toInt();
+  l.likeMax = s.value("listLikeMax", l.likeMax).toInt();
+  l.scrollMin = s.value("listScrollMin", l.scrollMin).toInt();
+  l.scrollMax = s.value("listScrollMax", l.scrollMax).toInt();
+  l.stayMin = s.value("listStayMin", l.stayMin).toInt();
+  l.stayMax = s.value("listStayMax", l.stayMax).toInt();
+  l.maxLikes = s.value("listMaxLikes", l.maxLikes).toInt();
+  l.restMin = s.value("listRestMin", l.restMin).toInt();
+  l.restMax = s.value("listRestMax", l.restMax).toInt();
+  l.cooldownMin = s.value("listCooldownMin", l.cooldownMin).toInt();
+  l.cooldownMax = s.value("listCooldownMax", l.cooldownMax).toInt();
+
+  ViewSettings &v = m_settings.view;
+  v.hideReciprocated = s.value("hideReciprocated", v.hideReciprocated).toBool();
+  v.only24h = s.value("only24h", v.only24h).toBool();
+
+  qDebug() << "[AppConfig] Imported legacy QSettings";
+}
+
+bool AppConfig::save() {
+  if (!m_dirty)
+    return true;
+
+  QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+
+  // QSaveFile writes to a temp file and renames on commit
+  QSaveFile file(m_filePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning() << "[AppConfig] Cannot write" << m_filePath;
+    return false;
+  }
+  file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+  if (!file.commit()) {
+    qWarning() << "[AppConfig] Commit failed for" << m_filePath;
+    return false;
+  }
+  m_dirty = false;
+  return true;
+}
+
+QJsonObject AppConfig::toJson() const {
+  const CollectorSettings &c = m_settings.collector;
+  QJsonObject collector{{"maxPages", c.maxPages},
+                        {"refreshMin", c.refreshMin},
+                        {"refreshMax", c.refreshMax},
+                        {"collectLikes", c.collectLikes},
+                        {"collectReplies", c.collectReplies},
+                        {"ignoredHandles", c.ignoredHandles}};
+
+  const ReciprocatorSettings &r = m_settings.reciprocator;
+  QJsonObject reciprocator{
+      {"scrollMin", r.scrollMin},     {"scrollMax", r.scrollMax},
+      {"likeWaitMin", r.likeWaitMin}, {"likeWaitMax", r.likeWaitMax},
+      {"browseMin", r.browseMin},     {"browseMax", r.browseMax},
+      {"restMin", r.restMin},         {"restMax", r.restMax}};
+
+  const ListMonitorSettings &l = m_settings.listMonitor;
+  QJsonObject listMonitor{
+      {"urls", l.urls},           {"likeMin", l.likeMin},
+      {"likeMax", l.likeMax},     {"scrollMin", l.scrollMin},
+      {"scrollMax", l.scrollMax}, {"stayMin", l.stayMin},
+      {"stayMax", l.stayMax},     {"maxLikes", l.maxLikes},
+      {"restMin", l.restMin},     {"restMax", l.restMax},
+      {"cooldownMin", l.cooldownMin}, {"cooldownMax", l.cooldownMax}};
+
+  const ViewSettings &v = m_settings.view;
+  QJsonObject view{{"hideReciprocated", v.hideReciprocated},
+                   {"only24h", v.only24h}};
+
+  QJsonObject storage{{"backend", m_settings.storage.backend}};
+
+  return QJsonObject{{"version", 1},
+                     {"collector", collector},
+                     {"reciprocator", reciprocator},
+                     {"listMonitor", listMonitor},
+                     {"view", view},
+                     {"storage", storage}};
+}
+
+void AppConfig::fromJson(const QJsonObject &root) {
+  QJsonObject collector = root["collector"].toObject();
+  CollectorSettings &c = m_settings.collector;
+  c.maxPages = collector["maxPages"].toInt(c.maxPages);
+  c.refreshMin = collector["refreshMin"].toInt(c.refreshMin);
+  c.refreshMax = collector["refreshMax"].toInt(c.refreshMax);
+  c.collectLikes = collector["collectLikes"].toBool(c.collectLikes);
+  c.collectReplies = collector["collectReplies"].toBool(c.collectReplies);
+  c.ignoredHandles = collector["ignoredHandles"].toString(c.ignoredHandles);
+
+  QJsonObject reciprocator = root["reciprocator"].toObject();
+  ReciprocatorSettings &r = m_settings.reciprocator;
+  r.scrollMin = reciprocator["scrollMin"].toInt(r.scrollMin);
+  r.scrollMax = reciprocator["scrollMax"].toInt(r.scrollMax);
+  r.likeWaitMin = reciprocator["likeWaitMin"].toInt(r.likeWaitMin);
+  r.likeWaitMax = reciprocator["likeWaitMax"].toInt(r.likeWaitMax);
+  r.browseMin = reciprocator["browseMin"].toInt(r.browseMin);
+  r.browseMax = reciprocator["browseMax"].toInt(r.browseMax);
+  r.restMin = reciprocator["restMin"].toInt(r.restMin);
+  r.restMax = reciprocator["restMax"].toInt(r.restMax);
+
+  QJsonObject listMonitor = root["listMonitor"].toObject();
+  ListMonitorSettings &l = m_settings.listMonitor;
+  l.urls = listMonitor["urls"].toString(l.urls);
+  l.likeMin = listMonitor["likeMin"].toInt(l.likeMin);
+  l.likeMax = listMonitor["likeMax"].toInt(l.likeMax);
+  l.scrollMin = listMonitor["scrollMin"].toInt(l.scrollMin);
+  l.scrollMax = listMonitor["scrollMax"].toInt(l.scrollMax);
+  l.stayMin = listMonitor["stayMin"].toInt(l.stayMin);
+  l.stayMax = listMonitor["stayMax"].toInt(l.stayMax);
+  l.maxLikes = listMonitor["maxLikes"].toInt(l.maxLikes);
+  l.restMin = listMonitor["restMin"].toInt(l.restMin);
+  l.restMax = listMonitor["restMax"].toInt(l.restMax);
+  l.cooldownMin = listMonitor["cooldownMin"].toInt(l.cooldownMin);
+  l.cooldownMax = listMonitor["cooldownMax"].toInt(l.cooldownMax);
+
+  QJsonObject view = root["view"].toObject();
+  ViewSettings &v = m_settings.view;
+  v.hideReciprocated = view["hideReciprocated"].toBool(v.hideReciprocated);
+  v.only24h = view["only24h"].toBool(v.only24h);
+
+  QJsonObject storage = root["storage"].toObject();
+  StorageSettings &st = m_settings.storage;
+  st.backend = storage["backend"].toString(st.backend);
+}
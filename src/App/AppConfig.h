@@ -0,0 +1,163 @@
+#ifndef APPCONFIG_H
+#define APPCONFIG_H
+
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+// 采集配置
+struct CollectorSettings {
+  int maxPages = 5;
+  int refreshMin = 60;  // 自动刷新间隔最小(秒)
+  int refreshMax = 120; // 自动刷新间隔最大(秒)
+  bool collectLikes = true;
+  bool collectReplies = true;
+  QString ignoredHandles; // 每行一个 handle，采集时直接丢弃
+
+  // 解析出的 handle（去掉 @ 和空行）
+  QStringList ignoredHandleList() const;
+
+  bool operator==(const CollectorSettings &o) const {
+    return maxPages == o.maxPages && refreshMin == o.refreshMin &&
+           refreshMax == o.refreshMax && collectLikes == o.collectLikes &&
+           collectReplies == o.collectReplies &&
+           ignoredHandles == o.ignoredHandles;
+  }
+  bool operator!=(const CollectorSettings &o) const { return !(*this == o); }
+};
+
+// 自动回馈配置
+struct ReciprocatorSettings {
+  int scrollMin = 3;   // 滚动间隔(秒)
+  int scrollMax = 8;
+  int likeWaitMin = 3; // 点赞等待(秒)
+  int likeWaitMax = 8;
+  int browseMin = 10;  // 浏览时长(分钟)
+  int browseMax = 30;
+  int restMin = 15;    // 休息时长(分钟)
+  int restMax = 45;
+
+  bool operator==(const ReciprocatorSettings &o) const {
+    return scrollMin == o.scrollMin && scrollMax == o.scrollMax &&
+           likeWaitMin == o.likeWaitMin && likeWaitMax == o.likeWaitMax &&
+           browseMin == o.browseMin && browseMax == o.browseMax &&
+           restMin == o.restMin && restMax == o.restMax;
+  }
+  bool operator!=(const ReciprocatorSettings &o) const { return !(*this == o); }
+};
+
+// LIST监控配置
+struct ListMonitorSettings {
+  QString urls;          // 每行一个 List URL
+  int likeMin = 15;      // 点赞间隔(秒)
+  int likeMax = 45;
+  int scrollMin = 3;     // 滚动间隔(秒)
+  int scrollMax = 8;
+  int stayMin = 3;       // List停留(分钟)
+  int stayMax = 8;
+  int maxLikes = 50;     // 单次最大点赞数
+  int restMin = 10;      // 达标后休息(分钟)
+  int restMax = 30;
+  int cooldownMin = 600; // 同用户冷却(秒)
+  int cooldownMax = 1200;
+
+  // 解析出的有效 URL
+  QStringList urlList() const;
+
+  bool operator==(const ListMonitorSettings &o) const {
+    return urls == o.urls && likeMin == o.likeMin && likeMax == o.likeMax &&
+           scrollMin == o.scrollMin && scrollMax == o.scrollMax &&
+           stayMin == o.stayMin && stayMax == o.stayMax &&
+           maxLikes == o.maxLikes && restMin == o.restMin &&
+           restMax == o.restMax && cooldownMin == o.cooldownMin &&
+           cooldownMax == o.cooldownMax;
+  }
+  bool operator!=(const ListMonitorSettings &o) const { return !(*this == o); }
+};
+
+// 记录列表显示选项
+struct ViewSettings {
+  bool hideReciprocated = true;
+  bool only24h = true;
+
+  bool operator==(const ViewSettings &o) const {
+    return hideReciprocated == o.hideReciprocated && only24h == o.only24h;
+  }
+  bool operator!=(const ViewSettings &o) const { return !(*this == o); }
+};
+
+// 账本存储后端（重启后生效）
+struct StorageSettings {
+  QString backend = "datastorage"; // 见 LedgerStore::backends()
+
+  bool operator==(const StorageSettings &o) const {
+    return backend == o.backend;
+  }
+  bool operator!=(const StorageSettings &o) const { return !(*this == o); }
+};
+
+struct AppSettings {
+  CollectorSettings collector;
+  ReciprocatorSettings reciprocator;
+  ListMonitorSettings listMonitor;
+  ViewSettings view;
+  StorageSettings storage;
+};
+
+// Central in-memory settings. Loaded in one pass, written back as a single
+// atomic JSON file after changes settle (debounced).
+class AppConfig : public QObject {
+  Q_OBJECT
+
+public:
+  explicit AppConfig(const QString &filePath, QObject *parent = nullptr);
+  ~AppConfig();
+
+  static QString defaultFilePath();
+
+  const AppSettings &settings() const { return m_settings; }
+  const CollectorSettings &collector() const { return m_settings.collector; }
+  const ReciprocatorSettings &reciprocator() const {
+    return m_settings.reciprocator;
+  }
+  const ListMonitorSettings &listMonitor() const {
+    return m_settings.listMonitor;
+  }
+  const ViewSettings &view() const { return m_settings.view; }
+  const StorageSettings &storage() const { return m_settings.storage; }
+
+  // Setters emit the matching signal and schedule a save only on change
+  void setCollector(const CollectorSettings &value);
+  void setReciprocator(const ReciprocatorSettings &value);
+  void setListMonitor(const ListMonitorSettings &value);
+  void setView(const ViewSettings &value);
+  void setStorage(const StorageSettings &value);
+
+  // Write pending changes immediately (also done on destruction)
+  void flush();
+
+signals:
+  void collectorChanged();
+  void reciprocatorChanged();
+  void listMonitorChanged();
+  void viewChanged();
+  void storageChanged();
+
+private:
+  void load();
+  void importLegacySettings();
+  bool normalize();
+  void scheduleSave();
+  bool save();
+  QJsonObject toJson() const;
+  void fromJson(const QJsonObject &root);
+
+  QString m_filePath;
+  AppSettings m_settings;
+  QTimer *m_saveTimer;
+  bool m_dirty;
+};
+
+#endif // APPCONFIG_H
@@ -0,0 +1,169 @@
+#include "LocalHttpServer.h"
+#include <QDebug>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+
+LocalHttpServer::LocalHttpServer(QObject *parent)
+    : QObject(parent), m_server(new QTcpServer(this)) {
+  connect(m_server, &QTcpServer::newConnection, this,
+          &LocalHttpServer::onNewConnection);
+}
+
+LocalHttpServer::~LocalHttpServer() { close(); }
+
+void LocalHttpServer::route(const QString &path, Handler handler) {
+  m_routes.insert(path, std::move(handler));
+}
+
+bool LocalHttpServer::listen(quint16 port) {
+  // Loopback only - never expose ledger data to the network
+  if (!m_server->listen(QHostAddress::LocalHost, port)) {
+    qWarning() << "[LocalHttpServer] listen failed on 127.0.0.1:" << port
+               << m_server->errorString();
+    return false;
+  }
+  qDebug() << "[LocalHttpServer] Listening on 127.0.0.1:"
+           << m_server->serverPort();
+  return true;
+}
+
+void LocalHttpServer::close() { m_server->close(); }
+
+void LocalHttpServer::onNewConnection() {
+  while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+    if (!socket->peerAddress().isLoopback()) {
+      socket->abort();
+      socket->deleteLater();
+      continue;
+    }
+
+    // Idle keep-alive connections are dropped after kIdleTimeoutMs
+    QTimer *idle = new QTimer(socket);
+    idle->setSingleShot(true);
+    idle->setInterval(kIdleTimeoutMs);
+    idle->setObjectName("xslIdle");
+    connect(idle, &QTimer::timeout, socket, &QTcpSocket::disconnectFromHost);
+    idle->start();
+
+    connect(socket, &QTcpSocket::disconnected, socket,
+            &QTcpSocket::deleteLater);
+    connect(socket, &QTcpSocket::readyRead, this,
+            [this, socket]() { onReadyRead(socket); });
+  }
+}
+
+void LocalHttpServer::onReadyRead(QTcpSocket *socket) {
+  // Wait for full header blocks; bodies are not supported
+  QByteArray buffered = socket->property("xslBuffer").toByteArray();
+  buffered += socket->readAll();
+
+  int end;
+  while ((end = buffered.indexOf("\r\n\r\n")) >= 0) {
+    QByteArray header = buffered.left(end);
+    buffered.remove(0, end + 4);
+
+    int served = socket->property("xslServed").toInt() + 1;
+    socket->setProperty("xslServed", served);
+    bool keepAlive = handleRequest(socket, header) &&
+                     served < kMaxRequestsPerConnection;
+    if (!keepAlive) {
+      socket->disconnectFromHost();
+      return;
+    }
+  }
+
+  if (buffered.size() > 16 * 1024) {
+    socket->abort();
+    return;
+  }
+  socket->setProperty("xslBuffer", buffered);
+  if (QTimer *idle = socket->findChild<QTimer *>("xslIdle"))
+    idle->start();
+}
+
+bool LocalHttpServer::handleRequest(QTcpSocket *socket,
+                                    const QByteArray &header) {
+  HttpResponse response;
+  QList<QByteArray> lines = header.split('\n');
+  QList<QByteArray> parts = lines.value(0).trimmed().split(' ');
+
+  // HTTP/1.1 is persistent by default, HTTP/1.0 only when asked for
+  bool http11 = parts.size() >= 3 && parts[2] == "HTTP/1.1";
+  bool keepAlive = http11;
+  QByteArray host;
+  bool hasOrigin = false;
+  for (int i = 1; i < lines.size(); i++) {
+    QByteArray line = lines[i].trimmed();
+    int colon = line.indexOf(':');
+    if (colon < 0)
+      continue;
+    QByteArray name = line.left(colon).trimmed().toLower();
+    QByteArray value = line.mid(colon + 1).trimmed().toLower();
+    if (name == "host") {
+      host = value;
+    } else if (name == "origin") {
+      hasOrigin = true;
+    } else if (name == "connection") {
+      if (value == "close")
+        keepAlive = false;
+      else if (value == "keep-alive")
+        keepAlive = true;
+    }
+  }
+  // Anything else reached us through a name that merely resolves to
+  // loopback (DNS rebinding)
+  const QByteArray portSuffix = ":" + QByteArray::number(port());
+  bool hostOk =
+      host == "127.0.0.1" + portSuffix || host == "localhost" + portSuffix;
+
+  if (parts.size() < 3 || !parts[2].startsWith("HTTP/1.")) {
+    response.status = 400;
+    response.body = "bad request\n";
+    keepAlive = false;
+  } else if (!hostOk) {
+    response.status = 421;
+    response.body = "misdirected request\n";
+    keepAlive = false;
+  } else if (hasOrigin) {
+    // Browsers send Origin on cross-origin requests; local tools don't
+    response.status = 403;
+    response.body = "forbidden\n";
+    keepAlive = false;
+  } else if (parts[0] != "GET") {
+    response.status = 405;
+    response.body = "method not allowed\n";
+  } else {
+    QUrl url(QString::fromLatin1(parts[1]));
+    auto it = m_routes.constFind(url.path());
+    if (it == m_routes.constEnd()) {
+      response.status = 404;
+      response.body = "not found\n";
+    } else {
+      // Fully decoding here would turn %26 / %3D inside a value into
+      // separators before QUrlQuery splits the items
+      response = it.value()(url.query(QUrl::FullyEncoded));
+    }
+  }
+
+  QByteArray reason = response.status == 200   ? "OK"
+                      : response.status == 400 ? "Bad Request"
+                      : response.status == 403 ? "Forbidden"
+                      : response.status == 404 ? "Not Found"
+                      : response.status == 405 ? "Method Not Allowed"
+                      : response.status == 421 ? "Misdirected Request"
+                      : response.status == 503 ? "Service Unavailable"
+                                               : "Error";
+  QByteArray head = "HTTP/1.1 " + QByteArray::number(response.status) + " " +
+                    reason + "\r\nContent-Type: " + response.contentType +
+                    "\r\nContent-Length: " +
+                    QByteArray::number(response.body.size()) +
+                    (keepAlive ? "\r\nConnection: keep-alive\r\nKeep-Alive: "
+                                 "timeout=" +
+                                     QByteArray::number(kIdleTimeoutMs / 1000)
+                               : QByteArray("\r\nConnection: close")) +
+                    "\r\n\r\n";
+  socket->write(head);
+  socket->write(response.body);
+  return keepAlive;
+}
@@ -0,0 +1,62 @@
+#ifndef LOCALHTTPSERVER_H
+#define LOCALHTTPSERVER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QTcpServer>
+#include <functional>
+
+class QTcpSocket;
+
+struct HttpResponse {
+  int status = 200;
+  QByteArray contentType = "text/plain; charset=utf-8";
+  QByteArray body;
+};
+
+// Minimal HTTP/1.1 GET server bound to 127.0.0.1 only, for local tooling
+//
+// Persistent connections: HTTP/1.1 keeps the socket open unless the client
+// sends "Connection: close"; pipelined requests are answered in order. Idle
+// sockets are closed after kIdleTimeoutMs. The server lives in the thread
+// of its QObject, so it can be moved to a worker thread; handlers then run
+// there and must not touch GUI-thread state.
+//
+// Loopback binding alone does not keep browsers out: a page can reach the
+// port through DNS rebinding or a cross-origin fetch. Requests whose Host
+// is not 127.0.0.1:<port> or localhost:<port> get 421, requests carrying
+// an Origin header get 403.
+class LocalHttpServer : public QObject {
+  Q_OBJECT
+
+public:
+  // query is passed fully encoded; decode items with QUrl::FullyDecoded
+  using Handler = std::function<HttpResponse(const QString &query)>;
+
+  static const int kIdleTimeoutMs = 5000;
+  static const int kMaxRequestsPerConnection = 1000;
+
+  explicit LocalHttpServer(QObject *parent = nullptr);
+  ~LocalHttpServer();
+
+  void route(const QString &path, Handler handler);
+
+  bool listen(quint16 port);
+  void close();
+  bool isListening() const { return m_server->isListening(); }
+  quint16 port() const { return m_server->serverPort(); }
+
+private slots:
+  void onNewConnection();
+
+private:
+  void onReadyRead(QTcpSocket *socket);
+  // Returns false when the connection should be closed after the response
+  bool handleRequest(QTcpSocket *socket, const QByteArray &header);
+
+  QTcpServer *m_server;
+  QHash<QString, Handler> m_routes;
+};
+
+#endif // LOCALHTTPSERVER_H
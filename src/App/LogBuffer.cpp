@@ -0,0 +1,208 @@
+#include "LogBuffer.h"
+#include "MemoryAccounting.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+LogBuffer::LogBuffer(int capacity, QObject *parent)
+    : QObject(parent), m_entries(qMax(capacity, 1)), m_head(0), m_count(0),
+      m_nextSeq(0), m_stringBytes(0), m_sink(nullptr) {
+  MemoryAccounting::instance()->addSource("log", this, [this]() {
+    return MemoryUsage{memoryBytes(), m_count};
+  });
+}
+
+LogBuffer::~LogBuffer() { setFileSink(QString()); }
+
+void LogBuffer::append(const QString &source, LogLevel level,
+                       const QString &message) {
+  LogEntry &slot = m_entries[m_head];
+
+  // Evict the oldest entry when full
+  if (m_count == m_entries.size()) {
+    release(slot.messageId);
+  } else {
+    m_count++;
+  }
+
+  slot.seq = m_nextSeq++;
+  slot.timestampMs = QDateTime::currentMSecsSinceEpoch();
+  slot.sourceId = sourceIdFor(source);
+  slot.level = level;
+  slot.messageId = intern(message);
+
+  m_head = (m_head + 1) % m_entries.size();
+
+  if (m_sink) {
+    m_sink->enqueue(QString("%1 [%2] [%3] %4")
+                        .arg(QDateTime::fromMSecsSinceEpoch(slot.timestampMs)
+                                 .toString("yyyy-MM-dd HH:mm:ss.zzz"),
+                             levelName(level), source, message));
+  }
+
+  emit entriesAppended();
+}
+
+const LogEntry &LogBuffer::entry(quint64 seq) const {
+  Q_ASSERT(seq >= firstSeq() && seq < m_nextSeq);
+  int back = static_cast<int>(m_nextSeq - seq); // 1 = newest
+  int index = (m_head - back + m_entries.size()) % m_entries.size();
+  return m_entries[index];
+}
+
+QString LogBuffer::message(const LogEntry &entry) const {
+  if (entry.messageId >= static_cast<quint32>(m_strings.size()))
+    return QString();
+  return m_strings[entry.messageId].text;
+}
+
+QString LogBuffer::levelName(LogLevel level) {
+  switch (level) {
+  case LogLevel::Debug:
+    return "DEBUG";
+  case LogLevel::Info:
+    return "INFO";
+  case LogLevel::Warning:
+    return "WARN";
+  case LogLevel::Error:
+    return "ERROR";
+  }
+  return QString();
+}
+
+qint64 LogBuffer::memoryBytes() const {
+  return qint64(m_entries.size()) * sizeof(LogEntry) +
+         qint64(m_strings.capacity()) * sizeof(InternedString) +
+         m_stringIndex.size() * qint64(sizeof(QString) + sizeof(quint32)) +
+         m_stringBytes;
+}
+
+quint32 LogBuffer::intern(const QString &message) {
+  auto it = m_stringIndex.constFind(message);
+  if (it != m_stringIndex.constEnd()) {
+    m_strings[it.value()].refs++;
+    return it.value();
+  }
+
+  quint32 id;
+  if (!m_freeStrings.isEmpty()) {
+    id = m_freeStrings.takeLast();
+  } else {
+    id = static_cast<quint32>(m_strings.size());
+    m_strings.append(InternedString());
+  }
+  m_strings[id].text = message;
+  m_strings[id].refs = 1;
+  m_stringIndex.insert(message, id);
+  m_stringBytes += message.size() * qint64(sizeof(QChar));
+  return id;
+}
+
+void LogBuffer::release(quint32 messageId) {
+  if (messageId >= static_cast<quint32>(m_strings.size()))
+    return;
+  InternedString &s = m_strings[messageId];
+  if (--s.refs > 0)
+    return;
+  m_stringBytes -= s.text.size() * qint64(sizeof(QChar));
+  m_stringIndex.remove(s.text);
+  s.text.clear();
+  m_freeStrings.append(messageId);
+}
+
+quint16 LogBuffer::sourceIdFor(const QString &source) {
+  int id = m_sources.indexOf(source);
+  if (id >= 0)
+    return static_cast<quint16>(id);
+  m_sources.append(source);
+  emit sourceAdded(source);
+  return static_cast<quint16>(m_sources.size() - 1);
+}
+
+void LogBuffer::setFileSink(const QString &directory, qint64 maxBytes,
+                            int maxFiles) {
+  if (m_sink) {
+    m_sink->shutdown();
+    delete m_sink;
+    m_sink = nullptr;
+  }
+  if (directory.isEmpty())
+    return;
+
+  QDir().mkpath(directory);
+  m_sink = new LogFileSink(directory, maxBytes, maxFiles);
+  m_sink->start(QThread::LowPriority);
+}
+
+// ==================== LogFileSink ====================
+
+LogFileSink::LogFileSink(const QString &directory, qint64 maxBytes,
+                         int maxFiles, QObject *parent)
+    : QThread(parent), m_directory(directory), m_maxBytes(maxBytes),
+      m_maxFiles(qMax(maxFiles, 1)), m_stopping(false) {}
+
+LogFileSink::~LogFileSink() { shutdown(); }
+
+void LogFileSink::enqueue(const QString &line) {
+  QMutexLocker locker(&m_mutex);
+  m_pending.append(line);
+  m_cond.wakeOne();
+}
+
+void LogFileSink::shutdown() {
+  {
+    QMutexLocker locker(&m_mutex);
+    m_stopping = true;
+    m_cond.wakeOne();
+  }
+  wait();
+}
+
+void LogFileSink::run() {
+  QFile file(filePath(0));
+  file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+
+  forever {
+    QStringList batch;
+    {
+      QMutexLocker locker(&m_mutex);
+      while (m_pending.isEmpty() && !m_stopping)
+        m_cond.wait(&m_mutex);
+      batch.swap(m_pending);
+      if (batch.isEmpty() && m_stopping)
+        break;
+    }
+
+    if (!file.isOpen())
+      continue;
+
+    for (const QString &line : batch) {
+      file.write(line.toUtf8());
+      file.write("\n");
+    }
+    file.flush();
+
+    if (file.size() >= m_maxBytes) {
+      file.close();
+      rotate();
+      file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+    }
+  }
+}
+
+void LogFileSink::rotate() {
+  // xsl.log -> xsl.1.log -> ... -> xsl.<maxFiles-1>.log (oldest dropped)
+  QFile::remove(filePath(m_maxFiles - 1));
+  for (int i = m_maxFiles - 2; i >= 0; i--) {
+    if (QFileInfo::exists(filePath(i)))
+      QFile::rename(filePath(i), filePath(i + 1));
+  }
+}
+
+QString LogFileSink::filePath(int index) const {
+  if (index == 0)
+    return m_directory + "/xsl.log";
+  return QString("%1/xsl.%2.log").arg(m_directory).arg(index);
+}
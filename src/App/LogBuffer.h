@@ -0,0 +1,114 @@
+#ifndef LOGBUFFER_H
+#define LOGBUFFER_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+enum class LogLevel : quint8 { Debug, Info, Warning, Error };
+
+// One slot of the ring buffer. Source and message are interned ids so a
+// slot stays a fixed 24 bytes regardless of message length.
+struct LogEntry {
+  quint64 seq = 0;
+  qint64 timestampMs = 0;
+  quint32 messageId = 0;
+  quint16 sourceId = 0;
+  LogLevel level = LogLevel::Info;
+};
+
+class LogFileSink;
+
+// Fixed-capacity log ring buffer shared by the log console and file sink
+class LogBuffer : public QObject {
+  Q_OBJECT
+
+public:
+  explicit LogBuffer(int capacity = 20000, QObject *parent = nullptr);
+  ~LogBuffer();
+
+  void append(const QString &source, LogLevel level, const QString &message);
+
+  int capacity() const { return m_entries.size(); }
+  int size() const { return m_count; }
+
+  // Sequence numbers are monotonic; [firstSeq, nextSeq) is resident
+  quint64 firstSeq() const { return m_nextSeq - m_count; }
+  quint64 nextSeq() const { return m_nextSeq; }
+  const LogEntry &entry(quint64 seq) const;
+
+  QString message(const LogEntry &entry) const;
+  QString source(quint16 sourceId) const { return m_sources.value(sourceId); }
+  QStringList sources() const { return m_sources; }
+  static QString levelName(LogLevel level);
+
+  // Approximate heap held by entries and interned strings
+  qint64 memoryBytes() const;
+
+  // Async rotating file sink; an empty directory disables it
+  void setFileSink(const QString &directory, qint64 maxBytes = 4 * 1024 * 1024,
+                   int maxFiles = 5);
+
+signals:
+  void entriesAppended();
+  void sourceAdded(const QString &source);
+
+private:
+  struct InternedString {
+    QString text;
+    int refs = 0;
+  };
+
+  quint32 intern(const QString &message);
+  void release(quint32 messageId);
+  quint16 sourceIdFor(const QString &source);
+
+  QVector<LogEntry> m_entries;
+  int m_head;  // index of the next slot to write
+  int m_count; // resident entries
+  quint64 m_nextSeq;
+
+  QVector<InternedString> m_strings;
+  QVector<quint32> m_freeStrings;
+  QHash<QString, quint32> m_stringIndex;
+  qint64 m_stringBytes;
+
+  QStringList m_sources;
+  LogFileSink *m_sink;
+};
+
+// Background writer so disk I/O never runs on the GUI thread
+class LogFileSink : public QThread {
+  Q_OBJECT
+
+public:
+  LogFileSink(const QString &directory, qint64 maxBytes, int maxFiles,
+              QObject *parent = nullptr);
+  ~LogFileSink();
+
+  void enqueue(const QString &line);
+  void shutdown();
+
+protected:
+  void run() override;
+
+private:
+  void rotate();
+  QString filePath(int index) const;
+
+  QString m_directory;
+  qint64 m_maxBytes;
+  int m_maxFiles;
+
+  QMutex m_mutex;
+  QWaitCondition m_cond;
+  QStringList m_pending;
+  bool m_stopping;
+};
+
+#endif // LOGBUFFER_H
@@ -0,0 +1,227 @@
+#include "MemoryAccounting.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QTableWidget>
+#include <QTimer>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// QTableWidgetItem + 值向量 + 模型里的指针槽
+const qint64 kTableItemBytes = 96;
+const int kTableSampleRows = 64;
+
+void publish(const QString &subsystem, const MemoryUsage &usage) {
+  QString labels = QString("subsystem=\"%1\"").arg(subsystem);
+  Metrics::instance()
+      ->gauge("xsl_memory_bytes",
+              "Estimated heap bytes held by a subsystem", labels)
+      ->set(usage.bytes);
+  Metrics::instance()
+      ->gauge("xsl_memory_objects",
+              "Objects (rows, items, buffers) held by a subsystem", labels)
+      ->set(usage.objects);
+}
+
+} // namespace
+
+MemoryAccounting *MemoryAccounting::instance() {
+  static MemoryAccounting *accounting = new MemoryAccounting();
+  return accounting;
+}
+
+MemoryAccounting::MemoryAccounting(QObject *parent)
+    : QObject(parent), m_timer(new QTimer(this)),
+      m_intervalMs(kDefaultIntervalMs) {
+  connect(m_timer, &QTimer::timeout, this, [this]() { sample(); });
+}
+
+void MemoryAccounting::addSource(const QString &subsystem, QObject *owner,
+                                 Estimator estimate) {
+  {
+    QMutexLocker lock(&m_sourceMutex);
+    m_sources.append({subsystem, owner, std::move(estimate)});
+  }
+  // 直接连接：owner 析构时立即注销，之后的采样不会再调用它
+  connect(
+      owner, &QObject::destroyed, this,
+      [this, owner]() {
+        QMutexLocker lock(&m_sourceMutex);
+        for (int i = m_sources.size() - 1; i >= 0; i--) {
+          if (m_sources[i].owner == owner)
+            m_sources.removeAt(i);
+        }
+      },
+      Qt::DirectConnection);
+}
+
+MemoryAccounting::Charge::Charge(const QString &subsystem, qint64 bytes,
+                                 qint64 objects)
+    : m_subsystem(subsystem), m_bytes(bytes), m_objects(objects) {
+  MemoryAccounting::instance()->applyCharge(m_subsystem, m_bytes, m_objects);
+}
+
+MemoryAccounting::Charge::~Charge() {
+  MemoryAccounting::instance()->applyCharge(m_subsystem, -m_bytes,
+                                            -m_objects);
+}
+
+void MemoryAccounting::Charge::resize(qint64 bytes) {
+  MemoryAccounting::instance()->applyCharge(m_subsystem, bytes - m_bytes, 0);
+  m_bytes = bytes;
+}
+
+void MemoryAccounting::applyCharge(const QString &subsystem, qint64 bytes,
+                                   qint64 objects) {
+  QMutexLocker lock(&m_mutex);
+  MemoryUsage &usage = m_charges[subsystem];
+  usage.bytes += bytes;
+  usage.objects += objects;
+  qint64 &peak = m_peaks[subsystem];
+  peak = qMax(peak, usage.bytes);
+}
+
+void MemoryAccounting::start(int intervalMs) {
+  m_intervalMs = qMax(intervalMs, 1000);
+  m_timer->start(m_intervalMs);
+  sample();
+  qDebug() << "[MemoryAccounting] Sampling every" << m_intervalMs << "ms";
+}
+
+void MemoryAccounting::stop() { m_timer->stop(); }
+
+bool MemoryAccounting::isRunning() const { return m_timer->isActive(); }
+
+MemorySample MemoryAccounting::sample() {
+  XSL_TRACE_SCOPE("MemoryAccounting::sample");
+  MemorySample s;
+  s.atMs = QDateTime::currentMSecsSinceEpoch();
+  s.residentBytes = residentBytes();
+  QList<Source> sources;
+  {
+    QMutexLocker lock(&m_sourceMutex);
+    sources = m_sources;
+  }
+  for (const Source &source : sources) {
+    // 还在工作线程里构建，数据可能正在写
+    if (source.owner->thread() != thread())
+      continue;
+    MemoryUsage usage = source.estimate();
+    MemoryUsage &total = s.subsystems[source.subsystem];
+    total.bytes += usage.bytes;
+    total.objects += usage.objects;
+  }
+
+  {
+    QMutexLocker lock(&m_mutex);
+    for (auto it = m_charges.constBegin(); it != m_charges.constEnd(); ++it) {
+      MemoryUsage &total = s.subsystems[it.key()];
+      total.bytes += it.value().bytes;
+      total.objects += it.value().objects;
+    }
+    for (auto it = s.subsystems.constBegin(); it != s.subsystems.constEnd();
+         ++it) {
+      qint64 &peak = m_peaks[it.key()];
+      peak = qMax(peak, it.value().bytes);
+    }
+    m_history.append(s);
+    if (m_history.size() > kHistoryCapacity)
+      m_history.removeFirst();
+  }
+
+  for (auto it = s.subsystems.constBegin(); it != s.subsystems.constEnd();
+       ++it)
+    publish(it.key(), it.value());
+  Metrics::instance()
+      ->gauge("xsl_process_resident_bytes", "Process resident set size")
+      ->set(s.residentBytes);
+  emit sampled();
+  return s;
+}
+
+QList<MemorySample> MemoryAccounting::history() const {
+  QMutexLocker lock(&m_mutex);
+  return m_history;
+}
+
+QHash<QString, qint64> MemoryAccounting::peaks() const {
+  QMutexLocker lock(&m_mutex);
+  return m_peaks;
+}
+
+qint64 MemoryAccounting::residentBytes() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return qint64(counters.WorkingSetSize);
+  return 0;
+#else
+  // statm 第二列：常驻页数；页大小因平台而异（arm64 常见 16K/64K）
+  QFile statm("/proc/self/statm");
+  if (!statm.open(QIODevice::ReadOnly))
+    return 0;
+  QList<QByteArray> fields = statm.readAll().split(' ');
+  static const qint64 pageSize = qMax(1L, sysconf(_SC_PAGESIZE));
+  return fields.value(1).toLongLong() * pageSize;
+#endif
+}
+
+qint64 MemoryAccounting::peakResidentBytes() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return qint64(counters.PeakWorkingSetSize);
+  return 0;
+#else
+  QFile status("/proc/self/status");
+  if (!status.open(QIODevice::ReadOnly))
+    return 0;
+  for (const QByteArray &line : status.readAll().split('\n')) {
+    if (line.startsWith("VmHWM:"))
+      return line.mid(6).trimmed().split(' ').value(0).toLongLong() * 1024;
+  }
+  return 0;
+#endif
+}
+
+MemoryUsage MemoryAccounting::estimateTable(const QTableWidget *table) {
+  MemoryUsage usage;
+  int rows = table->rowCount();
+  int cols = table->columnCount();
+  if (rows == 0 || cols == 0)
+    return usage;
+
+  // 均匀抽样若干行，按比例放大；表格可能有几十万行，不能逐格遍历
+  int sampled = qMin(rows, kTableSampleRows);
+  qint64 items = 0;
+  qint64 textBytes = 0;
+  for (int i = 0; i < sampled; i++) {
+    int row = int(qint64(i) * rows / sampled);
+    for (int col = 0; col < cols; col++) {
+      const QTableWidgetItem *item = table->item(row, col);
+      if (!item)
+        continue;
+      items++;
+      // 非虚调用：只算单元格自己存的值，不算子类（SnippetItem）临时
+      // 从别处解析出的文本
+      for (int role : {int(Qt::DisplayRole), int(Qt::ToolTipRole),
+                       int(Qt::UserRole), int(Qt::UserRole + 1)}) {
+        QVariant v = item->QTableWidgetItem::data(role);
+        if (v.typeId() == QMetaType::QString)
+          textBytes += v.toString().size() * qint64(sizeof(QChar));
+      }
+    }
+  }
+  usage.objects = items * rows / sampled;
+  usage.bytes = (items * kTableItemBytes + textBytes) * rows / sampled;
+  return usage;
+}
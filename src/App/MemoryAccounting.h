@@ -0,0 +1,112 @@
+#ifndef MEMORYACCOUNTING_H
+#define MEMORYACCOUNTING_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <functional>
+
+class QTableWidget;
+class QTimer;
+
+struct MemoryUsage {
+  qint64 bytes = 0;
+  qint64 objects = 0;
+};
+
+struct MemorySample {
+  qint64 atMs = 0;          // 采样时间（epoch 毫秒）
+  qint64 residentBytes = 0; // 进程常驻内存，读不到为 0
+  QHash<QString, MemoryUsage> subsystems;
+};
+
+// 按子系统的内存记账
+//
+// 两种来源：
+//  - 估算函数：长期持有数据的对象（账本快照、索引、日志缓冲、表格）
+//    构造时 addSource()，采样时在 GUI 线程调用；owner 析构时自动注销。
+//    在工作线程构造的对象（启动时重建的索引）移交到 GUI 线程之前不采样。
+//  - Charge：导出等短期缓冲，构造时记入、析构时扣除，任意线程可用。
+// 定时采样把结果写入 xsl_memory_bytes / xsl_memory_objects{subsystem}
+// 与 xsl_process_resident_bytes，并保留最近 kHistoryCapacity 次采样，
+// 诊断面板据此显示长时间运行的增长趋势。估算是近似值，不含分配器开销。
+class MemoryAccounting : public QObject {
+  Q_OBJECT
+
+public:
+  static const int kDefaultIntervalMs = 30000;
+  static const int kHistoryCapacity = 2880; // 默认间隔下 24 小时
+  // 估算函数共用：QHash 每个节点除键值外的开销（桶指针 + 节点头）
+  static const qint64 kHashEntryBytes = 32;
+
+  using Estimator = std::function<MemoryUsage()>;
+
+  static MemoryAccounting *instance();
+
+  // 任意线程可调用；owner 不在 GUI 线程时采样跳过它，直到移交过来。
+  // 同一子系统可以有多个来源，采样时相加
+  void addSource(const QString &subsystem, QObject *owner,
+                 Estimator estimate);
+
+  // RAII 记账：短期缓冲的字节数，可随缓冲增长 resize
+  class Charge {
+  public:
+    Charge(const QString &subsystem, qint64 bytes = 0, qint64 objects = 1);
+    ~Charge();
+    void resize(qint64 bytes);
+
+    Charge(const Charge &) = delete;
+    Charge &operator=(const Charge &) = delete;
+
+  private:
+    QString m_subsystem;
+    qint64 m_bytes;
+    qint64 m_objects;
+  };
+
+  // 在 GUI 线程调用
+  void start(int intervalMs = kDefaultIntervalMs);
+  void stop();
+  bool isRunning() const;
+  int intervalMs() const { return m_intervalMs; }
+
+  // 立即采样一次（也更新指标与历史）
+  MemorySample sample();
+  QList<MemorySample> history() const; // 旧的在前
+  // 各子系统自启动以来的最大字节数（含 Charge 的瞬时峰值）
+  QHash<QString, qint64> peaks() const;
+
+  static qint64 residentBytes();
+  static qint64 peakResidentBytes();
+
+  // QTableWidget 内容的估算：单元格对象 + 抽样行的文本
+  static MemoryUsage estimateTable(const QTableWidget *table);
+
+signals:
+  void sampled();
+
+private:
+  struct Source {
+    QString subsystem;
+    QObject *owner;
+    Estimator estimate;
+  };
+
+  explicit MemoryAccounting(QObject *parent = nullptr);
+
+  void applyCharge(const QString &subsystem, qint64 bytes, qint64 objects);
+
+  QTimer *m_timer;
+  int m_intervalMs;
+  mutable QMutex m_sourceMutex; // 保护 m_sources（注册可能来自工作线程）
+  QList<Source> m_sources;
+
+  mutable QMutex m_mutex; // 保护下面三项
+  QHash<QString, MemoryUsage> m_charges;
+  QHash<QString, qint64> m_peaks;
+  QList<MemorySample> m_history;
+};
+
+#endif // MEMORYACCOUNTING_H
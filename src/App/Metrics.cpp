@@ -0,0 +1,182 @@
+#include "Metrics.h"
+#include "Trace.h"
+#include <QMutexLocker>
+
+// ==================== Histogram ====================
+
+int Histogram::bucketIndex(quint64 micros) {
+  constexpr quint64 linearLimit = quint64(2) << kSubBits; // 64
+  if (micros < linearLimit)
+    return int(micros);
+
+  int msb = 63 - qCountLeadingZeroBits(micros);
+  int shift = msb - kSubBits;
+  int index = (shift << kSubBits) + int(micros >> shift);
+  return qMin(index, kBucketCount - 1);
+}
+
+quint64 Histogram::bucketLowerBound(int index) {
+  constexpr int linearLimit = 2 << kSubBits;
+  if (index < linearLimit)
+    return quint64(index);
+  int shift = (index >> kSubBits) - 1;
+  quint64 mantissa = quint64(index - (shift << kSubBits));
+  return mantissa << shift;
+}
+
+void Histogram::record(quint64 micros) {
+  m_buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(micros, std::memory_order_relaxed);
+
+  quint64 prev = m_max.load(std::memory_order_relaxed);
+  while (micros > prev &&
+         !m_max.compare_exchange_weak(prev, micros, std::memory_order_relaxed))
+    ;
+}
+
+quint64 Histogram::percentile(double q) const {
+  quint64 total = count();
+  if (total == 0)
+    return 0;
+
+  quint64 rank = quint64(qBound(0.0, q, 1.0) * double(total - 1)) + 1;
+  quint64 seen = 0;
+  for (int i = 0; i < kBucketCount; i++) {
+    seen += m_buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      // Upper edge of the bucket, never above the observed max
+      quint64 upper = i + 1 < kBucketCount ? bucketLowerBound(i + 1) - 1
+                                           : bucketLowerBound(i);
+      return qMin(upper, max());
+    }
+  }
+  return max();
+}
+
+// ==================== Metrics ====================
+
+Metrics *Metrics::instance() {
+  static Metrics s_instance;
+  return &s_instance;
+}
+
+Metrics::Series &Metrics::seriesFor(const QString &name, const QString &help,
+                                    Kind kind, const QString &labels) {
+  Family &family = m_families[name];
+  if (family.name.isEmpty()) {
+    family.name = name;
+    family.help = help;
+    family.kind = kind;
+  }
+  Q_ASSERT(family.kind == kind);
+
+  for (Series &s : family.series) {
+    if (s.labels == labels)
+      return s;
+  }
+  Series s;
+  s.labels = labels;
+  family.series.append(s);
+  return family.series.last();
+}
+
+Counter *Metrics::counter(const QString &name, const QString &help,
+                          const QString &labels) {
+  QMutexLocker locker(&m_mutex);
+  Series &s = seriesFor(name, help, Kind::Counter, labels);
+  if (!s.counter) {
+    m_counters.push_back(std::make_unique<Counter>());
+    s.counter = m_counters.back().get();
+  }
+  return s.counter;
+}
+
+Gauge *Metrics::gauge(const QString &name, const QString &help,
+                      const QString &labels) {
+  QMutexLocker locker(&m_mutex);
+  Series &s = seriesFor(name, help, Kind::Gauge, labels);
+  if (!s.gauge) {
+    m_gauges.push_back(std::make_unique<Gauge>());
+    s.gauge = m_gauges.back().get();
+  }
+  return s.gauge;
+}
+
+Histogram *Metrics::histogram(const QString &name, const QString &help,
+                              const QString &labels) {
+  QMutexLocker locker(&m_mutex);
+  Series &s = seriesFor(name, help, Kind::Histogram, labels);
+  if (!s.histogram) {
+    m_histograms.push_back(std::make_unique<Histogram>());
+    s.histogram = m_histograms.back().get();
+  }
+  return s.histogram;
+}
+
+QList<Metrics::Family> Metrics::families() const {
+  QMutexLocker locker(&m_mutex);
+  return m_families.values();
+}
+
+QByteArray Metrics::renderPrometheus() const {
+  auto seriesName = [](const QString &name, const QString &labels,
+                       const QString &extra = QString()) {
+    QStringList all;
+    if (!labels.isEmpty())
+      all << labels;
+    if (!extra.isEmpty())
+      all << extra;
+    return all.isEmpty() ? name : name + "{" + all.join(",") + "}";
+  };
+
+  QString out;
+  for (const Family &f : families()) {
+    out += QString("# HELP %1 %2\n").arg(f.name, f.help);
+    switch (f.kind) {
+    case Kind::Counter:
+      out += QString("# TYPE %1 counter\n").arg(f.name);
+      for (const Series &s : f.series)
+        out += QString("%1 %2\n")
+                   .arg(seriesName(f.name, s.labels))
+                   .arg(s.counter->value());
+      break;
+    case Kind::Gauge:
+      out += QString("# TYPE %1 gauge\n").arg(f.name);
+      for (const Series &s : f.series)
+        out += QString("%1 %2\n")
+                   .arg(seriesName(f.name, s.labels))
+                   .arg(s.gauge->value());
+      break;
+    case Kind::Histogram:
+      // Exposed as a summary: quantiles are what the dashboards plot
+      out += QString("# TYPE %1 summary\n").arg(f.name);
+      for (const Series &s : f.series) {
+        const Histogram *h = s.histogram;
+        for (double q : {0.5, 0.9, 0.99}) {
+          out += QString("%1 %2\n")
+                     .arg(seriesName(f.name, s.labels,
+                                     QString("quantile=\"%1\"").arg(q)))
+                     .arg(h->percentile(q) / 1e6, 0, 'g', 6);
+        }
+        out += QString("%1 %2\n")
+                   .arg(seriesName(f.name + "_sum", s.labels))
+                   .arg(h->sum() / 1e6, 0, 'g', 9);
+        out += QString("%1 %2\n")
+                   .arg(seriesName(f.name + "_count", s.labels))
+                   .arg(h->count());
+      }
+      break;
+    }
+  }
+  return out.toUtf8();
+}
+
+// ==================== ScopedLatency ====================
+
+ScopedLatency::ScopedLatency(Histogram *histogram)
+    : m_histogram(histogram), m_startNs(Trace::nowNs()) {}
+
+ScopedLatency::~ScopedLatency() {
+  m_histogram->record(quint64(Trace::nowNs() - m_startNs) / 1000);
+}
@@ -0,0 +1,121 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+
+// In-process metrics: lock-free counters, gauges and log-linear (HDR-style)
+// latency histograms, collected in one registry that can render itself in
+// Prometheus text exposition format.
+
+class Counter {
+public:
+  void inc(quint64 n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+  quint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<quint64> m_value{0};
+};
+
+class Gauge {
+public:
+  void set(qint64 v) { m_value.store(v, std::memory_order_relaxed); }
+  void add(qint64 d) { m_value.fetch_add(d, std::memory_order_relaxed); }
+  qint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<qint64> m_value{0};
+};
+
+// Records microseconds. 32 linear sub-buckets per power of two keep the
+// relative error at or below 1/32 (~3%). The last of the 1184 buckets starts
+// at 63 << 35 us, so the range ends near 2^41 us (~25 days); larger values
+// land in that bucket.
+class Histogram {
+public:
+  static constexpr int kSubBits = 5;
+  static constexpr int kBucketCount = 1184;
+
+  void record(quint64 micros);
+
+  quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+  quint64 sum() const { return m_sum.load(std::memory_order_relaxed); }
+  quint64 max() const { return m_max.load(std::memory_order_relaxed); }
+
+  // q in [0, 1]; returns an upper-bound estimate in microseconds
+  quint64 percentile(double q) const;
+
+  static int bucketIndex(quint64 micros);
+  static quint64 bucketLowerBound(int index);
+
+private:
+  std::array<std::atomic<quint64>, kBucketCount> m_buckets{};
+  std::atomic<quint64> m_count{0};
+  std::atomic<quint64> m_sum{0};
+  std::atomic<quint64> m_max{0};
+};
+
+class Metrics {
+public:
+  enum class Kind { Counter, Gauge, Histogram };
+
+  struct Series {
+    QString labels; // e.g. type="like"
+    Counter *counter = nullptr;
+    Gauge *gauge = nullptr;
+    Histogram *histogram = nullptr;
+  };
+
+  struct Family {
+    QString name;
+    QString help;
+    Kind kind;
+    QList<Series> series;
+  };
+
+  static Metrics *instance();
+
+  // Returned pointers stay valid for the lifetime of the process
+  Counter *counter(const QString &name, const QString &help,
+                   const QString &labels = QString());
+  Gauge *gauge(const QString &name, const QString &help,
+               const QString &labels = QString());
+  Histogram *histogram(const QString &name, const QString &help,
+                       const QString &labels = QString());
+
+  QList<Family> families() const;
+  QByteArray renderPrometheus() const;
+
+private:
+  Metrics() = default;
+  Series &seriesFor(const QString &name, const QString &help, Kind kind,
+                    const QString &labels);
+
+  mutable QMutex m_mutex;
+  QMap<QString, Family> m_families;
+  std::list<std::unique_ptr<Counter>> m_counters;
+  std::list<std::unique_ptr<Gauge>> m_gauges;
+  std::list<std::unique_ptr<Histogram>> m_histograms;
+};
+
+// Records the lifetime of the scope into a histogram
+class ScopedLatency {
+public:
+  explicit ScopedLatency(Histogram *histogram);
+  ~ScopedLatency();
+
+  ScopedLatency(const ScopedLatency &) = delete;
+  ScopedLatency &operator=(const ScopedLatency &) = delete;
+
+private:
+  Histogram *m_histogram;
+  qint64 m_startNs;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,300 @@
+#include "Scheduler.h"
+#include "Metrics.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <algorithm>
+#include <climits>
+
+Scheduler *Scheduler::instance() {
+  // 随 QCoreApplication 销毁，避免静态析构时 QTimer 已无事件循环
+  static SystemClock *s_clock = new SystemClock();
+  static Scheduler *s_instance =
+      new Scheduler(s_clock, 10, QCoreApplication::instance());
+  return s_instance;
+}
+
+Scheduler::Scheduler(Clock *clock, int tickMs, QObject *parent)
+    : QObject(parent), m_clock(clock), m_tickMs(qMax(1, tickMs)),
+      m_currentTick(0), m_nextId(1), m_armedTick(0), m_wakeups(0),
+      m_running(false) {
+  std::fill(std::begin(m_levelCount), std::end(m_levelCount), 0);
+  m_currentTick = quint64(qMax<qint64>(0, m_clock->nowMs())) / m_tickMs;
+
+  m_driver = new QTimer(this);
+  m_driver->setSingleShot(true);
+  m_driver->setTimerType(Qt::PreciseTimer);
+  connect(m_driver, &QTimer::timeout, this, &Scheduler::onDriverTimeout);
+}
+
+Scheduler::TimerId Scheduler::singleShot(qint64 delayMs, QObject *context,
+                                         std::function<void()> fn) {
+  return add(delayMs, 0, context, std::move(fn));
+}
+
+Scheduler::TimerId Scheduler::repeating(qint64 intervalMs, QObject *context,
+                                        std::function<void()> fn) {
+  return add(intervalMs, qMax<qint64>(1, intervalMs), context, std::move(fn));
+}
+
+bool Scheduler::cancel(TimerId id) {
+  // 槽位里的 id 留到扫描时丢弃（惰性删除）
+  return m_entries.remove(id) > 0;
+}
+
+qint64 Scheduler::deadlineMs(TimerId id) const {
+  auto it = m_entries.constFind(id);
+  return it == m_entries.constEnd() ? -1 : it->deadlineMs;
+}
+
+qint64 Scheduler::remainingMs(TimerId id) const {
+  auto it = m_entries.constFind(id);
+  if (it == m_entries.constEnd())
+    return 0;
+  return qMax<qint64>(0, it->deadlineMs - nowMs());
+}
+
+void Scheduler::runUntil(qint64 targetMs) {
+  if (!m_clock->isVirtual()) {
+    qWarning() << "[Scheduler] runUntil() requires a VirtualClock";
+    return;
+  }
+  quint64 targetTick = quint64(qMax<qint64>(0, targetMs)) / m_tickMs;
+  for (;;) {
+    quint64 wakeTick = nextWakeTick();
+    if (wakeTick == 0 || wakeTick > targetTick)
+      break;
+    ++m_wakeups;
+    advanceTo(wakeTick);
+  }
+  advanceTo(targetTick);
+  auto *clock = static_cast<VirtualClock *>(m_clock);
+  clock->setNowMs(qMax(clock->nowMs(), targetMs));
+}
+
+Scheduler::TimerId Scheduler::add(qint64 delayMs, qint64 intervalMs,
+                                  QObject *context, std::function<void()> fn) {
+  TimerId id = m_nextId++;
+  Entry entry;
+  entry.deadlineMs = nowMs() + qMax<qint64>(0, delayMs);
+  entry.intervalMs = intervalMs;
+  entry.expiryTick = 0;
+  entry.context = context;
+  entry.hasContext = context != nullptr;
+  entry.fn = std::move(fn);
+  m_entries.insert(id, std::move(entry));
+
+  // 当前 tick 的槽位已处理过，最早排到下一个 tick
+  place(id, qMax(tickForDeadline(m_entries[id].deadlineMs), m_currentTick + 1));
+  rearm();
+  return id;
+}
+
+quint64 Scheduler::tickForDeadline(qint64 deadlineMs) const {
+  if (deadlineMs <= 0)
+    return 0;
+  return (quint64(deadlineMs) + m_tickMs - 1) / m_tickMs; // 向上取整
+}
+
+void Scheduler::place(TimerId id, quint64 expiryTick) {
+  Entry &entry = m_entries[id];
+  expiryTick = qMax(expiryTick, m_currentTick);
+  entry.expiryTick = expiryTick;
+
+  quint64 delta = expiryTick - m_currentTick;
+  int level = 0;
+  while (level < kLevels - 1 &&
+         delta >= (quint64(1) << (kLevelBits * (level + 1)))) {
+    ++level;
+  }
+
+  // 超出轮子范围的放在最高层末尾，级联时重新计算
+  const quint64 maxDelta = (quint64(1) << (kLevelBits * kLevels)) - 1;
+  quint64 slotTick = delta > maxDelta ? m_currentTick + maxDelta : expiryTick;
+
+  int slot = int((slotTick >> (kLevelBits * level)) & (kSlots - 1));
+  m_wheel[level][slot].append(id);
+  m_levelCount[level]++;
+}
+
+void Scheduler::cascade(int level, int slot) {
+  QVector<TimerId> ids;
+  ids.swap(m_wheel[level][slot]);
+  m_levelCount[level] -= ids.size();
+  for (TimerId id : ids) {
+    auto it = m_entries.constFind(id);
+    if (it != m_entries.constEnd()) {
+      place(id, it->expiryTick);
+    }
+  }
+}
+
+void Scheduler::stepTick() {
+  ++m_currentTick;
+
+  // 到达上层边界时把上层槽位下放（先高后低）
+  for (int level = kLevels - 1; level >= 1; --level) {
+    quint64 mask = (quint64(1) << (kLevelBits * level)) - 1;
+    if ((m_currentTick & mask) == 0) {
+      cascade(level, int((m_currentTick >> (kLevelBits * level)) &
+                         (kSlots - 1)));
+    }
+  }
+
+  QVector<TimerId> &bucket = m_wheel[0][m_currentTick & (kSlots - 1)];
+  if (bucket.isEmpty())
+    return;
+
+  QVector<TimerId> ids;
+  ids.swap(bucket);
+  m_levelCount[0] -= ids.size();
+
+  QVector<TimerId> due;
+  for (TimerId id : ids) {
+    auto it = m_entries.constFind(id);
+    if (it == m_entries.constEnd())
+      continue;
+    if (it->expiryTick > m_currentTick) {
+      place(id, it->expiryTick);
+      continue;
+    }
+    due.append(id);
+  }
+  if (!due.isEmpty()) {
+    fire(due);
+  }
+}
+
+void Scheduler::advanceTo(quint64 targetTick) {
+  m_running = true;
+  while (m_currentTick < targetTick) {
+    if (m_entries.isEmpty()) {
+      // 只剩已取消的残留 id
+      for (int level = 0; level < kLevels; ++level) {
+        if (m_levelCount[level] == 0)
+          continue;
+        for (auto &bucket : m_wheel[level])
+          bucket.clear();
+        m_levelCount[level] = 0;
+      }
+      m_currentTick = targetTick;
+      break;
+    }
+
+    // 低层全空时直接跳到最低非空层的下一个边界
+    int lowest = 0;
+    while (lowest < kLevels && m_levelCount[lowest] == 0)
+      ++lowest;
+    if (lowest > 0 && lowest < kLevels) {
+      quint64 span = quint64(1) << (kLevelBits * lowest);
+      quint64 skipTo = (m_currentTick / span + 1) * span - 1;
+      if (skipTo >= targetTick) {
+        m_currentTick = targetTick;
+        break;
+      }
+      m_currentTick = qMax(m_currentTick, skipTo);
+    }
+
+    stepTick();
+  }
+  m_running = false;
+}
+
+void Scheduler::fire(const QVector<TimerId> &due) {
+  QVector<TimerId> ordered = due;
+  std::sort(ordered.begin(), ordered.end(), [this](TimerId a, TimerId b) {
+    qint64 da = m_entries.constFind(a)->deadlineMs;
+    qint64 db = m_entries.constFind(b)->deadlineMs;
+    return da != db ? da < db : a < b;
+  });
+
+  for (TimerId id : ordered) {
+    auto it = m_entries.find(id);
+    if (it == m_entries.end())
+      continue; // 被同批次前面的回调取消
+    if (it->hasContext && !it->context) {
+      m_entries.erase(it);
+      continue;
+    }
+
+    if (m_clock->isVirtual()) {
+      auto *clock = static_cast<VirtualClock *>(m_clock);
+      clock->setNowMs(qMax(clock->nowMs(), it->deadlineMs));
+    }
+
+    // 回调可能增删定时器（QHash 会重排），先取出
+    std::function<void()> fn = it->fn;
+    if (it->intervalMs > 0) {
+      it->deadlineMs += it->intervalMs;
+      qint64 now = nowMs();
+      if (it->deadlineMs <= now) {
+        it->deadlineMs = now + it->intervalMs; // 落后太多时不补发
+      }
+      place(id, qMax(tickForDeadline(it->deadlineMs), m_currentTick + 1));
+    } else {
+      m_entries.erase(it);
+    }
+    fn();
+  }
+}
+
+void Scheduler::onDriverTimeout() {
+  m_armedTick = 0;
+  ++m_wakeups;
+  static Counter *wakeups = Metrics::instance()->counter(
+      "xsl_scheduler_wakeups_total", "Timer wheel driver wakeups");
+  wakeups->inc();
+
+  advanceTo(quint64(qMax<qint64>(0, nowMs())) / m_tickMs);
+  rearm();
+}
+
+void Scheduler::rearm() {
+  if (m_clock->isVirtual() || m_running)
+    return;
+
+  if (m_entries.isEmpty()) {
+    m_driver->stop();
+    m_armedTick = 0;
+    return;
+  }
+
+  quint64 wakeTick = nextWakeTick();
+  if (wakeTick == 0)
+    return;
+  if (wakeTick == m_armedTick && m_driver->isActive())
+    return;
+
+  m_armedTick = wakeTick;
+  qint64 delay = qint64(wakeTick) * m_tickMs - nowMs();
+  m_driver->start(int(qBound<qint64>(0, delay, INT_MAX)));
+}
+
+quint64 Scheduler::nextWakeTick() const {
+  // 每层从游标往后找第一个有活条目的槽位：同层槽位按时间排列，这个槽位
+  // 里最早的到期 tick 就是该层的最早到期。各层取最小。上层槽位的边界不是
+  // 到期时间，中间的下放在唤醒后的 advanceTo() 里补做
+  quint64 earliest = 0;
+  for (int level = 0; level < kLevels; ++level) {
+    if (m_levelCount[level] == 0)
+      continue;
+    quint64 cursor = m_currentTick >> (kLevelBits * level);
+    for (int k = 1; k <= kSlots; ++k) {
+      const QVector<TimerId> &bucket =
+          m_wheel[level][(cursor + k) & (kSlots - 1)];
+      quint64 slotEarliest = 0;
+      for (TimerId id : bucket) {
+        auto it = m_entries.constFind(id);
+        if (it == m_entries.constEnd())
+          continue; // 已取消
+        if (slotEarliest == 0 || it->expiryTick < slotEarliest)
+          slotEarliest = it->expiryTick;
+      }
+      if (slotEarliest == 0)
+        continue;
+      if (earliest == 0 || slotEarliest < earliest)
+        earliest = slotEarliest;
+      break;
+    }
+  }
+  return earliest ? qMax(earliest, m_currentTick + 1) : 0;
+}
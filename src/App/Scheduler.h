@@ -0,0 +1,122 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+#include <functional>
+
+// 时间源 - 实际运行用 SystemClock，模拟/基准用 VirtualClock
+class Clock {
+public:
+  virtual ~Clock() = default;
+  virtual qint64 nowMs() const = 0;
+  virtual bool isVirtual() const { return false; }
+};
+
+class SystemClock : public Clock {
+public:
+  SystemClock() { m_timer.start(); }
+  qint64 nowMs() const override { return m_timer.elapsed(); }
+
+private:
+  QElapsedTimer m_timer;
+};
+
+// Only moves when told to; Scheduler::runUntil() steps it from wakeup to
+// wakeup so a day of scheduling runs in milliseconds.
+class VirtualClock : public Clock {
+public:
+  qint64 nowMs() const override { return m_now; }
+  bool isVirtual() const override { return true; }
+  void setNowMs(qint64 ms) { m_now = ms; }
+  void advance(qint64 ms) { m_now += ms; }
+
+private:
+  qint64 m_now = 0;
+};
+
+// Hierarchical timer wheel (4 levels x 64 slots). All timers share one
+// driver QTimer that is armed for the earliest pending deadline only, so
+// timers landing in the same tick wake the thread once and idle gaps cost
+// no wakeups. Countdowns should be
+// derived from deadlineMs()/remainingMs() rather than ticking counters.
+class Scheduler : public QObject {
+  Q_OBJECT
+
+public:
+  using TimerId = quint64; // 0 = none
+
+  // App-wide scheduler on the system clock
+  static Scheduler *instance();
+
+  // clock is not owned and must outlive the scheduler
+  explicit Scheduler(Clock *clock, int tickMs = 10, QObject *parent = nullptr);
+
+  Clock *clock() const { return m_clock; }
+  qint64 nowMs() const { return m_clock->nowMs(); }
+
+  // The callback is dropped if context is destroyed first
+  TimerId singleShot(qint64 delayMs, QObject *context,
+                     std::function<void()> fn);
+  // Fires every intervalMs measured from the previous deadline (no drift)
+  TimerId repeating(qint64 intervalMs, QObject *context,
+                    std::function<void()> fn);
+
+  bool cancel(TimerId id);
+  bool isActive(TimerId id) const { return m_entries.contains(id); }
+  qint64 deadlineMs(TimerId id) const; // -1 when inactive
+  qint64 remainingMs(TimerId id) const; // 0 when inactive
+
+  int pendingCount() const { return m_entries.size(); }
+  // Driver wakeups; under a VirtualClock, the wakeups runUntil() simulated
+  quint64 wakeups() const { return m_wakeups; }
+
+  // Virtual clock only: fire everything due up to targetMs in deadline
+  // order, moving the clock to each deadline before its callback runs.
+  // Wakes exactly where the driver timer would, so wakeups() is comparable.
+  void runUntil(qint64 targetMs);
+
+private:
+  static constexpr int kLevelBits = 6;
+  static constexpr int kSlots = 1 << kLevelBits;
+  static constexpr int kLevels = 4;
+
+  struct Entry {
+    qint64 deadlineMs;
+    qint64 intervalMs; // 0 = single shot
+    quint64 expiryTick;
+    QPointer<QObject> context;
+    bool hasContext;
+    std::function<void()> fn;
+  };
+
+  TimerId add(qint64 delayMs, qint64 intervalMs, QObject *context,
+              std::function<void()> fn);
+  void place(TimerId id, quint64 expiryTick);
+  void cascade(int level, int slot);
+  void advanceTo(quint64 targetTick);
+  void stepTick();
+  void fire(const QVector<TimerId> &due);
+  void onDriverTimeout();
+  void rearm();
+  quint64 nextWakeTick() const;
+  quint64 tickForDeadline(qint64 deadlineMs) const;
+
+  Clock *m_clock;
+  qint64 m_tickMs;
+  quint64 m_currentTick;
+  TimerId m_nextId;
+  QHash<TimerId, Entry> m_entries;
+  QVector<TimerId> m_wheel[kLevels][kSlots];
+  int m_levelCount[kLevels];
+  QTimer *m_driver;
+  quint64 m_armedTick; // 0 = not armed
+  quint64 m_wakeups;
+  bool m_running; // inside advanceTo(); rearm once at the end
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,112 @@
+#include "ScriptRegistry.h"
+#include <QDebug>
+#include <QMutexLocker>
+#include <QRegularExpression>
+
+namespace {
+
+bool isIdentifier(const QString &name) {
+  static const QRegularExpression re("^[A-Za-z_][A-Za-z0-9_]*$");
+  return re.match(name).hasMatch();
+}
+
+} // namespace
+
+ScriptRegistry *ScriptRegistry::instance() {
+  static ScriptRegistry s_instance;
+  return &s_instance;
+}
+
+bool ScriptRegistry::registerModule(const QString &name,
+                                    const QString &source) {
+  if (!isIdentifier(name)) {
+    qWarning() << "[ScriptRegistry] Invalid module name:" << name;
+    return false;
+  }
+  // 模块必须是一个括起来的对象字面量
+  QString body = source.trimmed();
+  if (!body.startsWith("({") || !body.endsWith("})")) {
+    qWarning() << "[ScriptRegistry] Module" << name
+               << "must be an object literal wrapped in ( )";
+    return false;
+  }
+
+  // 每个模块单独注入：一个模块语法错误不会影响其它模块
+  QString wrapped =
+      QString("(function(){try{"
+              "const x=window.__xsl||(window.__xsl={m:{}});"
+              "x.m['%1']=%2;"
+              "}catch(e){console.log('[SCRIPT_ERROR]%1: '+e);}})();")
+          .arg(name, body);
+
+  {
+    QMutexLocker lock(&m_mutex);
+    for (const ScriptModule &m : m_modules) {
+      if (m.name == name)
+        return false;
+    }
+    m_modules.append({name, wrapped.toStdWString()});
+  }
+
+  emit moduleAdded(name);
+  return true;
+}
+
+bool ScriptRegistry::contains(const QString &name) const {
+  QMutexLocker lock(&m_mutex);
+  for (const ScriptModule &m : m_modules) {
+    if (m.name == name)
+      return true;
+  }
+  return false;
+}
+
+QList<ScriptModule> ScriptRegistry::modules() const {
+  QMutexLocker lock(&m_mutex);
+  return m_modules;
+}
+
+const std::wstring &ScriptRegistry::bootstrapScript() {
+  static const std::wstring script =
+      L"(function(){"
+      L"  const x = window.__xsl || (window.__xsl = {m: {}});"
+      L"  const post = function(o) {"
+      L"    try { window.chrome.webview.postMessage(JSON.stringify(o)); }"
+      L"    catch(e) {}"
+      L"  };"
+      L"  x.call = function(fn, args, id) {"
+      L"    const dot = fn.indexOf('.');"
+      L"    const mod = x.m[fn.substring(0, dot)];"
+      L"    const f = mod && mod[fn.substring(dot + 1)];"
+      L"    if (typeof f !== 'function') {"
+      L"      console.log('[SCRIPT_ERROR]missing ' + fn);"
+      L"      return '__xsl_missing';"
+      L"    }"
+      L"    let r;"
+      L"    try { r = f.apply(mod, args || []); }"
+      L"    catch(e) { return {__xsl_error: String(e)}; }"
+      // Promise 结果通过带 id 的消息返回；ExecuteScript 只拿到占位
+      L"    if (id && r && typeof r.then === 'function') {"
+      L"      r.then(function(v) {"
+      L"        post({type: 'xsl_result', id: id, ok: true,"
+      L"              value: v === undefined ? null : v});"
+      L"      }, function(e) {"
+      L"        post({type: 'xsl_result', id: id, ok: false, error: String(e)});"
+      L"      });"
+      L"      return {__xsl_async: id};"
+      L"    }"
+      L"    return r === undefined ? null : r;"
+      L"  };"
+      L"})();";
+  return script;
+}
+
+std::wstring ScriptRegistry::callExpression(const QString &fn,
+                                            const QString &argsJson,
+                                            quint64 id) {
+  // fn 由调用方写死 ("module.fn")，不做转义
+  return QString("(window.__xsl&&__xsl.call)?__xsl.call('%1',%2,%3)"
+                 ":'__xsl_missing'")
+      .arg(fn, argsJson, QString::number(id))
+      .toStdWString();
+}
@@ -0,0 +1,53 @@
+#ifndef SCRIPTREGISTRY_H
+#define SCRIPTREGISTRY_H
+
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <string>
+
+// 页面脚本模块注册表
+//
+// 每个模块是一个 JS 对象字面量源码，例如:
+//   ({ scroll(amount) { window.scrollBy(0, amount); } })
+// 注册时校验并预先拼好包装后的宽字符串，之后 WebView2Handler 在每个文档
+// 创建时注入一次 (AddScriptToExecuteOnDocumentCreated)。调用时只发送
+// __xsl.call("module.fn", [args]) 这样的短消息。
+struct ScriptModule {
+  QString name;
+  std::wstring wrapped; // 注入用的完整脚本（已转换）
+};
+
+class ScriptRegistry : public QObject {
+  Q_OBJECT
+
+public:
+  static ScriptRegistry *instance();
+
+  // Register a module once; returns false on invalid name/source or when a
+  // module with that name already exists.
+  bool registerModule(const QString &name, const QString &source);
+
+  bool contains(const QString &name) const;
+  QList<ScriptModule> modules() const;
+
+  // Dispatcher installed before any module
+  static const std::wstring &bootstrapScript();
+
+  // "__xsl.call(...)" expression for one invocation. A non-zero id asks the
+  // page to report a Promise result as {type: "xsl_result", id, ...}.
+  static std::wstring callExpression(const QString &fn, const QString &argsJson,
+                                     quint64 id = 0);
+
+signals:
+  void moduleAdded(const QString &name);
+
+private:
+  ScriptRegistry() = default;
+
+  mutable QMutex m_mutex;
+  QList<ScriptModule> m_modules;
+};
+
+#endif // SCRIPTREGISTRY_H
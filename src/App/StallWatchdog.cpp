@@ -0,0 +1,146 @@
+#include "StallWatchdog.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <QDebug>
+#include <QThread>
+#include <QTimer>
+
+namespace {
+
+const char *kUninstrumented = "(uninstrumented)";
+
+Counter *stallCounter(const QString &scope) {
+  return Metrics::instance()->counter(
+      "xsl_event_loop_stalls_total",
+      "GUI event loop stalls by the innermost active trace scope",
+      QString("scope=\"%1\"").arg(scope));
+}
+
+} // namespace
+
+StallWatchdog *StallWatchdog::instance() {
+  static StallWatchdog *watchdog = new StallWatchdog();
+  return watchdog;
+}
+
+StallWatchdog::StallWatchdog(QObject *parent)
+    : QObject(parent), m_heartbeat(new QTimer(this)), m_thread(nullptr),
+      m_thresholdMs(kDefaultThresholdMs), m_lastBeatNs(0),
+      m_publishedBeatNs(0), m_running(false) {
+  m_heartbeat->setInterval(kHeartbeatMs);
+  m_heartbeat->setTimerType(Qt::PreciseTimer);
+  connect(m_heartbeat, &QTimer::timeout, this, &StallWatchdog::beat);
+}
+
+StallWatchdog::~StallWatchdog() { stop(); }
+
+void StallWatchdog::start(int thresholdMs) {
+  if (m_thread)
+    return;
+  m_thresholdMs = qMax(thresholdMs, kHeartbeatMs + kPollMs);
+  m_lastBeatNs = Trace::nowNs();
+  m_publishedBeatNs.store(m_lastBeatNs);
+  m_running.store(true);
+  m_heartbeat->start();
+
+  m_thread = QThread::create([this]() { watch(); });
+  m_thread->setObjectName("xsl-stall-watchdog");
+  m_thread->start(QThread::HighPriority);
+  qDebug() << "[StallWatchdog] Started, threshold" << m_thresholdMs << "ms";
+}
+
+void StallWatchdog::stop() {
+  if (!m_thread)
+    return;
+  m_running.store(false);
+  m_thread->wait();
+  delete m_thread;
+  m_thread = nullptr;
+  m_heartbeat->stop();
+}
+
+QList<StallEvent> StallWatchdog::events() const {
+  QMutexLocker lock(&m_mutex);
+  return m_events;
+}
+
+void StallWatchdog::clearEvents() {
+  QMutexLocker lock(&m_mutex);
+  m_events.clear();
+}
+
+void StallWatchdog::beat() {
+  static Histogram *stalls = Metrics::instance()->histogram(
+      "xsl_event_loop_stall_seconds",
+      "Time the GUI event loop was blocked beyond the stall threshold");
+
+  qint64 now = Trace::nowNs();
+  qint64 lateNs = now - m_lastBeatNs - qint64(kHeartbeatMs) * 1000000;
+  qint64 startNs = m_lastBeatNs + qint64(kHeartbeatMs) * 1000000;
+  m_lastBeatNs = now;
+  m_publishedBeatNs.store(now, std::memory_order_release);
+
+  QMutexLocker lock(&m_mutex);
+  QHash<QString, Sample> samples;
+  samples.swap(m_samples);
+  if (lateNs < qint64(m_thresholdMs) * 1000000)
+    return;
+
+  StallEvent event;
+  event.durationMs = lateNs / 1000000;
+  event.at = QDateTime::currentDateTime().addMSecs(-(now - startNs) / 1000000);
+  event.scope = kUninstrumented;
+  event.scopeMs = 0;
+  event.samples = 0;
+  int bestHits = 0;
+  for (auto it = samples.cbegin(); it != samples.cend(); ++it) {
+    event.samples += it->hits;
+    if (it->hits > bestHits) {
+      bestHits = it->hits;
+      event.scope = it.key();
+      event.chain = it->chain;
+      event.scopeMs = it->runningNs / 1000000;
+    }
+  }
+
+  m_events.append(event);
+  while (m_events.size() > kLogCapacity)
+    m_events.removeFirst();
+  lock.unlock();
+
+  stalls->record(quint64(lateNs / 1000));
+  stallCounter(event.scope)->inc();
+  qWarning() << "[StallWatchdog] Event loop stalled" << event.durationMs
+             << "ms in" << event.scope;
+  emit stallDetected(event);
+}
+
+void StallWatchdog::watch() {
+  // 心跳迟到超过一个轮询周期就开始采样，短于阈值的迟到在下次心跳时丢弃
+  const qint64 lateNs = qint64(kHeartbeatMs + kPollMs) * 1000000;
+  while (m_running.load()) {
+    QThread::msleep(kPollMs);
+    qint64 now = Trace::nowNs();
+    if (now - m_publishedBeatNs.load(std::memory_order_acquire) < lateNs)
+      continue;
+
+    QVector<Trace::ActiveScope> scopes = Trace::guiScopes();
+    QString scope = kUninstrumented;
+    QString chain;
+    qint64 runningNs = 0;
+    if (!scopes.isEmpty()) {
+      QStringList names;
+      for (const Trace::ActiveScope &s : scopes)
+        names.append(QLatin1String(s.name));
+      scope = names.last();
+      chain = names.join(" > ");
+      runningNs = now - scopes.last().startNs;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    Sample &sample = m_samples[scope];
+    sample.hits++;
+    sample.chain = chain;
+    sample.runningNs = qMax(sample.runningNs, runningNs);
+  }
+}
@@ -0,0 +1,80 @@
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <atomic>
+
+class QThread;
+class QTimer;
+
+struct StallEvent {
+  QDateTime at;       // 卡顿开始（本地时间）
+  qint64 durationMs;  // 事件循环未响应的时长
+  QString scope;      // 归因：卡顿期间采样次数最多的最内层作用域
+  QString chain;      // 该作用域所在的调用链，外 → 内
+  qint64 scopeMs;     // 该作用域在最后一次采样时已运行的时长
+  int samples;        // 卡顿期间的采样次数
+};
+
+// 事件循环卡顿检测
+//
+// GUI 线程每 kHeartbeatMs 跳一次心跳，心跳间隔超出阈值即为一次卡顿，
+// 时长由 GUI 线程自己精确测量。看门狗线程每 kPollMs 检查一次心跳，
+// 心跳迟到时读取 GUI 线程当前打开的 XSL_TRACE_SCOPE（Trace::guiScopes），
+// 按最内层作用域计数，卡顿结束时取采样最多的作为归因。
+// 结果进入直方图 xsl_event_loop_stall_seconds、按作用域的计数器和最近
+// kLogCapacity 条卡顿日志。关闭追踪编译时只有时长，没有归因。
+class StallWatchdog : public QObject {
+  Q_OBJECT
+
+public:
+  static const int kHeartbeatMs = 50;
+  static const int kPollMs = 20;
+  static const int kLogCapacity = 200;
+  static const int kDefaultThresholdMs = 250;
+
+  static StallWatchdog *instance();
+
+  // 在 GUI 线程调用
+  void start(int thresholdMs = kDefaultThresholdMs);
+  void stop();
+  bool isRunning() const { return m_thread != nullptr; }
+  int thresholdMs() const { return m_thresholdMs; }
+
+  QList<StallEvent> events() const; // 旧的在前
+  void clearEvents();
+
+signals:
+  void stallDetected(const StallEvent &event);
+
+private:
+  struct Sample {
+    int hits = 0;
+    QString chain;
+    qint64 runningNs = 0;
+  };
+
+  explicit StallWatchdog(QObject *parent = nullptr);
+  ~StallWatchdog() override;
+
+  void beat();  // GUI 线程
+  void watch(); // 看门狗线程
+
+  QTimer *m_heartbeat;
+  QThread *m_thread;
+  int m_thresholdMs;
+  qint64 m_lastBeatNs; // GUI 线程自用
+  std::atomic<qint64> m_publishedBeatNs;
+  std::atomic<bool> m_running;
+
+  mutable QMutex m_mutex; // 保护下面两项
+  QHash<QString, Sample> m_samples; // 当前这次迟到期间的采样
+  QList<StallEvent> m_events;
+};
+
+#endif // STALLWATCHDOG_H
@@ -0,0 +1,38 @@
+#include "StartupProfiler.h"
+#include "Metrics.h"
+
+QElapsedTimer StartupProfiler::s_timer;
+QList<QPair<QString, qint64>> StartupProfiler::s_phases;
+
+void StartupProfiler::start() {
+  s_timer.start();
+  s_phases.clear();
+}
+
+void StartupProfiler::mark(const QString &phase) {
+  if (!s_timer.isValid())
+    s_timer.start();
+  qint64 now = s_timer.elapsed();
+  s_phases.append({phase, now});
+  Metrics::instance()
+      ->gauge("xsl_startup_phase_ms", "Milliseconds from launch to phase end",
+              QString("phase=\"%1\"").arg(phase))
+      ->set(now);
+}
+
+qint64 StartupProfiler::elapsedMs() {
+  return s_timer.isValid() ? s_timer.elapsed() : 0;
+}
+
+QString StartupProfiler::report() {
+  QString out;
+  qint64 prev = 0;
+  for (const auto &p : s_phases) {
+    out += QString("%1 +%2ms  (%3ms)\n")
+               .arg(p.first, -24)
+               .arg(p.second - prev, 5)
+               .arg(p.second, 6);
+    prev = p.second;
+  }
+  return out;
+}
@@ -0,0 +1,27 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
+#include <QString>
+
+// 启动阶段计时 - main() 开始计时，各阶段 mark()，结束时 report()
+class StartupProfiler {
+public:
+  static void start();
+  static void mark(const QString &phase);
+
+  // Elapsed milliseconds since start()
+  static qint64 elapsedMs();
+
+  // "phase  +delta  total" lines, one per mark
+  static QString report();
+  static QList<QPair<QString, qint64>> phases() { return s_phases; }
+
+private:
+  static QElapsedTimer s_timer;
+  static QList<QPair<QString, qint64>> s_phases; // phase -> ms since start
+};
+
+#endif // STARTUPPROFILER_H
@@ -0,0 +1,221 @@
+#include "Trace.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr quint64 kEventsPerThread = 16384;
+
+struct Event {
+  const char *name;
+  qint64 startNs;
+  qint64 durationNs;
+};
+
+struct ThreadBuffer {
+  int tid = 0;
+  QString threadName;
+  std::atomic<quint64> written{0};
+  std::array<Event, kEventsPerThread> events;
+};
+
+struct Registry {
+  QMutex mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  int nextTid = 1;
+};
+
+Registry &registry() {
+  static Registry r;
+  return r;
+}
+
+std::atomic<bool> g_enabled{true};
+
+// Open spans of one thread. Only the owner writes; readers take depth with
+// acquire and tolerate entries that change underneath them.
+struct ScopeStack {
+  static constexpr int kDepth = 64;
+  std::atomic<int> depth{0};
+  std::array<std::atomic<const char *>, kDepth> names{};
+  std::array<std::atomic<qint64>, kDepth> starts{};
+};
+
+std::atomic<ScopeStack *> g_guiStack{nullptr};
+
+ScopeStack &localStack() {
+  thread_local ScopeStack stack;
+  thread_local bool registered = false;
+  if (!registered) {
+    // Spans before QApplication exists stay unregistered until it does
+    QCoreApplication *app = QCoreApplication::instance();
+    if (app) {
+      registered = true;
+      if (QThread::currentThread() == app->thread())
+        g_guiStack.store(&stack, std::memory_order_release);
+    }
+  }
+  return stack;
+}
+
+ThreadBuffer *localBuffer() {
+  // Registry keeps a reference so events survive thread exit until export
+  thread_local std::shared_ptr<ThreadBuffer> buffer;
+  if (!buffer) {
+    buffer = std::make_shared<ThreadBuffer>();
+    QThread *thread = QThread::currentThread();
+    bool isMain = QCoreApplication::instance() &&
+                  thread == QCoreApplication::instance()->thread();
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    buffer->tid = r.nextTid++;
+    buffer->threadName = isMain ? QString("GUI")
+                         : thread->objectName().isEmpty()
+                             ? QString("Thread %1").arg(buffer->tid)
+                             : thread->objectName();
+    r.buffers.push_back(buffer);
+  }
+  return buffer.get();
+}
+
+// 先整体转成 UTF-8 再按字节转义：代理对不会被拆开，多字节序列原样保留
+QByteArray jsonEscape(const QString &s) {
+  static const char hex[] = "0123456789abcdef";
+  QByteArray utf8 = s.toUtf8();
+  QByteArray out;
+  out.reserve(utf8.size());
+  for (char c : utf8) {
+    uchar u = uchar(c);
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (u < 0x20) {
+      out += "\\u00";
+      out += hex[u >> 4];
+      out += hex[u & 0xf];
+    } else {
+      out += c;
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+namespace Trace {
+
+qint64 nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void record(const char *name, qint64 startNs, qint64 durationNs) {
+  if (!g_enabled.load(std::memory_order_relaxed))
+    return;
+  ThreadBuffer *buffer = localBuffer();
+  quint64 n = buffer->written.load(std::memory_order_relaxed);
+  buffer->events[n % kEventsPerThread] = {name, startNs, durationNs};
+  buffer->written.store(n + 1, std::memory_order_release);
+}
+
+void enter(const char *name, qint64 startNs) {
+  ScopeStack &s = localStack();
+  int d = s.depth.load(std::memory_order_relaxed);
+  if (d < ScopeStack::kDepth) {
+    s.names[d].store(name, std::memory_order_relaxed);
+    s.starts[d].store(startNs, std::memory_order_relaxed);
+  }
+  s.depth.store(d + 1, std::memory_order_release);
+}
+
+void leave() {
+  ScopeStack &s = localStack();
+  int d = s.depth.load(std::memory_order_relaxed);
+  if (d > 0)
+    s.depth.store(d - 1, std::memory_order_release);
+}
+
+QVector<ActiveScope> guiScopes() {
+  QVector<ActiveScope> scopes;
+  ScopeStack *s = g_guiStack.load(std::memory_order_acquire);
+  if (!s)
+    return scopes;
+  int d = qMin(s->depth.load(std::memory_order_acquire), ScopeStack::kDepth);
+  scopes.reserve(d);
+  for (int i = 0; i < d; i++) {
+    const char *name = s->names[i].load(std::memory_order_relaxed);
+    if (name)
+      scopes.append({name, s->starts[i].load(std::memory_order_relaxed)});
+  }
+  return scopes;
+}
+
+void setEnabled(bool enabled) { g_enabled.store(enabled); }
+
+bool isEnabled() { return g_enabled.load(); }
+
+bool exportChromeJson(const QString &path) {
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return false;
+
+  // Events are read without stopping writers; a span being written during
+  // export may be dropped or torn, which is acceptable for a profiling dump.
+  Registry &r = registry();
+  QMutexLocker locker(&r.mutex);
+
+  QByteArray out = "{\"traceEvents\":[\n";
+  bool first = true;
+  auto separator = [&]() {
+    if (!first)
+      out += ",\n";
+    first = false;
+  };
+
+  for (const auto &buffer : r.buffers) {
+    separator();
+    out += QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                   "\"tid\":%1,\"args\":{\"name\":\"")
+               .arg(buffer->tid)
+               .toUtf8();
+    out += jsonEscape(buffer->threadName);
+    out += "\"}}";
+
+    quint64 written = buffer->written.load(std::memory_order_acquire);
+    quint64 begin =
+        written > kEventsPerThread ? written - kEventsPerThread : 0;
+    for (quint64 i = begin; i < written; i++) {
+      const Event &e = buffer->events[i % kEventsPerThread];
+      if (!e.name)
+        continue;
+      separator();
+      out += "{\"name\":\"";
+      out += jsonEscape(QString::fromLatin1(e.name));
+      out += QString("\",\"cat\":\"xsl\",\"ph\":\"X\",\"pid\":1,\"tid\":%1,"
+                     "\"ts\":%2,\"dur\":%3}")
+                 .arg(buffer->tid)
+                 .arg(e.startNs / 1000.0, 0, 'f', 3)
+                 .arg(e.durationNs / 1000.0, 0, 'f', 3)
+                 .toUtf8();
+      if (out.size() > (1 << 20)) {
+        file.write(out);
+        out.clear();
+      }
+    }
+  }
+
+  out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+  file.write(out);
+  return file.error() == QFile::NoError;
+}
+
+} // namespace Trace
@@ -0,0 +1,75 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// Lightweight scope tracing. Each thread writes complete events into its own
+// ring buffer (no locks on the hot path); exportChromeJson() snapshots all
+// buffers into Chrome trace_event JSON (chrome://tracing, Perfetto).
+//
+// Build with -DXSL_ENABLE_TRACING=OFF to compile every XSL_TRACE_SCOPE out.
+//
+// Open spans are also kept on a small per-thread stack so another thread
+// (StallWatchdog) can see what the GUI thread is doing right now.
+
+namespace Trace {
+
+qint64 nowNs();
+
+// Record a finished span; `name` must be a string literal
+void record(const char *name, qint64 startNs, qint64 durationNs);
+
+void setEnabled(bool enabled);
+bool isEnabled();
+
+// Write everything currently buffered; returns false on I/O error
+bool exportChromeJson(const QString &path);
+
+// Span bookkeeping for the open-scope stack
+void enter(const char *name, qint64 startNs);
+void leave();
+
+struct ActiveScope {
+  const char *name;
+  qint64 startNs;
+};
+
+// Spans currently open on the GUI thread, outermost first. Callable from any
+// thread; the GUI thread keeps running, so the answer may already be stale.
+QVector<ActiveScope> guiScopes();
+
+class Span {
+public:
+  explicit Span(const char *name) : m_name(name), m_start(nowNs()) {
+    enter(m_name, m_start);
+  }
+  ~Span() {
+    leave();
+    record(m_name, m_start, nowNs() - m_start);
+  }
+
+  Span(const Span &) = delete;
+  Span &operator=(const Span &) = delete;
+
+private:
+  const char *m_name;
+  qint64 m_start;
+};
+
+} // namespace Trace
+
+#define XSL_TRACE_CONCAT_INNER(a, b) a##b
+#define XSL_TRACE_CONCAT(a, b) XSL_TRACE_CONCAT_INNER(a, b)
+
+#if defined(XSL_TRACING) && XSL_TRACING
+#define XSL_TRACE_SCOPE(name)                                                  \
+  Trace::Span XSL_TRACE_CONCAT(xslTraceSpan_, __LINE__)(name)
+#else
+#define XSL_TRACE_SCOPE(name)                                                  \
+  do {                                                                         \
+  } while (0)
+#endif
+
+#endif // TRACE_H
@@ -1,8 +1,55 @@
 #include "WebView2Handler.h"
+#include "Metrics.h"
+#include "ScriptRegistry.h"
+#include "Trace.h"
 #include <QDateTime>
 #include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+
+namespace {
+
+struct MessageCounters {
+  Counter *json;
+  Counter *like;
+  Counter *reply;
+  Counter *progress;
+  Counter *selfHandle;
+  Counter *jsResult;
+  Counter *other;
+};
+
+const MessageCounters &messageCounters() {
+  auto make = [](const char *type) {
+    return Metrics::instance()->counter(
+        "xsl_web_messages_total", "Messages received from page scripts",
+        QString("type=\"%1\"").arg(type));
+  };
+  static const MessageCounters counters = {
+      make("json"),        make("like"),      make("reply"), make("progress"),
+      make("self_handle"), make("js_result"), make("other")};
+  return counters;
+}
+
+Histogram *callLatency() {
+  static Histogram *histogram = Metrics::instance()->histogram(
+      "xsl_js_call_seconds", "Round trip of WebView2Handler::call");
+  return histogram;
+}
+
+Counter *callFailures(const char *reason) {
+  return Metrics::instance()->counter(
+      "xsl_js_call_failures_total", "JS calls canceled before a result",
+      QString("reason=\"%1\"").arg(reason));
+}
 
-WebView2Handler::WebView2Handler(QObject *parent) : QObject(parent) {}
+} // namespace
+
+WebView2Handler::WebView2Handler(QObject *parent) : QObject(parent) {
+  connect(ScriptRegistry::instance(), &ScriptRegistry::moduleAdded, this,
+          &WebView2Handler::onScriptModuleAdded);
+}
 
 WebView2Handler::~WebView2Handler() { detach(); }
 
@@ -19,6 +66,7 @@ void WebView2Handler::attach(ICoreWebView2Controller *controller,
   m_webview = webview;
 
   setupEventHandlers();
+  installScriptModules();
 
   qDebug() << "[WebView2Handler] Attached to webview";
 }
@@ -29,6 +77,8 @@ void WebView2Handler::detach() {
   }
   m_controller.Reset();
   m_webview.Reset();
+  m_installedModules.clear();
+  cancelPendingCalls("detached");
 }
 
 void WebView2Handler::setupEventHandlers() {
@@ -40,6 +90,8 @@ void WebView2Handler::setupEventHandlers() {
       Microsoft::WRL::Callback<ICoreWebView2NavigationStartingEventHandler>(
           [this](ICoreWebView2 *sender,
                  ICoreWebView2NavigationStartingEventArgs *args) -> HRESULT {
+            // 旧文档的未完成调用不会再有结果
+            cancelPendingCalls("navigation");
             emit loadStarted();
             return S_OK;
           })
@@ -226,33 +278,232 @@ void WebView2Handler::executeJavaScript(const QString &code) {
           .Get());
 }
 
+void WebView2Handler::installScriptModules() {
+  if (!m_webview)
+    return;
+
+  // 注册后对之后创建的每个文档自动生效，无需每次加载重新注入
+  m_webview->AddScriptToExecuteOnDocumentCreated(
+      ScriptRegistry::bootstrapScript().c_str(), nullptr);
+  for (const ScriptModule &module : ScriptRegistry::instance()->modules()) {
+    m_webview->AddScriptToExecuteOnDocumentCreated(module.wrapped.c_str(),
+                                                   nullptr);
+    m_installedModules.insert(module.name);
+  }
+}
+
+void WebView2Handler::onScriptModuleAdded(const QString &name) {
+  if (!m_webview || m_installedModules.contains(name))
+    return;
+
+  for (const ScriptModule &module : ScriptRegistry::instance()->modules()) {
+    if (module.name != name)
+      continue;
+    // 以后的文档 + 当前文档
+    m_webview->AddScriptToExecuteOnDocumentCreated(module.wrapped.c_str(),
+                                                   nullptr);
+    m_webview->ExecuteScript(module.wrapped.c_str(), nullptr);
+    m_installedModules.insert(name);
+    return;
+  }
+}
+
+void WebView2Handler::injectScriptModulesNow() {
+  if (!m_webview)
+    return;
+  m_webview->ExecuteScript(ScriptRegistry::bootstrapScript().c_str(), nullptr);
+  for (const ScriptModule &module : ScriptRegistry::instance()->modules()) {
+    m_webview->ExecuteScript(module.wrapped.c_str(), nullptr);
+  }
+}
+
+void WebView2Handler::invoke(const QString &fn, const QJsonArray &args) {
+  invokeInternal(
+      fn, QString::fromUtf8(QJsonDocument(args).toJson(QJsonDocument::Compact)),
+      0, true);
+}
+
+QFuture<QJsonValue> WebView2Handler::call(const QString &fn,
+                                          const QJsonArray &args,
+                                          int timeoutMs) {
+  auto promise = std::make_shared<QPromise<QJsonValue>>();
+  promise->start();
+  QFuture<QJsonValue> future = promise->future();
+
+  if (!m_webview) {
+    callFailures("no_webview")->inc();
+    future.cancel();
+    promise->finish();
+    return future;
+  }
+
+  quint64 id = m_nextCallId++;
+  PendingCall pending{fn, promise, QElapsedTimer()};
+  pending.elapsed.start();
+  m_pendingCalls.insert(id, pending);
+
+  QTimer::singleShot(timeoutMs, this, [this, id]() {
+    if (m_pendingCalls.contains(id)) {
+      callFailures("timeout")->inc();
+      failCall(id, "timeout");
+    }
+  });
+
+  invokeInternal(
+      fn, QString::fromUtf8(QJsonDocument(args).toJson(QJsonDocument::Compact)),
+      id, true);
+  return future;
+}
+
+void WebView2Handler::cancelPendingCalls(const char *reason) {
+  const QList<quint64> ids = m_pendingCalls.keys();
+  for (quint64 id : ids) {
+    callFailures(reason)->inc();
+    failCall(id, "canceled");
+  }
+}
+
+void WebView2Handler::resolveCall(quint64 id, const QJsonValue &value) {
+  auto it = m_pendingCalls.find(id);
+  if (it == m_pendingCalls.end())
+    return; // 已超时或已取消
+  PendingCall pending = it.value();
+  m_pendingCalls.erase(it);
+
+  callLatency()->record(quint64(pending.elapsed.nsecsElapsed() / 1000));
+  if (!pending.promise->isCanceled()) {
+    pending.promise->addResult(value);
+  }
+  pending.promise->finish();
+}
+
+void WebView2Handler::failCall(quint64 id, const QString &reason) {
+  auto it = m_pendingCalls.find(id);
+  if (it == m_pendingCalls.end())
+    return;
+  PendingCall pending = it.value();
+  m_pendingCalls.erase(it);
+
+  qDebug() << "[WebView2Handler] Call" << pending.fn << "failed:" << reason;
+  pending.promise->future().cancel();
+  pending.promise->finish();
+}
+
+void WebView2Handler::invokeInternal(const QString &fn,
+                                     const QString &argsJson, quint64 id,
+                                     bool allowRetry) {
+  if (!m_webview) {
+    qWarning() << "[WebView2Handler] Cannot invoke" << fn
+               << ": webview is null";
+    if (id != 0)
+      callFailures("no_webview")->inc();
+    failCall(id, "webview is null");
+    return;
+  }
+
+  m_webview->ExecuteScript(
+      ScriptRegistry::callExpression(fn, argsJson, id).c_str(),
+      Microsoft::WRL::Callback<ICoreWebView2ExecuteScriptCompletedHandler>(
+          [this, fn, argsJson, id, allowRetry](HRESULT error,
+                                               LPCWSTR result) -> HRESULT {
+            QString text = result ? QString::fromWCharArray(result) : QString();
+
+            // 文档早于模块注册创建（或模块被页面覆盖）：补注入后重试一次
+            if (SUCCEEDED(error) && text == "\"__xsl_missing\"") {
+              if (allowRetry) {
+                injectScriptModulesNow();
+                invokeInternal(fn, argsJson, id, false);
+              } else {
+                qWarning() << "[WebView2Handler] Script function missing:"
+                           << fn;
+                if (id != 0)
+                  callFailures("missing")->inc();
+                failCall(id, "missing");
+              }
+              return S_OK;
+            }
+
+            if (id == 0)
+              return S_OK;
+            if (FAILED(error)) {
+              callFailures("error")->inc();
+              failCall(id, QString("ExecuteScript HRESULT 0x%1")
+                               .arg(quint32(error), 8, 16, QChar('0')));
+              return S_OK;
+            }
+
+            // 结果是任意 JSON 值；包一层数组以便 QJsonDocument 解析
+            QJsonValue value =
+                QJsonDocument::fromJson(("[" + text + "]").toUtf8())
+                    .array()
+                    .at(0);
+            QJsonObject obj = value.toObject();
+            if (obj.contains("__xsl_async"))
+              return S_OK; // 等待带 id 的 xsl_result 消息
+            if (obj.contains("__xsl_error")) {
+              callFailures("error")->inc();
+              failCall(id, obj.value("__xsl_error").toString());
+              return S_OK;
+            }
+            resolveCall(id, value);
+            return S_OK;
+          })
+          .Get());
+}
+
+bool WebView2Handler::processCallResult(const QString &msg) {
+  // JSON.stringify 保持键顺序，type 总在最前
+  if (!msg.startsWith("{\"type\":\"xsl_result\""))
+    return false;
+
+  QJsonObject obj = QJsonDocument::fromJson(msg.toUtf8()).object();
+  quint64 id = quint64(obj.value("id").toInteger());
+  if (obj.value("ok").toBool()) {
+    resolveCall(id, obj.value("value"));
+  } else {
+    callFailures("error")->inc();
+    failCall(id, obj.value("error").toString());
+  }
+  return true;
+}
+
 void WebView2Handler::processConsoleMessage(const QString &msg) {
+  XSL_TRACE_SCOPE("WebView2Handler::processConsoleMessage");
+  const MessageCounters &counters = messageCounters();
+
   // Forward JSON messages (from window.chrome.webview.postMessage)
   if (msg.startsWith("{")) {
+    counters.json->inc();
+    if (processCallResult(msg))
+      return;
     emit webMessageReceived(msg);
     return;
   }
 
   // XSocialLedger message protocol
   if (msg.startsWith("[LIKE_FOUND]")) {
+    counters.like->inc();
     QString jsonData = msg.mid(12);
     emit likeFound(jsonData);
     return;
   }
 
   if (msg.startsWith("[REPLY_FOUND]")) {
+    counters.reply->inc();
     QString jsonData = msg.mid(13);
     emit replyFound(jsonData);
     return;
   }
 
   if (msg.startsWith("[COLLECT_PROGRESS]")) {
+    counters.progress->inc();
     QString jsonData = msg.mid(18);
     emit collectProgress(jsonData);
     return;
   }
 
   if (msg.startsWith("[SELF_HANDLE]")) {
+    counters.selfHandle->inc();
     QString handle = msg.mid(13).trimmed();
     if (!handle.isEmpty()) {
       qDebug() << "[WebView2Handler] Self handle detected:" << handle;
@@ -262,12 +513,21 @@ void WebView2Handler::processConsoleMessage(const QString &msg) {
   }
 
   // Check for JS result
+  if (msg.startsWith("[SCRIPT_ERROR]")) {
+    counters.other->inc();
+    qWarning() << "[WebView2Handler]" << msg;
+    return;
+  }
+
   if (msg.startsWith("[JSRESULT]")) {
+    counters.jsResult->inc();
     QString result = msg.mid(10).trimmed();
     emit jsResultReceived(result);
     return;
   }
 
+  counters.other->inc();
+
   // Debug logging
   if (msg.startsWith("[DEBUG]") || msg.startsWith("[COLLECTOR]")) {
     qDebug() << msg;
@@ -1,11 +1,19 @@
 #ifndef WEBVIEW2HANDLER_H
 #define WEBVIEW2HANDLER_H
 
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonValue>
 #include <QObject>
+#include <QPromise>
+#include <QSet>
 #include <QString>
 #include <WebView2.h>
 #include <objbase.h>
 #include <windows.h>
+#include <memory>
 #include <wrl.h>
 
 // WebView2 event handler - converts WebView2 events to Qt signals
@@ -29,6 +37,22 @@ public:
   // Execute JavaScript
   void executeJavaScript(const QString &code);
 
+  // Call a function of a registered script module ("module.fn"); only the
+  // name and JSON-encoded args cross the bridge
+  void invoke(const QString &fn, const QJsonArray &args = QJsonArray());
+
+  // Same as invoke(), but returns the function's result. Promise results
+  // arrive later as a tagged web message matched by correlation id. The
+  // future is canceled on timeout, script error or navigation; callers may
+  // cancel it too.
+  QFuture<QJsonValue> call(const QString &fn,
+                           const QJsonArray &args = QJsonArray(),
+                           int timeoutMs = 10000);
+
+  // Cancel every outstanding call() (the document that would answer is gone);
+  // reason labels xsl_js_call_failures_total, e.g. "navigation", "detached"
+  void cancelPendingCalls(const char *reason);
+
   // Check if webview is valid
   bool isValid() const { return m_webview != nullptr; }
 
@@ -49,7 +73,17 @@ signals:
   void selfHandleDetected(const QString &handle);
   void webMessageReceived(const QString &message);
 
+private slots:
+  void onScriptModuleAdded(const QString &name);
+
 private:
+  void installScriptModules();
+  void injectScriptModulesNow();
+  void invokeInternal(const QString &fn, const QString &argsJson, quint64 id,
+                      bool allowRetry);
+  void resolveCall(quint64 id, const QJsonValue &value);
+  void failCall(quint64 id, const QString &reason);
+  bool processCallResult(const QString &msg);
   void setupEventHandlers();
   void removeEventHandlers();
   void processConsoleMessage(const QString &message);
@@ -65,6 +99,17 @@ private:
   EventRegistrationToken m_newWindowRequestedToken = {};
   EventRegistrationToken m_webMessageReceivedToken = {};
   EventRegistrationToken m_acceleratorKeyPressedToken = {};
+
+  // 已为当前 webview 注册的脚本模块
+  QSet<QString> m_installedModules;
+
+  struct PendingCall {
+    QString fn;
+    std::shared_ptr<QPromise<QJsonValue>> promise;
+    QElapsedTimer elapsed;
+  };
+  QHash<quint64, PendingCall> m_pendingCalls;
+  quint64 m_nextCallId = 1;
 };
 
 #endif // WEBVIEW2HANDLER_H
@@ -0,0 +1,77 @@
+#include "IngestFilter.h"
+#include "App/Metrics.h"
+
+quint64 RawRecord::hashHandle(QStringView handle) {
+  quint64 h = 14695981039346656037ULL;
+  for (QChar c : handle) {
+    ushort u = c.unicode();
+    if (u >= 'A' && u <= 'Z')
+      u += 'a' - 'A';
+    h ^= u;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+// ==================== HandleSetFilter ====================
+
+bool HandleSetFilter::accept(const RawRecord &record) const {
+  auto it = m_handles.constFind(record.handleHash);
+  return it == m_handles.constEnd() ||
+         it->compare(record.handle, Qt::CaseInsensitive) != 0;
+}
+
+bool HandleSetFilter::insert(const QString &handle) {
+  QString key = handle.trimmed();
+  if (key.startsWith('@'))
+    key.remove(0, 1);
+  if (key.isEmpty() || contains(key))
+    return false;
+  m_handles.insert(RawRecord::hashHandle(key), key.toLower());
+  return true;
+}
+
+bool HandleSetFilter::contains(const QString &handle) const {
+  return !accept(RawRecord::make(QLatin1String(), handle));
+}
+
+void HandleSetFilter::setHandles(const QStringList &handles) {
+  m_handles.clear();
+  for (const QString &handle : handles) {
+    insert(handle);
+  }
+}
+
+// ==================== TypeFilter ====================
+
+bool TypeFilter::accept(const RawRecord &record) const {
+  if (record.type == QLatin1String("like"))
+    return m_likes;
+  if (record.type == QLatin1String("reply"))
+    return m_replies;
+  return true;
+}
+
+void TypeFilter::setAllowed(bool likes, bool replies) {
+  m_likes = likes;
+  m_replies = replies;
+}
+
+// ==================== IngestFilterChain ====================
+
+bool IngestFilterChain::accept(const RawRecord &record) const {
+  for (const Stage &stage : m_stages) {
+    if (!stage.filter->accept(record)) {
+      stage.dropped->inc();
+      return false;
+    }
+  }
+  return true;
+}
+
+Counter *IngestFilterChain::droppedCounter(const char *name) {
+  return Metrics::instance()->counter(
+      "xsl_ingest_dropped_total",
+      "Collected records dropped by the ingest filter chain",
+      QString("filter=\"%1\"").arg(QLatin1String(name)));
+}
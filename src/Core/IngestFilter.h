@@ -0,0 +1,91 @@
+#ifndef INGESTFILTER_H
+#define INGESTFILTER_H
+
+#include <QHash>
+#include <QLatin1String>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <memory>
+#include <vector>
+
+class Counter;
+
+// 采集入口的原始字段：JSON 解析之后、构造 SocialAction 之前。
+// handle 指向解析结果（见 IngestParser），过滤期间不复制
+struct RawRecord {
+  QLatin1String type; // "like" / "reply"
+  QStringView handle;
+  quint64 handleHash; // 整条过滤链共用，只计算一次
+
+  static RawRecord make(QLatin1String type, QStringView handle) {
+    return RawRecord{type, handle, hashHandle(handle)};
+  }
+  // FNV-1a 64，ASCII 不区分大小写（handle 只含 [A-Za-z0-9_]），不分配内存
+  static quint64 hashHandle(QStringView handle);
+};
+
+// 过滤器：返回 false 表示丢弃
+class IngestFilter {
+public:
+  virtual ~IngestFilter() = default;
+  virtual const char *name() const = 0;
+  virtual bool accept(const RawRecord &record) const = 0;
+};
+
+// 按 handle 丢弃：预先计算哈希，命中后再比较字符串排除碰撞
+class HandleSetFilter : public IngestFilter {
+public:
+  explicit HandleSetFilter(const char *name) : m_name(name) {}
+
+  const char *name() const override { return m_name; }
+  bool accept(const RawRecord &record) const override;
+
+  // 返回 false 表示已存在（重复插入是空操作）
+  bool insert(const QString &handle);
+  bool contains(const QString &handle) const;
+  void setHandles(const QStringList &handles);
+  int size() const { return m_handles.size(); }
+
+private:
+  const char *m_name;
+  QHash<quint64, QString> m_handles; // 哈希 -> 小写 handle
+};
+
+// 按记录类型丢弃
+class TypeFilter : public IngestFilter {
+public:
+  const char *name() const override { return "type"; }
+  bool accept(const RawRecord &record) const override;
+
+  void setAllowed(bool likes, bool replies);
+
+private:
+  bool m_likes = true;
+  bool m_replies = true;
+};
+
+// 可组合的过滤链：按添加顺序求值，第一个拒绝者生效，
+// 丢弃数按过滤器计入 xsl_ingest_dropped_total{filter="..."}
+class IngestFilterChain {
+public:
+  // 取得所有权，返回原指针便于调用方继续配置
+  template <typename T> T *append(std::unique_ptr<T> filter) {
+    T *raw = filter.get();
+    m_stages.push_back({std::move(filter), droppedCounter(raw->name())});
+    return raw;
+  }
+
+  bool accept(const RawRecord &record) const;
+
+private:
+  struct Stage {
+    std::unique_ptr<IngestFilter> filter;
+    Counter *dropped;
+  };
+  static Counter *droppedCounter(const char *name);
+
+  std::vector<Stage> m_stages;
+};
+
+#endif // INGESTFILTER_H
@@ -0,0 +1,238 @@
+#include "IngestParser.h"
+
+namespace {
+
+char16_t at(QStringView json, qsizetype pos) {
+  return json[pos].unicode();
+}
+
+bool isSpace(char16_t c) {
+  return c == u' ' || c == u'\t' || c == u'\n' || c == u'\r';
+}
+
+void skipSpace(QStringView json, qsizetype &pos) {
+  while (pos < json.size() && isSpace(at(json, pos)))
+    pos++;
+}
+
+int hexValue(char16_t c) {
+  if (c >= u'0' && c <= u'9')
+    return c - u'0';
+  if (c >= u'a' && c <= u'f')
+    return c - u'a' + 10;
+  if (c >= u'A' && c <= u'F')
+    return c - u'A' + 10;
+  return -1;
+}
+
+// pos 指向开头的引号；成功时移到结尾引号之后。
+// firstEscape 返回第一个反斜杠的位置，没有转义为 -1
+bool scanString(QStringView json, qsizetype &pos, qsizetype *firstEscape) {
+  *firstEscape = -1;
+  pos++;
+  while (pos < json.size()) {
+    char16_t c = at(json, pos);
+    if (c == u'"') {
+      pos++;
+      return true;
+    }
+    if (c == u'\\') {
+      if (*firstEscape < 0)
+        *firstEscape = pos;
+      pos += 2;
+      continue;
+    }
+    if (c < 0x20)
+      return false;
+    pos++;
+  }
+  return false;
+}
+
+// 非字符串值：标量到分隔符为止，对象/数组按括号深度跳过
+bool skipValue(QStringView json, qsizetype &pos, QStringView *raw) {
+  qsizetype start = pos;
+  char16_t c = at(json, pos);
+  if (c == u'{' || c == u'[') {
+    int depth = 0;
+    while (pos < json.size()) {
+      c = at(json, pos);
+      if (c == u'"') {
+        qsizetype escape;
+        if (!scanString(json, pos, &escape))
+          return false;
+        continue;
+      }
+      if (c == u'{' || c == u'[') {
+        depth++;
+      } else if ((c == u'}' || c == u']') && --depth == 0) {
+        pos++;
+        *raw = json.sliced(start, pos - start);
+        return true;
+      }
+      pos++;
+    }
+    return false;
+  }
+
+  while (pos < json.size()) {
+    c = at(json, pos);
+    if (c == u',' || c == u'}' || c == u']' || isSpace(c))
+      break;
+    pos++;
+  }
+  if (pos == start)
+    return false;
+  *raw = json.sliced(start, pos - start);
+  return true;
+}
+
+} // namespace
+
+IngestParser::IngestParser()
+    : m_arena(m_inline, sizeof(m_inline)), m_fields(&m_arena) {}
+
+bool IngestParser::parse(QStringView json) {
+  release();
+  if (parseObject(json))
+    return true;
+  m_fields.clear();
+  return false;
+}
+
+bool IngestParser::parseObject(QStringView json) {
+  // 采集消息一般 5~8 个字段，一次预留避免表在池里反复增长
+  m_fields.reserve(8);
+  qsizetype pos = 0;
+  skipSpace(json, pos);
+  if (pos >= json.size() || at(json, pos) != u'{')
+    return false;
+  pos++;
+  skipSpace(json, pos);
+
+  if (pos < json.size() && at(json, pos) == u'}') {
+    pos++;
+  } else {
+    for (;;) {
+      if (pos >= json.size() || at(json, pos) != u'"')
+        return false;
+      Field field;
+      if (!parseString(json, pos, &field.key))
+        return false;
+      skipSpace(json, pos);
+      if (pos >= json.size() || at(json, pos) != u':')
+        return false;
+      pos++;
+      skipSpace(json, pos);
+      if (pos >= json.size())
+        return false;
+      bool ok = at(json, pos) == u'"'
+                    ? parseString(json, pos, &field.value)
+                    : skipValue(json, pos, &field.value);
+      if (!ok)
+        return false;
+      m_fields.push_back(field);
+
+      skipSpace(json, pos);
+      if (pos < json.size() && at(json, pos) == u',') {
+        pos++;
+        skipSpace(json, pos);
+        continue;
+      }
+      if (pos < json.size() && at(json, pos) == u'}') {
+        pos++;
+        break;
+      }
+      return false;
+    }
+  }
+
+  skipSpace(json, pos);
+  return pos == json.size();
+}
+
+bool IngestParser::parseString(QStringView json, qsizetype &pos,
+                               QStringView *out) {
+  qsizetype start = pos + 1;
+  qsizetype escape;
+  if (!scanString(json, pos, &escape))
+    return false;
+  qsizetype end = pos - 1; // 结尾引号
+  if (escape < 0) {
+    *out = json.sliced(start, end - start);
+    return true;
+  }
+
+  // 解码后不会比原文长；最多申请原文长度
+  auto *buf = static_cast<char16_t *>(m_arena.allocate(
+      size_t(end - start) * sizeof(char16_t), alignof(char16_t)));
+  qsizetype n = 0;
+  for (qsizetype i = start; i < escape; i++)
+    buf[n++] = at(json, i);
+  qsizetype i = escape;
+  while (i < end) {
+    char16_t c = at(json, i);
+    if (c != u'\\') {
+      buf[n++] = c;
+      i++;
+      continue;
+    }
+    char16_t e = at(json, i + 1);
+    switch (e) {
+    case u'"':
+    case u'\\':
+    case u'/':
+      buf[n++] = e;
+      break;
+    case u'b':
+      buf[n++] = u'\b';
+      break;
+    case u'f':
+      buf[n++] = u'\f';
+      break;
+    case u'n':
+      buf[n++] = u'\n';
+      break;
+    case u'r':
+      buf[n++] = u'\r';
+      break;
+    case u't':
+      buf[n++] = u'\t';
+      break;
+    case u'u': {
+      // 代理对按两个 \u 依次写入，拼起来就是合法的 UTF-16
+      if (i + 6 > end)
+        return false;
+      int code = 0;
+      for (qsizetype k = i + 2; k < i + 6; k++) {
+        int h = hexValue(at(json, k));
+        if (h < 0)
+          return false;
+        code = code * 16 + h;
+      }
+      buf[n++] = char16_t(code);
+      i += 6;
+      continue;
+    }
+    default:
+      return false;
+    }
+    i += 2;
+  }
+  *out = QStringView(buf, n);
+  return true;
+}
+
+QStringView IngestParser::value(QLatin1String key) const {
+  for (auto it = m_fields.rbegin(); it != m_fields.rend(); ++it) {
+    if (it->key == key)
+      return it->value;
+  }
+  return QStringView();
+}
+
+void IngestParser::release() {
+  // 字段表的存储也在池里：先换成空表，再整体回卷
+  std::pmr::vector<Field>(&m_arena).swap(m_fields);
+  m_arena.release();
+}
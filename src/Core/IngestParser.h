@@ -0,0 +1,52 @@
+#ifndef INGESTPARSER_H
+#define INGESTPARSER_H
+
+#include <QLatin1String>
+#include <QStringView>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+// 采集消息解析 - 代替 QJsonDocument::fromJson(toUtf8()) 的单遍扫描
+//
+// 采集脚本每条消息是一个扁平 JSON 对象（字符串/数字字段）。直接在
+// UTF-16 原文上扫描：不含转义的字符串值是指向原文的视图，含转义的解码到
+// 本批次的单调内存池（先用对象内的缓冲，超出才向堆申请）。字段表也分配
+// 在池里。下一次 parse() 或 release() 时整批一次性归还，调用方只把最终
+// 需要保存的字段复制成 QString。
+//
+// 返回的视图在下一次 parse()/release() 之前、且原文存活期间有效。
+class IngestParser {
+public:
+  static const int kInlineBytes = 4096;
+
+  IngestParser();
+  IngestParser(const IngestParser &) = delete;
+  IngestParser &operator=(const IngestParser &) = delete;
+
+  // 先归还上一批，再解析；不是 JSON 对象时返回 false
+  bool parse(QStringView json);
+
+  // 字符串字段的值（已解码）；其余类型为原始 JSON 文本。
+  // 缺失时为 null 视图，与空字符串可区分；重复键取最后一个
+  QStringView value(QLatin1String key) const;
+  int size() const { return int(m_fields.size()); }
+
+  // 归还整批内存（清空字段表）
+  void release();
+
+private:
+  struct Field {
+    QStringView key;
+    QStringView value;
+  };
+
+  bool parseObject(QStringView json);
+  bool parseString(QStringView json, qsizetype &pos, QStringView *out);
+
+  alignas(std::max_align_t) std::byte m_inline[kInlineBytes];
+  std::pmr::monotonic_buffer_resource m_arena;
+  std::pmr::vector<Field> m_fields;
+};
+
+#endif // INGESTPARSER_H
@@ -1,5 +1,7 @@
 #include "ListMonitorEngine.h"
-#include "Data/DataStorage.h"
+#include "App/AppConfig.h"
+#include "App/ScriptRegistry.h"
+#include "Data/LedgerStore.h"
 #include "Data/SocialAction.h"
 #include "UI/WebView2Widget.h"
 #include <QDateTime>
@@ -8,9 +10,119 @@
 #include <QJsonObject>
 #include <QRandomGenerator>
 
+namespace {
+
+// 页面脚本模块 "list"：启动时注册一次，每个文档创建时注入
+const char *kListScript = R"JS(
+({
+    // 平滑滚动停稳（连续 3 帧位置不变）后 resolve
+    scroll(amount) {
+        return new Promise(resolve => {
+            let lastY = -1;
+            let stable = 0;
+            const started = performance.now();
+            const check = () => {
+                stable = window.scrollY === lastY ? stable + 1 : 0;
+                lastY = window.scrollY;
+                if (stable >= 3 || performance.now() - started > 2000) {
+                    resolve(window.scrollY);
+                    return;
+                }
+                requestAnimationFrame(check);
+            };
+            window.scrollBy({ top: amount, behavior: 'smooth' });
+            requestAnimationFrame(check);
+        });
+    },
+
+    scan() {
+        try {
+            const articles = document.querySelectorAll('article[data-testid="tweet"]');
+            for (let i = 0; i < articles.length; i++) {
+                const article = articles[i];
+                const rect = article.getBoundingClientRect();
+                // 只处理可见区域的帖子
+                if (rect.top < -100 || rect.bottom > window.innerHeight + 100) continue;
+
+                // 获取帖子ID
+                const timeLink = article.querySelector('a[href*="/status/"]');
+                let tweetId = '';
+                if (timeLink) {
+                    const match = timeLink.href.match(/\/status\/(\d+)/);
+                    if (match) tweetId = match[1];
+                }
+                if (!tweetId) continue;
+
+                // 跳过回复帖 - 只点赞原创帖
+                const textContent = article.textContent || '';
+                if (textContent.includes('Replying to') || textContent.includes('回复')) continue;
+                // 检查是否有回复指示器
+                const replyIndicator = article.querySelector('[data-testid="reply"]');
+                const socialContext = article.querySelector('[data-testid="socialContext"]');
+                if (socialContext && socialContext.textContent && socialContext.textContent.includes('replied')) continue;
+
+                // 获取作者handle
+                const userLinks = article.querySelectorAll('a[role="link"][href^="/"]');
+                let authorHandle = '';
+                for (const link of userLinks) {
+                    const href = link.getAttribute('href');
+                    if (href && /^\/[a-zA-Z0-9_]+$/.test(href)) {
+                        authorHandle = href.substring(1).toLowerCase();
+                        break;
+                    }
+                }
+
+                // 查找未点赞按钮
+                const likeBtn = article.querySelector('[data-testid="like"]');
+                if (!likeBtn) continue; // 已经点赞了(data-testid="unlike")或无按钮
+
+                // 发送到C++
+                try {
+                    window.chrome.webview.postMessage(JSON.stringify({
+                        type: 'list_unliked_post',
+                        index: i,
+                        tweetId: tweetId,
+                        handle: authorHandle
+                    }));
+                } catch(e) {}
+                return; // 一次只处理一个
+            }
+        } catch(e) {}
+    },
+
+    like(index) {
+        try {
+            const articles = document.querySelectorAll('article[data-testid="tweet"]');
+            if (index >= articles.length) return;
+            const article = articles[index];
+            const likeBtn = article.querySelector('[data-testid="like"]');
+            if (!likeBtn) return;
+
+            // 模拟鼠标进入
+            likeBtn.dispatchEvent(new MouseEvent('mouseenter', {bubbles: true}));
+            likeBtn.dispatchEvent(new MouseEvent('mouseover', {bubbles: true}));
+
+            setTimeout(function() {
+                likeBtn.click();
+                likeBtn.dispatchEvent(new MouseEvent('mouseleave', {bubbles: true}));
+
+                try {
+                    window.chrome.webview.postMessage(JSON.stringify({
+                        type: 'list_like_clicked'
+                    }));
+                } catch(e) {}
+            }, 200 + Math.random() * 500);
+        } catch(e) {}
+    }
+})
+)JS";
+
+} // namespace
+
 ListMonitorEngine::ListMonitorEngine(WebView2Widget *browser,
-                                     DataStorage *storage, QObject *parent)
-    : QObject(parent), m_browser(browser), m_storage(storage), m_state(Idle),
+                                     LedgerStore *storage, QObject *parent)
+    : QObject(parent), m_browser(browser), m_storage(storage),
+      m_config(nullptr), m_state(Idle),
       m_running(false), m_currentListIndex(0), m_scrollCount(0),
       m_sessionLikeCount(0),
       // 风控默认值
@@ -34,6 +146,9 @@ ListMonitorEngine::ListMonitorEngine(WebView2Widget *browser,
           &ListMonitorEngine::onPageLoaded);
   connect(m_browser, &WebView2Widget::webMessageReceived, this,
           &ListMonitorEngine::onWebMessage);
+
+  ScriptRegistry::instance()->registerModule("list",
+                                             QString::fromUtf8(kListScript));
 }
 
 ListMonitorEngine::~ListMonitorEngine() { stop(); }
@@ -101,6 +216,21 @@ void ListMonitorEngine::setUserCooldown(int minSec, int maxSec) {
   m_userCooldownMaxSec = maxSec;
 }
 
+void ListMonitorEngine::setConfig(AppConfig *config) {
+  m_config = config;
+  auto apply = [this]() {
+    const ListMonitorSettings &l = m_config->listMonitor();
+    setLikeInterval(l.likeMin, l.likeMax);
+    setScrollInterval(l.scrollMin, l.scrollMax);
+    setListStayDuration(l.stayMin, l.stayMax);
+    setMaxLikesPerSession(l.maxLikes);
+    setRestInterval(l.restMin, l.restMax);
+    setUserCooldown(l.cooldownMin, l.cooldownMax);
+  };
+  apply();
+  connect(m_config, &AppConfig::listMonitorChanged, this, apply);
+}
+
 int ListMonitorEngine::randomInRange(int minVal, int maxVal) {
   if (minVal >= maxVal)
     return minVal;
@@ -200,21 +330,15 @@ void ListMonitorEngine::doScroll() {
   // 滚动距离
   int scrollAmount = 200 + QRandomGenerator::global()->bounded(401); // 200-600
 
-  QString scrollJs = QString(R"JS(
-(function() {
-    window.scrollBy({ top: %1, behavior: 'smooth' });
-})();
-)JS")
-                         .arg(scrollAmount);
-
-  m_browser->ExecuteJavaScript(scrollJs);
-
-  // 滚动后扫描未点赞的帖子
-  QTimer::singleShot(800, this, [this]() {
+  // 滚动真正停下后扫描未点赞的帖子（超时、导航取消或模块缺失也照常扫描）
+  auto scan = [this]() {
     if (m_running && m_state == Scanning) {
       injectScanScript();
     }
-  });
+  };
+  m_browser->Call("list.scroll", {scrollAmount}, 3000)
+      .then(this, [scan](const QJsonValue &) { scan(); })
+      .onCanceled(this, scan);
 
   // 每10次滚动汇报一下
   if (m_scrollCount % 10 == 0) {
@@ -233,64 +357,7 @@ void ListMonitorEngine::injectScanScript() {
 
   // 扫描当前可见区域的帖子，查找未点赞的
   // 排除已知的 tweetId 避免重复
-  QString script = R"JS(
-(function() {
-    try {
-        const articles = document.querySelectorAll('article[data-testid="tweet"]');
-        for (let i = 0; i < articles.length; i++) {
-            const article = articles[i];
-            const rect = article.getBoundingClientRect();
-            // 只处理可见区域的帖子
-            if (rect.top < -100 || rect.bottom > window.innerHeight + 100) continue;
-
-            // 获取帖子ID
-            const timeLink = article.querySelector('a[href*="/status/"]');
-            let tweetId = '';
-            if (timeLink) {
-                const match = timeLink.href.match(/\/status\/(\d+)/);
-                if (match) tweetId = match[1];
-            }
-            if (!tweetId) continue;
-
-            // 跳过回复帖 - 只点赞原创帖
-            const textContent = article.textContent || '';
-            if (textContent.includes('Replying to') || textContent.includes('回复')) continue;
-            // 检查是否有回复指示器
-            const replyIndicator = article.querySelector('[data-testid="reply"]');
-            const socialContext = article.querySelector('[data-testid="socialContext"]');
-            if (socialContext && socialContext.textContent && socialContext.textContent.includes('replied')) continue;
-
-            // 获取作者handle
-            const userLinks = article.querySelectorAll('a[role="link"][href^="/"]');
-            let authorHandle = '';
-            for (const link of userLinks) {
-                const href = link.getAttribute('href');
-                if (href && /^\/[a-zA-Z0-9_]+$/.test(href)) {
-                    authorHandle = href.substring(1).toLowerCase();
-                    break;
-                }
-            }
-
-            // 查找未点赞按钮
-            const likeBtn = article.querySelector('[data-testid="like"]');
-            if (!likeBtn) continue; // 已经点赞了(data-testid="unlike")或无按钮
-
-            // 发送到C++
-            try {
-                window.chrome.webview.postMessage(JSON.stringify({
-                    type: 'list_unliked_post',
-                    index: i,
-                    tweetId: tweetId,
-                    handle: authorHandle
-                }));
-            } catch(e) {}
-            return; // 一次只处理一个
-        }
-    } catch(e) {}
-})();
-)JS";
-
-  m_browser->ExecuteJavaScript(script);
+  m_browser->Invoke("list.scan");
 }
 
 void ListMonitorEngine::injectLikeScript(int articleIndex) {
@@ -298,35 +365,7 @@ void ListMonitorEngine::injectLikeScript(int articleIndex) {
     return;
 
   // 模拟hover + click 点赞
-  QString script = QString(R"JS(
-(function() {
-    try {
-        const articles = document.querySelectorAll('article[data-testid="tweet"]');
-        if (%1 >= articles.length) return;
-        const article = articles[%1];
-        const likeBtn = article.querySelector('[data-testid="like"]');
-        if (!likeBtn) return;
-
-        // 模拟鼠标进入
-        likeBtn.dispatchEvent(new MouseEvent('mouseenter', {bubbles: true}));
-        likeBtn.dispatchEvent(new MouseEvent('mouseover', {bubbles: true}));
-
-        setTimeout(function() {
-            likeBtn.click();
-            likeBtn.dispatchEvent(new MouseEvent('mouseleave', {bubbles: true}));
-
-            try {
-                window.chrome.webview.postMessage(JSON.stringify({
-                    type: 'list_like_clicked'
-                }));
-            } catch(e) {}
-        }, 200 + Math.random() * 500);
-    } catch(e) {}
-})();
-)JS")
-                       .arg(articleIndex);
-
-  m_browser->ExecuteJavaScript(script);
+  m_browser->Invoke("list.like", {articleIndex});
 }
 
 void ListMonitorEngine::switchToNextList() {
@@ -431,7 +470,7 @@ void ListMonitorEngine::onWebMessage(const QString &message) {
         m_userLastLikedTime[handle] = QDateTime::currentDateTimeUtc();
       }
 
-      // 存入DataStorage - 标记为已回馈
+      // 存入账本 - 标记为已回馈
       SocialAction action;
       action.userHandle = handle;
       action.type = "list_like";
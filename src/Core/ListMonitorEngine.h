@@ -10,14 +10,15 @@
 
 
 class WebView2Widget;
-class DataStorage;
+class LedgerStore;
+class AppConfig;
 
 // LIST监控引擎 - 轮流监控多个Twitter List页面，自动点赞所有新帖子
 class ListMonitorEngine : public QObject {
   Q_OBJECT
 
 public:
-  explicit ListMonitorEngine(WebView2Widget *browser, DataStorage *storage,
+  explicit ListMonitorEngine(WebView2Widget *browser, LedgerStore *storage,
                              QObject *parent = nullptr);
   ~ListMonitorEngine();
 
@@ -35,6 +36,9 @@ public:
   void setRestInterval(int minMin, int maxMin);
   void setUserCooldown(int minSec, int maxSec);
 
+  // 从 AppConfig 读取风控参数并跟随其变化
+  void setConfig(AppConfig *config);
+
 signals:
   void statusMessage(const QString &message);
   void likedPost(const QString &userHandle, const QString &tweetUrl);
@@ -64,7 +68,8 @@ private:
   int randomInRange(int minVal, int maxVal);
 
   WebView2Widget *m_browser;
-  DataStorage *m_storage;
+  LedgerStore *m_storage;
+  AppConfig *m_config;
   State m_state;
   bool m_running;
 
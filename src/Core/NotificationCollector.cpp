@@ -1,46 +1,293 @@
 ﻿#include "NotificationCollector.h"
-#include "Data/DataStorage.h"
+#include "App/AppConfig.h"
+#include "App/Metrics.h"
+#include "App/Scheduler.h"
+#include "App/ScriptRegistry.h"
+#include "App/Trace.h"
+#include "Data/LedgerStore.h"
 #include "Data/SocialAction.h"
 #include "UI/WebView2Widget.h"
 #include <QDebug>
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <QJsonValue>
 #include <QRandomGenerator>
 
+namespace {
+
+struct CollectorMetrics {
+  Counter *parseFailures;
+  Counter *duplicates;
+  Histogram *commitLatency;
+};
+
+const CollectorMetrics &collectorMetrics() {
+  Metrics *m = Metrics::instance();
+  static const CollectorMetrics metrics = {
+      m->counter("xsl_parse_failures_total",
+                 "Collector payloads that were not valid JSON objects"),
+      m->counter("xsl_duplicates_rejected_total",
+                 "Records rejected by LedgerStore::addAction as duplicates"),
+      m->histogram("xsl_storage_commit_seconds",
+                   "Latency of LedgerStore::addAction")};
+  return metrics;
+}
+
+// 记录类型只有两种：共用同一份字符串数据，不为每条记录分配
+const QString &typeName(QLatin1String type) {
+  static const QString like = QStringLiteral("like");
+  static const QString reply = QStringLiteral("reply");
+  return type == QLatin1String("like") ? like : reply;
+}
+
+// 页面脚本模块 "collector"：启动时注册一次，每个文档创建时注入
+const char *kCollectorScript = R"JS(
+({
+    start() {
+        if (window.__xsl_injected) return;
+        window.__xsl_injected = true;
+
+        const seen = new Set();
+
+        // 自动检测当前登录用户的 handle（排除自己）— 多种方式兜底
+        let myHandle = '';
+
+        function detectMyHandle() {
+            if (myHandle) return myHandle;
+
+            // 方法1: data-testid
+            const profileLink = document.querySelector('a[data-testid="AppTabBar_Profile_Link"]');
+            if (profileLink) {
+                const href = profileLink.getAttribute('href') || '';
+                if (href.match(/^\/[a-zA-Z0-9_]+$/)) {
+                    myHandle = href.replace('/', '').toLowerCase();
+                    console.log('[SELF_HANDLE]' + myHandle);
+                    return myHandle;
+                }
+            }
+
+            // 方法2: nav 里的个人主页链接
+            const navLinks = document.querySelectorAll('nav a[role="link"]');
+            const sysRoutes = ['/i/', '/home', '/explore', '/search', '/notifications', '/messages', '/settings', '/compose', '/premium'];
+            for (const link of navLinks) {
+                const href = link.getAttribute('href') || '';
+                if (href.match(/^\/[a-zA-Z0-9_]+$/) && !sysRoutes.some(r => href.startsWith(r))) {
+                    myHandle = href.replace('/', '').toLowerCase();
+                    console.log('[SELF_HANDLE]' + myHandle);
+                    return myHandle;
+                }
+            }
+
+            // 方法3: 从 "Replying to @XXX" 文本提取（最可靠！因为通知页必有此文本）
+            const allLinks = document.querySelectorAll('a[role="link"]');
+            for (const link of allLinks) {
+                const href = link.getAttribute('href') || '';
+                if (!href.match(/^\/[a-zA-Z0-9_]+$/)) continue;
+                // 检查此链接前面是否有 "Replying to" 文本
+                const parent = link.closest('div');
+                if (parent && parent.textContent && parent.textContent.includes('Replying to')) {
+                    // 这个通知页的 "Replying to @XXX" 中的 XXX 就是自己
+                    const handle = href.replace('/', '').toLowerCase();
+                    // 统计此 handle 出现在 "Replying to" 中的次数
+                    const replyingTexts = document.querySelectorAll('div[dir="ltr"]');
+                    let count = 0;
+                    for (const rt of replyingTexts) {
+                        if (rt.textContent && rt.textContent.includes('Replying to') && rt.textContent.includes('@' + handle)) {
+                            count++;
+                        }
+                    }
+                    // 如果多次出现在 "Replying to" 中，很可能是自己
+                    if (count >= 2) {
+                        myHandle = handle;
+                        console.log('[SELF_HANDLE]' + myHandle);
+                        return myHandle;
+                    }
+                }
+            }
+
+            // 方法4: 从 cookie 中提取 screen_name (twid)
+            try {
+                const cookies = document.cookie;
+                const twidMatch = cookies.match(/twid=u%3D(\d+)/);
+                if (twidMatch) {
+                    // 有 twid 但无法直接获取 screen_name
+                    // 尝试从页面 __NEXT_DATA__ 或 meta 标签获取
+                    const metaTag = document.querySelector('meta[property="al:android:url"]');
+                    if (metaTag) {
+                        const content = metaTag.getAttribute('content') || '';
+                        const match = content.match(/screen_name=([^&]+)/);
+                        if (match) {
+                            myHandle = match[1].toLowerCase();
+                            console.log('[SELF_HANDLE]' + myHandle);
+                            return myHandle;
+                        }
+                    }
+                }
+            } catch(e) {}
+
+            return myHandle;
+        }
+
+        // 初始检测
+        detectMyHandle();
+        // 延迟再次检测（DOM 可能未完全加载）
+        setTimeout(detectMyHandle, 3000);
+        setTimeout(detectMyHandle, 8000);
+
+        function collectNotifications() {
+            const articles = document.querySelectorAll('article[role="article"]');
+            let newCount = 0;
+
+            articles.forEach(el => {
+                const text = el.innerText || '';
+                const timeEl = el.querySelector('time');
+                const timestamp = timeEl ? timeEl.getAttribute('datetime') : '';
+                if (!timestamp) return;
+
+                // 获取所有用户链接
+                const links = Array.from(el.querySelectorAll('a[role="link"]'))
+                    .filter(a => {
+                        const href = a.getAttribute('href') || '';
+                        return href.match(/^\/[^/]+$/) && !href.startsWith('/i/') && !href.startsWith('/search');
+                    });
+
+                if (links.length === 0) return;
+
+                // 判断类型
+                let type = '';
+                if (text.includes('liked') || text.includes('赞了') || text.includes('いいね')) {
+                    type = 'like';
+                } else if (text.includes('replied') || text.includes('回复') || text.includes('Replying to') || text.includes('返信')) {
+                    type = 'reply';
+                } else if (text.includes('mentioned') || text.includes('提到') || text.includes('メンション')) {
+                    type = 'reply';
+                } else {
+                    return;  // 跳过其他类型
+                }
+
+                // 获取帖子链接
+                const statusEl = el.querySelector('a[href*="/status/"]');
+                const statusLink = statusEl ? statusEl.href : '';
+
+                // 获取帖子片段
+                const snippet = text.substring(0, 120).replace(/\n/g, ' ');
+
+                links.forEach(link => {
+                    const href = link.getAttribute('href') || '';
+                    const handle = href.replace('/', '');
+                    const name = link.innerText || handle;
+
+                    if (!handle || handle.length === 0) return;
+
+                    // ★ 排除自己的账号
+                    if (myHandle && handle.toLowerCase() === myHandle) return;
+
+                    const id = handle + '_' + type + '_' + timestamp;
+                    if (seen.has(id)) return;
+                    seen.add(id);
+
+                    const data = {
+                        handle: handle,
+                        name: name,
+                        type: type,
+                        timestamp: timestamp,
+                        statusLink: statusLink,
+                        snippet: snippet
+                    };
+
+                    const tag = type === 'like' ? '[LIKE_FOUND]' : '[REPLY_FOUND]';
+                    console.log(tag + JSON.stringify(data));
+                    newCount++;
+                });
+            });
+
+            if (newCount > 0) {
+                console.log('[COLLECT_PROGRESS]{"found":' + newCount + ',"total":' + seen.size + '}');
+            }
+            return newCount;
+        }
+
+        // 初始采集
+        setTimeout(collectNotifications, 1000);
+
+        // 滚动监听
+        let scrollTimer = null;
+        window.addEventListener('scroll', () => {
+            clearTimeout(scrollTimer);
+            scrollTimer = setTimeout(collectNotifications, 800);
+        });
+
+        // 定时采集 (DOM 可能动态更新)
+        setInterval(collectNotifications, 10000);
+
+        // MutationObserver 监听新内容
+        const observer = new MutationObserver((mutations) => {
+            clearTimeout(scrollTimer);
+            scrollTimer = setTimeout(collectNotifications, 500);
+        });
+
+        const container = document.querySelector('[aria-label]') || document.body;
+        observer.observe(container, { childList: true, subtree: true });
+
+        // 供 scroll() 翻页后立即补采
+        this.collect = collectNotifications;
+
+        console.log('[DEBUG] XSocialLedger collector script injected (excluding @' + myHandle + ')');
+    },
+
+    // 通知列表出现（或超时）后 resolve
+    waitReady(timeoutMs) {
+        return new Promise(resolve => {
+            const ready = () => document.querySelector('article[role="article"]');
+            if (ready()) { resolve(true); return; }
+            const observer = new MutationObserver(() => {
+                if (ready()) { observer.disconnect(); resolve(true); }
+            });
+            observer.observe(document.documentElement, { childList: true, subtree: true });
+            setTimeout(() => { observer.disconnect(); resolve(!!ready()); }, timeoutMs);
+        });
+    },
+
+    // 翻页后等 DOM 安静下来（新内容渲染完）立即采集，返回新增条数
+    scroll(timeoutMs) {
+        const self = this;
+        window.scrollBy(0, window.innerHeight * 0.8);
+        return new Promise(resolve => {
+            let done = false;
+            let quietTimer = null;
+            const finish = () => {
+                if (done) return;
+                done = true;
+                observer.disconnect();
+                clearTimeout(quietTimer);
+                resolve(typeof self.collect === 'function' ? self.collect() : 0);
+            };
+            const observer = new MutationObserver(() => {
+                clearTimeout(quietTimer);
+                quietTimer = setTimeout(finish, 300);
+            });
+            observer.observe(document.body, { childList: true, subtree: true });
+            quietTimer = setTimeout(finish, 300);
+            setTimeout(finish, timeoutMs);
+        });
+    }
+})
+)JS";
+
+} // namespace
+
 NotificationCollector::NotificationCollector(WebView2Widget *browser,
-                                             DataStorage *storage,
+                                             LedgerStore *storage,
                                              QObject *parent)
     : QObject(parent), m_browser(browser), m_storage(storage),
-      m_collecting(false), m_scriptInjected(false), m_scrollCount(0),
-      m_maxPages(5), m_refreshMinInterval(60), m_refreshMaxInterval(120),
-      m_countdownRemaining(0) {
-
-  m_pollTimer = new QTimer(this);
-  m_pollTimer->setInterval(15000); // 15s polling
-  connect(m_pollTimer, &QTimer::timeout, this,
-          &NotificationCollector::onPollTimer);
-
-  m_autoRefreshTimer = new QTimer(this);
-  m_autoRefreshTimer->setSingleShot(true);
-  connect(m_autoRefreshTimer, &QTimer::timeout, this, [this]() {
-    m_countdownTimer->stop();
-    if (!m_collecting) {
-      emit statusMessage(QString::fromUtf8(
-          "\xe2\x8f\xb0 "
-          "\xe8\x87\xaa\xe5\x8a\xa8\xe5\x88\xb7\xe6\x96\xb0\xe4\xb8\xad..."));
-      m_browser->Reload();
-      QTimer::singleShot(3000, this, [this]() { startCollecting(); });
-    }
-  });
-
-  m_countdownTimer = new QTimer(this);
-  m_countdownTimer->setInterval(1000);
-  connect(m_countdownTimer, &QTimer::timeout, this, [this]() {
-    m_countdownRemaining--;
-    if (m_countdownRemaining > 0) {
-      emit refreshCountdown(m_countdownRemaining);
-    }
-  });
+      m_config(nullptr), m_scheduler(Scheduler::instance()), m_pollTimer(0),
+      m_autoRefreshTimer(0), m_collecting(false), m_scriptInjected(false),
+      m_scrollCount(0), m_maxPages(5), m_refreshMinInterval(60),
+      m_refreshMaxInterval(120) {
+
+  // 入口过滤链：自己 -> 忽略名单 -> 类型
+  m_selfFilter = m_filters.append(std::make_unique<HandleSetFilter>("self"));
+  m_ignoreFilter =
+      m_filters.append(std::make_unique<HandleSetFilter>("ignore"));
+  m_typeFilter = m_filters.append(std::make_unique<TypeFilter>());
 
   // 连接浏览器信号
   connect(m_browser, &WebView2Widget::loadFinished, this,
@@ -54,6 +301,15 @@ NotificationCollector::NotificationCollector(WebView2Widget *browser,
   connect(
       m_browser, &WebView2Widget::selfHandleDetected, this,
       [this](const QString &handle) {
+        // 页面脚本每次加载最多上报三次：只有首次检测到时清理一次，
+        // 之后自己的记录在入口处就被丢弃，重复上报是空操作
+        if (!m_selfFilter->insert(handle)) {
+          static Counter *repeats = Metrics::instance()->counter(
+              "xsl_self_detections_skipped_total",
+              "Repeated self-handle detections that needed no cleanup");
+          repeats->inc();
+          return;
+        }
         m_storage->setSelfHandle(handle);
         int removed = m_storage->removeByHandle(handle);
         if (removed > 0) {
@@ -62,9 +318,39 @@ NotificationCollector::NotificationCollector(WebView2Widget *browser,
               QString("已清理 %1 条自己的记录 (@%2)").arg(removed).arg(handle));
         }
       });
+
+  ScriptRegistry::instance()->registerModule(
+      "collector", QString::fromUtf8(kCollectorScript));
 }
 
-NotificationCollector::~NotificationCollector() { stopCollecting(); }
+NotificationCollector::~NotificationCollector() {
+  stopCollecting();
+  m_scheduler->cancel(m_autoRefreshTimer);
+}
+
+void NotificationCollector::setScheduler(Scheduler *scheduler) {
+  m_scheduler->cancel(m_pollTimer);
+  m_scheduler->cancel(m_autoRefreshTimer);
+  m_pollTimer = 0;
+  m_autoRefreshTimer = 0;
+  m_scheduler = scheduler;
+}
+
+qint64 NotificationCollector::refreshRemainingMs() const {
+  return m_scheduler->remainingMs(m_autoRefreshTimer);
+}
+
+void NotificationCollector::onAutoRefresh() {
+  m_autoRefreshTimer = 0;
+  emit countdownChanged();
+  if (!m_collecting) {
+    emit statusMessage(QString::fromUtf8(
+        "\xe2\x8f\xb0 "
+        "\xe8\x87\xaa\xe5\x8a\xa8\xe5\x88\xb7\xe6\x96\xb0\xe4\xb8\xad..."));
+    m_browser->Reload();
+    m_scheduler->singleShot(3000, this, [this]() { startCollecting(); });
+  }
+}
 
 void NotificationCollector::startCollecting() {
   if (m_collecting)
@@ -78,8 +364,9 @@ void NotificationCollector::startCollecting() {
   // 如果页面已加载，直接注入脚本
   injectCollectorScript();
 
-  // 启动轮询
-  m_pollTimer->start();
+  // 启动轮询（15s）
+  m_scheduler->cancel(m_pollTimer);
+  m_pollTimer = m_scheduler->repeating(15000, this, [this]() { onPollTimer(); });
 }
 
 void NotificationCollector::stopCollecting() {
@@ -87,7 +374,8 @@ void NotificationCollector::stopCollecting() {
     return;
 
   m_collecting = false;
-  m_pollTimer->stop();
+  m_scheduler->cancel(m_pollTimer);
+  m_pollTimer = 0;
   m_scriptInjected = false;
   emit collectingStateChanged(false);
   emit statusMessage("采集已停止");
@@ -97,276 +385,95 @@ void NotificationCollector::onPageLoaded(bool success) {
   if (!success || !m_collecting)
     return;
 
-  qDebug() << "[Collector] Page loaded, injecting script...";
+  qDebug() << "[Collector] Page loaded, waiting for notifications...";
   m_scriptInjected = false;
 
-  // 延迟注入，等页面渲染完成
-  QTimer::singleShot(2000, this, [this]() {
+  // 等通知列表真正渲染出来再注入（超时也照常注入）
+  auto inject = [this]() {
     if (m_collecting) {
       injectCollectorScript();
     }
-  });
+  };
+  m_browser->Call("collector.waitReady", {5000}, 6000)
+      .then(this, [inject](const QJsonValue &) { inject(); })
+      .onCanceled(this, inject);
 }
 
 void NotificationCollector::injectCollectorScript() {
   if (m_scriptInjected)
     return;
 
-  QString script = R"JS(
-(function() {
-    if (window.__xsl_injected) return;
-    window.__xsl_injected = true;
-
-    const seen = new Set();
-
-    // 自动检测当前登录用户的 handle（排除自己）— 多种方式兜底
-    let myHandle = '';
-
-    function detectMyHandle() {
-        if (myHandle) return myHandle;
-
-        // 方法1: data-testid
-        const profileLink = document.querySelector('a[data-testid="AppTabBar_Profile_Link"]');
-        if (profileLink) {
-            const href = profileLink.getAttribute('href') || '';
-            if (href.match(/^\/[a-zA-Z0-9_]+$/)) {
-                myHandle = href.replace('/', '').toLowerCase();
-                console.log('[SELF_HANDLE]' + myHandle);
-                return myHandle;
-            }
-        }
-
-        // 方法2: nav 里的个人主页链接
-        const navLinks = document.querySelectorAll('nav a[role="link"]');
-        const sysRoutes = ['/i/', '/home', '/explore', '/search', '/notifications', '/messages', '/settings', '/compose', '/premium'];
-        for (const link of navLinks) {
-            const href = link.getAttribute('href') || '';
-            if (href.match(/^\/[a-zA-Z0-9_]+$/) && !sysRoutes.some(r => href.startsWith(r))) {
-                myHandle = href.replace('/', '').toLowerCase();
-                console.log('[SELF_HANDLE]' + myHandle);
-                return myHandle;
-            }
-        }
-
-        // 方法3: 从 "Replying to @XXX" 文本提取（最可靠！因为通知页必有此文本）
-        const allLinks = document.querySelectorAll('a[role="link"]');
-        for (const link of allLinks) {
-            const href = link.getAttribute('href') || '';
-            if (!href.match(/^\/[a-zA-Z0-9_]+$/)) continue;
-            // 检查此链接前面是否有 "Replying to" 文本
-            const parent = link.closest('div');
-            if (parent && parent.textContent && parent.textContent.includes('Replying to')) {
-                // 这个通知页的 "Replying to @XXX" 中的 XXX 就是自己
-                const handle = href.replace('/', '').toLowerCase();
-                // 统计此 handle 出现在 "Replying to" 中的次数
-                const replyingTexts = document.querySelectorAll('div[dir="ltr"]');
-                let count = 0;
-                for (const rt of replyingTexts) {
-                    if (rt.textContent && rt.textContent.includes('Replying to') && rt.textContent.includes('@' + handle)) {
-                        count++;
-                    }
-                }
-                // 如果多次出现在 "Replying to" 中，很可能是自己
-                if (count >= 2) {
-                    myHandle = handle;
-                    console.log('[SELF_HANDLE]' + myHandle);
-                    return myHandle;
-                }
-            }
-        }
-
-        // 方法4: 从 cookie 中提取 screen_name (twid)
-        try {
-            const cookies = document.cookie;
-            const twidMatch = cookies.match(/twid=u%3D(\d+)/);
-            if (twidMatch) {
-                // 有 twid 但无法直接获取 screen_name
-                // 尝试从页面 __NEXT_DATA__ 或 meta 标签获取
-                const metaTag = document.querySelector('meta[property="al:android:url"]');
-                if (metaTag) {
-                    const content = metaTag.getAttribute('content') || '';
-                    const match = content.match(/screen_name=([^&]+)/);
-                    if (match) {
-                        myHandle = match[1].toLowerCase();
-                        console.log('[SELF_HANDLE]' + myHandle);
-                        return myHandle;
-                    }
-                }
-            }
-        } catch(e) {}
-
-        return myHandle;
-    }
-
-    // 初始检测
-    detectMyHandle();
-    // 延迟再次检测（DOM 可能未完全加载）
-    setTimeout(detectMyHandle, 3000);
-    setTimeout(detectMyHandle, 8000);
-
-    function collectNotifications() {
-        const articles = document.querySelectorAll('article[role="article"]');
-        let newCount = 0;
-
-        articles.forEach(el => {
-            const text = el.innerText || '';
-            const timeEl = el.querySelector('time');
-            const timestamp = timeEl ? timeEl.getAttribute('datetime') : '';
-            if (!timestamp) return;
-
-            // 获取所有用户链接
-            const links = Array.from(el.querySelectorAll('a[role="link"]'))
-                .filter(a => {
-                    const href = a.getAttribute('href') || '';
-                    return href.match(/^\/[^/]+$/) && !href.startsWith('/i/') && !href.startsWith('/search');
-                });
-
-            if (links.length === 0) return;
-
-            // 判断类型
-            let type = '';
-            if (text.includes('liked') || text.includes('赞了') || text.includes('いいね')) {
-                type = 'like';
-            } else if (text.includes('replied') || text.includes('回复') || text.includes('Replying to') || text.includes('返信')) {
-                type = 'reply';
-            } else if (text.includes('mentioned') || text.includes('提到') || text.includes('メンション')) {
-                type = 'reply';
-            } else {
-                return;  // 跳过其他类型
-            }
-
-            // 获取帖子链接
-            const statusEl = el.querySelector('a[href*="/status/"]');
-            const statusLink = statusEl ? statusEl.href : '';
-
-            // 获取帖子片段
-            const snippet = text.substring(0, 120).replace(/\n/g, ' ');
-
-            links.forEach(link => {
-                const href = link.getAttribute('href') || '';
-                const handle = href.replace('/', '');
-                const name = link.innerText || handle;
-
-                if (!handle || handle.length === 0) return;
-
-                // ★ 排除自己的账号
-                if (myHandle && handle.toLowerCase() === myHandle) return;
-
-                const id = handle + '_' + type + '_' + timestamp;
-                if (seen.has(id)) return;
-                seen.add(id);
-
-                const data = {
-                    handle: handle,
-                    name: name,
-                    type: type,
-                    timestamp: timestamp,
-                    statusLink: statusLink,
-                    snippet: snippet
-                };
-
-                const tag = type === 'like' ? '[LIKE_FOUND]' : '[REPLY_FOUND]';
-                console.log(tag + JSON.stringify(data));
-                newCount++;
-            });
-        });
-
-        if (newCount > 0) {
-            console.log('[COLLECT_PROGRESS]{"found":' + newCount + ',"total":' + seen.size + '}');
-        }
-    }
-
-    // 初始采集
-    setTimeout(collectNotifications, 1000);
-
-    // 滚动监听
-    let scrollTimer = null;
-    window.addEventListener('scroll', () => {
-        clearTimeout(scrollTimer);
-        scrollTimer = setTimeout(collectNotifications, 800);
-    });
-
-    // 定时采集 (DOM 可能动态更新)
-    setInterval(collectNotifications, 10000);
-
-    // MutationObserver 监听新内容
-    const observer = new MutationObserver((mutations) => {
-        clearTimeout(scrollTimer);
-        scrollTimer = setTimeout(collectNotifications, 500);
-    });
-
-    const container = document.querySelector('[aria-label]') || document.body;
-    observer.observe(container, { childList: true, subtree: true });
-
-    console.log('[DEBUG] XSocialLedger collector script injected (excluding @' + myHandle + ')');
-})();
-)JS";
-
-  m_browser->ExecuteJavaScript(script);
+  m_browser->Invoke("collector.start");
   m_scriptInjected = true;
   qDebug() << "[Collector] Script injected";
   emit statusMessage("采集脚本已注入");
 }
 
 void NotificationCollector::onLikeFound(const QString &jsonData) {
-  QJsonDocument doc = QJsonDocument::fromJson(jsonData.toUtf8());
-  if (!doc.isObject())
-    return;
+  XSL_TRACE_SCOPE("NotificationCollector::onLikeFound");
+  ingest(jsonData, QLatin1String("like"));
+}
 
-  QJsonObject obj = doc.object();
-  SocialAction action;
-  action.userHandle = obj["handle"].toString();
-  action.userName = obj["name"].toString();
-  action.type = "like";
-  action.timestamp = obj["timestamp"].toString();
-  action.postSnippet = obj["snippet"].toString();
-  action.statusLink = obj["statusLink"].toString();
-  action.reciprocated = false;
-  action.id =
-      SocialAction::makeId(action.userHandle, action.type, action.timestamp);
+void NotificationCollector::onReplyFound(const QString &jsonData) {
+  XSL_TRACE_SCOPE("NotificationCollector::onReplyFound");
+  ingest(jsonData, QLatin1String("reply"));
+}
 
-  if (m_storage->addAction(action)) {
-    qDebug() << "[Collector] New like from" << action.userHandle << "at"
-             << action.timestamp;
-    emit newLikeCollected(action.userName.isEmpty() ? action.userHandle
-                                                    : action.userName,
-                          action.timestamp);
+void NotificationCollector::ingest(const QString &jsonData,
+                                   QLatin1String type) {
+  // 每条消息一个批次：字段是指向原文或解析器内存池的视图，下一条消息
+  // 解析时整批归还
+  if (!m_parser.parse(jsonData)) {
+    collectorMetrics().parseFailures->inc();
+    return;
   }
-}
 
-void NotificationCollector::onReplyFound(const QString &jsonData) {
-  QJsonDocument doc = QJsonDocument::fromJson(jsonData.toUtf8());
-  if (!doc.isObject())
+  // 先按原始字段过滤，被丢弃的记录不构造 SocialAction、不进存储
+  QStringView handle = m_parser.value(QLatin1String("handle"));
+  if (!m_filters.accept(RawRecord::make(type, handle)))
     return;
 
-  QJsonObject obj = doc.object();
+  // 只有最终保存的字段复制成 QString
   SocialAction action;
-  action.userHandle = obj["handle"].toString();
-  action.userName = obj["name"].toString();
-  action.type = "reply";
-  action.timestamp = obj["timestamp"].toString();
-  action.postSnippet = obj["snippet"].toString();
-  action.statusLink = obj["statusLink"].toString();
+  action.userHandle = handle.toString();
+  action.userName = m_parser.value(QLatin1String("name")).toString();
+  action.type = typeName(type);
+  action.timestamp = m_parser.value(QLatin1String("timestamp")).toString();
+  action.postSnippet = m_parser.value(QLatin1String("snippet")).toString();
+  action.statusLink = m_parser.value(QLatin1String("statusLink")).toString();
   action.reciprocated = false;
   action.id =
       SocialAction::makeId(action.userHandle, action.type, action.timestamp);
 
-  if (m_storage->addAction(action)) {
-    qDebug() << "[Collector] New reply from" << action.userHandle << "at"
-             << action.timestamp;
-    emit newReplyCollected(action.userName.isEmpty() ? action.userHandle
-                                                     : action.userName,
-                           action.timestamp);
+  bool added;
+  {
+    XSL_TRACE_SCOPE("LedgerStore::addAction");
+    ScopedLatency latency(collectorMetrics().commitLatency);
+    added = m_storage->addAction(action);
+  }
+  if (!added) {
+    collectorMetrics().duplicates->inc();
+    return;
+  }
+
+  qDebug() << "[Collector] New" << type << "from" << action.userHandle << "at"
+           << action.timestamp;
+  emit actionAdded(action);
+  QString who = action.userName.isEmpty() ? action.userHandle : action.userName;
+  if (type == QLatin1String("like")) {
+    emit newLikeCollected(who, action.timestamp);
+  } else {
+    emit newReplyCollected(who, action.timestamp);
   }
 }
 
 void NotificationCollector::onCollectProgress(const QString &jsonData) {
-  QJsonDocument doc = QJsonDocument::fromJson(jsonData.toUtf8());
-  if (!doc.isObject())
+  if (!m_parser.parse(jsonData)) {
+    collectorMetrics().parseFailures->inc();
     return;
-  QJsonObject obj = doc.object();
-  int found = obj["found"].toInt();
-  int total = obj["total"].toInt();
+  }
+  int found = m_parser.value(QLatin1String("found")).toInt();
+  int total = m_parser.value(QLatin1String("total")).toInt();
   emit statusMessage(
       QString("采集中... 本次新增 %1 条，累计 %2 条").arg(found).arg(total));
 }
@@ -384,21 +491,23 @@ void NotificationCollector::triggerScroll() {
 
   // Check page limit
   if (m_maxPages > 0 && m_scrollCount >= m_maxPages) {
-    m_pollTimer->stop();
+    m_scheduler->cancel(m_pollTimer);
+    m_pollTimer = 0;
     m_scriptInjected = false;
     // Start auto-refresh timer if enabled
     if (m_refreshMinInterval > 0) {
       int interval = m_refreshMinInterval +
                      QRandomGenerator::global()->bounded(
                          m_refreshMaxInterval - m_refreshMinInterval + 1);
-      m_autoRefreshTimer->start(interval * 1000);
-      m_countdownRemaining = interval;
-      m_countdownTimer->start();
+      m_scheduler->cancel(m_autoRefreshTimer);
+      m_autoRefreshTimer = m_scheduler->singleShot(
+          qint64(interval) * 1000, this, [this]() { onAutoRefresh(); });
+      emit countdownChanged();
       emit statusMessage(
           QString::fromUtf8("\xe2\x8f\xb3 "
                             "\xe8\x87\xaa\xe5\x8a\xa8\xe5\x88\xb7\xe6\x96\xb0"
                             "\xe5\x80\x92\xe8\xae\xa1\xe6\x97\xb6: %1s")
-              .arg(m_countdownRemaining));
+              .arg(interval));
     } else {
       m_collecting = false;
       emit collectingStateChanged(false);
@@ -411,16 +520,25 @@ void NotificationCollector::triggerScroll() {
     return;
   }
 
-  QString scrollScript = R"JS(
-    (function() {
-        window.scrollBy(0, window.innerHeight * 0.8);
-        if (typeof collectNotifications === 'function') {
-            setTimeout(collectNotifications, 1000);
-        }
-    })();
-    )JS";
+  // 等本次翻页的内容加载完成后立即采集，不再固定等待
+  m_browser->Call("collector.scroll", {3000}, 5000)
+      .then(this, [this](const QJsonValue &found) {
+        qDebug() << "[Collector] Page" << m_scrollCount << "collected"
+                 << found.toInt() << "new";
+      });
+}
 
-  m_browser->ExecuteJavaScript(scrollScript);
+void NotificationCollector::setConfig(AppConfig *config) {
+  m_config = config;
+  auto apply = [this]() {
+    const CollectorSettings &c = m_config->collector();
+    setMaxPages(c.maxPages);
+    setAutoRefreshRange(c.refreshMin, c.refreshMax);
+    m_ignoreFilter->setHandles(c.ignoredHandleList());
+    m_typeFilter->setAllowed(c.collectLikes, c.collectReplies);
+  };
+  apply();
+  connect(m_config, &AppConfig::collectorChanged, this, apply);
 }
 
 void NotificationCollector::setAutoRefreshRange(int minSec, int maxSec) {
@@ -430,7 +548,9 @@ void NotificationCollector::setAutoRefreshRange(int minSec, int maxSec) {
 
 void NotificationCollector::setAutoRefreshEnabled(bool enabled) {
   if (!enabled) {
-    m_autoRefreshTimer->stop();
+    m_scheduler->cancel(m_autoRefreshTimer);
+    m_autoRefreshTimer = 0;
+    emit countdownChanged();
     m_refreshMinInterval = 0;
     m_refreshMaxInterval = 0;
   }
@@ -1,18 +1,22 @@
 #ifndef NOTIFICATIONCOLLECTOR_H
 #define NOTIFICATIONCOLLECTOR_H
 
+#include "App/Scheduler.h"
+#include "IngestFilter.h"
+#include "IngestParser.h"
+#include "Data/SocialAction.h"
 #include <QObject>
-#include <QTimer>
 
 class WebView2Widget;
-class DataStorage;
+class LedgerStore;
+class AppConfig;
 
 // 通知采集引擎 - 注入 JS 到 X.com 通知页面进行数据采集
 class NotificationCollector : public QObject {
   Q_OBJECT
 
 public:
-  explicit NotificationCollector(WebView2Widget *browser, DataStorage *storage,
+  explicit NotificationCollector(WebView2Widget *browser, LedgerStore *storage,
                                  QObject *parent = nullptr);
   ~NotificationCollector();
 
@@ -30,13 +34,26 @@ public:
   int refreshMaxInterval() const { return m_refreshMaxInterval; }
   void setAutoRefreshEnabled(bool enabled);
 
+  // 从 AppConfig 读取采集参数并跟随其变化
+  void setConfig(AppConfig *config);
+
+  // Defaults to Scheduler::instance(); a virtual-clock scheduler lets the
+  // whole poll/refresh cycle be simulated. Cancels pending timers.
+  void setScheduler(Scheduler *scheduler);
+
+  // 距下次自动刷新的毫秒数（未安排时为 0），由截止时间推算
+  qint64 refreshRemainingMs() const;
+
 signals:
   void newLikeCollected(const QString &userName, const QString &timestamp);
   void newReplyCollected(const QString &userName, const QString &timestamp);
+  // 新记录已写入账本（派生索引据此增量更新）
+  void actionAdded(const SocialAction &action);
   void collectingStateChanged(bool collecting);
   void statusMessage(const QString &message);
   void selfRecordsCleaned(int removedCount);
-  void refreshCountdown(int secondsRemaining);
+  // 自动刷新截止时间被设置或清除
+  void countdownChanged();
 
 private slots:
   void onPageLoaded(bool success);
@@ -48,19 +65,26 @@ private slots:
 private:
   void injectCollectorScript();
   void triggerScroll();
+  void onAutoRefresh();
+  void ingest(const QString &jsonData, QLatin1String type);
 
   WebView2Widget *m_browser;
-  DataStorage *m_storage;
-  QTimer *m_pollTimer;
-  QTimer *m_autoRefreshTimer;
+  LedgerStore *m_storage;
+  AppConfig *m_config;
+  Scheduler *m_scheduler;
+  Scheduler::TimerId m_pollTimer;
+  Scheduler::TimerId m_autoRefreshTimer;
+  IngestFilterChain m_filters;
+  HandleSetFilter *m_selfFilter;   // 已检测到的自己的 handle
+  HandleSetFilter *m_ignoreFilter; // 用户配置的忽略名单
+  TypeFilter *m_typeFilter;
+  IngestParser m_parser; // 采集消息逐条解析，每条一个内存批次
   bool m_collecting;
   bool m_scriptInjected;
   int m_scrollCount;
   int m_maxPages;
   int m_refreshMinInterval;
   int m_refreshMaxInterval;
-  QTimer *m_countdownTimer;
-  int m_countdownRemaining;
 };
 
 #endif // NOTIFICATIONCOLLECTOR_H
@@ -1,15 +1,165 @@
 #include "ReciprocatorEngine.h"
-#include "Data/DataStorage.h"
+#include "App/AppConfig.h"
+#include "App/ScriptRegistry.h"
+#include "Data/LedgerStore.h"
 #include "UI/WebView2Widget.h"
 #include <QDebug>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QRandomGenerator>
 
+namespace {
+
+// 页面脚本模块 "recip"：启动时注册一次，每个文档创建时注入
+const char *kRecipScript = R"JS(
+({
+    scroll(amount) {
+        window.scrollBy({ top: amount, behavior: 'smooth' });
+    },
+
+    scan(handles) {
+        const targets = new Set(handles);
+        if (targets.size === 0) return;
+
+        const skipPaths = ['home','explore','search','notifications','messages',
+            'settings','i','compose','login','signup','tos','privacy','help',
+            'about','jobs','premium','lists'];
+
+        const articles = document.querySelectorAll('article[data-testid="tweet"]');
+        for (let idx = 0; idx < articles.length; idx++) {
+            const article = articles[idx];
+            const likeBtn = article.querySelector('[data-testid="like"]');
+            if (!likeBtn) continue;
+
+            const links = article.querySelectorAll('a[href]');
+            let author = '';
+            for (const link of links) {
+                const href = link.getAttribute('href');
+                if (!href) continue;
+                const match = href.match(/^\/([a-zA-Z0-9_]+)$/);
+                if (!match) continue;
+                const username = match[1].toLowerCase();
+                if (skipPaths.includes(username)) continue;
+                author = username;
+                break;
+            }
+
+            if (author && targets.has(author)) {
+                // 优化#6: 不做scrollIntoView（太精准不自然），帖子在正常滚动中已在视口附近
+                try {
+                    window.chrome.webview.postMessage(JSON.stringify({
+                        type: 'reciprocate_target',
+                        handle: author,
+                        index: idx
+                    }));
+                } catch(e) {}
+                return;
+            }
+        }
+    },
+
+    like(index) {
+        const articles = document.querySelectorAll('article[data-testid="tweet"]');
+        if (index < articles.length) {
+            const likeBtn = articles[index].querySelector('[data-testid="like"]');
+            if (likeBtn) {
+                // 先触发hover效果
+                likeBtn.dispatchEvent(new MouseEvent('mouseenter', {bubbles: true}));
+                likeBtn.dispatchEvent(new MouseEvent('mouseover', {bubbles: true}));
+                // 短暂停顿后点击 (200-500ms)
+                const delay = 200 + Math.random() * 300;
+                setTimeout(() => {
+                    likeBtn.click();
+                    likeBtn.dispatchEvent(new MouseEvent('mouseleave', {bubbles: true}));
+                    try {
+                        window.chrome.webview.postMessage(JSON.stringify({
+                            type: 'like_clicked'
+                        }));
+                    } catch(e) {}
+                }, delay);
+            }
+        }
+    },
+
+    clickMore() {
+        // 第一步：强制立即滚到最顶部
+        window.scrollTo(0, 0);
+        document.documentElement.scrollTop = 0;
+        document.body.scrollTop = 0;
+
+        let attempts = 0;
+        const maxAttempts = 10; // 10次 x 2秒 = 最多20秒
+        const checkInterval = 2000;
+
+        function ensureAtTop() {
+            // 每次检查前都确保在最顶部
+            if (window.scrollY > 5) {
+                window.scrollTo(0, 0);
+                document.documentElement.scrollTop = 0;
+                document.body.scrollTop = 0;
+                console.log('[XSocialLedger] Force scroll to top, was at: ' + window.scrollY);
+            }
+        }
+
+        function tryClickMore() {
+            attempts++;
+            ensureAtTop();
+
+            try {
+                const cells = document.querySelectorAll('[data-testid="cellInnerDiv"]');
+                for (const cell of cells) {
+                    const text = cell.textContent || '';
+                    if (/show.*post|显示.*帖|条新帖|新的帖子|new post/i.test(text)) {
+                        const btn = cell.querySelector('[role="button"]') || cell.querySelector('button');
+                        if (btn) {
+                            btn.click();
+                            console.log('[XSocialLedger] Auto-clicked: Show new posts (attempt ' + attempts + ')');
+                            try {
+                                window.chrome.webview.postMessage(JSON.stringify({
+                                    type: 'more_clicked', attempts: attempts
+                                }));
+                            } catch(e) {}
+                            return;
+                        }
+                        cell.click();
+                        console.log('[XSocialLedger] Auto-clicked cell: Show new posts (attempt ' + attempts + ')');
+                        try {
+                            window.chrome.webview.postMessage(JSON.stringify({
+                                type: 'more_clicked', attempts: attempts
+                            }));
+                        } catch(e) {}
+                        return;
+                    }
+                }
+            } catch(e) {}
+
+            if (attempts < maxAttempts) {
+                setTimeout(tryClickMore, checkInterval);
+            } else {
+                console.log('[XSocialLedger] More button not found after ' + maxAttempts + ' attempts');
+                try {
+                    window.chrome.webview.postMessage(JSON.stringify({
+                        type: 'more_timeout'
+                    }));
+                } catch(e) {}
+            }
+        }
+
+        // 等1秒确保DOM更新后开始检查
+        setTimeout(tryClickMore, 1000);
+    }
+})
+)JS";
+
+} // namespace
+
 ReciprocatorEngine::ReciprocatorEngine(WebView2Widget *browser,
-                                       DataStorage *storage, QObject *parent)
-    : QObject(parent), m_browser(browser), m_storage(storage), m_state(Idle),
-      m_browsing(false), m_scrollCount(0), m_countdownRemaining(0),
+                                       LedgerStore *storage, QObject *parent)
+    : QObject(parent), m_browser(browser), m_storage(storage),
+      m_config(nullptr), m_state(Idle),
+      m_browsing(false), m_scheduler(Scheduler::instance()), m_sessionTimer(0),
+      m_scrollCount(0),
       m_scrollMinSec(3), m_scrollMaxSec(8), m_likeWaitMinSec(3),
       m_likeWaitMaxSec(8), m_browseMinMin(10), m_browseMaxMin(30),
       m_restMinMin(15), m_restMaxMin(45) {
@@ -18,31 +168,6 @@ ReciprocatorEngine::ReciprocatorEngine(WebView2Widget *browser,
   m_scrollTimer->setSingleShot(true);
   connect(m_scrollTimer, &QTimer::timeout, this, &ReciprocatorEngine::doScroll);
 
-  m_sessionTimer = new QTimer(this);
-  m_sessionTimer->setSingleShot(true);
-  connect(m_sessionTimer, &QTimer::timeout, this, [this]() {
-    if (!m_browsing)
-      return;
-    if (m_state == Browsing || m_state == LikePause) {
-      // 浏览时间到，开始休息
-      startRestSession();
-    } else if (m_state == Resting) {
-      // 休息结束，重新开始浏览
-      startBrowseSession();
-    }
-  });
-
-  m_countdownTimer = new QTimer(this);
-  m_countdownTimer->setInterval(1000);
-  connect(m_countdownTimer, &QTimer::timeout, this, [this]() {
-    m_countdownRemaining--;
-    if (m_countdownRemaining > 0) {
-      emit sessionCountdown(m_countdownRemaining);
-    } else {
-      m_countdownTimer->stop();
-    }
-  });
-
   m_clickMoreTimer = new QTimer(this);
   m_clickMoreTimer->setSingleShot(true); // 每次随机间隔
   connect(m_clickMoreTimer, &QTimer::timeout, this, [this]() {
@@ -58,10 +183,38 @@ ReciprocatorEngine::ReciprocatorEngine(WebView2Widget *browser,
           &ReciprocatorEngine::onPageLoaded);
   connect(m_browser, &WebView2Widget::webMessageReceived, this,
           &ReciprocatorEngine::onWebMessage);
+
+  ScriptRegistry::instance()->registerModule("recip",
+                                             QString::fromUtf8(kRecipScript));
 }
 
 ReciprocatorEngine::~ReciprocatorEngine() { stopBrowsing(); }
 
+qint64 ReciprocatorEngine::sessionRemainingMs() const {
+  return m_scheduler->remainingMs(m_sessionTimer);
+}
+
+void ReciprocatorEngine::scheduleSessionEnd(int seconds) {
+  m_scheduler->cancel(m_sessionTimer);
+  m_sessionTimer = m_scheduler->singleShot(qint64(seconds) * 1000, this,
+                                           [this]() { onSessionTimeout(); });
+  emit countdownChanged();
+}
+
+void ReciprocatorEngine::onSessionTimeout() {
+  m_sessionTimer = 0;
+  emit countdownChanged();
+  if (!m_browsing)
+    return;
+  if (m_state == Browsing || m_state == LikePause) {
+    // 浏览时间到，开始休息
+    startRestSession();
+  } else if (m_state == Resting) {
+    // 休息结束，重新开始浏览
+    startBrowseSession();
+  }
+}
+
 void ReciprocatorEngine::startBrowsing(
     const QList<QPair<QString, QString>> &targets) {
   if (targets.isEmpty())
@@ -90,13 +243,13 @@ void ReciprocatorEngine::stopBrowsing() {
   m_browsing = false;
   m_state = Idle;
   m_scrollTimer->stop();
-  m_sessionTimer->stop();
-  m_countdownTimer->stop();
+  m_scheduler->cancel(m_sessionTimer);
+  m_sessionTimer = 0;
   m_clickMoreTimer->stop();
   m_targetMap.clear();
   m_likedHandles.clear();
   m_scrollCount = 0;
-  m_countdownRemaining = 0;
+  emit countdownChanged();
   emit browsingStateChanged("idle");
   emit batchFinished();
 }
@@ -124,6 +277,18 @@ void ReciprocatorEngine::setBrowseRestCycle(int browseMinMin, int browseMaxMin,
   m_restMaxMin = restMaxMin;
 }
 
+void ReciprocatorEngine::setConfig(AppConfig *config) {
+  m_config = config;
+  auto apply = [this]() {
+    const ReciprocatorSettings &r = m_config->reciprocator();
+    setScrollInterval(r.scrollMin, r.scrollMax);
+    setLikeWaitInterval(r.likeWaitMin, r.likeWaitMax);
+    setBrowseRestCycle(r.browseMin, r.browseMax, r.restMin, r.restMax);
+  };
+  apply();
+  connect(m_config, &AppConfig::reciprocatorChanged, this, apply);
+}
+
 int ReciprocatorEngine::randomInRange(int minVal, int maxVal) {
   if (minVal >= maxVal)
     return minVal;
@@ -169,9 +334,7 @@ void ReciprocatorEngine::startBrowseSession() {
 
   // 设置浏览时长定时器
   int browseSeconds = randomInRange(m_browseMinMin * 60, m_browseMaxMin * 60);
-  m_sessionTimer->start(browseSeconds * 1000);
-  m_countdownRemaining = browseSeconds;
-  m_countdownTimer->start();
+  scheduleSessionEnd(browseSeconds);
 
   // 开始自动点击More（随机间隔 2-4分钟）
   m_clickMoreTimer->start(randomInRange(120, 240) * 1000);
@@ -193,9 +356,7 @@ void ReciprocatorEngine::startRestSession() {
   emit browsingStateChanged("resting");
 
   int restSeconds = randomInRange(m_restMinMin * 60, m_restMaxMin * 60);
-  m_sessionTimer->start(restSeconds * 1000);
-  m_countdownRemaining = restSeconds;
-  m_countdownTimer->start();
+  scheduleSessionEnd(restSeconds);
 
   emit statusMessage(
       QString::fromUtf8("😴 休息中... %1 分钟后继续").arg(restSeconds / 60));
@@ -248,14 +409,7 @@ void ReciprocatorEngine::doScroll() {
     scrollAmount = 80 + QRandomGenerator::global()->bounded(121);
   }
 
-  QString scrollJs = QString(R"JS(
-(function() {
-    window.scrollBy({ top: %1, behavior: 'smooth' });
-})();
-)JS")
-                         .arg(scrollAmount);
-
-  m_browser->ExecuteJavaScript(scrollJs);
+  m_browser->Invoke("recip.scroll", {scrollAmount});
 
   // === 优化#5: 状态消息每10次更新一次 ===
   if (m_scrollCount % 10 == 0) {
@@ -277,14 +431,14 @@ void ReciprocatorEngine::doScroll() {
   scheduleNextScroll();
 }
 
-QString ReciprocatorEngine::buildTargetHandlesJs() {
-  QStringList handles;
+QJsonArray ReciprocatorEngine::buildTargetHandles() {
+  QJsonArray handles;
   for (auto it = m_targetMap.constBegin(); it != m_targetMap.constEnd(); ++it) {
     if (!m_likedHandles.contains(it.key())) {
-      handles << "'" + it.key() + "'";
+      handles.append(it.key());
     }
   }
-  return "[" + handles.join(",") + "]";
+  return handles;
 }
 
 void ReciprocatorEngine::injectScanScript() {
@@ -299,84 +453,12 @@ void ReciprocatorEngine::injectScanScript() {
     return;
   }
 
-  QString handlesJs = buildTargetHandlesJs();
-
-  QString script = QString(R"JS(
-(function() {
-    const targets = new Set(%1);
-    if (targets.size === 0) return;
-
-    const skipPaths = ['home','explore','search','notifications','messages',
-        'settings','i','compose','login','signup','tos','privacy','help',
-        'about','jobs','premium','lists'];
-
-    const articles = document.querySelectorAll('article[data-testid="tweet"]');
-    for (let idx = 0; idx < articles.length; idx++) {
-        const article = articles[idx];
-        const likeBtn = article.querySelector('[data-testid="like"]');
-        if (!likeBtn) continue;
-
-        const links = article.querySelectorAll('a[href]');
-        let author = '';
-        for (const link of links) {
-            const href = link.getAttribute('href');
-            if (!href) continue;
-            const match = href.match(/^\/([a-zA-Z0-9_]+)$/);
-            if (!match) continue;
-            const username = match[1].toLowerCase();
-            if (skipPaths.includes(username)) continue;
-            author = username;
-            break;
-        }
-
-        if (author && targets.has(author)) {
-            // 优化#6: 不做scrollIntoView（太精准不自然），帖子在正常滚动中已在视口附近
-            try {
-                window.chrome.webview.postMessage(JSON.stringify({
-                    type: 'reciprocate_target',
-                    handle: author,
-                    index: idx
-                }));
-            } catch(e) {}
-            return;
-        }
-    }
-})();
-)JS")
-                       .arg(handlesJs);
-
-  m_browser->ExecuteJavaScript(script);
+  m_browser->Invoke("recip.scan", {buildTargetHandles()});
 }
 
 void ReciprocatorEngine::injectLikeScript(int articleIndex) {
   // 优化#3: 模拟鼠标hover效果后再点击
-  QString script = QString(R"JS(
-(function() {
-    const articles = document.querySelectorAll('article[data-testid="tweet"]');
-    if (%1 < articles.length) {
-        const likeBtn = articles[%1].querySelector('[data-testid="like"]');
-        if (likeBtn) {
-            // 先触发hover效果
-            likeBtn.dispatchEvent(new MouseEvent('mouseenter', {bubbles: true}));
-            likeBtn.dispatchEvent(new MouseEvent('mouseover', {bubbles: true}));
-            // 短暂停顿后点击 (200-500ms)
-            const delay = 200 + Math.random() * 300;
-            setTimeout(() => {
-                likeBtn.click();
-                likeBtn.dispatchEvent(new MouseEvent('mouseleave', {bubbles: true}));
-                try {
-                    window.chrome.webview.postMessage(JSON.stringify({
-                        type: 'like_clicked'
-                    }));
-                } catch(e) {}
-            }, delay);
-        }
-    }
-})();
-)JS")
-                       .arg(articleIndex);
-
-  m_browser->ExecuteJavaScript(script);
+  m_browser->Invoke("recip.like", {articleIndex});
 }
 
 void ReciprocatorEngine::injectClickMoreScript() {
@@ -387,77 +469,7 @@ void ReciprocatorEngine::injectClickMoreScript() {
   // 必须确保真正回到顶部(scrollY=0)，按钮才会出现
   emit statusMessage(QString::fromUtf8("⬆️ 滚动到顶部等待新帖子..."));
 
-  QString script = R"JS(
-(function() {
-    // 第一步：强制立即滚到最顶部
-    window.scrollTo(0, 0);
-    document.documentElement.scrollTop = 0;
-    document.body.scrollTop = 0;
-
-    let attempts = 0;
-    const maxAttempts = 10; // 10次 x 2秒 = 最多20秒
-    const checkInterval = 2000;
-
-    function ensureAtTop() {
-        // 每次检查前都确保在最顶部
-        if (window.scrollY > 5) {
-            window.scrollTo(0, 0);
-            document.documentElement.scrollTop = 0;
-            document.body.scrollTop = 0;
-            console.log('[XSocialLedger] Force scroll to top, was at: ' + window.scrollY);
-        }
-    }
-
-    function tryClickMore() {
-        attempts++;
-        ensureAtTop();
-
-        try {
-            const cells = document.querySelectorAll('[data-testid="cellInnerDiv"]');
-            for (const cell of cells) {
-                const text = cell.textContent || '';
-                if (/show.*post|显示.*帖|条新帖|新的帖子|new post/i.test(text)) {
-                    const btn = cell.querySelector('[role="button"]') || cell.querySelector('button');
-                    if (btn) {
-                        btn.click();
-                        console.log('[XSocialLedger] Auto-clicked: Show new posts (attempt ' + attempts + ')');
-                        try {
-                            window.chrome.webview.postMessage(JSON.stringify({
-                                type: 'more_clicked', attempts: attempts
-                            }));
-                        } catch(e) {}
-                        return;
-                    }
-                    cell.click();
-                    console.log('[XSocialLedger] Auto-clicked cell: Show new posts (attempt ' + attempts + ')');
-                    try {
-                        window.chrome.webview.postMessage(JSON.stringify({
-                            type: 'more_clicked', attempts: attempts
-                        }));
-                    } catch(e) {}
-                    return;
-                }
-            }
-        } catch(e) {}
-
-        if (attempts < maxAttempts) {
-            setTimeout(tryClickMore, checkInterval);
-        } else {
-            console.log('[XSocialLedger] More button not found after ' + maxAttempts + ' attempts');
-            try {
-                window.chrome.webview.postMessage(JSON.stringify({
-                    type: 'more_timeout'
-                }));
-            } catch(e) {}
-        }
-    }
-
-    // 等1秒确保DOM更新后开始检查
-    setTimeout(tryClickMore, 1000);
-})();
-)JS";
-
-  m_browser->ExecuteJavaScript(script);
+  m_browser->Invoke("recip.clickMore");
 }
 
 void ReciprocatorEngine::onWebMessage(const QString &message) {
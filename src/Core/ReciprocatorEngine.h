@@ -1,6 +1,8 @@
 #ifndef RECIPROCATORENGINE_H
 #define RECIPROCATORENGINE_H
 
+#include "App/Scheduler.h"
+#include <QJsonArray>
 #include <QMap>
 #include <QObject>
 #include <QPair>
@@ -8,14 +10,15 @@
 #include <QTimer>
 
 class WebView2Widget;
-class DataStorage;
+class LedgerStore;
+class AppConfig;
 
 // 自动回馈引擎 - 模拟真人在首页时间线浏览并自动点赞回馈
 class ReciprocatorEngine : public QObject {
   Q_OBJECT
 
 public:
-  explicit ReciprocatorEngine(WebView2Widget *browser, DataStorage *storage,
+  explicit ReciprocatorEngine(WebView2Widget *browser, LedgerStore *storage,
                               QObject *parent = nullptr);
   ~ReciprocatorEngine();
 
@@ -31,12 +34,19 @@ public:
   void setBrowseRestCycle(int browseMinMin, int browseMaxMin, int restMinMin,
                           int restMaxMin);
 
+  // 从 AppConfig 读取回馈参数并跟随其变化
+  void setConfig(AppConfig *config);
+
+  // 当前浏览/休息周期剩余毫秒（无周期时为 0）
+  qint64 sessionRemainingMs() const;
+
 signals:
   void statusMessage(const QString &message);
   void likedUser(const QString &handle, const QString &actionId);
   void
   browsingStateChanged(const QString &state); // "browsing", "resting", "idle"
-  void sessionCountdown(int secondsRemaining);
+  // 浏览/休息周期截止时间被设置或清除
+  void countdownChanged();
   void batchFinished();
 
 private slots:
@@ -60,13 +70,17 @@ private:
   void injectClickMoreScript();
   void startBrowseSession();
   void startRestSession();
+  void scheduleSessionEnd(int seconds);
+  void onSessionTimeout();
   int randomInRange(int minVal, int maxVal);
-  QString buildTargetHandlesJs();
+  QJsonArray buildTargetHandles();
 
   WebView2Widget *m_browser;
-  DataStorage *m_storage;
+  LedgerStore *m_storage;
+  AppConfig *m_config;
   State m_state;
   bool m_browsing;
+  Scheduler *m_scheduler;
 
   // 目标用户
   QMap<QString, QString> m_targetMap; // handle -> actionId
@@ -74,12 +88,10 @@ private:
 
   // 定时器
   QTimer *m_scrollTimer;    // 滚动定时器
-  QTimer *m_sessionTimer;   // 浏览/休息周期定时器
-  QTimer *m_countdownTimer; // 倒计时显示
+  Scheduler::TimerId m_sessionTimer; // 浏览/休息周期截止
   QTimer *m_clickMoreTimer; // 自动点击More
 
   int m_scrollCount;
-  int m_countdownRemaining;
 
   // 可配置参数
   int m_scrollMinSec;   // 滚动间隔最小(秒) 默认5
@@ -0,0 +1,566 @@
+#include "ArrowExporter.h"
+#include "App/MemoryAccounting.h"
+#include "App/Trace.h"
+#include "LedgerStore.h"
+#include <QDateTime>
+#include <QHash>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// ==================== 极简 FlatBuffers ====================
+//
+// 从前往后写：表之后紧跟它引用的子对象（uoffset 只能指向更高地址），
+// vtable 放在表之前。只覆盖 Arrow 元数据用到的字段类型。
+
+class FbTable {
+public:
+  FbTable &i8(int id, qint8 v) { return scalar(id, quint8(v), 1); }
+  FbTable &u8(int id, quint8 v) { return scalar(id, v, 1); }
+  FbTable &boolean(int id, bool v) { return scalar(id, v ? 1 : 0, 1); }
+  FbTable &i16(int id, qint16 v) { return scalar(id, quint16(v), 2); }
+  FbTable &i32(int id, qint32 v) { return scalar(id, quint32(v), 4); }
+  FbTable &i64(int id, qint64 v) { return scalar(id, quint64(v), 8); }
+
+  FbTable &table(int id, const FbTable &t) {
+    Field f{id, Field::Table, 4, 0, {}, {t}, 0};
+    m_fields.push_back(f);
+    return *this;
+  }
+  FbTable &string(int id, const QString &s) {
+    Field f{id, Field::String, 4, 0, s.toUtf8(), {}, 0};
+    m_fields.push_back(f);
+    return *this;
+  }
+  FbTable &tables(int id, const std::vector<FbTable> &ts) {
+    Field f{id, Field::TableVector, 4, 0, {}, ts, 0};
+    m_fields.push_back(f);
+    return *this;
+  }
+  // 8 字节对齐的结构体数组（Block / FieldNode / Buffer）
+  FbTable &structs(int id, const QByteArray &data, int count) {
+    Field f{id, Field::StructVector, 4, 0, data, {}, count};
+    m_fields.push_back(f);
+    return *this;
+  }
+
+private:
+  friend class FbWriter;
+
+  struct Field {
+    enum Kind { Scalar, Table, String, TableVector, StructVector };
+    int id;
+    Kind kind;
+    int size; // 表内占用字节，也是对齐
+    quint64 value;
+    QByteArray bytes;
+    std::vector<FbTable> tables;
+    int count;
+  };
+
+  FbTable &scalar(int id, quint64 v, int size) {
+    Field f{id, Field::Scalar, size, v, {}, {}, 0};
+    m_fields.push_back(f);
+    return *this;
+  }
+
+  std::vector<Field> m_fields;
+};
+
+class FbWriter {
+public:
+  // 根表序列化，结果长度补齐到 8 的倍数
+  QByteArray finish(const FbTable &root) {
+    m_buf.clear();
+    m_buf.append(4, '\0');
+    patch(0, quint32(writeTable(root)));
+    align(8);
+    return m_buf;
+  }
+
+private:
+  void align(int a) {
+    while (m_buf.size() % a)
+      m_buf.append('\0');
+  }
+  void put(quint64 v, int size) {
+    char le[8];
+    qToLittleEndian(v, le);
+    m_buf.append(le, size);
+  }
+  void putAt(int at, quint64 v, int size) {
+    char le[8];
+    qToLittleEndian(v, le);
+    memcpy(m_buf.data() + at, le, size);
+  }
+  void patch(int at, quint32 v) { putAt(at, v, 4); }
+
+  int writeTable(const FbTable &t) {
+    const auto &fields = t.m_fields;
+
+    // 表内布局：soffset 之后按大小降序排列字段，减少填充
+    std::vector<int> order(fields.size());
+    for (size_t i = 0; i < order.size(); i++)
+      order[i] = int(i);
+    std::stable_sort(order.begin(), order.end(), [&fields](int a, int b) {
+      return fields[a].size > fields[b].size;
+    });
+    std::vector<int> offsets(fields.size());
+    int cursor = 4;
+    int maxId = -1;
+    for (int i : order) {
+      int size = fields[i].size;
+      cursor = (cursor + size - 1) / size * size;
+      offsets[i] = cursor;
+      cursor += size;
+      maxId = qMax(maxId, fields[i].id);
+    }
+    int inlineSize = cursor;
+
+    align(2);
+    int vtable = m_buf.size();
+    put(4 + 2 * (maxId + 1), 2);
+    put(inlineSize, 2);
+    for (int id = 0; id <= maxId; id++) {
+      int off = 0;
+      for (size_t i = 0; i < fields.size(); i++) {
+        if (fields[i].id == id)
+          off = offsets[i];
+      }
+      put(off, 2);
+    }
+
+    // 表起点按 8 对齐，表内偏移即绝对对齐
+    align(8);
+    int table = m_buf.size();
+    put(quint32(table - vtable), 4);
+    m_buf.append(inlineSize - 4, '\0');
+    for (size_t i = 0; i < fields.size(); i++) {
+      if (fields[i].kind == FbTable::Field::Scalar)
+        putAt(table + offsets[i], fields[i].value, fields[i].size);
+    }
+
+    for (size_t i = 0; i < fields.size(); i++) {
+      const auto &f = fields[i];
+      if (f.kind == FbTable::Field::Scalar)
+        continue;
+      int at = table + offsets[i];
+      int child = writeChild(f);
+      patch(at, quint32(child - at));
+    }
+    return table;
+  }
+
+  int writeChild(const FbTable::Field &f) {
+    switch (f.kind) {
+    case FbTable::Field::Table:
+      return writeTable(f.tables.front());
+    case FbTable::Field::String: {
+      align(4);
+      int pos = m_buf.size();
+      put(quint32(f.bytes.size()), 4);
+      m_buf.append(f.bytes);
+      m_buf.append('\0');
+      return pos;
+    }
+    case FbTable::Field::TableVector: {
+      align(4);
+      int pos = m_buf.size();
+      put(quint32(f.tables.size()), 4);
+      int slots = m_buf.size();
+      m_buf.append(int(f.tables.size()) * 4, '\0');
+      for (size_t i = 0; i < f.tables.size(); i++) {
+        int slot = slots + int(i) * 4;
+        int child = writeTable(f.tables[i]);
+        patch(slot, quint32(child - slot));
+      }
+      return pos;
+    }
+    case FbTable::Field::StructVector: {
+      // 长度字段之后的元素需 8 对齐
+      align(4);
+      if ((m_buf.size() + 4) % 8)
+        m_buf.append(4, '\0');
+      int pos = m_buf.size();
+      put(quint32(f.count), 4);
+      m_buf.append(f.bytes);
+      return pos;
+    }
+    case FbTable::Field::Scalar:
+      break;
+    }
+    return 0;
+  }
+
+  QByteArray m_buf;
+};
+
+// ==================== Arrow 元数据 ====================
+
+// Schema.fbs / Message.fbs 中的枚举值
+const qint16 kMetadataV5 = 4;
+const quint8 kTypeInt = 2;
+const quint8 kTypeUtf8 = 5;
+const quint8 kTypeBool = 6;
+const quint8 kTypeTimestamp = 10;
+const quint8 kHeaderSchema = 1;
+const quint8 kHeaderDictionaryBatch = 2;
+const quint8 kHeaderRecordBatch = 3;
+const qint16 kTimeUnitMillisecond = 1;
+
+const qint64 kHandleDictId = 0;
+const qint64 kTypeDictId = 1;
+
+void appendLe(QByteArray &out, quint64 v, int size) {
+  char le[8];
+  qToLittleEndian(v, le);
+  out.append(le, size);
+}
+
+void padTo8(QByteArray &out) {
+  while (out.size() % 8)
+    out.append('\0');
+}
+
+FbTable intType(int bitWidth) {
+  return FbTable().i32(0, bitWidth).boolean(1, true);
+}
+
+FbTable field(const QString &name, bool nullable, quint8 typeType,
+              const FbTable &type) {
+  FbTable f;
+  f.string(0, name).boolean(1, nullable).u8(2, typeType).table(3, type);
+  f.tables(5, {}); // children 不能缺省
+  return f;
+}
+
+FbTable dictField(const QString &name, qint64 dictId, int indexBits) {
+  FbTable f = field(name, false, kTypeUtf8, FbTable());
+  f.table(4, FbTable()
+                 .i64(0, dictId)
+                 .table(1, intType(indexBits))
+                 .boolean(2, false)
+                 .i16(3, 0));
+  return f;
+}
+
+FbTable schema() {
+  std::vector<FbTable> fields = {
+      dictField("handle", kHandleDictId, 32),
+      field("name", false, kTypeUtf8, FbTable()),
+      dictField("type", kTypeDictId, 8),
+      field("timestamp", true, kTypeTimestamp,
+            FbTable().i16(0, kTimeUnitMillisecond).string(1, "UTC")),
+      field("status_link", false, kTypeUtf8, FbTable()),
+      field("snippet", false, kTypeUtf8, FbTable()),
+      field("reciprocated", false, kTypeBool, FbTable()),
+  };
+  return FbTable().i16(0, 0).tables(1, fields); // little-endian
+}
+
+FbTable message(quint8 headerType, const FbTable &header, qint64 bodyLength) {
+  return FbTable()
+      .i16(0, kMetadataV5)
+      .u8(1, headerType)
+      .table(2, header)
+      .i64(3, bodyLength);
+}
+
+// record batch 的 body 与 nodes/buffers 描述
+class BatchBody {
+public:
+  void node(qint64 length, qint64 nullCount) {
+    appendLe(m_nodes, quint64(length), 8);
+    appendLe(m_nodes, quint64(nullCount), 8);
+    m_nodeCount++;
+  }
+  void buffer(const QByteArray &data) {
+    appendLe(m_buffers, quint64(m_body.size()), 8);
+    appendLe(m_buffers, quint64(data.size()), 8);
+    m_body.append(data);
+    padTo8(m_body);
+    m_bufferCount++;
+  }
+  void emptyBuffer() { buffer(QByteArray()); }
+
+  const QByteArray &body() const { return m_body; }
+  FbTable recordBatch(qint64 length) const {
+    return FbTable()
+        .i64(0, length)
+        .structs(1, m_nodes, m_nodeCount)
+        .structs(2, m_buffers, m_bufferCount);
+  }
+
+private:
+  QByteArray m_body;
+  QByteArray m_nodes;
+  QByteArray m_buffers;
+  int m_nodeCount = 0;
+  int m_bufferCount = 0;
+};
+
+struct Utf8Column {
+  QByteArray offsets;
+  QByteArray data;
+  int count = 0;
+
+  Utf8Column() { appendLe(offsets, 0, 4); }
+  void append(const QString &s) {
+    data.append(s.toUtf8());
+    appendLe(offsets, quint32(data.size()), 4);
+    count++;
+  }
+  void writeTo(BatchBody &body) const {
+    body.node(count, 0);
+    body.emptyBuffer(); // 无 null，省略有效位图
+    body.buffer(offsets);
+    body.buffer(data);
+  }
+  qint64 bytes() const { return offsets.capacity() + data.capacity(); }
+};
+
+void setBit(QByteArray &bitmap, int i) {
+  bitmap[i / 8] = char(quint8(bitmap[i / 8]) | (1u << (i % 8)));
+}
+
+// 一个 record batch 的列缓冲
+struct Batch {
+  QByteArray handles; // int32 字典下标
+  Utf8Column names;
+  QByteArray types; // int8 字典下标
+  QByteArray timestamps;
+  QByteArray tsValid;
+  int tsNulls = 0;
+  Utf8Column links;
+  Utf8Column snippets;
+  QByteArray reciprocated;
+  int rows = 0;
+
+  void append(qint32 handle, qint8 type, const SocialAction &a) {
+    if (rows % 8 == 0) {
+      tsValid.append('\0');
+      reciprocated.append('\0');
+    }
+    appendLe(handles, quint32(handle), 4);
+    names.append(a.userName);
+    types.append(char(type));
+    QDateTime dt = QDateTime::fromString(a.timestamp, Qt::ISODateWithMs);
+    if (dt.isValid()) {
+      appendLe(timestamps, quint64(dt.toMSecsSinceEpoch()), 8);
+      setBit(tsValid, rows);
+    } else {
+      appendLe(timestamps, 0, 8);
+      tsNulls++;
+    }
+    links.append(a.statusLink);
+    snippets.append(a.postSnippet);
+    if (a.reciprocated)
+      setBit(reciprocated, rows);
+    rows++;
+  }
+
+  BatchBody body() const {
+    BatchBody b;
+    b.node(rows, 0);
+    b.emptyBuffer();
+    b.buffer(handles);
+    names.writeTo(b);
+    b.node(rows, 0);
+    b.emptyBuffer();
+    b.buffer(types);
+    b.node(rows, tsNulls);
+    if (tsNulls > 0)
+      b.buffer(tsValid);
+    else
+      b.emptyBuffer();
+    b.buffer(timestamps);
+    links.writeTo(b);
+    snippets.writeTo(b);
+    b.node(rows, 0);
+    b.emptyBuffer();
+    b.buffer(reciprocated);
+    return b;
+  }
+
+  qint64 bytes() const {
+    return handles.capacity() + names.bytes() + types.capacity() +
+           timestamps.capacity() + tsValid.capacity() + links.bytes() +
+           snippets.bytes() + reciprocated.capacity();
+  }
+};
+
+class IpcFileWriter {
+public:
+  explicit IpcFileWriter(QSaveFile *file) : m_file(file), m_pos(0) {}
+
+  bool begin() { return raw(QByteArray("ARROW1\0\0", 8)); }
+
+  bool writeSchema() {
+    return writeMessage(message(kHeaderSchema, schema(), 0), QByteArray(),
+                        nullptr);
+  }
+
+  bool writeDictionary(qint64 id, const Utf8Column &values) {
+    BatchBody body;
+    values.writeTo(body);
+    FbTable batch = FbTable()
+                        .i64(0, id)
+                        .table(1, body.recordBatch(values.count))
+                        .boolean(2, false);
+    return writeMessage(message(kHeaderDictionaryBatch, batch,
+                                body.body().size()),
+                        body.body(), &m_dictionaryBlocks);
+  }
+
+  bool writeBatch(const Batch &batch) {
+    BatchBody body = batch.body();
+    return writeMessage(message(kHeaderRecordBatch,
+                                body.recordBatch(batch.rows),
+                                body.body().size()),
+                        body.body(), &m_batchBlocks);
+  }
+
+  bool finish() {
+    // 流结束标记，之后是 footer（含 schema 与各块位置）
+    QByteArray eos;
+    appendLe(eos, 0xFFFFFFFFu, 4);
+    appendLe(eos, 0, 4);
+    if (!raw(eos))
+      return false;
+
+    FbTable footer = FbTable()
+                         .i16(0, kMetadataV5)
+                         .table(1, schema())
+                         .structs(2, m_dictionaryBlocks.bytes,
+                                  m_dictionaryBlocks.count)
+                         .structs(3, m_batchBlocks.bytes, m_batchBlocks.count);
+    QByteArray fb = FbWriter().finish(footer);
+    QByteArray tail;
+    appendLe(tail, quint32(fb.size()), 4);
+    tail.append("ARROW1", 6);
+    return raw(fb) && raw(tail);
+  }
+
+private:
+  struct Blocks {
+    QByteArray bytes;
+    int count = 0;
+  };
+
+  bool raw(const QByteArray &data) {
+    if (m_file->write(data) != data.size())
+      return false;
+    m_pos += data.size();
+    return true;
+  }
+
+  // 封装消息: 0xFFFFFFFF | int32 元数据长度 | 元数据 | body
+  bool writeMessage(const FbTable &msg, const QByteArray &body,
+                    Blocks *blocks) {
+    QByteArray meta = FbWriter().finish(msg);
+    qint64 offset = m_pos;
+    QByteArray prefix;
+    appendLe(prefix, 0xFFFFFFFFu, 4);
+    appendLe(prefix, quint32(meta.size()), 4);
+    if (!raw(prefix) || !raw(meta) || !raw(body))
+      return false;
+    if (blocks) {
+      // struct Block { long offset; int metaDataLength; long bodyLength; }
+      appendLe(blocks->bytes, quint64(offset), 8);
+      appendLe(blocks->bytes, quint32(8 + meta.size()), 4);
+      appendLe(blocks->bytes, 0, 4);
+      appendLe(blocks->bytes, quint64(body.size()), 8);
+      blocks->count++;
+    }
+    return true;
+  }
+
+  QSaveFile *m_file;
+  qint64 m_pos;
+  Blocks m_dictionaryBlocks;
+  Blocks m_batchBlocks;
+};
+
+} // namespace
+
+qint64 ArrowExporter::write(const LedgerStore *store, const QString &filePath,
+                            QString *error) {
+  XSL_TRACE_SCOPE("ArrowExporter::write");
+  auto fail = [error](const QString &message) {
+    if (error)
+      *error = message;
+    return qint64(-1);
+  };
+
+  // 第一遍：只收集字典，按首次出现的顺序编号
+  QHash<QString, qint32> handleIndex;
+  QHash<QString, qint8> typeIndex;
+  Utf8Column handleDict;
+  Utf8Column typeDict;
+  bool tooManyTypes = false;
+  store->scan([&](const SocialAction &a) {
+    if (!handleIndex.contains(a.userHandle)) {
+      handleIndex.insert(a.userHandle, handleDict.count);
+      handleDict.append(a.userHandle);
+    }
+    if (!typeIndex.contains(a.type)) {
+      if (typeDict.count == 127) {
+        tooManyTypes = true;
+        return false;
+      }
+      typeIndex.insert(a.type, qint8(typeDict.count));
+      typeDict.append(a.type);
+    }
+    return true;
+  });
+  if (tooManyTypes)
+    return fail("too many distinct record types for an int8 enum");
+
+  // 字典 + 当前批次的列缓冲；批次写出时的峰值最大
+  qint64 dictBytes = handleDict.bytes() + typeDict.bytes() +
+                     handleIndex.size() * (MemoryAccounting::kHashEntryBytes +
+                                           qint64(sizeof(QString)));
+  MemoryAccounting::Charge charge("export", dictBytes);
+
+  QSaveFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly))
+    return fail(file.errorString());
+
+  IpcFileWriter writer(&file);
+  if (!writer.begin() || !writer.writeSchema() ||
+      !writer.writeDictionary(kHandleDictId, handleDict) ||
+      !writer.writeDictionary(kTypeDictId, typeDict))
+    return fail(file.errorString());
+
+  // 第二遍：逐批写出
+  qint64 rows = 0;
+  bool ok = true;
+  Batch batch;
+  store->scan([&](const SocialAction &a) {
+    auto h = handleIndex.constFind(a.userHandle);
+    auto t = typeIndex.constFind(a.type);
+    if (h == handleIndex.constEnd() || t == typeIndex.constEnd())
+      return true; // 两遍之间新增的记录，下次导出再包含
+    batch.append(*h, *t, a);
+    rows++;
+    if (batch.rows == kBatchRows) {
+      charge.resize(dictBytes + batch.bytes());
+      ok = writer.writeBatch(batch);
+      batch = Batch();
+    }
+    return ok;
+  });
+  if (ok && batch.rows > 0) {
+    charge.resize(dictBytes + batch.bytes());
+    ok = writer.writeBatch(batch);
+  }
+  if (!ok || !writer.finish())
+    return fail(file.errorString());
+  if (!file.commit())
+    return fail(file.errorString());
+  return rows;
+}
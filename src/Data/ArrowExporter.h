@@ -0,0 +1,27 @@
+#ifndef ARROWEXPORTER_H
+#define ARROWEXPORTER_H
+
+#include <QString>
+
+class LedgerStore;
+
+// 列式导出 - Apache Arrow IPC 文件格式 (Feather v2)，pandas / polars /
+// DuckDB 可直接内存映射读取
+//
+// 列: handle (字典编码 utf8), name, type (字典编码, int8 枚举),
+//     timestamp (毫秒, UTC, 无效为 null), status_link, snippet,
+//     reciprocated (bool)
+//
+// 扫描存储两遍：第一遍只收集两个字典，第二遍每 kBatchRows 行写出一个
+// record batch，内存占用与批大小而非账本大小成正比。FlatBuffers 元数据
+// 手写序列化，不引入 Arrow 库。
+class ArrowExporter {
+public:
+  static const int kBatchRows = 65536;
+
+  // 返回写出的行数，失败返回 -1 并设置 error
+  static qint64 write(const LedgerStore *store, const QString &filePath,
+                      QString *error = nullptr);
+};
+
+#endif // ARROWEXPORTER_H
@@ -0,0 +1,49 @@
+#include "DataStorageBackend.h"
+#include "DataStorage.h"
+
+DataStorageBackend::DataStorageBackend(QObject *parent)
+    : LedgerStore(parent), m_storage(new DataStorage(this)) {}
+
+bool DataStorageBackend::addAction(const SocialAction &action) {
+  return m_storage->addAction(action);
+}
+
+QList<SocialAction> DataStorageBackend::loadLikes() const {
+  return m_storage->loadLikes();
+}
+
+QList<SocialAction> DataStorageBackend::loadReplies() const {
+  return m_storage->loadReplies();
+}
+
+void DataStorageBackend::markReciprocated(const QString &actionId,
+                                          bool reciprocated) {
+  m_storage->markReciprocated(actionId, reciprocated);
+}
+
+int DataStorageBackend::removeByHandle(const QString &handle) {
+  return m_storage->removeByHandle(handle);
+}
+
+void DataStorageBackend::setSelfHandle(const QString &handle) {
+  m_storage->setSelfHandle(handle);
+}
+
+QList<SocialAction>
+DataStorageBackend::getReciprocatedByDate(const QDate &date) const {
+  return m_storage->getReciprocatedByDate(date);
+}
+
+int DataStorageBackend::likeCount() const { return m_storage->likeCount(); }
+
+int DataStorageBackend::replyCount() const { return m_storage->replyCount(); }
+
+int DataStorageBackend::pendingLikeCount() const {
+  return m_storage->pendingLikeCount();
+}
+
+int DataStorageBackend::pendingReplyCount() const {
+  return m_storage->pendingReplyCount();
+}
+
+void DataStorageBackend::flush() { m_storage->flush(); }
@@ -0,0 +1,36 @@
+#ifndef DATASTORAGEBACKEND_H
+#define DATASTORAGEBACKEND_H
+
+#include "LedgerStore.h"
+
+class DataStorage;
+
+// 原有 DataStorage 作为 LedgerStore 的一个后端，逐个方法转发
+class DataStorageBackend : public LedgerStore {
+  Q_OBJECT
+
+public:
+  explicit DataStorageBackend(QObject *parent = nullptr);
+
+  QString backendName() const override { return "datastorage"; }
+
+  bool addAction(const SocialAction &action) override;
+  QList<SocialAction> loadLikes() const override;
+  QList<SocialAction> loadReplies() const override;
+  void markReciprocated(const QString &actionId, bool reciprocated) override;
+  int removeByHandle(const QString &handle) override;
+  void setSelfHandle(const QString &handle) override;
+  QList<SocialAction> getReciprocatedByDate(const QDate &date) const override;
+
+  int likeCount() const override;
+  int replyCount() const override;
+  int pendingLikeCount() const override;
+  int pendingReplyCount() const override;
+
+  void flush() override;
+
+private:
+  DataStorage *m_storage;
+};
+
+#endif // DATASTORAGEBACKEND_H
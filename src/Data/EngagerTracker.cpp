@@ -0,0 +1,305 @@
+#include "EngagerTracker.h"
+#include "App/MemoryAccounting.h"
+#include "App/Trace.h"
+#include <QDateTime>
+#include <QVector>
+#include <algorithm>
+
+namespace {
+const qint64 kMinute = 60 * 1000;
+const qint64 kHour = 60 * kMinute;
+const qint64 kDay = 24 * kHour;
+} // namespace
+
+QList<EngagerTracker::WindowSpec> EngagerTracker::defaultWindows() {
+  return {{"1h", kMinute, 60},
+          {"24h", kHour, 24},
+          {"7d", 6 * kHour, 28},
+          {"30d", kDay, 30}};
+}
+
+EngagerTracker::EngagerTracker(QObject *parent,
+                               const QList<WindowSpec> &windows,
+                               int bucketCapacity, int exactTopK)
+    : QObject(parent), m_specs(windows), m_capacity(qMax(8, bucketCapacity)),
+      m_exactK(qMax(0, exactTopK)) {
+  for (const WindowSpec &spec : m_specs) {
+    Window w;
+    w.spec = spec;
+    w.ring.resize(spec.buckets);
+    m_windows.append(w);
+  }
+
+  // 计数器的键与 m_names 共享同一份字符串数据，只算节点
+  MemoryAccounting::instance()->addSource("engagers", this, [this]() {
+    const qint64 entry = MemoryAccounting::kHashEntryBytes +
+                         qint64(sizeof(QString) + sizeof(Counter));
+    MemoryUsage usage;
+    for (const Window &w : m_windows) {
+      usage.bytes += w.ring.size() * qint64(sizeof(Bucket));
+      for (const Bucket &b : w.ring) {
+        usage.bytes += b.counters.size() * entry;
+        usage.objects += b.counters.size();
+      }
+      const qint64 exact =
+          MemoryAccounting::kHashEntryBytes +
+          qint64(sizeof(QString) + sizeof(Exact)) +
+          w.spec.buckets * qint64(sizeof(qint64) + sizeof(int));
+      usage.bytes += w.exact.size() * exact;
+      usage.objects += w.exact.size();
+    }
+    for (auto it = m_names.constBegin(); it != m_names.constEnd(); ++it) {
+      usage.bytes += MemoryAccounting::kHashEntryBytes +
+                     qint64(sizeof(QString)) * 2 +
+                     (it.key().size() + it.value().size()) *
+                         qint64(sizeof(QChar));
+    }
+    return usage;
+  });
+}
+
+void EngagerTracker::clear() {
+  for (Window &w : m_windows) {
+    for (Bucket &b : w.ring) {
+      b.index = -1;
+      b.counters.clear();
+    }
+    w.exact.clear();
+  }
+  m_names.clear();
+}
+
+void EngagerTracker::rebuild(const QList<SocialAction> &actions) {
+  XSL_TRACE_SCOPE("EngagerTracker::rebuild");
+  clear();
+  // 按时间先后重放：历史是点赞、回复分别加载后拼起来的，乱序时新跟踪的
+  // handle 只能补齐当前桶之前的桶，之后的桶里已有的计数就丢了
+  QVector<QPair<qint64, int>> order; // 时间戳, 下标
+  order.reserve(actions.size());
+  for (int i = 0; i < actions.size(); i++) {
+    QDateTime dt =
+        QDateTime::fromString(actions[i].timestamp, Qt::ISODateWithMs);
+    if (dt.isValid())
+      order.append({dt.toMSecsSinceEpoch(), i});
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [](const auto &a, const auto &b) {
+                     return a.first < b.first;
+                   });
+  for (const auto &entry : order) {
+    apply(actions[entry.second], entry.first);
+  }
+  emit updated();
+}
+
+bool EngagerTracker::add(const SocialAction &action) {
+  QDateTime dt = QDateTime::fromString(action.timestamp, Qt::ISODateWithMs);
+  if (!dt.isValid() || !apply(action, dt.toMSecsSinceEpoch()))
+    return false;
+  emit updated();
+  return true;
+}
+
+bool EngagerTracker::apply(const SocialAction &action, qint64 ms) {
+  if (action.type != QLatin1String("like") &&
+      action.type != QLatin1String("reply"))
+    return false;
+  if (action.userHandle.isEmpty())
+    return false;
+
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  QString handle = action.userHandle.toLower();
+  if (!action.userName.isEmpty())
+    m_names[handle] = action.userName;
+
+  for (Window &w : m_windows) {
+    // 超出窗口的历史记录直接跳过
+    if (ms <= now - w.spec.spanMs())
+      continue;
+    qint64 index = ms / w.spec.bucketMs;
+    Bucket &bucket = w.ring[int(index % w.spec.buckets)];
+    if (bucket.index != index) {
+      if (bucket.index > index)
+        continue; // 槽位已被更新的桶占用，这条已滑出窗口
+      bucket.index = index;
+      bucket.counters.clear();
+    }
+    offer(bucket, handle);
+    track(w, handle, index);
+  }
+  return true;
+}
+
+void EngagerTracker::offer(Bucket &bucket, const QString &handle) {
+  auto it = bucket.counters.find(handle);
+  if (it != bucket.counters.end()) {
+    it->count++;
+    return;
+  }
+  if (bucket.counters.size() < m_capacity) {
+    bucket.counters.insert(handle, Counter{1, 0});
+    return;
+  }
+
+  // Space-Saving：顶替计数最小的条目，继承其计数作为误差
+  auto minIt = bucket.counters.begin();
+  for (auto c = bucket.counters.begin(); c != bucket.counters.end(); ++c) {
+    if (c->count < minIt->count)
+      minIt = c;
+  }
+  int evicted = minIt->count;
+  bucket.counters.erase(minIt);
+  bucket.counters.insert(handle, Counter{evicted + 1, evicted});
+}
+
+void EngagerTracker::track(Window &w, const QString &handle, qint64 index) {
+  const int n = w.spec.buckets;
+  auto it = w.exact.find(handle);
+  if (it != w.exact.end()) {
+    Exact &e = *it;
+    if (index < e.since)
+      return; // 开始跟踪之前的桶只有摘要计数
+    int slot = int(index % n);
+    if (e.index[slot] != index) {
+      if (e.index[slot] > index)
+        return;
+      e.index[slot] = index;
+      e.count[slot] = 0;
+    }
+    e.count[slot]++;
+    return;
+  }
+  if (m_exactK == 0)
+    return;
+
+  qint64 oldest = index - n + 1;
+  if (w.exact.size() >= m_exactK) {
+    // 摘要下界超过被跟踪者中最小的精确计数才换人
+    int bound = 0;
+    for (const Bucket &b : w.ring) {
+      if (b.index < oldest || b.index > index)
+        continue;
+      auto c = b.counters.constFind(handle);
+      if (c != b.counters.constEnd())
+        bound += c->count - c->error;
+    }
+    auto weakest = w.exact.end();
+    int weakestCount = 0;
+    for (auto e = w.exact.begin(); e != w.exact.end(); ++e) {
+      int count = exactCount(*e, oldest, index);
+      if (weakest == w.exact.end() || count < weakestCount) {
+        weakest = e;
+        weakestCount = count;
+      }
+    }
+    if (bound <= weakestCount)
+      return;
+    w.exact.erase(weakest);
+  }
+
+  // 从当前桶往回补齐：error 为 0 的条目是精确值，未满的桶里没有该 handle
+  // 说明计数为 0；满桶里没有它、或者条目带误差就停在这里
+  Exact e;
+  e.since = index + 1;
+  e.index.fill(-1, n);
+  e.count.fill(0, n);
+  for (qint64 i = index; i >= oldest; i--) {
+    const Bucket &b = w.ring[int(i % n)];
+    int count = 0;
+    if (b.index == i) {
+      auto c = b.counters.constFind(handle);
+      if (c != b.counters.constEnd()) {
+        if (c->error != 0)
+          break;
+        count = c->count;
+      } else if (b.counters.size() >= m_capacity) {
+        break;
+      }
+    } else if (b.index > i) {
+      break;
+    }
+    e.index[int(i % n)] = i;
+    e.count[int(i % n)] = count;
+    e.since = i;
+  }
+  w.exact.insert(handle, e);
+}
+
+int EngagerTracker::exactCount(const Exact &e, qint64 oldest, qint64 newest) {
+  int total = 0;
+  for (int slot = 0; slot < e.index.size(); slot++) {
+    if (e.index[slot] >= oldest && e.index[slot] <= newest)
+      total += e.count[slot];
+  }
+  return total;
+}
+
+QList<EngagerTracker::Ranked> EngagerTracker::top(int window, int k,
+                                                  qint64 nowMs) const {
+  if (window < 0 || window >= m_windows.size())
+    return {};
+  const Window &w = m_windows[window];
+  if (nowMs < 0)
+    nowMs = QDateTime::currentMSecsSinceEpoch();
+  qint64 newest = nowMs / w.spec.bucketMs;
+  qint64 oldest = newest - w.spec.buckets + 1;
+
+  // 合并窗口内各桶；某桶缺少该 handle 时，其计数上界为该桶的最小计数
+  QHash<QString, Counter> merged;
+  int missingBound = 0;
+  for (const Bucket &b : w.ring) {
+    if (b.index < oldest || b.index > newest || b.counters.isEmpty())
+      continue;
+    int bucketMin = 0;
+    if (b.counters.size() >= m_capacity) {
+      bucketMin = std::min_element(b.counters.begin(), b.counters.end(),
+                                   [](const Counter &a, const Counter &c) {
+                                     return a.count < c.count;
+                                   })
+                      ->count;
+    }
+    missingBound += bucketMin;
+    for (auto it = b.counters.constBegin(); it != b.counters.constEnd(); ++it) {
+      Counter &m = merged[it.key()];
+      m.count += it->count - bucketMin;
+      m.error += it->error - bucketMin;
+    }
+  }
+
+  // 跟踪覆盖整个窗口的 handle 用精确计数代替摘要区间
+  QHash<QString, int> exact;
+  for (auto it = w.exact.constBegin(); it != w.exact.constEnd(); ++it) {
+    if (it->since <= oldest)
+      exact.insert(it.key(), exactCount(*it, oldest, newest));
+  }
+
+  QVector<Ranked> ranked;
+  ranked.reserve(merged.size() + exact.size());
+  for (auto it = merged.constBegin(); it != merged.constEnd(); ++it) {
+    Ranked r;
+    r.handle = it.key();
+    r.name = m_names.value(it.key());
+    auto e = exact.find(it.key());
+    if (e != exact.end()) {
+      r.count = e.value();
+      exact.erase(e);
+    } else {
+      r.count = it->count + missingBound;
+      r.error = qMax(0, it->error + missingBound);
+    }
+    ranked.append(r);
+  }
+  for (auto it = exact.constBegin(); it != exact.constEnd(); ++it) {
+    if (it.value() > 0)
+      ranked.append(Ranked{it.key(), m_names.value(it.key()), it.value(), 0});
+  }
+
+  int n = qMin(qMax(0, k), int(ranked.size()));
+  std::partial_sort(ranked.begin(), ranked.begin() + n, ranked.end(),
+                    [](const Ranked &a, const Ranked &b) {
+                      if (a.count != b.count)
+                        return a.count > b.count;
+                      return a.handle < b.handle;
+                    });
+  return QList<Ranked>(ranked.begin(), ranked.begin() + n);
+}
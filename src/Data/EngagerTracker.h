@@ -0,0 +1,97 @@
+#ifndef ENGAGERTRACKER_H
+#define ENGAGERTRACKER_H
+
+#include "SocialAction.h"
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+// 滑动窗口内的高频互动用户 (heavy hitters)
+//
+// 每个窗口被切成 N 个时间桶，每个桶是一个容量固定的 Space-Saving 摘要
+// (handle -> 计数, 误差上界)。查询时合并窗口内各桶的摘要取前 K 名，不需要
+// 扫描历史记录。error 为 0 的计数是精确值；桶未溢出时所有计数都精确。
+//
+// 另外每个窗口为至多 exactTopK 个 handle 维护逐桶的精确计数：新 handle 的
+// 摘要下界超过被跟踪者中最小的精确计数时替换它，并用仍然精确的摘要计数
+// 补齐之前的桶。跟踪覆盖整个窗口的 handle，top() 给出精确计数。
+//
+// add 的开销：handle 已在桶里或桶有空位时 O(1)；桶满需要顶替时线性扫描
+// 最小计数，O(bucketCapacity)。精确计数对已跟踪的 handle 是 O(1)，未跟踪的
+// handle 争取进入时是 O(buckets + exactTopK)。
+class EngagerTracker : public QObject {
+  Q_OBJECT
+
+public:
+  struct WindowSpec {
+    QString label; // "1h", "24h" ...
+    qint64 bucketMs;
+    int buckets;
+    qint64 spanMs() const { return bucketMs * buckets; }
+  };
+
+  struct Ranked {
+    QString handle;
+    QString name;
+    int count = 0; // 上界
+    int error = 0; // count - error 为下界
+    bool isExact() const { return error == 0; }
+  };
+
+  // 1h / 24h / 7d / 30d
+  static QList<WindowSpec> defaultWindows();
+
+  explicit EngagerTracker(QObject *parent = nullptr,
+                          const QList<WindowSpec> &windows = defaultWindows(),
+                          int bucketCapacity = 256, int exactTopK = 50);
+
+  const QList<WindowSpec> &windows() const { return m_specs; }
+
+  void clear();
+  // Replays actions in timestamp order, whatever order they come in
+  void rebuild(const QList<SocialAction> &actions);
+  // Counts like/reply records; others are ignored
+  bool add(const SocialAction &action);
+
+  // Top k engagers of window `window` as of nowMs (default: current time)
+  QList<Ranked> top(int window, int k, qint64 nowMs = -1) const;
+
+signals:
+  void updated();
+
+private:
+  struct Counter {
+    int count = 0;
+    int error = 0;
+  };
+  struct Bucket {
+    qint64 index = -1; // 绝对桶号 = 时间 / bucketMs
+    QHash<QString, Counter> counters;
+  };
+  // 与 ring 同样按绝对桶号取模；since 及之后的桶计数完整
+  struct Exact {
+    qint64 since = 0;
+    QVector<qint64> index;
+    QVector<int> count;
+  };
+  struct Window {
+    WindowSpec spec;
+    QVector<Bucket> ring;
+    QHash<QString, Exact> exact; // 至多 m_exactK 个
+  };
+
+  bool apply(const SocialAction &action, qint64 ms);
+  void offer(Bucket &bucket, const QString &handle);
+  void track(Window &w, const QString &handle, qint64 index);
+  static int exactCount(const Exact &e, qint64 oldest, qint64 newest);
+
+  QList<WindowSpec> m_specs;
+  QVector<Window> m_windows;
+  int m_capacity;
+  int m_exactK;
+  QHash<QString, QString> m_names; // handle -> 最近显示名
+};
+
+#endif // ENGAGERTRACKER_H
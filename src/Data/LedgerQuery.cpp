@@ -0,0 +1,417 @@
+#include "LedgerQuery.h"
+#include <QAtomicInt>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+
+namespace {
+
+// 只读连接，析构时注销（QSqlQuery 须先于它销毁）
+class ReadConnection {
+public:
+  explicit ReadConnection(const QString &path) {
+    static QAtomicInt serial;
+    m_name = QString("xsl-query-%1").arg(serial.fetchAndAddRelaxed(1));
+    m_db = QSqlDatabase::addDatabase("QSQLITE", m_name);
+    m_db.setDatabaseName(path);
+    m_db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000");
+    if (m_db.open()) {
+      QSqlQuery pragma(m_db);
+      pragma.exec(QString("PRAGMA mmap_size = %1").arg(LedgerQuery::kMmapBytes));
+      pragma.exec("PRAGMA query_only = 1");
+    }
+  }
+  ~ReadConnection() {
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(m_name);
+  }
+
+  bool isOpen() const { return m_db.isOpen(); }
+  QString errorText() const { return m_db.lastError().text(); }
+  const QSqlDatabase &db() const { return m_db; }
+
+private:
+  QString m_name;
+  QSqlDatabase m_db;
+};
+
+struct Filter {
+  QString where; // 以 " AND " 开头的附加条件
+  QVariantList binds;
+};
+
+Filter buildFilter(const LedgerQuerySpec &spec) {
+  Filter f;
+  QStringList types;
+  for (const QString &t : spec.types) {
+    types.append(t);
+    if (t == "like")
+      types.append("list_like");
+  }
+  if (!types.isEmpty()) {
+    QStringList marks;
+    for (const QString &t : types) {
+      marks.append("?");
+      f.binds.append(t);
+    }
+    f.where += " AND type IN (" + marks.join(", ") + ")";
+  }
+  if (!spec.handle.isEmpty()) {
+    QString handle = spec.handle;
+    if (handle.startsWith('@'))
+      handle.remove(0, 1);
+    f.where += " AND handle = ?"; // 列是 NOCASE
+    f.binds.append(handle);
+  }
+  if (spec.since.isValid()) {
+    f.where += " AND ts_ms >= ?";
+    f.binds.append(spec.since.startOfDay().toMSecsSinceEpoch());
+  }
+  if (spec.until.isValid()) {
+    f.where += " AND ts_ms < ?";
+    f.binds.append(spec.until.addDays(1).startOfDay().toMSecsSinceEpoch());
+  }
+  if (spec.state != LedgerQuerySpec::State::Any) {
+    f.where += " AND reciprocated = ?";
+    f.binds.append(spec.state == LedgerQuerySpec::State::Reciprocated ? 1 : 0);
+  }
+  return f;
+}
+
+// 时间桶：本地时区是整点偏移时按小时，否则按 15 分钟
+qint64 bucketMs() {
+  int offset = QDateTime::currentDateTime().offsetFromUtc();
+  return offset % 3600 == 0 ? 3600000 : 900000;
+}
+
+QString groupExpr(const QString &key, qint64 bucket) {
+  if (key == "day" || key == "month")
+    return QString("ts_ms / %1").arg(bucket);
+  return key; // handle / type
+}
+
+QVariant groupValue(const QString &key, const QVariant &raw, qint64 bucket) {
+  if (key == "day" || key == "month") {
+    if (raw.isNull())
+      return QString("undated");
+    QDate d = QDateTime::fromMSecsSinceEpoch(raw.toLongLong() * bucket).date();
+    return d.toString(key == "day" ? "yyyy-MM-dd" : "yyyy-MM");
+  }
+  if (key == "handle")
+    return raw.toString().toLower();
+  return raw.toString();
+}
+
+struct Partition {
+  qint64 lo;
+  qint64 hi; // 不含
+};
+
+struct Partial {
+  struct Cell {
+    QVariantList values;
+    qint64 count = 0;
+    qint64 pending = 0;
+  };
+  QHash<QString, Cell> cells;
+  QString error;
+
+  void merge(const Partial &other) {
+    if (error.isEmpty())
+      error = other.error;
+    for (auto it = other.cells.cbegin(); it != other.cells.cend(); ++it) {
+      Cell &cell = cells[it.key()];
+      if (cell.values.isEmpty())
+        cell.values = it->values;
+      cell.count += it->count;
+      cell.pending += it->pending;
+    }
+  }
+};
+
+bool bindAll(QSqlQuery &q, const QVariantList &binds) {
+  for (int i = 0; i < binds.size(); i++)
+    q.bindValue(i, binds[i]);
+  return q.exec();
+}
+
+bool aggregate(const QString &path, const LedgerQuerySpec &spec,
+               int threads, LedgerQueryResult *result, QString *error) {
+  const Filter filter = buildFilter(spec);
+  const qint64 bucket = bucketMs();
+
+  QStringList exprs;
+  for (const QString &key : spec.groupBy)
+    exprs.append(groupExpr(key, bucket));
+  QString sql = "SELECT ";
+  if (!exprs.isEmpty())
+    sql += exprs.join(", ") + ", ";
+  sql += "COUNT(*), SUM(reciprocated = 0) FROM actions "
+         "WHERE seq >= ? AND seq < ?" +
+         filter.where;
+  if (!exprs.isEmpty())
+    sql += " GROUP BY " + exprs.join(", ");
+
+  // 分区边界：开始时的 seq 范围
+  qint64 minSeq = 0, maxSeq = -1;
+  {
+    ReadConnection conn(path);
+    if (!conn.isOpen()) {
+      *error = conn.errorText();
+      return false;
+    }
+    QSqlQuery q(conn.db());
+    if (!q.exec("SELECT MIN(seq), MAX(seq) FROM actions") || !q.next()) {
+      *error = q.lastError().text();
+      return false;
+    }
+    if (!q.value(0).isNull()) {
+      minSeq = q.value(0).toLongLong();
+      maxSeq = q.value(1).toLongLong();
+    }
+  }
+  QList<Partition> partitions;
+  int parts = qMax(1, threads * 2); // 多于线程数，均衡各分区的过滤率差异
+  qint64 span = maxSeq - minSeq + 1;
+  qint64 step = qMax<qint64>(1, (span + parts - 1) / parts);
+  for (qint64 lo = minSeq; lo <= maxSeq; lo += step)
+    partitions.append({lo, qMin(lo + step, maxSeq + 1)});
+  if (partitions.isEmpty())
+    partitions.append({0, 0});
+  result->partitions = partitions.size();
+
+  auto map = [&path, &sql, &filter, &spec, bucket](const Partition &p) {
+    Partial partial;
+    ReadConnection conn(path);
+    if (!conn.isOpen()) {
+      partial.error = conn.errorText();
+      return partial;
+    }
+    QSqlQuery q(conn.db());
+    q.setForwardOnly(true);
+    if (!q.prepare(sql)) {
+      partial.error = q.lastError().text();
+      return partial;
+    }
+    QVariantList binds = {p.lo, p.hi};
+    binds += filter.binds;
+    if (!bindAll(q, binds)) {
+      partial.error = q.lastError().text();
+      return partial;
+    }
+    const int n = spec.groupBy.size();
+    while (q.next()) {
+      Partial::Cell cell;
+      QStringList key;
+      for (int i = 0; i < n; i++) {
+        QVariant v = groupValue(spec.groupBy[i], q.value(i), bucket);
+        cell.values.append(v);
+        key.append(v.toString());
+      }
+      cell.count = q.value(n).toLongLong();
+      cell.pending = q.value(n + 1).toLongLong();
+      // 同一分区内多个时间桶可能落在同一天，按换算后的键合并
+      Partial::Cell &slot = partial.cells[key.join(QChar(0x1f))];
+      if (slot.values.isEmpty())
+        slot.values = cell.values;
+      slot.count += cell.count;
+      slot.pending += cell.pending;
+    }
+    return partial;
+  };
+  auto reduce = [](Partial &acc, const Partial &part) { acc.merge(part); };
+
+  QThreadPool pool;
+  pool.setMaxThreadCount(qMax(1, threads));
+  Partial total = QtConcurrent::blockingMappedReduced<Partial>(
+      &pool, partitions, map, reduce, QtConcurrent::UnorderedReduce);
+  if (!total.error.isEmpty()) {
+    *error = total.error;
+    return false;
+  }
+
+  result->columns = spec.groupBy;
+  result->columns << "count" << "pending";
+  QList<Partial::Cell> cells = total.cells.values();
+  bool byTime = spec.groupBy.contains("day") || spec.groupBy.contains("month");
+  std::sort(cells.begin(), cells.end(),
+            [byTime](const Partial::Cell &a, const Partial::Cell &b) {
+              if (!byTime && a.count != b.count)
+                return a.count > b.count;
+              for (int i = 0; i < a.values.size(); i++) {
+                int c = a.values[i].toString().compare(b.values[i].toString());
+                if (c != 0)
+                  return c < 0;
+              }
+              return false;
+            });
+  for (const Partial::Cell &cell : cells) {
+    QVariantList row = cell.values;
+    row << cell.count << cell.pending;
+    result->rows.append(row);
+  }
+  if (spec.groupBy.isEmpty() && result->rows.isEmpty())
+    result->rows.append(QVariantList{qint64(0), qint64(0)});
+  return true;
+}
+
+bool list(const QString &path, const LedgerQuerySpec &spec,
+          LedgerQueryResult *result, QString *error) {
+  const Filter filter = buildFilter(spec);
+  ReadConnection conn(path);
+  if (!conn.isOpen()) {
+    *error = conn.errorText();
+    return false;
+  }
+  QSqlQuery q(conn.db());
+  q.setForwardOnly(true);
+  if (!q.prepare("SELECT ts, handle, name, type, reciprocated, "
+                 "(SELECT text FROM snippets WHERE hash = snippet_id), link "
+                 "FROM actions WHERE 1" +
+                 filter.where + " ORDER BY ts_ms DESC LIMIT ?")) {
+    *error = q.lastError().text();
+    return false;
+  }
+  QVariantList binds = filter.binds;
+  binds.append(spec.limit);
+  if (!bindAll(q, binds)) {
+    *error = q.lastError().text();
+    return false;
+  }
+  result->columns = {"timestamp", "handle",  "name", "type",
+                     "reciprocated", "snippet", "link"};
+  result->partitions = 1;
+  while (q.next()) {
+    result->rows.append({q.value(0).toString(), q.value(1).toString(),
+                         q.value(2).toString(), q.value(3).toString(),
+                         q.value(4).toInt() != 0, q.value(5).toString(),
+                         q.value(6).toString()});
+  }
+  return true;
+}
+
+// 终端显示宽度：CJK 等宽字符算 2 列
+int displayWidth(const QString &s) {
+  int w = 0;
+  for (QChar c : s)
+    w += c.unicode() >= 0x2E80 ? 2 : 1;
+  return w;
+}
+
+QString cellText(const QVariant &v) {
+  if (v.typeId() == QMetaType::Bool)
+    return v.toBool() ? "yes" : "no";
+  QString s = v.toString();
+  s.replace('\n', ' ');
+  return s;
+}
+
+bool isNumeric(const QVariant &v) {
+  return v.typeId() == QMetaType::LongLong || v.typeId() == QMetaType::Int;
+}
+
+} // namespace
+
+QString LedgerQuery::defaultLedgerPath() {
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+         "/ledger.sqlite";
+}
+
+bool LedgerQuery::run(const QString &ledgerPath, const LedgerQuerySpec &spec,
+                      int threads, LedgerQueryResult *result, QString *error) {
+  QElapsedTimer timer;
+  timer.start();
+  QString message;
+  bool ok = spec.limit > 0 && spec.groupBy.isEmpty()
+                ? list(ledgerPath, spec, result, &message)
+                : aggregate(ledgerPath, spec, threads, result, &message);
+  result->elapsedMs = timer.elapsed();
+  if (!ok && error)
+    *error = message;
+  return ok;
+}
+
+QString LedgerQueryResult::toTable() const {
+  const int kMaxCell = 60;
+  QList<QStringList> text;
+  QList<int> widths;
+  for (const QString &c : columns)
+    widths.append(displayWidth(c));
+  for (const QVariantList &row : rows) {
+    QStringList cells;
+    for (int i = 0; i < row.size(); i++) {
+      QString s = cellText(row[i]);
+      if (displayWidth(s) > kMaxCell) {
+        while (displayWidth(s) > kMaxCell - 1)
+          s.chop(1);
+        s += QString::fromUtf8("…");
+      }
+      widths[i] = qMax(widths[i], displayWidth(s));
+      cells.append(s);
+    }
+    text.append(cells);
+  }
+
+  auto pad = [&widths](const QString &s, int col, bool right) {
+    QString fill(widths[col] - displayWidth(s), ' ');
+    return right ? fill + s : s + fill;
+  };
+  QString out;
+  QStringList header;
+  for (int i = 0; i < columns.size(); i++)
+    header.append(pad(columns[i], i, false));
+  out += header.join("  ").trimmed() + "\n";
+  QStringList rule;
+  for (int w : widths)
+    rule.append(QString(w, '-'));
+  out += rule.join("  ") + "\n";
+  for (int r = 0; r < text.size(); r++) {
+    QStringList line;
+    for (int i = 0; i < text[r].size(); i++)
+      line.append(pad(text[r][i], i, isNumeric(rows[r][i])));
+    out += line.join("  ") + "\n";
+  }
+  return out;
+}
+
+QString LedgerQueryResult::toCsv() const {
+  auto quote = [](QString s) {
+    if (s.contains(',') || s.contains('"') || s.contains('\n')) {
+      s.replace("\"", "\"\"");
+      s = "\"" + s + "\"";
+    }
+    return s;
+  };
+  QString out = columns.join(",") + "\n";
+  for (const QVariantList &row : rows) {
+    QStringList cells;
+    for (const QVariant &v : row)
+      cells.append(quote(v.typeId() == QMetaType::Bool
+                             ? QString(v.toBool() ? "1" : "0")
+                             : v.toString()));
+    out += cells.join(",") + "\n";
+  }
+  return out;
+}
+
+QString LedgerQueryResult::toJsonLines() const {
+  QString out;
+  for (const QVariantList &row : rows) {
+    QJsonObject obj;
+    for (int i = 0; i < columns.size() && i < row.size(); i++)
+      obj[columns[i]] = QJsonValue::fromVariant(row[i]);
+    out += QString::fromUtf8(QJsonDocument(obj).toJson(QJsonDocument::Compact)) +
+           "\n";
+  }
+  return out;
+}
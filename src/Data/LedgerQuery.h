@@ -0,0 +1,54 @@
+#ifndef LEDGERQUERY_H
+#define LEDGERQUERY_H
+
+#include <QDate>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+// 查询条件（xsl_query 命令行参数直接映射到这里）
+struct LedgerQuerySpec {
+  enum class State { Any, Pending, Reciprocated };
+
+  QStringList types; // 空 = 全部；"like" 包含 list_like
+  QString handle;    // 不区分大小写，可带 @
+  QDate since;       // 本地日期，含
+  QDate until;       // 本地日期，含
+  State state = State::Any;
+  QStringList groupBy; // day / month / handle / type，可组合
+  int limit = 0;       // > 0 且无 groupBy 时列出最新的记录
+};
+
+struct LedgerQueryResult {
+  QStringList columns;
+  QList<QVariantList> rows;
+  int partitions = 0;
+  qint64 elapsedMs = 0;
+
+  QString toTable() const;
+  QString toCsv() const;
+  QString toJsonLines() const;
+};
+
+// 账本离线查询 - 不依赖 GUI，直接只读打开 SQLite 账本文件
+//
+// 只读连接 + mmap；WAL 模式下与正在写入的应用互不阻塞。聚合查询按 seq
+// 切成若干分区，QtConcurrent 在线程池上各开一个连接并行 GROUP BY，
+// 再合并部分结果。seq 上限在开始时确定，查询期间新写入的记录不计入。
+//
+// 按日/月分组时 SQL 只按 UTC 时间桶（整点，或非整点时区按 15 分钟）
+// 聚合，桶到本地日期的换算在合并阶段完成，夏令时也准确。
+class LedgerQuery {
+public:
+  static const qint64 kMmapBytes = 256ll * 1024 * 1024;
+
+  // 与 SqliteLedgerStore::defaultFilePath() 相同（需相同的应用名/组织名）
+  static QString defaultLedgerPath();
+
+  static bool run(const QString &ledgerPath, const LedgerQuerySpec &spec,
+                  int threads, LedgerQueryResult *result,
+                  QString *error = nullptr);
+};
+
+#endif // LEDGERQUERY_H
@@ -0,0 +1,337 @@
+#include "LedgerQueryService.h"
+#include "App/LocalHttpServer.h"
+#include "App/Metrics.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QThread>
+#include <QTimer>
+#include <QUrlQuery>
+#include <climits>
+
+namespace {
+
+HttpResponse jsonResponse(const QJsonObject &obj) {
+  HttpResponse response;
+  response.contentType = "application/json; charset=utf-8";
+  response.body = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+  return response;
+}
+
+// 服务器传来的查询串未解码，取值时才完整解码（%26、%2B 等保持原义）
+QString param(const QUrlQuery &q, const QString &key) {
+  return q.queryItemValue(key, QUrl::FullyDecoded);
+}
+
+HttpResponse errorResponse(int status, const QString &message) {
+  HttpResponse response = jsonResponse(QJsonObject{{"error", message}});
+  response.status = status;
+  return response;
+}
+
+// 视图按时间倒序：第一个早于 ms 的行
+int firstOlderThan(const LedgerView &view, qint64 ms) {
+  int lo = 0, hi = view.size();
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (view.epochMs(mid) >= ms)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// [from, to] 本地日期对应的行区间 [begin, end)
+void dateRange(const LedgerView &view, const QDate &from, const QDate &to,
+               int *begin, int *end) {
+  *begin = to.isValid()
+               ? firstOlderThan(view, to.addDays(1).startOfDay()
+                                          .toMSecsSinceEpoch())
+               : 0;
+  *end = from.isValid()
+             ? firstOlderThan(view, from.startOfDay().toMSecsSinceEpoch())
+             : view.size();
+}
+
+// 游标: 代数:偏移:时间:id，base64url
+QString encodeCursor(const LedgerView &view, int next) {
+  const SocialAction &last = view.at(next - 1);
+  QByteArray raw = QByteArray::number(view.generation()) + ":" +
+                   QByteArray::number(next) + ":" +
+                   QByteArray::number(view.epochMs(next - 1)) + ":" +
+                   last.id.toUtf8();
+  return QString::fromLatin1(raw.toBase64(QByteArray::Base64UrlEncoding |
+                                          QByteArray::OmitTrailingEquals));
+}
+
+// 返回续读的起始行；游标无效返回 -1
+int decodeCursor(const LedgerView &view, const QString &cursor) {
+  QByteArray raw = QByteArray::fromBase64(
+      cursor.toLatin1(),
+      QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals);
+  QList<QByteArray> parts = raw.split(':');
+  if (parts.size() < 4)
+    return -1;
+  bool ok1, ok2, ok3;
+  quint64 generation = parts[0].toULongLong(&ok1);
+  int offset = parts[1].toInt(&ok2);
+  qint64 ms = parts[2].toLongLong(&ok3);
+  QString id = QString::fromUtf8(parts.mid(3).join(':'));
+  if (!ok1 || !ok2 || !ok3)
+    return -1;
+
+  // 同一快照：行号不变
+  if (generation == view.generation() && offset >= 0 && offset <= view.size())
+    return offset;
+
+  // 快照已变：跳过时间更新的行，再在同一时间的行里找到上次的 id
+  int row = ms == LLONG_MIN ? firstOlderThan(view, LLONG_MIN + 1)
+                            : firstOlderThan(view, ms + 1);
+  for (int i = row; i < view.size() && view.epochMs(i) == ms; i++) {
+    if (view.at(i).id == id)
+      return i + 1;
+  }
+  // 上次的记录已不在视图中（例如已回馈），从更早的行继续
+  return ms == LLONG_MIN ? view.size() : firstOlderThan(view, ms);
+}
+
+QJsonObject actionJson(const LedgerView &view, int row) {
+  QJsonObject obj = view.at(row).toJson();
+  qint64 ms = view.epochMs(row);
+  if (ms != LLONG_MIN)
+    obj["epochMs"] = ms;
+  return obj;
+}
+
+Counter *requestCounter(const char *route) {
+  return Metrics::instance()->counter(
+      "xsl_query_requests_total", "Requests served by the local query API",
+      QString("route=\"%1\"").arg(QLatin1String(route)));
+}
+
+} // namespace
+
+LedgerQueryService::LedgerQueryService(LedgerViewCache *views, QObject *parent)
+    : QObject(parent), m_views(views), m_thread(nullptr), m_server(nullptr),
+      m_port(0), m_publishPending(false) {
+  connect(m_views, &LedgerViewCache::changed, this,
+          &LedgerQueryService::schedulePublish);
+}
+
+LedgerQueryService::~LedgerQueryService() { stop(); }
+
+bool LedgerQueryService::start(quint16 port) {
+  if (m_server)
+    return true;
+  publish();
+
+  m_thread = new QThread(this);
+  m_thread->setObjectName("xsl-query-api");
+  m_server = new LocalHttpServer; // 无父对象，随线程结束删除
+  m_server->route("/v1/actions", [this](const QString &query) {
+    return queryActions(query);
+  });
+  m_server->route("/v1/pending",
+                  [this](const QString &) { return queryPending(); });
+  m_server->route("/v1/daily", [this](const QString &query) {
+    return queryDaily(query);
+  });
+  m_server->moveToThread(m_thread);
+  connect(m_thread, &QThread::finished, m_server, &QObject::deleteLater);
+  m_thread->start();
+
+  // listen 必须在服务器所在线程调用
+  bool ok = false;
+  LocalHttpServer *server = m_server;
+  QMetaObject::invokeMethod(
+      server,
+      [server, port, &ok]() {
+        ok = server->listen(port);
+      },
+      Qt::BlockingQueuedConnection);
+  if (!ok) {
+    stop();
+    return false;
+  }
+  m_port = port;
+  qDebug() << "[LedgerQueryService] Serving on 127.0.0.1:" << port;
+  return true;
+}
+
+void LedgerQueryService::stop() {
+  if (!m_thread)
+    return;
+  m_thread->quit();
+  m_thread->wait();
+  delete m_thread;
+  m_thread = nullptr;
+  m_server = nullptr;
+  m_port = 0;
+}
+
+void LedgerQueryService::schedulePublish() {
+  // 连续变更合并为一次发布
+  if (!m_server || m_publishPending)
+    return;
+  m_publishPending = true;
+  QTimer::singleShot(kPublishDelayMs, this, &LedgerQueryService::publish);
+}
+
+void LedgerQueryService::publish() {
+  m_publishPending = false;
+  auto snap = std::make_shared<Snapshot>();
+  snap->likes = m_views->view("like", LedgerViewCache::Filter::All);
+  snap->pendingLikes = m_views->view("like", LedgerViewCache::Filter::Pending);
+  snap->replies = m_views->view("reply", LedgerViewCache::Filter::All);
+  snap->pendingReplies =
+      m_views->view("reply", LedgerViewCache::Filter::Pending);
+  QMutexLocker lock(&m_mutex);
+  m_snapshot = std::move(snap);
+}
+
+std::shared_ptr<const LedgerQueryService::Snapshot>
+LedgerQueryService::snapshot() const {
+  QMutexLocker lock(&m_mutex);
+  return m_snapshot;
+}
+
+// ==================== 请求处理（服务线程） ====================
+
+HttpResponse LedgerQueryService::queryActions(const QString &query) const {
+  static Counter *requests = requestCounter("actions");
+  requests->inc();
+  auto snap = snapshot();
+  if (!snap)
+    return errorResponse(503, "ledger not loaded");
+
+  QUrlQuery q(query);
+  QString type = param(q, "type");
+  if (type.isEmpty())
+    type = "like";
+  if (type != "like" && type != "reply")
+    return errorResponse(400, "type must be like or reply");
+  bool pending = param(q, "pending") == "1";
+  const LedgerView &view =
+      type == "like" ? *(pending ? snap->pendingLikes : snap->likes)
+                     : *(pending ? snap->pendingReplies : snap->replies);
+
+  QDate from = QDate::fromString(param(q, "from"), Qt::ISODate);
+  QDate to = QDate::fromString(param(q, "to"), Qt::ISODate);
+  QString handle = param(q, "handle");
+  bool limitOk = false;
+  int limit = param(q, "limit").toInt(&limitOk);
+  if (!limitOk || limit <= 0)
+    limit = 100;
+  limit = qMin(limit, kMaxPageSize);
+
+  int begin, end;
+  dateRange(view, from, to, &begin, &end);
+  if (q.hasQueryItem("cursor")) {
+    int resume = decodeCursor(view, param(q, "cursor"));
+    if (resume < 0)
+      return errorResponse(400, "invalid cursor");
+    begin = qMax(begin, resume);
+  }
+
+  QJsonArray items;
+  int row = begin;
+  for (; row < end && items.size() < limit; row++) {
+    if (!handle.isEmpty() &&
+        view.at(row).userHandle.compare(handle, Qt::CaseInsensitive) != 0)
+      continue;
+    items.append(actionJson(view, row));
+  }
+
+  QJsonObject obj;
+  obj["generation"] = qint64(view.generation());
+  obj["items"] = items;
+  obj["nextCursor"] =
+      row < end && row > 0 ? QJsonValue(encodeCursor(view, row)) : QJsonValue();
+  return jsonResponse(obj);
+}
+
+HttpResponse LedgerQueryService::queryPending() const {
+  static Counter *requests = requestCounter("pending");
+  requests->inc();
+  auto snap = snapshot();
+  if (!snap)
+    return errorResponse(503, "ledger not loaded");
+
+  QJsonObject obj;
+  obj["likes"] = snap->likes->size();
+  obj["replies"] = snap->replies->size();
+  obj["pendingLikes"] = snap->pendingLikes->size();
+  obj["pendingReplies"] = snap->pendingReplies->size();
+  qint64 dayAgo = QDateTime::currentMSecsSinceEpoch() - 86400000;
+  obj["pendingLikes24h"] = snap->pendingLikes->countSince(dayAgo);
+  obj["pendingReplies24h"] = snap->pendingReplies->countSince(dayAgo);
+  return jsonResponse(obj);
+}
+
+HttpResponse LedgerQueryService::queryDaily(const QString &query) const {
+  static Counter *requests = requestCounter("daily");
+  requests->inc();
+  auto snap = snapshot();
+  if (!snap)
+    return errorResponse(503, "ledger not loaded");
+
+  QUrlQuery q(query);
+  QDate to = QDate::fromString(param(q, "to"), Qt::ISODate);
+  if (!to.isValid())
+    to = QDate::currentDate();
+  QDate from = QDate::fromString(param(q, "from"), Qt::ISODate);
+  if (!from.isValid())
+    from = to.addDays(-29);
+  if (from > to || from.daysTo(to) >= kMaxRollupDays)
+    return errorResponse(400, "date range must be 1 to 366 days");
+
+  struct Day {
+    int likes = 0;
+    int replies = 0;
+    int reciprocatedLikes = 0;
+    int reciprocatedReplies = 0;
+  };
+  QMap<QDate, Day> days;
+  for (QDate d = from; d <= to; d = d.addDays(1))
+    days.insert(d, Day());
+
+  auto tally = [&](const LedgerView &view, bool likes) {
+    int begin, end;
+    dateRange(view, from, to, &begin, &end);
+    for (int row = begin; row < end; row++) {
+      QDate d = QDateTime::fromMSecsSinceEpoch(view.epochMs(row)).date();
+      auto it = days.find(d);
+      if (it == days.end())
+        continue;
+      bool done = view.at(row).reciprocated;
+      if (likes) {
+        it->likes++;
+        it->reciprocatedLikes += done;
+      } else {
+        it->replies++;
+        it->reciprocatedReplies += done;
+      }
+    }
+  };
+  tally(*snap->likes, true);
+  tally(*snap->replies, false);
+
+  QJsonArray rows;
+  for (auto it = days.cbegin(); it != days.cend(); ++it) {
+    rows.append(QJsonObject{
+        {"date", it.key().toString(Qt::ISODate)},
+        {"likes", it->likes},
+        {"replies", it->replies},
+        {"reciprocatedLikes", it->reciprocatedLikes},
+        {"reciprocatedReplies", it->reciprocatedReplies},
+    });
+  }
+  QJsonObject obj;
+  obj["generation"] = qint64(snap->likes->generation());
+  obj["days"] = rows;
+  return jsonResponse(obj);
+}
@@ -0,0 +1,69 @@
+#ifndef LEDGERQUERYSERVICE_H
+#define LEDGERQUERYSERVICE_H
+
+#include "LedgerViewCache.h"
+#include <QMutex>
+#include <QObject>
+#include <memory>
+
+class LocalHttpServer;
+class QThread;
+struct HttpResponse;
+
+// 本机只读查询 API - XSL_QUERY_PORT=端口 启用
+//
+// HTTP 服务在独立线程运行（keep-alive），只读取 GUI 线程发布的不可变
+// 视图快照：LedgerViewCache 变化后合并发布一次，请求线程复制
+// shared_ptr 后无锁遍历，不访问存储，也不阻塞界面和采集写入。
+//
+//   GET /v1/actions?type=like|reply&pending=1&handle=&from=&to=&limit=&cursor=
+//   GET /v1/pending
+//   GET /v1/daily?from=yyyy-MM-dd&to=yyyy-MM-dd
+//
+// 分页用游标：同一快照代数内是行偏移，代数变化后按 (时间, id) 重新定位，
+// 新记录不会让后续页重复或错位。
+class LedgerQueryService : public QObject {
+  Q_OBJECT
+
+public:
+  static const int kPublishDelayMs = 200;
+  static const int kMaxPageSize = 500;
+  static const int kMaxRollupDays = 366;
+
+  explicit LedgerQueryService(LedgerViewCache *views,
+                              QObject *parent = nullptr);
+  ~LedgerQueryService() override;
+
+  bool start(quint16 port);
+  void stop();
+  bool isRunning() const { return m_server != nullptr; }
+  quint16 port() const { return m_port; }
+
+  // 请求线程读取的快照
+  struct Snapshot {
+    std::shared_ptr<const LedgerView> likes;
+    std::shared_ptr<const LedgerView> pendingLikes;
+    std::shared_ptr<const LedgerView> replies;
+    std::shared_ptr<const LedgerView> pendingReplies;
+  };
+
+private:
+  void schedulePublish();
+  void publish();
+  std::shared_ptr<const Snapshot> snapshot() const;
+
+  HttpResponse queryActions(const QString &query) const;
+  HttpResponse queryPending() const;
+  HttpResponse queryDaily(const QString &query) const;
+
+  LedgerViewCache *m_views;
+  QThread *m_thread;
+  LocalHttpServer *m_server; // 在 m_thread 中
+  quint16 m_port;
+  bool m_publishPending;
+
+  mutable QMutex m_mutex;
+  std::shared_ptr<const Snapshot> m_snapshot;
+};
+
+#endif // LEDGERQUERYSERVICE_H
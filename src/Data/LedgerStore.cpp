@@ -0,0 +1,74 @@
+#include "LedgerStore.h"
+#include "App/Trace.h"
+#include "DataStorageBackend.h"
+#include "SqliteLedgerStore.h"
+#include <QDateTime>
+#include <QDebug>
+#include <algorithm>
+
+QList<SocialAction> LedgerStore::searchSnippets(const QString &query,
+                                                int limit) const {
+  QList<SocialAction> result;
+  if (query.isEmpty())
+    return result;
+  for (const QList<SocialAction> &part : {loadLikes(), loadReplies()}) {
+    for (const SocialAction &a : part) {
+      if (a.postSnippet.contains(query, Qt::CaseInsensitive))
+        result.append(a);
+    }
+  }
+  std::sort(result.begin(), result.end(),
+            [](const SocialAction &a, const SocialAction &b) {
+              return a.timestamp > b.timestamp;
+            });
+  if (result.size() > limit)
+    result.erase(result.begin() + limit, result.end());
+  return result;
+}
+
+void LedgerStore::scan(
+    const std::function<bool(const SocialAction &)> &visit) const {
+  for (const SocialAction &a : loadLikes()) {
+    if (!visit(a))
+      return;
+  }
+  for (const SocialAction &a : loadReplies()) {
+    if (!visit(a))
+      return;
+  }
+}
+
+QStringList LedgerStore::backends() { return {"datastorage", "sqlite"}; }
+
+LedgerStore *LedgerStore::open(const QString &backend, QObject *parent) {
+  XSL_TRACE_SCOPE("LedgerStore::open");
+  if (backend == QLatin1String("sqlite")) {
+    auto *store =
+        new SqliteLedgerStore(SqliteLedgerStore::defaultFilePath(), parent);
+    if (store->isOpen()) {
+      if (store->isEmpty()) {
+        // 首次切换：从原有账本导入
+        DataStorageBackend legacy;
+        int imported =
+            store->importActions(legacy.loadLikes() + legacy.loadReplies());
+        qDebug() << "[LedgerStore] Imported" << imported
+                 << "records into sqlite";
+      }
+      return store;
+    }
+    qWarning() << "[LedgerStore] sqlite backend unavailable, using default";
+    delete store;
+  }
+  return new DataStorageBackend(parent);
+}
+
+LedgerStore *LedgerStore::openScratch(const QString &backend,
+                                      const QString &dir, QObject *parent) {
+  if (backend == QLatin1String("sqlite")) {
+    auto *store = new SqliteLedgerStore(dir + "/scratch.sqlite", parent);
+    if (store->isOpen())
+      return store;
+    delete store;
+  }
+  return nullptr;
+}
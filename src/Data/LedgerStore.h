@@ -0,0 +1,71 @@
+#ifndef LEDGERSTORE_H
+#define LEDGERSTORE_H
+
+#include "SocialAction.h"
+#include <QDate>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+class QThread;
+
+// 账本存储接口 - 界面和引擎只依赖它，后端可替换
+//
+// 所有后端须满足的语义（LedgerStoreBench::conformance 逐条检查）：
+// - addAction: id 已存在时返回 false，不覆盖原记录
+// - loadLikes / loadReplies: 按类型返回，顺序不作保证
+// - markReciprocated: 幂等
+// - removeByHandle: handle 不区分大小写，返回删除条数
+// - getReciprocatedByDate: 已回馈且本地日期为 date 的记录
+class LedgerStore : public QObject {
+  Q_OBJECT
+
+public:
+  explicit LedgerStore(QObject *parent = nullptr) : QObject(parent) {}
+  ~LedgerStore() override = default;
+
+  virtual QString backendName() const = 0;
+
+  virtual bool addAction(const SocialAction &action) = 0;
+  virtual QList<SocialAction> loadLikes() const = 0;
+  virtual QList<SocialAction> loadReplies() const = 0;
+  virtual void markReciprocated(const QString &actionId, bool reciprocated) = 0;
+  virtual int removeByHandle(const QString &handle) = 0;
+  virtual void setSelfHandle(const QString &handle) = 0;
+  virtual QList<SocialAction> getReciprocatedByDate(const QDate &date) const = 0;
+
+  virtual int likeCount() const = 0;
+  virtual int replyCount() const = 0;
+  virtual int pendingLikeCount() const = 0;
+  virtual int pendingReplyCount() const = 0;
+
+  // Persist buffered writes (also done on destruction)
+  virtual void flush() = 0;
+
+  // 交给 thread 使用，在当前所属线程里调用（启动时账本在工作线程打开、
+  // 加载，完成后交给 GUI 线程）。持有线程相关资源的后端一并移交
+  virtual void handOver(QThread *thread) { moveToThread(thread); }
+
+  // 逐条遍历点赞与回复，visit 返回 false 时停止。默认实现按类型加载，
+  // 支持游标的后端应覆盖以避免整表物化
+  virtual void scan(
+      const std::function<bool(const SocialAction &)> &visit) const;
+
+  // 片段子串搜索，新的在前；默认实现线性扫描
+  virtual QList<SocialAction> searchSnippets(const QString &query,
+                                             int limit = 100) const;
+
+  // 已知后端: "datastorage"（默认）、"sqlite"
+  static QStringList backends();
+  // 打开指定后端；打不开时回退默认后端。首次切到 sqlite 时
+  // 从默认后端导入全部历史记录。
+  static LedgerStore *open(const QString &backend, QObject *parent = nullptr);
+  // 在目录 dir 下新建 backend 的临时库，供一致性检查与写负载使用；
+  // 文件位置固定的后端（datastorage）返回 nullptr
+  static LedgerStore *openScratch(const QString &backend, const QString &dir,
+                                  QObject *parent = nullptr);
+};
+
+#endif // LEDGERSTORE_H
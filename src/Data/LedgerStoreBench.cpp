@@ -0,0 +1,252 @@
+#include "LedgerStoreBench.h"
+#include "App/Trace.h"
+#include "LedgerStore.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <functional>
+
+namespace {
+
+SocialAction makeAction(int i, const QString &type, const QDateTime &when) {
+  SocialAction a;
+  a.userHandle = QString("bench_user%1").arg(i % 97);
+  a.userName = QString("Bench %1").arg(i % 97);
+  a.type = type;
+  a.timestamp = when.toUTC().toString(Qt::ISODateWithMs);
+  a.postSnippet =
+      QString::fromUtf8("基准测试片段 #%1 performance ledger").arg(i);
+  a.statusLink = QString("https://x.com/bench_user%1/status/%2")
+                     .arg(i % 97)
+                     .arg(1000000 + i);
+  a.id = SocialAction::makeId(a.userHandle, a.type, a.timestamp);
+  a.reciprocated = false;
+  return a;
+}
+
+// 一致性检查的记录：X 的 handle 不允许连字符，不会碰到账本里的真实用户
+SocialAction conformanceAction(int i, const QString &type,
+                               const QDateTime &when) {
+  SocialAction a = makeAction(i, type, when);
+  a.userHandle = QString("xsl-conformance-%1").arg(i);
+  a.statusLink = QString("https://x.com/%1/status/%2")
+                     .arg(a.userHandle)
+                     .arg(1000000 + i);
+  a.id = SocialAction::makeId(a.userHandle, a.type, a.timestamp);
+  return a;
+}
+
+bool containsId(const QList<SocialAction> &actions, const QString &id) {
+  for (const SocialAction &a : actions) {
+    if (a.id == id)
+      return true;
+  }
+  return false;
+}
+
+const SocialAction *findId(const QList<SocialAction> &actions,
+                           const QString &id) {
+  for (const SocialAction &a : actions) {
+    if (a.id == id)
+      return &a;
+  }
+  return nullptr;
+}
+
+LedgerStoreBench::Timing measure(const QString &op, int iterations,
+                                 const std::function<void(int)> &fn) {
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < iterations; i++) {
+    fn(i);
+  }
+  return {op, iterations, timer.nsecsElapsed() / 1000};
+}
+
+} // namespace
+
+QList<LedgerStoreBench::Check>
+LedgerStoreBench::conformance(LedgerStore *store) {
+  XSL_TRACE_SCOPE("LedgerStoreBench::conformance");
+  QList<Check> checks;
+  auto check = [&checks](const QString &name, bool passed,
+                         const QString &detail = QString()) {
+    checks.append({name, passed, detail});
+  };
+
+  // 本地时间正午，避免跨日边界
+  QDateTime noon(QDate::currentDate().addDays(-1), QTime(12, 0));
+  SocialAction like = conformanceAction(1, "like", noon);
+  SocialAction reply = conformanceAction(2, "reply", noon.addSecs(60));
+
+  int likesBefore = store->likeCount();
+  int repliesBefore = store->replyCount();
+
+  check("addAction 新记录返回 true",
+        store->addAction(like) && store->addAction(reply));
+  SocialAction changed = like;
+  changed.userName = "Overwritten";
+  check("addAction 重复 id 返回 false", !store->addAction(changed));
+  QList<SocialAction> likes = store->loadLikes();
+  QList<SocialAction> replies = store->loadReplies();
+  const SocialAction *stored = findId(likes, like.id);
+  check("重复 id 不覆盖原记录",
+        stored && stored->userName == like.userName);
+  check("loadLikes 只含点赞",
+        containsId(likes, like.id) && !containsId(likes, reply.id));
+  check("loadReplies 只含回复",
+        containsId(replies, reply.id) && !containsId(replies, like.id));
+  check("字段往返一致",
+        stored && stored->userHandle == like.userHandle &&
+            stored->timestamp == like.timestamp &&
+            stored->postSnippet == like.postSnippet &&
+            stored->statusLink == like.statusLink && !stored->reciprocated);
+
+  check("计数与加载一致", store->likeCount() == likes.size() &&
+                              store->replyCount() == replies.size(),
+        QString("%1/%2").arg(store->likeCount()).arg(store->replyCount()));
+  check("计数增加 1", store->likeCount() == likesBefore + 1 &&
+                          store->replyCount() == repliesBefore + 1);
+
+  int pendingBefore = store->pendingLikeCount();
+  store->markReciprocated(like.id, true);
+  store->markReciprocated(like.id, true);
+  check("markReciprocated 幂等",
+        store->pendingLikeCount() == pendingBefore - 1);
+  likes = store->loadLikes();
+  stored = findId(likes, like.id);
+  check("markReciprocated 写回记录", stored && stored->reciprocated);
+
+  QList<SocialAction> day = store->getReciprocatedByDate(noon.date());
+  check("getReciprocatedByDate 含当日已回馈",
+        containsId(day, like.id) && !containsId(day, reply.id));
+  check("getReciprocatedByDate 不含其它日期",
+        !containsId(store->getReciprocatedByDate(noon.date().addDays(-1)),
+                    like.id));
+
+  store->markReciprocated(like.id, false);
+  check("取消回馈", store->pendingLikeCount() == pendingBefore);
+
+  check("searchSnippets 长查询",
+        containsId(store->searchSnippets(QString("#%1 perf").arg(2)),
+                   reply.id));
+  check("searchSnippets 中文短查询",
+        containsId(store->searchSnippets(QString::fromUtf8("片段")),
+                   like.id));
+
+  int removed = store->removeByHandle(like.userHandle.toUpper());
+  check("removeByHandle 不区分大小写", removed == 1,
+        QString::number(removed));
+  check("removeByHandle 重复调用为 0",
+        store->removeByHandle(like.userHandle) == 0);
+  check("删除后不可见", !containsId(store->loadLikes(), like.id));
+  check("删除后可重新写入", store->addAction(like));
+
+  store->removeByHandle(like.userHandle);
+  store->removeByHandle(reply.userHandle);
+  store->flush();
+  return checks;
+}
+
+QList<LedgerStoreBench::Timing>
+LedgerStoreBench::readWorkload(LedgerStore *store, int iterations) {
+  XSL_TRACE_SCOPE("LedgerStoreBench::readWorkload");
+  QDate today = QDate::currentDate();
+  return {
+      measure("loadLikes", iterations, [store](int) { store->loadLikes(); }),
+      measure("loadReplies", iterations,
+              [store](int) { store->loadReplies(); }),
+      measure("counts x4", iterations,
+              [store](int) {
+                store->likeCount();
+                store->replyCount();
+                store->pendingLikeCount();
+                store->pendingReplyCount();
+              }),
+      measure("getReciprocatedByDate", iterations,
+              [store, today](int i) {
+                store->getReciprocatedByDate(today.addDays(-i));
+              }),
+      measure("searchSnippets", iterations,
+              [store](int) { store->searchSnippets("http", 100); }),
+  };
+}
+
+QList<SocialAction> LedgerStoreBench::syntheticActions(int rows,
+                                                     const QDateTime &newest,
+                                                     int days,
+                                                     int reciprocatedPercent) {
+  QDateTime start = newest.addDays(-days);
+  int reciprocatedRows = qint64(rows) * reciprocatedPercent / 100;
+  QList<SocialAction> actions;
+  actions.reserve(rows);
+  for (int i = 0; i < rows; i++) {
+    SocialAction a =
+        makeAction(i, i % 3 ? "like" : "reply",
+                   start.addSecs(qint64(i) * days * 86400 / qMax(rows, 1)));
+    a.reciprocated = i < reciprocatedRows;
+    actions.append(a);
+  }
+  return actions;
+}
+
+QList<LedgerStoreBench::Timing>
+LedgerStoreBench::writeWorkload(LedgerStore *store, int rows) {
+  XSL_TRACE_SCOPE("LedgerStoreBench::writeWorkload");
+  QList<SocialAction> actions =
+      syntheticActions(rows, QDateTime::currentDateTimeUtc());
+
+  QList<Timing> timings;
+  timings.append(measure("addAction", rows, [store, &actions](int i) {
+    store->addAction(actions[i]);
+  }));
+  timings.append(measure("markReciprocated", rows, [store, &actions](int i) {
+    store->markReciprocated(actions[i].id, true);
+  }));
+  timings.append(measure("flush", 1, [store](int) { store->flush(); }));
+  timings.append(measure("removeByHandle", 97, [store](int i) {
+    store->removeByHandle(QString("bench_user%1").arg(i));
+  }));
+  return timings;
+}
+
+QString LedgerStoreBench::toMarkdown(const QList<Result> &results) {
+  QString md = QString::fromUtf8("# 存储引擎基准\n\n");
+  for (const Result &r : results) {
+    md += QString("## %1\n\n").arg(r.backend);
+    md += QString::fromUtf8("- 数据: %1 (%2 行)\n\n")
+              .arg(r.dataset)
+              .arg(r.rows);
+
+    if (!r.checks.isEmpty()) {
+      int passed = 0;
+      for (const Check &c : r.checks)
+        passed += c.passed ? 1 : 0;
+      md += QString::fromUtf8("### 一致性 %1/%2\n\n")
+                .arg(passed)
+                .arg(r.checks.size());
+      for (const Check &c : r.checks) {
+        md += QString("- %1 %2%3\n")
+                  .arg(c.passed ? QString::fromUtf8("✅")
+                                : QString::fromUtf8("❌"),
+                       c.name,
+                       c.detail.isEmpty() ? QString()
+                                          : QString(" (%1)").arg(c.detail));
+      }
+      md += "\n";
+    }
+
+    if (!r.timings.isEmpty()) {
+      md += QString::fromUtf8("| 操作 | 次数 | 平均 | 总计 |\n");
+      md += "|------|------|------|------|\n";
+      for (const Timing &t : r.timings) {
+        md += QString("| %1 | %2 | %3 us | %4 ms |\n")
+                  .arg(t.op)
+                  .arg(t.iterations)
+                  .arg(t.meanUs())
+                  .arg(t.totalUs / 1000.0, 0, 'f', 1);
+      }
+      md += "\n";
+    }
+  }
+  return md;
+}
@@ -0,0 +1,51 @@
+#ifndef LEDGERSTOREBENCH_H
+#define LEDGERSTOREBENCH_H
+
+#include "SocialAction.h"
+#include <QList>
+#include <QString>
+
+class LedgerStore;
+
+// 存储后端的一致性检查与基准测试 - 对任意 LedgerStore 运行同一套用例
+//
+// conformance() 写入并在结束时删除两条自己的记录（handle 带连字符，
+// 不会与真实用户重名），删除会在账本里留下墓碑，只能用于临时库；
+// writeWorkload() 批量写入、按用户删除，只能用于临时库；
+// readWorkload() 只读，也可以在正在使用的账本上运行。
+class LedgerStoreBench {
+public:
+  struct Check {
+    QString name;
+    bool passed;
+    QString detail;
+  };
+  struct Timing {
+    QString op;
+    int iterations;
+    qint64 totalUs;
+    qint64 meanUs() const { return iterations ? totalUs / iterations : 0; }
+  };
+  struct Result {
+    QString backend;
+    QString dataset; // 数据来源说明
+    int rows = 0;
+    QList<Check> checks;
+    QList<Timing> timings;
+  };
+
+  static QList<Check> conformance(LedgerStore *store);
+  static QList<Timing> readWorkload(LedgerStore *store, int iterations = 5);
+  // 插入 rows 条合成记录，再逐条标记、按用户删除
+  static QList<Timing> writeWorkload(LedgerStore *store, int rows = 2000);
+
+  static QString toMarkdown(const QList<Result> &results);
+
+  // 合成记录：点赞与回复 2:1，时间在 [newest - days, newest] 内均匀分布，
+  // 按时间从旧到新生成；最旧的 reciprocatedPercent% 标记为已回馈
+  static QList<SocialAction> syntheticActions(int rows, const QDateTime &newest,
+                                              int days = 30,
+                                              int reciprocatedPercent = 0);
+};
+
+#endif // LEDGERSTOREBENCH_H
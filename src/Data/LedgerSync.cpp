@@ -0,0 +1,153 @@
+#include "LedgerSync.h"
+#include "App/Metrics.h"
+#include "App/Trace.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <QtEndian>
+
+namespace {
+
+using Digest = SqliteLedgerStore::PartitionDigest;
+using SyncRow = SqliteLedgerStore::SyncRow;
+
+// 两个按 key 升序的摘要序列做归并，返回任一侧缺失或不同的 key
+QStringList differingKeys(const QList<Digest> &a, const QList<Digest> &b) {
+  QStringList keys;
+  int i = 0, j = 0;
+  while (i < a.size() || j < b.size()) {
+    if (j == b.size() || (i < a.size() && a[i].key < b[j].key)) {
+      keys.append(a[i++].key);
+    } else if (i == a.size() || b[j].key < a[i].key) {
+      keys.append(b[j++].key);
+    } else {
+      if (a[i] != b[j])
+        keys.append(a[i].key);
+      i++;
+      j++;
+    }
+  }
+  return keys;
+}
+
+// other 是否应覆盖 mine 的回馈状态
+bool wins(const SyncRow &other, const SyncRow &mine) {
+  if (other.action.reciprocated == mine.action.reciprocated)
+    return false;
+  if (other.reciprocatedAt != mine.reciprocatedAt)
+    return other.reciprocatedAt > mine.reciprocatedAt;
+  return other.action.reciprocated;
+}
+
+// 计算一个日分区里双方各自缺的记录
+void diffPartition(const QList<SyncRow> &local, const QList<SyncRow> &peer,
+                   QList<SyncRow> *toLocal, QList<SyncRow> *toPeer) {
+  QHash<QString, const SyncRow *> localById;
+  localById.reserve(local.size());
+  for (const SyncRow &row : local)
+    localById.insert(row.action.id, &row);
+
+  QSet<QString> seen;
+  for (const SyncRow &row : peer) {
+    seen.insert(row.action.id);
+    const SyncRow *mine = localById.value(row.action.id);
+    if (!mine)
+      toLocal->append(row);
+    else if (wins(row, *mine))
+      toLocal->append(row);
+    else if (wins(*mine, row))
+      toPeer->append(*mine);
+  }
+  for (const SyncRow &row : local) {
+    if (!seen.contains(row.action.id))
+      toPeer->append(row);
+  }
+}
+
+} // namespace
+
+QByteArray LedgerSync::rootHash(const QList<Digest> &months) {
+  QCryptographicHash h(QCryptographicHash::Sha256);
+  for (const Digest &d : months) {
+    QByteArray node = d.key.toUtf8();
+    char le[12];
+    qToLittleEndian(d.hash, le);
+    qToLittleEndian(qint32(d.count), le + 8);
+    node.append(le, sizeof(le));
+    h.addData(node);
+  }
+  return h.result();
+}
+
+QString LedgerSync::ledgerFileIn(const QString &directory) {
+  return QDir(directory).filePath("ledger.sqlite");
+}
+
+LedgerSync::Report LedgerSync::sync(SqliteLedgerStore *local,
+                                    SqliteLedgerStore *peer) {
+  XSL_TRACE_SCOPE("LedgerSync::sync");
+  static Histogram *latency = Metrics::instance()->histogram(
+      "xsl_ledger_sync_seconds", "Duration of a partition-level ledger sync");
+  static Counter *pulledRecords = Metrics::instance()->counter(
+      "xsl_ledger_sync_records_total", "Records written by ledger sync",
+      "direction=\"pull\"");
+  static Counter *pushedRecords = Metrics::instance()->counter(
+      "xsl_ledger_sync_records_total", "Records written by ledger sync",
+      "direction=\"push\"");
+  ScopedLatency timing(latency);
+  QElapsedTimer timer;
+  timer.start();
+
+  Report report;
+  // 墓碑先行：删除两边都生效后分区摘要才可能一致。只发对方水位之后的；
+  // 两个方向先都读出来，补记的墓碑不会在同一次同步里回传
+  using Tombstone = SqliteLedgerStore::Tombstone;
+  const QList<Tombstone> toPeer =
+      local->tombstonesAfter(local->tombstoneMark(peer->ledgerId()));
+  const QList<Tombstone> toLocal =
+      peer->tombstonesAfter(peer->tombstoneMark(local->ledgerId()));
+  report.removedLocal = local->applyTombstones(toLocal);
+  report.removedPeer = peer->applyTombstones(toPeer);
+  report.tombstonesSent = toPeer.size() + toLocal.size();
+  // 水位越过刚补记的墓碑：它们来自对方，不必再发回去
+  local->setTombstoneMark(peer->ledgerId(), local->lastTombstoneSeq());
+  peer->setTombstoneMark(local->ledgerId(), peer->lastTombstoneSeq());
+  report.tombstonesPruned =
+      local->pruneTombstones() + peer->pruneTombstones();
+
+  const QList<Digest> localMonths = local->monthDigests();
+  const QList<Digest> peerMonths = peer->monthDigests();
+  if (rootHash(localMonths) == rootHash(peerMonths)) {
+    report.alreadyInSync = true;
+    report.elapsedMs = timer.elapsed();
+    return report;
+  }
+
+  const QStringList months = differingKeys(localMonths, peerMonths);
+  report.monthsDiffering = months.size();
+  for (const QString &month : months) {
+    const QStringList days =
+        differingKeys(local->dayDigests(month), peer->dayDigests(month));
+    report.daysDiffering += days.size();
+    for (const QString &day : days) {
+      QList<SyncRow> toLocal, toPeer;
+      diffPartition(local->partitionRows(day), peer->partitionRows(day),
+                    &toLocal, &toPeer);
+      report.pulled += local->applySyncRows(toLocal);
+      report.pushed += peer->applySyncRows(toPeer);
+    }
+  }
+
+  pulledRecords->inc(report.pulled);
+  pushedRecords->inc(report.pushed);
+  report.elapsedMs = timer.elapsed();
+  qDebug() << "[LedgerSync]" << report.monthsDiffering << "months,"
+           << report.daysDiffering << "days differ; pulled" << report.pulled
+           << "pushed" << report.pushed << "removed" << report.removedLocal
+           << "/" << report.removedPeer << "tombstones"
+           << report.tombstonesSent << "in" << report.elapsedMs << "ms";
+  return report;
+}
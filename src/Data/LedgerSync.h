@@ -0,0 +1,45 @@
+#ifndef LEDGERSYNC_H
+#define LEDGERSYNC_H
+
+#include "SqliteLedgerStore.h"
+#include <QByteArray>
+#include <QString>
+
+// 两份账本的分区级双向同步
+//
+// 先交换墓碑：一边删除的记录在另一边也删除，且不会再被拉回；
+// 删除之后又重新写入的记录按时间保留，随后作为普通记录同步过去。
+// 每份账本按对端的 ledgerId 记水位，只发上次同步之后新增的墓碑；
+// 所有已知对端都收到的墓碑随即清理。第一次同步的新对端收不到已清理
+// 的墓碑，它带来的旧记录会被当作新记录接收。
+// 比较自上而下：根哈希相同直接返回；否则逐月比较摘要，只对不同的月
+// 读取日摘要，只对不同的日读取记录。合并按 SocialAction::makeId 去重，
+// 两边都有的记录按 reciprocatedAt 后写者胜（时间相同时已回馈胜）。
+// 昵称、片段不调和，各自保留先写入的版本，也不计入分区摘要。
+// 耗时与变化的分区数成正比，和历史长度无关。
+class LedgerSync {
+public:
+  struct Report {
+    bool alreadyInSync = false;
+    int monthsDiffering = 0;
+    int daysDiffering = 0;
+    int pulled = 0;           // 写入本地的记录（新增或回馈状态变化）
+    int pushed = 0;           // 写入对端的记录
+    int removedLocal = 0;     // 按对端墓碑删除的本地记录
+    int removedPeer = 0;      // 按本地墓碑删除的对端记录
+    int tombstonesSent = 0;   // 两个方向交换的墓碑
+    int tombstonesPruned = 0; // 两边清理的墓碑
+    qint64 elapsedMs = 0;
+  };
+
+  static Report sync(SqliteLedgerStore *local, SqliteLedgerStore *peer);
+
+  // 月摘要序列的 SHA-256
+  static QByteArray rootHash(
+      const QList<SqliteLedgerStore::PartitionDigest> &months);
+
+  // 对端目录下账本文件的位置
+  static QString ledgerFileIn(const QString &directory);
+};
+
+#endif // LEDGERSYNC_H
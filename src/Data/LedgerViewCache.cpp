@@ -0,0 +1,354 @@
+#include "LedgerViewCache.h"
+#include "App/MemoryAccounting.h"
+#include "App/Metrics.h"
+#include "App/Trace.h"
+#include "LedgerStore.h"
+#include <QDateTime>
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+const int kMaxLog = 4096; // 更长的变更历史不值得补丁，直接重建
+
+bool passes(const SocialAction &a, LedgerViewCache::Filter filter) {
+  return filter == LedgerViewCache::Filter::All || !a.reciprocated;
+}
+
+// 视图顺序：新的在前；同一时刻按时间戳字符串、再按行号倒序，
+// 使重建和补丁得到完全相同的顺序
+bool rowBefore(const LedgerSnapshot &snapshot, int a, int b) {
+  qint64 ea = snapshot.epochMs(a), eb = snapshot.epochMs(b);
+  if (ea != eb)
+    return ea > eb;
+  const QString &ta = snapshot.at(a).timestamp;
+  const QString &tb = snapshot.at(b).timestamp;
+  if (ta != tb)
+    return ta > tb;
+  return a > b;
+}
+
+} // namespace
+
+// ==================== LedgerSnapshot ====================
+
+LedgerSnapshot::Row LedgerSnapshot::makeRow(const SocialAction &a) {
+  QDateTime dt = QDateTime::fromString(a.timestamp, Qt::ISODateWithMs);
+  Row row{a, dt.isValid() ? dt.toMSecsSinceEpoch() : LLONG_MIN,
+          SnippetRef(a.postSnippet)};
+  // 换成共享的文本，从存储读出的那份随 a 释放
+  row.action.postSnippet = row.snippet.text();
+  return row;
+}
+
+qint64 LedgerSnapshot::rowBytes(const SocialAction &a) {
+  // UTF-16 负载 + 结构体，粗略估计；片段计入 SnippetStore
+  return sizeof(Row) +
+         (a.id.size() + a.userHandle.size() + a.userName.size() +
+          a.type.size() + a.timestamp.size() + a.statusLink.size()) *
+             qint64(sizeof(QChar));
+}
+
+std::shared_ptr<const LedgerSnapshot>
+LedgerSnapshot::fromList(const QList<SocialAction> &actions) {
+  auto snapshot = std::make_shared<LedgerSnapshot>();
+  std::shared_ptr<Chunk> chunk;
+  for (const SocialAction &a : actions) {
+    if (!chunk) {
+      chunk = std::make_shared<Chunk>();
+      chunk->reserve(kChunkRows);
+    }
+    chunk->append(makeRow(a));
+    snapshot->m_bytes += rowBytes(a);
+    if (chunk->size() == kChunkRows) {
+      snapshot->m_chunks.append(chunk);
+      chunk.reset();
+    }
+  }
+  if (chunk)
+    snapshot->m_chunks.append(chunk);
+  snapshot->m_size = actions.size();
+  return snapshot;
+}
+
+std::shared_ptr<const LedgerSnapshot>
+LedgerSnapshot::appended(const SocialAction &a) const {
+  auto next = std::make_shared<LedgerSnapshot>(*this);
+  if (m_size % kChunkRows == 0) {
+    auto chunk = std::make_shared<Chunk>();
+    chunk->reserve(kChunkRows);
+    chunk->append(makeRow(a));
+    next->m_chunks.append(chunk);
+  } else {
+    auto chunk = std::make_shared<Chunk>(*m_chunks.last());
+    chunk->append(makeRow(a));
+    next->m_chunks.last() = chunk;
+  }
+  next->m_size++;
+  next->m_bytes += rowBytes(a);
+  return next;
+}
+
+std::shared_ptr<const LedgerSnapshot>
+LedgerSnapshot::withReciprocated(int row, bool value) const {
+  auto next = std::make_shared<LedgerSnapshot>(*this);
+  int c = row / kChunkRows;
+  auto chunk = std::make_shared<Chunk>(*m_chunks[c]);
+  (*chunk)[row % kChunkRows].action.reciprocated = value;
+  next->m_chunks[c] = chunk;
+  return next;
+}
+
+// ==================== LedgerView ====================
+
+int LedgerView::countSince(qint64 cutoffMs) const {
+  // 视图按时间倒序，满足条件的是前缀
+  auto it = std::partition_point(
+      m_rows.begin(), m_rows.end(),
+      [this, cutoffMs](int row) {
+        return m_snapshot->epochMs(row) >= cutoffMs;
+      });
+  return int(it - m_rows.begin());
+}
+
+// ==================== LedgerViewCache ====================
+
+LedgerViewCache::LedgerViewCache(LedgerStore *storage, int capacity,
+                                 QObject *parent)
+    : QObject(parent), m_storage(storage), m_capacity(qMax(2, capacity)),
+      m_generation(1), m_logFloor(0) {
+  // 快照 + id 索引 + 缓存视图的行号表；视图共享快照，快照只算一次
+  MemoryAccounting::instance()->addSource("ledger", this, [this]() {
+    MemoryUsage usage;
+    for (const TypeState &state : m_types) {
+      if (!state.snapshot)
+        continue;
+      usage.bytes += state.snapshot->estimatedBytes() +
+                     state.rowOf.size() *
+                         (MemoryAccounting::kHashEntryBytes +
+                          qint64(sizeof(QString) + sizeof(int)));
+      usage.objects += state.snapshot->size();
+    }
+    for (const Entry &e : m_lru)
+      usage.bytes += e.view->size() * qint64(sizeof(int));
+    usage.bytes += m_log.size() * qint64(sizeof(Change));
+    return usage;
+  });
+}
+
+LedgerViewCache::TypeState &LedgerViewCache::ensureLoaded(const QString &type) {
+  TypeState &state = m_types[type];
+  if (state.snapshot)
+    return state;
+
+  adopt(type, load(type == QLatin1String("reply") ? m_storage->loadReplies()
+                                                   : m_storage->loadLikes()));
+  return state;
+}
+
+LedgerViewCache::Loaded
+LedgerViewCache::load(const QList<SocialAction> &actions) {
+  XSL_TRACE_SCOPE("LedgerViewCache::load");
+  Loaded loaded;
+  loaded.snapshot = LedgerSnapshot::fromList(actions);
+  loaded.rowOf.reserve(actions.size());
+  for (int i = 0; i < actions.size(); i++) {
+    loaded.rowOf.insert(actions[i].id, i);
+  }
+  return loaded;
+}
+
+void LedgerViewCache::adopt(const QString &type, const Loaded &loaded) {
+  TypeState &state = m_types[type];
+  state.snapshot = loaded.snapshot;
+  state.rowOf = loaded.rowOf;
+  state.loadedGeneration = m_generation;
+  publishMetrics(type);
+}
+
+std::shared_ptr<const LedgerView> LedgerViewCache::view(const QString &type,
+                                                        Filter filter) {
+  static Counter *hits = Metrics::instance()->counter(
+      "xsl_view_cache_total", "Ledger view lookups", "result=\"hit\"");
+  static Counter *patches = Metrics::instance()->counter(
+      "xsl_view_cache_total", "Ledger view lookups", "result=\"patch\"");
+  static Counter *misses = Metrics::instance()->counter(
+      "xsl_view_cache_total", "Ledger view lookups", "result=\"miss\"");
+
+  TypeState &state = ensureLoaded(type);
+
+  std::shared_ptr<const LedgerView> cached;
+  for (const Entry &e : m_lru) {
+    if (e.type == type && e.filter == filter) {
+      cached = e.view;
+      break;
+    }
+  }
+
+  std::shared_ptr<const LedgerView> result;
+  if (cached && cached->m_generation == m_generation) {
+    hits->inc();
+    result = cached;
+  } else if (cached && cached->m_generation >= state.loadedGeneration &&
+             cached->m_generation >= m_logFloor) {
+    patches->inc();
+    result = patch(*cached, type, filter);
+  } else {
+    misses->inc();
+    result = build(type, filter);
+  }
+  touch(type, filter, result);
+  return result;
+}
+
+std::shared_ptr<const LedgerSnapshot>
+LedgerViewCache::snapshot(const QString &type) {
+  return ensureLoaded(type).snapshot;
+}
+
+std::shared_ptr<const LedgerView> LedgerViewCache::build(const QString &type,
+                                                         Filter filter) {
+  XSL_TRACE_SCOPE("LedgerViewCache::build");
+  const TypeState &state = m_types[type];
+  const LedgerSnapshot &snapshot = *state.snapshot;
+
+  auto view = std::make_shared<LedgerView>();
+  view->m_snapshot = state.snapshot;
+  view->m_generation = m_generation;
+  view->m_rows.reserve(snapshot.size());
+  for (int row = 0; row < snapshot.size(); row++) {
+    if (passes(snapshot.at(row), filter))
+      view->m_rows.append(row);
+  }
+
+  std::sort(view->m_rows.begin(), view->m_rows.end(),
+            [&snapshot](int a, int b) { return rowBefore(snapshot, a, b); });
+  return view;
+}
+
+std::shared_ptr<const LedgerView>
+LedgerViewCache::patch(const LedgerView &old, const QString &type,
+                       Filter filter) {
+  XSL_TRACE_SCOPE("LedgerViewCache::patch");
+  const TypeState &state = m_types[type];
+  const LedgerSnapshot &snapshot = *state.snapshot;
+
+  auto view = std::make_shared<LedgerView>();
+  view->m_snapshot = state.snapshot;
+  view->m_generation = m_generation;
+  view->m_rows = old.m_rows;
+
+  auto before = [&snapshot](int a, int b) {
+    return rowBefore(snapshot, a, b);
+  };
+
+  QVector<int> &rows = view->m_rows;
+  for (const Change &c : m_log) {
+    if (c.generation <= old.m_generation || c.type != type)
+      continue;
+    auto pos = std::lower_bound(rows.begin(), rows.end(), c.row, before);
+    bool present = pos != rows.end() && *pos == c.row;
+    // 以当前快照状态为准：同一行多次变化时结果一致
+    bool wanted = passes(snapshot.at(c.row), filter);
+    if (wanted && !present)
+      rows.insert(pos, c.row);
+    else if (!wanted && present)
+      rows.erase(pos);
+  }
+  return view;
+}
+
+void LedgerViewCache::touch(const QString &type, Filter filter,
+                            const std::shared_ptr<const LedgerView> &view) {
+  for (int i = 0; i < m_lru.size(); i++) {
+    if (m_lru[i].type == type && m_lru[i].filter == filter) {
+      m_lru.removeAt(i);
+      break;
+    }
+  }
+  m_lru.prepend({type, filter, view});
+  while (m_lru.size() > m_capacity) {
+    m_lru.removeLast();
+  }
+  trimLog();
+}
+
+void LedgerViewCache::noteAdded(const SocialAction &action) {
+  m_generation++;
+  QString type = action.type;
+  auto it = m_types.find(type);
+  if (type != QLatin1String("like") && type != QLatin1String("reply")) {
+    // 其它类型 (list_like 等) 是否出现在 loadLikes() 中由存储决定，
+    // 无法确定时让点赞快照重新加载
+    invalidate("like");
+  } else if (it != m_types.end() && it->snapshot) {
+    if (!it->rowOf.contains(action.id)) {
+      int row = it->snapshot->size();
+      it->snapshot = it->snapshot->appended(action);
+      it->rowOf.insert(action.id, row);
+      m_log.append({m_generation, type, row, true});
+      publishMetrics(type);
+    }
+  }
+  trimLog();
+  emit changed();
+}
+
+void LedgerViewCache::noteReciprocated(const QString &actionId,
+                                       bool reciprocated) {
+  m_generation++;
+  for (auto it = m_types.begin(); it != m_types.end(); ++it) {
+    if (!it->snapshot)
+      continue;
+    auto row = it->rowOf.constFind(actionId);
+    if (row == it->rowOf.constEnd())
+      continue;
+    if (it->snapshot->at(*row).reciprocated != reciprocated) {
+      it->snapshot = it->snapshot->withReciprocated(*row, reciprocated);
+      m_log.append({m_generation, it.key(), *row, false});
+    }
+    break;
+  }
+  trimLog();
+  emit changed();
+}
+
+void LedgerViewCache::invalidate(const QString &type) {
+  m_generation++;
+  for (auto it = m_types.begin(); it != m_types.end(); ++it) {
+    if (type.isEmpty() || it.key() == type) {
+      it->snapshot.reset();
+      it->rowOf.clear();
+    }
+  }
+  for (int i = m_lru.size() - 1; i >= 0; i--) {
+    if (type.isEmpty() || m_lru[i].type == type)
+      m_lru.removeAt(i);
+  }
+  emit changed();
+}
+
+void LedgerViewCache::trimLog() {
+  // 只保留仍有缓存视图可能用到的变更
+  quint64 oldest = m_generation;
+  for (const Entry &e : m_lru) {
+    oldest = qMin(oldest, e.view->m_generation);
+  }
+  int drop = 0;
+  while (drop < m_log.size() && m_log[drop].generation <= oldest)
+    drop++;
+  if (m_log.size() - drop > kMaxLog)
+    drop = m_log.size() - kMaxLog; // 过旧的视图将重建
+  if (drop > 0) {
+    m_logFloor = qMax(m_logFloor, m_log[drop - 1].generation);
+    m_log.remove(0, drop);
+  }
+}
+
+void LedgerViewCache::publishMetrics(const QString &type) {
+  const TypeState &state = m_types[type];
+  Metrics::instance()
+      ->gauge("xsl_ledger_memory_bytes", "Estimated in-memory ledger size",
+              QString("type=\"%1\"").arg(type))
+      ->set(state.snapshot ? state.snapshot->estimatedBytes() : 0);
+}
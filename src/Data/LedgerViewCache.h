@@ -0,0 +1,153 @@
+#ifndef LEDGERVIEWCACHE_H
+#define LEDGERVIEWCACHE_H
+
+#include "SnippetStore.h"
+#include "SocialAction.h"
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+class LedgerStore;
+
+// 某一类型记录的不可变快照
+//
+// 按 4096 行分块保存，块之间共享：追加或修改一行只复制一个块和块指针表，
+// 旧快照仍然有效。行号在两次完整重载之间保持稳定。
+// 片段在记录进入快照时 intern 一次，postSnippet 与 SnippetStore 共享文本。
+class LedgerSnapshot {
+public:
+  static const int kChunkRows = 4096;
+
+  static std::shared_ptr<const LedgerSnapshot>
+  fromList(const QList<SocialAction> &actions);
+
+  int size() const { return m_size; }
+  const SocialAction &at(int row) const { return rowAt(row).action; }
+  qint64 epochMs(int row) const { return rowAt(row).epochMs; }
+  const SnippetRef &snippet(int row) const { return rowAt(row).snippet; }
+  qint64 estimatedBytes() const { return m_bytes; }
+
+  std::shared_ptr<const LedgerSnapshot> appended(const SocialAction &a) const;
+  std::shared_ptr<const LedgerSnapshot> withReciprocated(int row,
+                                                         bool value) const;
+
+private:
+  struct Row {
+    SocialAction action;
+    qint64 epochMs;     // 时间戳解析一次；无效为 LLONG_MIN
+    SnippetRef snippet; // action.postSnippet 的文本由它持有
+  };
+  using Chunk = QVector<Row>;
+
+  const Row &rowAt(int row) const {
+    return (*m_chunks[row / kChunkRows])[row % kChunkRows];
+  }
+  static Row makeRow(const SocialAction &a);
+  static qint64 rowBytes(const SocialAction &a);
+
+  QVector<std::shared_ptr<const Chunk>> m_chunks;
+  int m_size = 0;
+  qint64 m_bytes = 0;
+};
+
+// 排序 + 过滤后的物化视图：快照行号，按时间倒序
+class LedgerView {
+public:
+  quint64 generation() const { return m_generation; }
+  int size() const { return m_rows.size(); }
+  const SocialAction &at(int i) const { return m_snapshot->at(m_rows[i]); }
+  qint64 epochMs(int i) const { return m_snapshot->epochMs(m_rows[i]); }
+  const SnippetRef &snippet(int i) const {
+    return m_snapshot->snippet(m_rows[i]);
+  }
+
+  // Rows with a timestamp >= cutoffMs; they form a prefix of the view
+  int countSince(qint64 cutoffMs) const;
+
+private:
+  friend class LedgerViewCache;
+
+  std::shared_ptr<const LedgerSnapshot> m_snapshot;
+  QVector<int> m_rows;
+  quint64 m_generation = 0;
+};
+
+// 查询结果缓存 - 按 (类型, 过滤, 代数) 缓存物化视图
+//
+// 每次已知的账本变更 (note*) 使代数加一并记入变更日志。相同查询在代数
+// 未变时 O(1) 返回同一个 shared_ptr<const LedgerView>；代数变化不大时
+// 按日志对旧视图打补丁（二分插入/删除），不再整体复制、排序、过滤。
+// 无法打补丁的变更 (invalidate) 会在下次查询时重新加载该类型。
+class LedgerViewCache : public QObject {
+  Q_OBJECT
+
+public:
+  enum class Filter { All, Pending };
+
+  explicit LedgerViewCache(LedgerStore *storage, int capacity = 8,
+                           QObject *parent = nullptr);
+
+  // 一种类型的快照与行号表。load() 可在任意线程运行（启动时在工作线程
+  // 建好），adopt() 在所属线程装入尚未加载的类型，首次查询不再整表加载
+  struct Loaded {
+    std::shared_ptr<const LedgerSnapshot> snapshot;
+    QHash<QString, int> rowOf; // action id -> 行号
+  };
+  static Loaded load(const QList<SocialAction> &actions);
+  void adopt(const QString &type, const Loaded &loaded);
+
+  quint64 generation() const { return m_generation; }
+
+  // type: "like" or "reply"
+  std::shared_ptr<const LedgerView> view(const QString &type, Filter filter);
+  // 当前快照（未排序、未过滤），可交给工作线程只读
+  std::shared_ptr<const LedgerSnapshot> snapshot(const QString &type);
+
+  void noteAdded(const SocialAction &action);
+  void noteReciprocated(const QString &actionId, bool reciprocated);
+  // Drop the snapshot of one type (empty = all); reloaded on next query
+  void invalidate(const QString &type = QString());
+
+signals:
+  void changed();
+
+private:
+  struct TypeState {
+    std::shared_ptr<const LedgerSnapshot> snapshot; // null = 未加载
+    QHash<QString, int> rowOf;                      // action id -> 行号
+    quint64 loadedGeneration = 0; // 早于此代数的视图不能打补丁
+  };
+  struct Change {
+    quint64 generation;
+    QString type;
+    int row;
+    bool added; // false = reciprocated 变化
+  };
+  struct Entry {
+    QString type;
+    Filter filter;
+    std::shared_ptr<const LedgerView> view;
+  };
+
+  TypeState &ensureLoaded(const QString &type);
+  std::shared_ptr<const LedgerView> build(const QString &type, Filter filter);
+  std::shared_ptr<const LedgerView> patch(const LedgerView &old,
+                                          const QString &type, Filter filter);
+  void touch(const QString &type, Filter filter,
+             const std::shared_ptr<const LedgerView> &view);
+  void trimLog();
+  void publishMetrics(const QString &type);
+
+  LedgerStore *m_storage;
+  int m_capacity;
+  quint64 m_generation;
+  QHash<QString, TypeState> m_types;
+  QList<Entry> m_lru; // 最近使用的在前
+  QVector<Change> m_log;
+  quint64 m_logFloor; // 不晚于此代数的变更可能已从日志删除
+};
+
+#endif // LEDGERVIEWCACHE_H
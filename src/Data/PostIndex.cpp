@@ -0,0 +1,135 @@
+#include "PostIndex.h"
+#include "App/MemoryAccounting.h"
+#include "App/Trace.h"
+#include <QDateTime>
+#include <algorithm>
+
+PostIndex::PostIndex(QObject *parent) : QObject(parent) {
+  // 片段正文在 SnippetStore 里记账，这里只算引用
+  MemoryAccounting::instance()->addSource("post_index", this, [this]() {
+    const qint64 entry = MemoryAccounting::kHashEntryBytes;
+    MemoryUsage usage;
+    usage.objects = m_posts.size();
+    for (const PostStats &post : m_posts) {
+      usage.bytes += entry + qint64(sizeof(quint64) + sizeof(PostStats)) +
+                     post.statusLink.size() * qint64(sizeof(QChar)) +
+                     post.handles.size() * (entry + qint64(sizeof(quint32)));
+    }
+    for (const QString &name : m_handleNames) {
+      usage.bytes += entry + qint64(sizeof(QString) * 2 + sizeof(quint32)) +
+                     name.size() * qint64(sizeof(QChar));
+    }
+    return usage;
+  });
+}
+
+quint64 PostIndex::tweetIdFromLink(const QString &statusLink) {
+  static const QString marker = QStringLiteral("/status/");
+  int pos = statusLink.indexOf(marker);
+  if (pos < 0)
+    return 0;
+
+  quint64 id = 0;
+  for (int i = pos + marker.size(); i < statusLink.size(); i++) {
+    QChar c = statusLink.at(i);
+    if (c < QLatin1Char('0') || c > QLatin1Char('9'))
+      break;
+    id = id * 10 + quint64(c.unicode() - '0');
+  }
+  return id;
+}
+
+void PostIndex::clear() {
+  m_posts.clear();
+  m_handleIds.clear();
+  m_handleNames.clear();
+}
+
+void PostIndex::rebuild(const QList<SocialAction> &actions) {
+  XSL_TRACE_SCOPE("PostIndex::rebuild");
+  clear();
+  quint64 tweetId = 0;
+  for (const SocialAction &action : actions) {
+    apply(action, &tweetId);
+  }
+  emit rebuilt();
+}
+
+bool PostIndex::add(const SocialAction &action) {
+  quint64 tweetId = 0;
+  if (!apply(action, &tweetId))
+    return false;
+  emit postUpdated(tweetId);
+  return true;
+}
+
+const PostStats *PostIndex::post(quint64 tweetId) const {
+  auto it = m_posts.constFind(tweetId);
+  return it == m_posts.constEnd() ? nullptr : &it.value();
+}
+
+QList<const PostStats *> PostIndex::topPosts(int limit) const {
+  QVector<const PostStats *> all;
+  all.reserve(m_posts.size());
+  for (const PostStats &p : m_posts) {
+    all.append(&p);
+  }
+
+  auto byEngagement = [](const PostStats *a, const PostStats *b) {
+    if (a->engagement() != b->engagement())
+      return a->engagement() > b->engagement();
+    return a->lastSeenMs > b->lastSeenMs;
+  };
+  int n = limit > 0 ? qMin(limit, int(all.size())) : int(all.size());
+  std::partial_sort(all.begin(), all.begin() + n, all.end(), byEngagement);
+  return QList<const PostStats *>(all.begin(), all.begin() + n);
+}
+
+bool PostIndex::apply(const SocialAction &action, quint64 *tweetId) {
+  bool isLike = action.type == QLatin1String("like");
+  if (!isLike && action.type != QLatin1String("reply"))
+    return false;
+  quint64 id = tweetIdFromLink(action.statusLink);
+  if (id == 0)
+    return false;
+
+  QDateTime dt = QDateTime::fromString(action.timestamp, Qt::ISODateWithMs);
+  qint64 ms = dt.isValid() ? dt.toMSecsSinceEpoch() : 0;
+
+  PostStats &post = m_posts[id];
+  if (post.tweetId == 0) {
+    post.tweetId = id;
+    post.statusLink = action.statusLink;
+    post.firstSeenMs = ms;
+    post.lastSeenMs = ms;
+  }
+  if (isLike)
+    post.likes++;
+  else
+    post.replies++;
+  if (ms > 0) {
+    if (post.firstSeenMs <= 0 || ms < post.firstSeenMs)
+      post.firstSeenMs = ms;
+    if (ms >= post.lastSeenMs) {
+      post.lastSeenMs = ms;
+      if (!action.postSnippet.isEmpty())
+        post.snippet = SnippetRef(action.postSnippet);
+    }
+  }
+  if (post.snippet.isEmpty())
+    post.snippet = SnippetRef(action.postSnippet);
+  post.handles.insert(internHandle(action.userHandle.toLower()));
+
+  *tweetId = id;
+  return true;
+}
+
+quint32 PostIndex::internHandle(const QString &handle) {
+  auto it = m_handleIds.constFind(handle);
+  if (it != m_handleIds.constEnd())
+    return it.value();
+  quint32 id = quint32(m_handleNames.size());
+  m_handleNames.append(handle);
+  m_handleIds.insert(handle, id);
+  return id;
+}
@@ -0,0 +1,69 @@
+#ifndef POSTINDEX_H
+#define POSTINDEX_H
+
+#include "SnippetStore.h"
+#include "SocialAction.h"
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+// 单个帖子的互动汇总
+struct PostStats {
+  quint64 tweetId = 0;
+  QString statusLink;
+  SnippetRef snippet; // 最近一条记录的片段
+  int likes = 0;
+  int replies = 0;
+  qint64 firstSeenMs = 0;
+  qint64 lastSeenMs = 0;
+  QSet<quint32> handles; // 互动用户 (PostIndex 内部 id)
+
+  int engagement() const { return likes + replies; }
+};
+
+// 帖子互动索引 - 按 tweet id (取自 statusLink) 聚合
+//
+// X 的通知是分组的 ("A、B 和另外 12 人赞了你的帖子")，采集器对每个用户
+// 各写一条记录，statusLink 相同。索引在每条新记录入账时 O(1) 更新，
+// 帖子视图不再需要扫描全部 SocialAction。只统计 like / reply；
+// list_like 是我们点别人的帖子，不计入。
+class PostIndex : public QObject {
+  Q_OBJECT
+
+public:
+  explicit PostIndex(QObject *parent = nullptr);
+
+  // ".../status/<digits>" -> tweet id, 0 when the link has none
+  static quint64 tweetIdFromLink(const QString &statusLink);
+
+  void clear();
+  void rebuild(const QList<SocialAction> &actions);
+
+  // Returns false when the action is not indexed (type or link)
+  bool add(const SocialAction &action);
+
+  int postCount() const { return m_posts.size(); }
+  const PostStats *post(quint64 tweetId) const;
+
+  // Posts ordered by engagement, then most recent activity
+  QList<const PostStats *> topPosts(int limit) const;
+
+  QString handleName(quint32 id) const { return m_handleNames.value(id); }
+
+signals:
+  void postUpdated(quint64 tweetId);
+  void rebuilt();
+
+private:
+  bool apply(const SocialAction &action, quint64 *tweetId);
+  quint32 internHandle(const QString &handle);
+
+  QHash<quint64, PostStats> m_posts;
+  QHash<QString, quint32> m_handleIds;
+  QVector<QString> m_handleNames;
+};
+
+#endif // POSTINDEX_H
@@ -0,0 +1,192 @@
+#include "ReportEngine.h"
+#include "App/Metrics.h"
+#include "App/Trace.h"
+#include "LedgerViewCache.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrent>
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+struct Partition {
+  int snapshot; // Snapshots 下标
+  int begin;
+  int end;
+};
+
+QString csvField(const QString &value) {
+  if (!value.contains(QLatin1Char(',')) && !value.contains(QLatin1Char('"')) &&
+      !value.contains(QLatin1Char('\n')))
+    return value;
+  QString escaped = value;
+  escaped.replace("\"", "\"\"");
+  return "\"" + escaped + "\"";
+}
+
+QList<QPair<QString, ReportPartial::HandleTotals>>
+sortedHandles(const ReportPartial &totals) {
+  QList<QPair<QString, ReportPartial::HandleTotals>> sorted;
+  sorted.reserve(totals.handles.size());
+  for (auto it = totals.handles.constBegin(); it != totals.handles.constEnd();
+       ++it) {
+    sorted.append({it.key(), it.value()});
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+    if (a.second.total() != b.second.total())
+      return a.second.total() > b.second.total();
+    return a.first < b.first;
+  });
+  return sorted;
+}
+
+} // namespace
+
+void ReportPartial::merge(const ReportPartial &other) {
+  for (auto it = other.handles.constBegin(); it != other.handles.constEnd();
+       ++it) {
+    HandleTotals &t = handles[it.key()];
+    if (t.name.isEmpty())
+      t.name = it->name;
+    t.likes += it->likes;
+    t.replies += it->replies;
+  }
+  for (auto it = other.days.constBegin(); it != other.days.constEnd(); ++it) {
+    DayTotals &d = days[it.key()];
+    d.likes += it->likes;
+    d.replies += it->replies;
+  }
+  likes += other.likes;
+  replies += other.replies;
+}
+
+QFuture<RangeReport> ReportEngine::run(const Snapshots &snapshots,
+                                       const QDate &from, const QDate &to) {
+  // 每个线程约 4 个分区，便于线程池均衡负载；分区不跨快照
+  int rows = 0;
+  for (const auto &snapshot : snapshots)
+    rows += snapshot->size();
+  const int threads = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+  const int partitionCount = qBound(1, threads * 4, qMax(1, rows / 2048));
+  const int step = qMax(1, (rows + partitionCount - 1) / partitionCount);
+  QVector<Partition> partitions;
+  for (int s = 0; s < snapshots.size(); s++) {
+    const int size = snapshots[s]->size();
+    for (int begin = 0; begin < size; begin += step) {
+      partitions.append({s, begin, qMin(size, begin + step)});
+    }
+  }
+
+  auto timer = std::make_shared<QElapsedTimer>();
+  timer->start();
+
+  auto map = [snapshots, from, to](const Partition &p) {
+    XSL_TRACE_SCOPE("ReportEngine::map");
+    const LedgerSnapshot &snapshot = *snapshots[p.snapshot];
+    ReportPartial partial;
+    for (int i = p.begin; i < p.end; i++) {
+      const SocialAction &a = snapshot.at(i);
+      if (!a.reciprocated)
+        continue;
+      bool isLike = a.type == QLatin1String("like");
+      if (!isLike && a.type != QLatin1String("reply"))
+        continue;
+      // 快照里的时间戳已解析过
+      const qint64 ms = snapshot.epochMs(i);
+      if (ms == LLONG_MIN)
+        continue;
+      QDate date = QDateTime::fromMSecsSinceEpoch(ms).toLocalTime().date();
+      if (date < from || date > to)
+        continue;
+
+      ReportPartial::HandleTotals &t = partial.handles[a.userHandle];
+      if (t.name.isEmpty())
+        t.name = a.userName;
+      ReportPartial::DayTotals &d = partial.days[date];
+      if (isLike) {
+        t.likes++;
+        d.likes++;
+        partial.likes++;
+      } else {
+        t.replies++;
+        d.replies++;
+        partial.replies++;
+      }
+    }
+    return partial;
+  };
+  auto reduce = [](ReportPartial &result, const ReportPartial &partial) {
+    result.merge(partial);
+  };
+
+  int partitionsUsed = partitions.size();
+  return QtConcurrent::mappedReduced<ReportPartial>(
+             partitions, map, reduce, QtConcurrent::UnorderedReduce)
+      .then([from, to, rows, partitionsUsed, timer](ReportPartial totals) {
+        static Histogram *latency = Metrics::instance()->histogram(
+            "xsl_report_seconds", "Duration of a date-range report");
+        RangeReport report;
+        report.from = from;
+        report.to = to;
+        report.totals = std::move(totals);
+        report.partitions = partitionsUsed;
+        report.rowsScanned = rows;
+        report.elapsedMs = timer->elapsed();
+        latency->record(quint64(timer->nsecsElapsed() / 1000));
+        return report;
+      });
+}
+
+QString RangeReport::toMarkdown(int topN) const {
+  QString md;
+  md += QString("# %1 ~ %2\n\n")
+            .arg(from.toString("yyyy-MM-dd"), to.toString("yyyy-MM-dd"));
+  md += QString::fromUtf8("## 区间回馈统计\n\n");
+  md += QString::fromUtf8("- 已回馈用户数: **%1**\n").arg(totals.handles.size());
+  md += QString::fromUtf8("- 点赞数: **%1**\n").arg(totals.likes);
+  md += QString::fromUtf8("- 回复数: **%1**\n").arg(totals.replies);
+  md += QString::fromUtf8("- 总计: **%1**\n").arg(totals.likes + totals.replies);
+  md += QString::fromUtf8("- 活跃天数: **%1** / %2\n\n")
+            .arg(totals.days.size())
+            .arg(from.daysTo(to) + 1);
+
+  auto sorted = sortedHandles(totals);
+  if (sorted.isEmpty()) {
+    md += QString::fromUtf8("*该区间无回馈记录*\n");
+  } else {
+    md += QString::fromUtf8("| # | 用户 | 点赞 | 回复 | 合计 |\n");
+    md += "|---|------|-------|---------|-------|\n";
+    int rank = 1;
+    for (const auto &p : sorted) {
+      if (rank > topN)
+        break;
+      md += QString("| %1 | @%2 | %3 | %4 | %5 |\n")
+                .arg(rank++)
+                .arg(p.first)
+                .arg(p.second.likes)
+                .arg(p.second.replies)
+                .arg(p.second.total());
+    }
+  }
+
+  md += QString::fromUtf8("\n*%1 行 / %2 个分区 / %3 ms*\n")
+            .arg(rowsScanned)
+            .arg(partitions)
+            .arg(elapsedMs);
+  return md;
+}
+
+QString RangeReport::toCsv() const {
+  QString csv = "handle,name,likes,replies,total\n";
+  for (const auto &p : sortedHandles(totals)) {
+    csv += QString("%1,%2,%3,%4,%5\n")
+               .arg(csvField(p.first), csvField(p.second.name))
+               .arg(p.second.likes)
+               .arg(p.second.replies)
+               .arg(p.second.total());
+  }
+  return csv;
+}
@@ -0,0 +1,61 @@
+#ifndef REPORTENGINE_H
+#define REPORTENGINE_H
+
+#include "SocialAction.h"
+#include <QDate>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <memory>
+
+class LedgerSnapshot;
+
+// 可合并的部分统计：各分区独立计算，最后按任意顺序合并
+struct ReportPartial {
+  struct HandleTotals {
+    QString name;
+    int likes = 0;
+    int replies = 0;
+    int total() const { return likes + replies; }
+  };
+  struct DayTotals {
+    int likes = 0;
+    int replies = 0;
+  };
+
+  QHash<QString, HandleTotals> handles;
+  QMap<QDate, DayTotals> days;
+  int likes = 0;
+  int replies = 0;
+
+  void merge(const ReportPartial &other);
+};
+
+struct RangeReport {
+  QDate from;
+  QDate to;
+  ReportPartial totals;
+  int partitions = 0;
+  qint64 rowsScanned = 0;
+  qint64 elapsedMs = 0;
+
+  QString toMarkdown(int topN = 100) const;
+  QString toCsv() const; // 每个用户一行
+};
+
+// 区间回馈报告 - map-reduce 计算
+//
+// 各类型的账本快照按行切成若干分区，QtConcurrent::mappedReduced 在全局
+// 线程池上并行统计每个分区（已回馈、日期落在区间内的记录），再合并部分
+// 结果。快照来自 LedgerViewCache，不可变，工作线程只读，不访问存储。
+class ReportEngine {
+public:
+  using Snapshots = QList<std::shared_ptr<const LedgerSnapshot>>;
+
+  static QFuture<RangeReport> run(const Snapshots &snapshots,
+                                  const QDate &from, const QDate &to);
+};
+
+#endif // REPORTENGINE_H
@@ -0,0 +1,105 @@
+#include "SnippetStore.h"
+#include "App/Metrics.h"
+#include <QMutexLocker>
+
+SnippetStore *SnippetStore::instance() {
+  static SnippetStore s_instance;
+  return &s_instance;
+}
+
+SnippetId SnippetStore::hashOf(const QString &text) {
+  // FNV-1a 64，按 UTF-16 码元
+  quint64 h = 14695981039346656037ULL;
+  for (QChar c : text) {
+    h ^= c.unicode();
+    h *= 1099511628211ULL;
+  }
+  return h ? h : 1;
+}
+
+SnippetStore::Blob *SnippetStore::intern(const QString &text) {
+  if (text.isEmpty())
+    return nullptr;
+  SnippetId id = hashOf(text);
+
+  QMutexLocker lock(&m_mutex);
+  Blob *blob = nullptr;
+  // 哈希碰撞时线性探测下一个 id
+  for (;; id = id + 1 ? id + 1 : 1) {
+    auto it = m_blobs.find(id);
+    if (it == m_blobs.end())
+      break;
+    Blob *existing = it.value();
+    if (existing->text != text)
+      continue;
+    // 只在引用数非 0 时加一：0 表示最后一个 release 正要删除它，
+    // 不能复活。把它从表里摘掉（由那个 release 释放），在原位新建
+    qint64 refs = existing->refs.load(std::memory_order_relaxed);
+    while (refs > 0 && !existing->refs.compare_exchange_weak(
+                           refs, refs + 1, std::memory_order_acq_rel)) {
+    }
+    if (refs > 0) {
+      blob = existing;
+    } else {
+      m_blobs.erase(it);
+    }
+    break;
+  }
+  if (!blob) {
+    blob = new Blob{id, text};
+    m_blobs.insert(id, blob);
+    m_bytes += text.size() * qint64(sizeof(QChar));
+  }
+  m_refs.fetch_add(1, std::memory_order_relaxed);
+  return blob;
+}
+
+void SnippetStore::retain(Blob *blob) {
+  if (!blob)
+    return;
+  blob->refs.fetch_add(1, std::memory_order_relaxed);
+  m_refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SnippetStore::release(Blob *blob) {
+  if (!blob)
+    return;
+  m_refs.fetch_sub(1, std::memory_order_relaxed);
+  if (blob->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    return;
+
+  // 归零后不会再被 intern 取回，这里是唯一的删除者
+  QMutexLocker lock(&m_mutex);
+  auto it = m_blobs.find(blob->id);
+  if (it != m_blobs.end() && it.value() == blob)
+    m_blobs.erase(it);
+  m_bytes -= blob->text.size() * qint64(sizeof(QChar));
+  delete blob;
+}
+
+int SnippetStore::blobCount() const {
+  QMutexLocker lock(&m_mutex);
+  return m_blobs.size();
+}
+
+qint64 SnippetStore::blobBytes() const {
+  QMutexLocker lock(&m_mutex);
+  return m_bytes;
+}
+
+qint64 SnippetStore::referenceCount() const {
+  return m_refs.load(std::memory_order_relaxed);
+}
+
+void SnippetStore::publishMetrics() const {
+  static Gauge *blobs = Metrics::instance()->gauge(
+      "xsl_snippet_blobs", "Distinct post snippets held by SnippetStore");
+  static Gauge *bytes = Metrics::instance()->gauge(
+      "xsl_snippet_bytes", "UTF-16 bytes held by SnippetStore");
+  static Gauge *refs = Metrics::instance()->gauge(
+      "xsl_snippet_references", "Live references to stored snippets");
+  QMutexLocker lock(&m_mutex);
+  blobs->set(m_blobs.size());
+  bytes->set(m_bytes);
+  refs->set(m_refs.load(std::memory_order_relaxed));
+}
@@ -0,0 +1,82 @@
+#ifndef SNIPPETSTORE_H
+#define SNIPPETSTORE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+
+using SnippetId = quint64; // 0 = 空片段
+
+// 帖子片段的内容寻址存储
+//
+// 同一帖子的每个点赞者都带着相同的 postSnippet (通知正文前 120 字)。
+// 这里按 64 位内容哈希保存一份文本并做引用计数，记录、索引和表格只持有
+// SnippetRef。文本创建后不再修改，读取和复制引用都不加锁；只有 intern
+// 和最后一个引用释放时才取锁。
+class SnippetStore {
+public:
+  struct Blob {
+    SnippetId id;
+    QString text;
+    std::atomic<qint64> refs{1};
+  };
+
+  static SnippetStore *instance();
+
+  // 64 位内容哈希（FNV-1a），跨进程稳定；账本库的 snippets 表也用它作 id
+  static SnippetId hashOf(const QString &text);
+
+  // Adds one reference. Equal text shares one blob while that blob is alive,
+  // with one exception: after probing past a colliding blob, freeing the
+  // colliding blob lets the same text be interned again at the vacated id,
+  // giving a second blob with identical content. Returns nullptr for "".
+  Blob *intern(const QString &text);
+  void retain(Blob *blob);  // 无锁，调用方必须已持有引用
+  void release(Blob *blob); // 最后一个引用释放时取锁删除
+
+  int blobCount() const;
+  qint64 blobBytes() const;
+  qint64 referenceCount() const;
+
+  // 更新 xsl_snippet_* 指标；由主窗口定时调用，不在每次 intern 时发布
+  void publishMetrics() const;
+
+private:
+  SnippetStore() = default;
+
+  mutable QMutex m_mutex;
+  QHash<SnippetId, Blob *> m_blobs; // 受 m_mutex 保护
+  qint64 m_bytes = 0;               // 受 m_mutex 保护
+  std::atomic<qint64> m_refs{0};
+};
+
+// Counted reference to a snippet; cheap to copy (8 bytes, no lock)
+class SnippetRef {
+public:
+  SnippetRef() = default;
+  explicit SnippetRef(const QString &text)
+      : m_blob(SnippetStore::instance()->intern(text)) {}
+  SnippetRef(const SnippetRef &other) : m_blob(other.m_blob) {
+    SnippetStore::instance()->retain(m_blob);
+  }
+  SnippetRef &operator=(const SnippetRef &other) {
+    if (m_blob != other.m_blob) {
+      SnippetStore::instance()->retain(other.m_blob);
+      SnippetStore::instance()->release(m_blob);
+      m_blob = other.m_blob;
+    }
+    return *this;
+  }
+  ~SnippetRef() { SnippetStore::instance()->release(m_blob); }
+
+  SnippetId id() const { return m_blob ? m_blob->id : 0; }
+  bool isEmpty() const { return !m_blob; }
+  // 共享同一份 QString 数据：不解码、不分配
+  QString text() const { return m_blob ? m_blob->text : QString(); }
+
+private:
+  SnippetStore::Blob *m_blob = nullptr;
+};
+
+#endif // SNIPPETSTORE_H
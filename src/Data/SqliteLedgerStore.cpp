@@ -0,0 +1,1054 @@
+#include "SqliteLedgerStore.h"
+#include "App/Trace.h"
+#include "SnippetStore.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QMap>
+#include <QSet>
+#include <QSqlError>
+#include <QStandardPaths>
+#include <QUuid>
+#include <QVariant>
+#include <QtEndian>
+
+namespace {
+
+// 片段按 id 从 snippets 表取回
+const char *kColumns =
+    "id, handle, name, type, ts, "
+    "(SELECT text FROM snippets WHERE hash = snippet_id), link, reciprocated";
+const char *kLikeTypes = "('like', 'list_like')";
+// 触发器里的当前时间（毫秒）；strftime('%s') 只到秒，同一秒内删除又
+// 重新写入会比不出先后
+const char *kNowMs =
+    "CAST((julianday('now') - 2440587.5) * 86400000 AS INTEGER)";
+
+// 序号自增且不复用（AUTOINCREMENT），清理之后水位仍然有效
+const char *kCreateTombstones =
+    "CREATE TABLE IF NOT EXISTS tombstones ("
+    "  seq INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "  id TEXT NOT NULL UNIQUE,"
+    "  deleted_ms INTEGER NOT NULL)";
+
+// 内容寻址：片段 id 是文本的 FNV-1a 哈希，碰撞时顺延到下一个空位；
+// 已存在的相同文本直接复用。空片段为 NULL，失败也为 NULL
+QVariant internSnippet(QSqlQuery &find, QSqlQuery &add, const QString &text) {
+  if (text.isEmpty())
+    return QVariant();
+  for (SnippetId id = SnippetStore::hashOf(text);; id = id + 1 ? id + 1 : 1) {
+    find.bindValue(0, qint64(id));
+    if (!find.exec()) {
+      qWarning() << "[SqliteLedgerStore] snippet lookup failed:"
+                 << find.lastError().text();
+      return QVariant();
+    }
+    const bool taken = find.next();
+    const bool same = taken && find.value(0).toString() == text;
+    find.finish();
+    if (same)
+      return qint64(id);
+    if (taken)
+      continue;
+    add.bindValue(0, qint64(id));
+    add.bindValue(1, text);
+    if (!add.exec()) {
+      qWarning() << "[SqliteLedgerStore] snippet insert failed:"
+                 << add.lastError().text();
+      return QVariant();
+    }
+    return qint64(id);
+  }
+}
+
+QVariant epochMs(const QString &timestamp) {
+  QDateTime dt = QDateTime::fromString(timestamp, Qt::ISODateWithMs);
+  return dt.isValid() ? QVariant(dt.toMSecsSinceEpoch()) : QVariant();
+}
+
+// 分区键：UTC 日期，两台机器时区不同也落在同一分区
+QString dayKey(const QVariant &tsMs) {
+  if (tsMs.isNull())
+    return "0000-00-00";
+  return QDateTime::fromMSecsSinceEpoch(tsMs.toLongLong())
+      .toUTC()
+      .toString("yyyy-MM-dd");
+}
+
+// 摘要只覆盖同步会合并的状态：id（已含 handle/type/时间戳）和回馈状态。
+// 昵称、片段等字段同步不调和，算进摘要会让两边永远不一致、每次重比。
+// 改变摘要定义时递增，旧库打开时重算
+const int kDigestVersion = 2;
+
+// 记录摘要：对 id 做一次 SHA-256，前 8 字节是未回馈状态的摘要，
+// 后 8 字节是已回馈状态的摘要；切换回馈状态不必重新计算
+struct RowDigest {
+  qint64 pending;
+  qint64 reciprocated;
+};
+
+RowDigest rowDigest(const QString &id) {
+  const QByteArray d =
+      QCryptographicHash::hash(id.toUtf8(), QCryptographicHash::Sha256);
+  return {qFromLittleEndian<qint64>(d.constData()),
+          qFromLittleEndian<qint64>(d.constData() + 8)};
+}
+
+// 分区摘要是成员摘要的异或，触发器增量维护；SQLite 没有异或运算符
+QString sqlXor(const QString &a, const QString &b) {
+  return QString("((%1) | (%2)) & ~((%1) & (%2))").arg(a, b);
+}
+
+QString effectiveDigest(const QString &row) {
+  return QString("CASE WHEN %1.reciprocated THEN %1.digest1 "
+                 "ELSE %1.digest0 END")
+      .arg(row);
+}
+
+} // namespace
+
+struct SqliteLedgerStore::Statements {
+  explicit Statements(const QSqlDatabase &db)
+      : insert(db), markReciprocated(db), removeByHandle(db), loadLikes(db),
+        loadReplies(db), byDate(db), likeCount(db), replyCount(db),
+        pendingLikeCount(db), pendingReplyCount(db), search(db),
+        searchLike(db), isEmpty(db), scan(db), months(db), days(db),
+        dayRows(db), syncUpdate(db), tombstonesAfter(db),
+        lastTombstoneSeq(db), tombstoneMark(db), setTombstoneMark(db),
+        pruneTombstones(db), deletedAt(db), addedAt(db), bury(db),
+        removeById(db), findSnippet(db), addSnippet(db), pruneSnippets(db) {}
+
+  bool prepareAll(bool fts);
+
+  QSqlQuery insert;
+  QSqlQuery markReciprocated;
+  QSqlQuery removeByHandle;
+  QSqlQuery loadLikes;
+  QSqlQuery loadReplies;
+  QSqlQuery byDate;
+  QSqlQuery likeCount;
+  QSqlQuery replyCount;
+  QSqlQuery pendingLikeCount;
+  QSqlQuery pendingReplyCount;
+  QSqlQuery search;     // FTS5
+  QSqlQuery searchLike; // 短查询或无 FTS5 时的回退
+  QSqlQuery isEmpty;
+  QSqlQuery scan; // 只进游标，逐行读取
+  QSqlQuery months;
+  QSqlQuery days;
+  QSqlQuery dayRows;
+  QSqlQuery syncUpdate;
+  QSqlQuery tombstonesAfter;
+  QSqlQuery lastTombstoneSeq;
+  QSqlQuery tombstoneMark;
+  QSqlQuery setTombstoneMark;
+  QSqlQuery pruneTombstones;
+  QSqlQuery deletedAt;
+  QSqlQuery addedAt;
+  QSqlQuery bury;
+  QSqlQuery removeById;
+  QSqlQuery findSnippet;
+  QSqlQuery addSnippet;
+  QSqlQuery pruneSnippets;
+};
+
+bool SqliteLedgerStore::Statements::prepareAll(bool fts) {
+  const QString cols = kColumns;
+  const QString likes = kLikeTypes;
+  struct Item {
+    QSqlQuery *query;
+    QString sql;
+  };
+  QList<Item> items = {
+      {&insert, "INSERT OR IGNORE INTO actions (id, handle, name, type, ts, "
+                "ts_ms, snippet_id, link, reciprocated, recip_ms, day, "
+                "digest0, digest1, added_ms) "
+                "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"},
+      {&markReciprocated, "UPDATE actions SET reciprocated = ?, recip_ms = ? "
+                          "WHERE id = ? AND reciprocated <> ?"},
+      {&removeByHandle, "DELETE FROM actions WHERE handle = ?"},
+      {&loadLikes,
+       "SELECT " + cols + " FROM actions WHERE type IN " + likes},
+      {&loadReplies, "SELECT " + cols + " FROM actions WHERE type = 'reply'"},
+      {&byDate, "SELECT " + cols +
+                    " FROM actions WHERE type IN ('like', 'list_like', "
+                    "'reply') AND ts_ms >= ? AND ts_ms < ? "
+                    "AND reciprocated = 1"},
+      {&likeCount, "SELECT COUNT(*) FROM actions WHERE type IN " + likes},
+      {&replyCount, "SELECT COUNT(*) FROM actions WHERE type = 'reply'"},
+      {&pendingLikeCount, "SELECT COUNT(*) FROM actions WHERE type IN " +
+                              likes + " AND reciprocated = 0"},
+      {&pendingReplyCount, "SELECT COUNT(*) FROM actions "
+                           "WHERE type = 'reply' AND reciprocated = 0"},
+      {&searchLike, "SELECT " + cols +
+                        " FROM actions WHERE snippet_id IN (SELECT hash FROM "
+                        "snippets WHERE text LIKE ? ESCAPE '\\') "
+                        "ORDER BY ts_ms DESC LIMIT ?"},
+      {&isEmpty, "SELECT NOT EXISTS (SELECT 1 FROM actions)"},
+      {&scan, "SELECT " + cols + " FROM actions WHERE type IN " + likes +
+                  " OR type = 'reply'"},
+      {&months, "SELECT month, x, n FROM ledger_months ORDER BY month"},
+      {&days, "SELECT day, x, n FROM ledger_days "
+              "WHERE day >= ? AND day < ? ORDER BY day"},
+      {&dayRows, "SELECT " + cols +
+                     ", recip_ms, added_ms FROM actions WHERE day = ?"},
+      {&syncUpdate, "UPDATE actions SET reciprocated = ?, recip_ms = ? "
+                    "WHERE id = ? AND reciprocated <> ?"},
+      {&tombstonesAfter, "SELECT seq, id, deleted_ms FROM tombstones "
+                         "WHERE seq > ? ORDER BY seq"},
+      {&lastTombstoneSeq, "SELECT COALESCE((SELECT seq FROM sqlite_sequence "
+                          "WHERE name = 'tombstones'), 0)"},
+      {&tombstoneMark, "SELECT seq FROM tombstone_marks WHERE peer = ?"},
+      {&setTombstoneMark, "INSERT INTO tombstone_marks (peer, seq) "
+                          "VALUES (?, ?) ON CONFLICT (peer) "
+                          "DO UPDATE SET seq = excluded.seq"},
+      {&pruneTombstones, "DELETE FROM tombstones WHERE seq <= "
+                         "(SELECT MIN(seq) FROM tombstone_marks)"},
+      {&deletedAt, "SELECT deleted_ms FROM tombstones WHERE id = ?"},
+      {&addedAt, "SELECT added_ms FROM actions WHERE id = ?"},
+      {&bury, "INSERT OR IGNORE INTO tombstones (id, deleted_ms) "
+              "VALUES (?, ?)"},
+      {&removeById, "DELETE FROM actions WHERE id = ?"},
+      {&findSnippet, "SELECT text FROM snippets WHERE hash = ?"},
+      {&addSnippet, "INSERT INTO snippets (hash, text) VALUES (?, ?)"},
+      {&pruneSnippets, "DELETE FROM snippets WHERE NOT EXISTS (SELECT 1 "
+                       "FROM actions WHERE snippet_id = snippets.hash)"},
+  };
+  scan.setForwardOnly(true);
+  if (fts) {
+    items.append(
+        {&search, "SELECT a.id, a.handle, a.name, a.type, a.ts, (SELECT text "
+                  "FROM snippets WHERE hash = a.snippet_id), a.link, "
+                  "a.reciprocated FROM actions_fts "
+                  "JOIN actions a ON a.seq = actions_fts.rowid "
+                  "WHERE actions_fts MATCH ? ORDER BY a.ts_ms DESC LIMIT ?"});
+  }
+
+  for (Item &item : items) {
+    if (!item.query->prepare(item.sql)) {
+      qWarning() << "[SqliteLedgerStore] prepare failed:"
+                 << item.query->lastError().text() << item.sql;
+      return false;
+    }
+  }
+  return true;
+}
+
+SqliteLedgerStore::SqliteLedgerStore(const QString &filePath, QObject *parent)
+    : SqliteLedgerStore(filePath, Journal::Wal, parent) {}
+
+SqliteLedgerStore::SqliteLedgerStore(const QString &filePath, Journal journal,
+                                     QObject *parent)
+    : LedgerStore(parent),
+      m_connection(QString("ledger-%1").arg(quintptr(this), 0, 16)),
+      m_open(false), m_fts(false) {
+  m_open = openDatabase(filePath, journal);
+}
+
+SqliteLedgerStore::~SqliteLedgerStore() {
+  if (m_open)
+    flush();
+  m_sql.reset();
+  m_db.close();
+  m_db = QSqlDatabase();
+  QSqlDatabase::removeDatabase(m_connection);
+}
+
+QString SqliteLedgerStore::defaultFilePath() {
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+         "/ledger.sqlite";
+}
+
+bool SqliteLedgerStore::openDatabase(const QString &filePath,
+                                     Journal journal) {
+  XSL_TRACE_SCOPE("SqliteLedgerStore::open");
+  QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+  m_db = QSqlDatabase::addDatabase("QSQLITE", m_connection);
+  m_db.setDatabaseName(filePath);
+  m_filePath = QFileInfo(filePath).absoluteFilePath();
+  m_db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+  if (!m_db.open()) {
+    qWarning() << "[SqliteLedgerStore] Cannot open" << filePath
+               << m_db.lastError().text();
+    return false;
+  }
+
+  if (journal == Journal::Wal) {
+    // WAL：读不阻塞写；NORMAL 在 WAL 下只在检查点时 fsync
+    exec("PRAGMA journal_mode = WAL");
+    exec("PRAGMA synchronous = NORMAL");
+  } else {
+    // 回滚日志：文件曾以 WAL 打开过也切换回来（需要独占，同步时满足）；
+    // 每次提交 fsync，共享目录上掉线也不留半个事务
+    exec("PRAGMA journal_mode = DELETE");
+    exec("PRAGMA synchronous = FULL");
+  }
+  exec("PRAGMA temp_store = MEMORY");
+  if (!createSchema() || !resetStaleDigests() || !backfillDigests())
+    return false;
+
+  m_sql = std::make_unique<Statements>(m_db);
+  return m_sql->prepareAll(m_fts);
+}
+
+bool SqliteLedgerStore::createSchema() {
+  bool ok =
+      exec("CREATE TABLE IF NOT EXISTS actions ("
+           "  seq INTEGER PRIMARY KEY,"
+           "  id TEXT NOT NULL UNIQUE,"
+           "  handle TEXT NOT NULL COLLATE NOCASE,"
+           "  name TEXT,"
+           "  type TEXT NOT NULL,"
+           "  ts TEXT NOT NULL,"
+           "  ts_ms INTEGER," // 解析后的时间戳，无效为 NULL
+           "  link TEXT,"
+           "  reciprocated INTEGER NOT NULL DEFAULT 0)") &&
+      addMissingColumns() &&
+      // 覆盖计数与按日查询，不回表
+      exec("CREATE INDEX IF NOT EXISTS actions_type_ts "
+           "ON actions (type, ts_ms, reciprocated)") &&
+      exec("CREATE INDEX IF NOT EXISTS actions_handle ON actions (handle)") &&
+      exec("CREATE INDEX IF NOT EXISTS actions_day ON actions (day)") &&
+      // 片段按内容存一份，记录只引用 id；同一帖子的点赞者共用一行
+      exec("CREATE TABLE IF NOT EXISTS snippets ("
+           "  hash INTEGER PRIMARY KEY,"
+           "  text TEXT NOT NULL)") &&
+      exec("CREATE INDEX IF NOT EXISTS actions_snippet "
+           "ON actions (snippet_id)") &&
+      migrateSnippets() &&
+      createPartitionSchema() &&
+      // 墓碑：任何删除都记下 id，同步时不再从对端拉回；
+      // 同一 id 重新写入时清除，否则两边摘要永远对不上
+      migrateTombstones() && exec(kCreateTombstones) &&
+      exec("CREATE TRIGGER IF NOT EXISTS actions_tombstone AFTER DELETE ON "
+           "actions BEGIN INSERT OR IGNORE INTO tombstones (id, deleted_ms) "
+           "VALUES (old.id, " + QString(kNowMs) + "); END") &&
+      exec("CREATE TRIGGER IF NOT EXISTS actions_untomb AFTER INSERT ON "
+           "actions BEGIN DELETE FROM tombstones WHERE id = new.id; END") &&
+      // 每个对端已收到的本库墓碑序号
+      exec("CREATE TABLE IF NOT EXISTS tombstone_marks ("
+           "  peer TEXT PRIMARY KEY,"
+           "  seq INTEGER NOT NULL)") &&
+      loadLedgerId();
+  if (!ok)
+    return false;
+
+  // 外部内容 FTS5 表，内容来自把片段接回记录的视图，触发器同步；
+  // trigram 分词支持中文子串
+  if (!exec("CREATE VIEW IF NOT EXISTS actions_text AS "
+            "SELECT a.seq AS seq, s.text AS snippet FROM actions a "
+            "LEFT JOIN snippets s ON s.hash = a.snippet_id"))
+    return false;
+  QSqlQuery probe(m_db);
+  bool hadFts =
+      probe.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND "
+                 "name = 'actions_fts'") &&
+      probe.next();
+  probe.finish(); // 未结束的读语句会挡住下面的建表
+  m_fts =
+      exec("CREATE VIRTUAL TABLE IF NOT EXISTS actions_fts USING fts5("
+           "snippet, content = 'actions_text', content_rowid = 'seq', "
+           "tokenize = 'trigram')") &&
+      exec("CREATE TRIGGER IF NOT EXISTS actions_fts_insert AFTER INSERT ON "
+           "actions BEGIN INSERT INTO actions_fts (rowid, snippet) "
+           "VALUES (new.seq, (SELECT text FROM snippets "
+           "WHERE hash = new.snippet_id)); END") &&
+      // 孤立片段在删除语句之后才清理，这里还能取到原文
+      exec("CREATE TRIGGER IF NOT EXISTS actions_fts_delete AFTER DELETE ON "
+           "actions BEGIN INSERT INTO actions_fts (actions_fts, rowid, "
+           "snippet) VALUES ('delete', old.seq, (SELECT text FROM snippets "
+           "WHERE hash = old.snippet_id)); END");
+  // 旧库（或曾在没有 FTS5 的环境里写入）已有记录：新建的索引是空的，
+  // 触发器只管之后的写入，这里按内容表重建一次
+  if (m_fts && !hadFts && probe.exec("SELECT 1 FROM actions LIMIT 1") &&
+      probe.next()) {
+    probe.finish();
+    qDebug() << "[SqliteLedgerStore] Building full-text index";
+    m_fts = exec("INSERT INTO actions_fts (actions_fts) VALUES ('rebuild')");
+  }
+  if (!m_fts) {
+    qWarning() << "[SqliteLedgerStore] FTS5 unavailable, snippet search "
+                  "falls back to LIKE";
+  }
+  return true;
+}
+
+bool SqliteLedgerStore::addMissingColumns() {
+  // 旧库升级：同步所需的列
+  QSet<QString> existing;
+  QSqlQuery info(m_db);
+  if (!info.exec("PRAGMA table_info(actions)"))
+    return false;
+  while (info.next())
+    existing.insert(info.value(1).toString());
+
+  const QList<QPair<QString, QString>> columns = {
+      {"recip_ms", "INTEGER NOT NULL DEFAULT 0"}, // 回馈状态最后修改时间
+      {"day", "TEXT"},                            // UTC 日期分区
+      {"digest0", "INTEGER"},                     // 未回馈时的记录摘要
+      {"digest1", "INTEGER"},                     // 已回馈时的记录摘要
+      {"added_ms", "INTEGER NOT NULL DEFAULT 0"}, // 写入时间，0 = 升级前
+      {"snippet_id", "INTEGER"},                  // snippets.hash，空片段 NULL
+  };
+  for (const auto &column : columns) {
+    if (!existing.contains(column.first) &&
+        !exec("ALTER TABLE actions ADD COLUMN " + column.first + " " +
+              column.second))
+      return false;
+  }
+  return true;
+}
+
+bool SqliteLedgerStore::migrateTombstones() {
+  // 第一版墓碑表没有序号：改名、按新结构重建、按原顺序拷回。
+  // 改名会改写触发器里的表名，先删掉两个触发器，随后按新表重建
+  QSqlQuery info(m_db);
+  if (!info.exec("PRAGMA table_info(tombstones)"))
+    return false;
+  bool exists = false, hasSeq = false;
+  while (info.next()) {
+    exists = true;
+    hasSeq |= info.value(1).toString() == "seq";
+  }
+  info.finish();
+  if (!exists || hasSeq)
+    return true;
+
+  m_db.transaction();
+  bool ok = exec("DROP TRIGGER IF EXISTS actions_tombstone") &&
+            exec("DROP TRIGGER IF EXISTS actions_untomb") &&
+            exec("ALTER TABLE tombstones RENAME TO tombstones_v1") &&
+            exec(kCreateTombstones) &&
+            exec("INSERT INTO tombstones (id, deleted_ms) "
+                 "SELECT id, deleted_ms FROM tombstones_v1 ORDER BY rowid") &&
+            exec("DROP TABLE tombstones_v1");
+  if (!ok) {
+    m_db.rollback();
+    return false;
+  }
+  return m_db.commit();
+}
+
+bool SqliteLedgerStore::migrateSnippets() {
+  // 旧库的片段内联在 actions.snippet：按内容写进 snippets 表、记下 id，
+  // 然后删掉原列（SQLite 3.35 之前不支持，退而清空）。
+  // 原 FTS5 索引以 actions 为内容表，删掉后按 actions_text 视图重建
+  QSqlQuery probe(m_db);
+  if (!probe.exec("SELECT 1 FROM sqlite_master WHERE type = 'view' AND "
+                  "name = 'actions_text'"))
+    return false;
+  const bool hasView = probe.next();
+  probe.finish();
+  if (!hasView && !(exec("DROP TRIGGER IF EXISTS actions_fts_insert") &&
+                    exec("DROP TRIGGER IF EXISTS actions_fts_delete") &&
+                    exec("DROP TABLE IF EXISTS actions_fts")))
+    return false;
+
+  if (!probe.exec("PRAGMA table_info(actions)"))
+    return false;
+  bool hasInline = false;
+  while (probe.next())
+    hasInline |= probe.value(1).toString() == "snippet";
+  probe.finish();
+  if (!hasInline)
+    return true;
+
+  QStringList texts;
+  probe.setForwardOnly(true);
+  if (!probe.exec("SELECT DISTINCT snippet FROM actions "
+                  "WHERE snippet IS NOT NULL AND snippet <> ''"))
+    return false;
+  while (probe.next())
+    texts.append(probe.value(0).toString());
+  probe.finish();
+
+  XSL_TRACE_SCOPE("SqliteLedgerStore::migrateSnippets");
+  m_db.transaction();
+  QSqlQuery find(m_db), add(m_db), update(m_db);
+  bool ok = find.prepare("SELECT text FROM snippets WHERE hash = ?") &&
+            add.prepare("INSERT INTO snippets (hash, text) VALUES (?, ?)") &&
+            update.prepare("UPDATE actions SET snippet_id = ? "
+                           "WHERE snippet = ?");
+  for (int i = 0; ok && i < texts.size(); i++) {
+    const QVariant id = internSnippet(find, add, texts[i]);
+    update.bindValue(0, id);
+    update.bindValue(1, texts[i]);
+    ok = !id.isNull() && update.exec();
+  }
+  ok = ok && (exec("ALTER TABLE actions DROP COLUMN snippet") ||
+              exec("UPDATE actions SET snippet = NULL"));
+  if (!ok) {
+    m_db.rollback();
+    return false;
+  }
+  if (!texts.isEmpty())
+    qDebug() << "[SqliteLedgerStore] Moved" << texts.size()
+             << "distinct snippets out of actions";
+  return m_db.commit();
+}
+
+bool SqliteLedgerStore::loadLedgerId() {
+  if (!exec("CREATE TABLE IF NOT EXISTS ledger_meta ("
+            "  key TEXT PRIMARY KEY,"
+            "  value TEXT NOT NULL)") ||
+      !exec("INSERT OR IGNORE INTO ledger_meta (key, value) VALUES "
+            "('ledger_id', '" +
+            QUuid::createUuid().toString(QUuid::WithoutBraces) + "')"))
+    return false;
+  QSqlQuery q(m_db);
+  if (!q.exec("SELECT value FROM ledger_meta WHERE key = 'ledger_id'") ||
+      !q.next())
+    return false;
+  m_ledgerId = q.value(0).toString();
+  return true;
+}
+
+bool SqliteLedgerStore::createPartitionSchema() {
+  // 两层分区摘要：日 → 月，根哈希由月摘要算出。触发器随增删改维护，
+  // 比较两份账本只需读几百行摘要
+  struct Level {
+    QString table;
+    QString key;
+    QString keyOf; // %1 = new / old
+  };
+  const QList<Level> levels = {
+      {"ledger_days", "day", "%1.day"},
+      {"ledger_months", "month", "substr(%1.day, 1, 7)"},
+  };
+
+  QString onInsert, onDelete, onUpdate;
+  for (const Level &l : levels) {
+    if (!exec("CREATE TABLE IF NOT EXISTS " + l.table + " (" + l.key +
+              " TEXT PRIMARY KEY, x INTEGER NOT NULL, n INTEGER NOT NULL)"))
+      return false;
+    const QString newKey = l.keyOf.arg("new");
+    const QString oldKey = l.keyOf.arg("old");
+    onInsert += QString("INSERT INTO %1 (%2, x, n) VALUES (%3, %4, 1) "
+                        "ON CONFLICT (%2) DO UPDATE SET x = %5, n = n + 1; ")
+                    .arg(l.table, l.key, newKey, effectiveDigest("new"),
+                         sqlXor("x", "excluded.x"));
+    onDelete += QString("UPDATE %1 SET x = %4, n = n - 1 WHERE %2 = %3; "
+                        "DELETE FROM %1 WHERE %2 = %3 AND n <= 0; ")
+                    .arg(l.table, l.key, oldKey,
+                         sqlXor("x", effectiveDigest("old")));
+    onUpdate += QString("UPDATE %1 SET x = %4 WHERE %2 = %3; ")
+                    .arg(l.table, l.key, newKey,
+                         sqlXor("x", sqlXor(effectiveDigest("old"),
+                                            effectiveDigest("new"))));
+  }
+
+  return exec("CREATE TRIGGER IF NOT EXISTS actions_part_insert AFTER INSERT "
+              "ON actions BEGIN " + onInsert + "END") &&
+         exec("CREATE TRIGGER IF NOT EXISTS actions_part_delete AFTER DELETE "
+              "ON actions BEGIN " + onDelete + "END") &&
+         exec("CREATE TRIGGER IF NOT EXISTS actions_part_update AFTER UPDATE "
+              "OF reciprocated ON actions "
+              "WHEN old.reciprocated <> new.reciprocated BEGIN " +
+              onUpdate + "END");
+}
+
+bool SqliteLedgerStore::resetStaleDigests() {
+  // user_version 记录摘要定义的版本；旧定义的摘要清空，由 backfill 重算
+  QSqlQuery version(m_db);
+  if (!version.exec("PRAGMA user_version") || !version.next())
+    return false;
+  int current = version.value(0).toInt();
+  version.finish();
+  if (current >= kDigestVersion)
+    return true;
+  return exec("UPDATE actions SET digest0 = NULL, digest1 = NULL") &&
+         exec(QString("PRAGMA user_version = %1").arg(kDigestVersion));
+}
+
+bool SqliteLedgerStore::backfillDigests() {
+  // 升级前写入的记录没有摘要：补算一次，然后重建分区表
+  QSqlQuery select(m_db);
+  select.setForwardOnly(true);
+  if (!select.exec("SELECT seq, id, ts_ms FROM actions WHERE digest0 IS NULL"))
+    return false;
+
+  struct Pending {
+    qint64 seq;
+    QString day;
+    RowDigest digest;
+  };
+  QList<Pending> pending;
+  while (select.next()) {
+    pending.append({select.value(0).toLongLong(), dayKey(select.value(2)),
+                    rowDigest(select.value(1).toString())});
+  }
+  select.finish();
+  if (pending.isEmpty())
+    return true;
+
+  XSL_TRACE_SCOPE("SqliteLedgerStore::backfillDigests");
+  m_db.transaction();
+  QSqlQuery update(m_db);
+  update.prepare(
+      "UPDATE actions SET day = ?, digest0 = ?, digest1 = ? WHERE seq = ?");
+  for (const Pending &p : pending) {
+    update.bindValue(0, p.day);
+    update.bindValue(1, p.digest.pending);
+    update.bindValue(2, p.digest.reciprocated);
+    update.bindValue(3, p.seq);
+    update.exec();
+  }
+
+  // 分区表整体重算：异或聚合在这里做，SQLite 没有对应的聚合函数
+  QMap<QString, QPair<qint64, int>> days;
+  QSqlQuery all(m_db);
+  all.setForwardOnly(true);
+  all.exec("SELECT day, reciprocated, digest0, digest1 FROM actions");
+  while (all.next()) {
+    auto &slot = days[all.value(0).toString()];
+    slot.first ^= all.value(all.value(1).toInt() ? 3 : 2).toLongLong();
+    slot.second++;
+  }
+  all.finish();
+  QMap<QString, QPair<qint64, int>> months;
+  for (auto it = days.cbegin(); it != days.cend(); ++it) {
+    auto &slot = months[it.key().left(7)];
+    slot.first ^= it.value().first;
+    slot.second += it.value().second;
+  }
+
+  exec("DELETE FROM ledger_days");
+  exec("DELETE FROM ledger_months");
+  QSqlQuery put(m_db);
+  for (const auto &level : {qMakePair(QString("ledger_days"), &days),
+                            qMakePair(QString("ledger_months"), &months)}) {
+    put.prepare("INSERT INTO " + level.first + " VALUES (?, ?, ?)");
+    for (auto it = level.second->cbegin(); it != level.second->cend(); ++it) {
+      put.bindValue(0, it.key());
+      put.bindValue(1, it.value().first);
+      put.bindValue(2, it.value().second);
+      put.exec();
+    }
+  }
+  bool ok = m_db.commit();
+  qDebug() << "[SqliteLedgerStore] Backfilled digests for" << pending.size()
+           << "records";
+  return ok;
+}
+
+bool SqliteLedgerStore::exec(const QString &sql) {
+  QSqlQuery query(m_db);
+  if (!query.exec(sql)) {
+    qWarning() << "[SqliteLedgerStore]" << query.lastError().text() << sql;
+    return false;
+  }
+  return true;
+}
+
+bool SqliteLedgerStore::isEmpty() const {
+  return !m_open || scalar(m_sql->isEmpty) != 0;
+}
+
+bool SqliteLedgerStore::insert(const SocialAction &action,
+                               qint64 reciprocatedAt, qint64 addedAt) {
+  QSqlQuery &q = m_sql->insert;
+  const QVariant tsMs = epochMs(action.timestamp);
+  const RowDigest digest = rowDigest(action.id);
+  const QVariant snippet =
+      internSnippet(m_sql->findSnippet, m_sql->addSnippet, action.postSnippet);
+  q.bindValue(0, action.id);
+  q.bindValue(1, action.userHandle);
+  q.bindValue(2, action.userName);
+  q.bindValue(3, action.type);
+  q.bindValue(4, action.timestamp);
+  q.bindValue(5, tsMs);
+  q.bindValue(6, snippet);
+  q.bindValue(7, action.statusLink);
+  q.bindValue(8, action.reciprocated ? 1 : 0);
+  q.bindValue(9, reciprocatedAt);
+  q.bindValue(10, dayKey(tsMs));
+  q.bindValue(11, digest.pending);
+  q.bindValue(12, digest.reciprocated);
+  q.bindValue(13, addedAt);
+  if (!q.exec()) {
+    qWarning() << "[SqliteLedgerStore] insert failed:" << q.lastError().text();
+    return false;
+  }
+  return q.numRowsAffected() > 0;
+}
+
+int SqliteLedgerStore::importActions(const QList<SocialAction> &actions) {
+  if (!m_open)
+    return 0;
+  XSL_TRACE_SCOPE("SqliteLedgerStore::import");
+  int added = 0;
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  m_db.transaction();
+  for (const SocialAction &a : actions) {
+    if (insert(a, 0, now))
+      added++;
+  }
+  m_db.commit();
+  return added;
+}
+
+bool SqliteLedgerStore::isSelf(const QString &handle) const {
+  return !m_selfHandle.isEmpty() &&
+         handle.compare(m_selfHandle, Qt::CaseInsensitive) == 0;
+}
+
+qint64 SqliteLedgerStore::deletedAt(const QString &id) const {
+  m_sql->deletedAt.bindValue(0, id);
+  return lookup(m_sql->deletedAt, -1);
+}
+
+qint64 SqliteLedgerStore::addedAt(const QString &id) const {
+  m_sql->addedAt.bindValue(0, id);
+  return lookup(m_sql->addedAt, -1);
+}
+
+bool SqliteLedgerStore::addAction(const SocialAction &action) {
+  if (!m_open)
+    return false;
+  if (isSelf(action.userHandle))
+    return false;
+  return insert(action, 0, QDateTime::currentMSecsSinceEpoch());
+}
+
+QList<SocialAction> SqliteLedgerStore::collect(QSqlQuery &query) const {
+  QList<SocialAction> result;
+  if (!query.exec()) {
+    qWarning() << "[SqliteLedgerStore] query failed:"
+               << query.lastError().text();
+    return result;
+  }
+  while (query.next()) {
+    result.append(rowToAction(query));
+  }
+  query.finish();
+  return result;
+}
+
+SocialAction SqliteLedgerStore::rowToAction(const QSqlQuery &query) {
+  SocialAction a;
+  a.id = query.value(0).toString();
+  a.userHandle = query.value(1).toString();
+  a.userName = query.value(2).toString();
+  a.type = query.value(3).toString();
+  a.timestamp = query.value(4).toString();
+  a.postSnippet = query.value(5).toString();
+  a.statusLink = query.value(6).toString();
+  a.reciprocated = query.value(7).toInt() != 0;
+  return a;
+}
+
+void SqliteLedgerStore::scan(
+    const std::function<bool(const SocialAction &)> &visit) const {
+  if (!m_open)
+    return;
+  XSL_TRACE_SCOPE("SqliteLedgerStore::scan");
+  QSqlQuery &q = m_sql->scan;
+  if (!q.exec()) {
+    qWarning() << "[SqliteLedgerStore] scan failed:" << q.lastError().text();
+    return;
+  }
+  while (q.next()) {
+    if (!visit(rowToAction(q)))
+      break;
+  }
+  q.finish();
+}
+
+int SqliteLedgerStore::scalar(QSqlQuery &query) const {
+  int value = 0;
+  if (query.exec() && query.next())
+    value = query.value(0).toInt();
+  query.finish();
+  return value;
+}
+
+qint64 SqliteLedgerStore::lookup(QSqlQuery &query, qint64 missing) const {
+  qint64 value = missing;
+  if (query.exec() && query.next())
+    value = query.value(0).toLongLong();
+  query.finish();
+  return value;
+}
+
+QList<SocialAction> SqliteLedgerStore::loadLikes() const {
+  if (!m_open)
+    return {};
+  XSL_TRACE_SCOPE("SqliteLedgerStore::loadLikes");
+  return collect(m_sql->loadLikes);
+}
+
+QList<SocialAction> SqliteLedgerStore::loadReplies() const {
+  if (!m_open)
+    return {};
+  XSL_TRACE_SCOPE("SqliteLedgerStore::loadReplies");
+  return collect(m_sql->loadReplies);
+}
+
+void SqliteLedgerStore::markReciprocated(const QString &actionId,
+                                         bool reciprocated) {
+  if (!m_open)
+    return;
+  QSqlQuery &q = m_sql->markReciprocated;
+  q.bindValue(0, reciprocated ? 1 : 0);
+  q.bindValue(1, QDateTime::currentMSecsSinceEpoch()); // 同步时后写者胜
+  q.bindValue(2, actionId);
+  q.bindValue(3, reciprocated ? 1 : 0);
+  if (!q.exec())
+    qWarning() << "[SqliteLedgerStore] update failed:" << q.lastError().text();
+}
+
+int SqliteLedgerStore::removeByHandle(const QString &handle) {
+  if (!m_open)
+    return 0;
+  QSqlQuery &q = m_sql->removeByHandle;
+  q.bindValue(0, handle);
+  if (!q.exec()) {
+    qWarning() << "[SqliteLedgerStore] delete failed:" << q.lastError().text();
+    return 0;
+  }
+  const int removed = q.numRowsAffected();
+  if (removed > 0)
+    pruneSnippets();
+  return removed;
+}
+
+void SqliteLedgerStore::pruneSnippets() {
+  // 删除记录后不再被引用的片段
+  if (!m_sql->pruneSnippets.exec())
+    qWarning() << "[SqliteLedgerStore] delete failed:"
+               << m_sql->pruneSnippets.lastError().text();
+}
+
+void SqliteLedgerStore::setSelfHandle(const QString &handle) {
+  m_selfHandle = handle;
+}
+
+QList<SocialAction>
+SqliteLedgerStore::getReciprocatedByDate(const QDate &date) const {
+  if (!m_open)
+    return {};
+  QSqlQuery &q = m_sql->byDate;
+  q.bindValue(0, date.startOfDay().toMSecsSinceEpoch());
+  q.bindValue(1, date.addDays(1).startOfDay().toMSecsSinceEpoch());
+  return collect(q);
+}
+
+int SqliteLedgerStore::likeCount() const {
+  return m_open ? scalar(m_sql->likeCount) : 0;
+}
+
+int SqliteLedgerStore::replyCount() const {
+  return m_open ? scalar(m_sql->replyCount) : 0;
+}
+
+int SqliteLedgerStore::pendingLikeCount() const {
+  return m_open ? scalar(m_sql->pendingLikeCount) : 0;
+}
+
+int SqliteLedgerStore::pendingReplyCount() const {
+  return m_open ? scalar(m_sql->pendingReplyCount) : 0;
+}
+
+void SqliteLedgerStore::flush() {
+  if (!m_open)
+    return;
+  QSqlQuery query(m_db);
+  query.exec("PRAGMA wal_checkpoint(PASSIVE)");
+}
+
+void SqliteLedgerStore::handOver(QThread *thread) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+  if (m_open)
+    m_db.moveToThread(thread);
+#endif
+  // 更早的 Qt 没有 QSqlDatabase::moveToThread；QSQLITE 不检查连接所属的
+  // 线程，打开它的线程用完再交出去、之后只在一个线程里使用即可
+  LedgerStore::handOver(thread);
+}
+
+QList<SocialAction> SqliteLedgerStore::searchSnippets(const QString &query,
+                                                      int limit) const {
+  if (!m_open || query.isEmpty())
+    return {};
+  XSL_TRACE_SCOPE("SqliteLedgerStore::searchSnippets");
+
+  // trigram 至少需要 3 个字符，更短的走 LIKE
+  if (m_fts && query.size() >= 3) {
+    QSqlQuery &q = m_sql->search;
+    QString phrase = query;
+    phrase.replace("\"", "\"\"");
+    q.bindValue(0, "\"" + phrase + "\"");
+    q.bindValue(1, limit);
+    return collect(q);
+  }
+
+  QString pattern = query;
+  pattern.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+  QSqlQuery &q = m_sql->searchLike;
+  q.bindValue(0, "%" + pattern + "%");
+  q.bindValue(1, limit);
+  return collect(q);
+}
+
+QList<SqliteLedgerStore::PartitionDigest>
+SqliteLedgerStore::readDigests(QSqlQuery &query) const {
+  QList<PartitionDigest> result;
+  if (!query.exec()) {
+    qWarning() << "[SqliteLedgerStore] digest query failed:"
+               << query.lastError().text();
+    return result;
+  }
+  while (query.next()) {
+    result.append({query.value(0).toString(), query.value(1).toLongLong(),
+                   query.value(2).toInt()});
+  }
+  query.finish();
+  return result;
+}
+
+QList<SqliteLedgerStore::PartitionDigest>
+SqliteLedgerStore::monthDigests() const {
+  if (!m_open)
+    return {};
+  return readDigests(m_sql->months);
+}
+
+QList<SqliteLedgerStore::PartitionDigest>
+SqliteLedgerStore::dayDigests(const QString &month) const {
+  if (!m_open)
+    return {};
+  QSqlQuery &q = m_sql->days;
+  q.bindValue(0, month + "-00");
+  q.bindValue(1, month + "-99");
+  return readDigests(q);
+}
+
+QList<SqliteLedgerStore::SyncRow>
+SqliteLedgerStore::partitionRows(const QString &day) const {
+  QList<SyncRow> result;
+  if (!m_open)
+    return result;
+  QSqlQuery &q = m_sql->dayRows;
+  q.bindValue(0, day);
+  if (!q.exec()) {
+    qWarning() << "[SqliteLedgerStore] query failed:" << q.lastError().text();
+    return result;
+  }
+  while (q.next())
+    result.append(
+        {rowToAction(q), q.value(8).toLongLong(), q.value(9).toLongLong()});
+  q.finish();
+  return result;
+}
+
+int SqliteLedgerStore::applySyncRows(const QList<SyncRow> &rows) {
+  if (!m_open || rows.isEmpty())
+    return 0;
+  XSL_TRACE_SCOPE("SqliteLedgerStore::applySyncRows");
+  int changed = 0;
+  m_db.transaction();
+  for (const SyncRow &row : rows) {
+    if (isSelf(row.action.userHandle))
+      continue;
+    // 本地删除过的不从对端拉回，除非对端在删除之后重新写入
+    const qint64 deleted = deletedAt(row.action.id);
+    if (deleted >= 0 && row.addedAt <= deleted)
+      continue;
+    if (insert(row.action, row.reciprocatedAt, row.addedAt)) {
+      changed++;
+      continue;
+    }
+    // 已存在：只有回馈状态可变
+    QSqlQuery &q = m_sql->syncUpdate;
+    q.bindValue(0, row.action.reciprocated ? 1 : 0);
+    q.bindValue(1, row.reciprocatedAt);
+    q.bindValue(2, row.action.id);
+    q.bindValue(3, row.action.reciprocated ? 1 : 0);
+    if (q.exec())
+      changed += q.numRowsAffected();
+  }
+  m_db.commit();
+  return changed;
+}
+
+QList<SqliteLedgerStore::Tombstone>
+SqliteLedgerStore::tombstonesAfter(qint64 afterSeq) const {
+  QList<Tombstone> result;
+  if (!m_open)
+    return result;
+  QSqlQuery &q = m_sql->tombstonesAfter;
+  q.bindValue(0, afterSeq);
+  if (!q.exec()) {
+    qWarning() << "[SqliteLedgerStore] query failed:" << q.lastError().text();
+    return result;
+  }
+  while (q.next()) {
+    result.append({q.value(0).toLongLong(), q.value(1).toString(),
+                   q.value(2).toLongLong()});
+  }
+  q.finish();
+  return result;
+}
+
+qint64 SqliteLedgerStore::lastTombstoneSeq() const {
+  return m_open ? lookup(m_sql->lastTombstoneSeq, 0) : 0;
+}
+
+qint64 SqliteLedgerStore::tombstoneMark(const QString &peer) const {
+  if (!m_open)
+    return 0;
+  m_sql->tombstoneMark.bindValue(0, peer);
+  return lookup(m_sql->tombstoneMark, 0);
+}
+
+void SqliteLedgerStore::setTombstoneMark(const QString &peer, qint64 seq) {
+  if (!m_open)
+    return;
+  QSqlQuery &q = m_sql->setTombstoneMark;
+  q.bindValue(0, peer);
+  q.bindValue(1, seq);
+  if (!q.exec())
+    qWarning() << "[SqliteLedgerStore] update failed:" << q.lastError().text();
+}
+
+int SqliteLedgerStore::pruneTombstones() {
+  if (!m_open)
+    return 0;
+  QSqlQuery &q = m_sql->pruneTombstones;
+  if (!q.exec()) {
+    qWarning() << "[SqliteLedgerStore] delete failed:" << q.lastError().text();
+    return 0;
+  }
+  return q.numRowsAffected();
+}
+
+int SqliteLedgerStore::applyTombstones(const QList<Tombstone> &tombstones) {
+  if (!m_open || tombstones.isEmpty())
+    return 0;
+  XSL_TRACE_SCOPE("SqliteLedgerStore::applyTombstones");
+  int removed = 0;
+  m_db.transaction();
+  for (const Tombstone &t : tombstones) {
+    if (deletedAt(t.id) >= 0)
+      continue; // 已经交换过
+    if (addedAt(t.id) > t.deletedAt)
+      continue; // 本地在删除之后重新写入，保留；对端会从同步里拿回
+    // 先按对端的删除时间记墓碑，触发器随后的 INSERT OR IGNORE 不会覆盖；
+    // 本地没有这条记录时也要记下
+    QSqlQuery &bury = m_sql->bury;
+    bury.bindValue(0, t.id);
+    bury.bindValue(1, t.deletedAt);
+    bury.exec();
+    QSqlQuery &remove = m_sql->removeById;
+    remove.bindValue(0, t.id);
+    if (remove.exec())
+      removed += remove.numRowsAffected();
+  }
+  if (removed > 0)
+    pruneSnippets();
+  m_db.commit();
+  return removed;
+}
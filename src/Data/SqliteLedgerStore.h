@@ -0,0 +1,149 @@
+#ifndef SQLITELEDGERSTORE_H
+#define SQLITELEDGERSTORE_H
+
+#include "LedgerStore.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <memory>
+
+// SQLite 后端（Qt 自带的 QSQLITE 驱动）
+//
+// 默认 WAL 日志 + synchronous=NORMAL；所有语句打开时预编译一次。
+// 网络共享上的账本（同步对端）用回滚日志打开：WAL 依赖共享内存，
+// 在网络文件系统上不可用。
+// (type, ts_ms, reciprocated) 索引覆盖计数和按日查询，(handle) 索引
+// 覆盖按用户删除。片段按内容哈希在 snippets 表里只存一份，记录引用
+// snippet_id；片段建 FTS5 trigram 索引，中文子串也能搜索。
+//
+// 每条记录带内容摘要，按 UTC 日、月两层聚合成分区摘要（见 LedgerSync）。
+// 删除的记录由触发器写入墓碑表，同步时交换，已删除的不会被对端拉回；
+// 删除之后重新写入同一 id 时清除墓碑，同步按写入/删除时间后写者胜。
+// 墓碑带自增序号，按对端水位增量交换，所有已知对端都收到后清理。
+class SqliteLedgerStore : public LedgerStore {
+  Q_OBJECT
+
+public:
+  enum class Journal {
+    Wal,      // 本机磁盘
+    Rollback, // journal_mode=DELETE，可用于挂载的共享目录
+  };
+
+  explicit SqliteLedgerStore(const QString &filePath,
+                             QObject *parent = nullptr);
+  SqliteLedgerStore(const QString &filePath, Journal journal,
+                    QObject *parent = nullptr);
+  ~SqliteLedgerStore() override;
+
+  static QString defaultFilePath();
+
+  bool isOpen() const { return m_open; }
+  bool hasFullTextIndex() const { return m_fts; }
+  bool isEmpty() const;
+
+  QString filePath() const { return m_filePath; }
+
+  // 单个事务批量写入，已存在的 id 跳过；返回写入条数
+  int importActions(const QList<SocialAction> &actions);
+
+  // ---- 分区摘要，供 LedgerSync 比较两份账本 ----
+  struct PartitionDigest {
+    QString key; // 月 "yyyy-MM" 或日 "yyyy-MM-dd"
+    qint64 hash; // 成员记录摘要的异或
+    int count;
+
+    bool operator==(const PartitionDigest &o) const {
+      return key == o.key && hash == o.hash && count == o.count;
+    }
+    bool operator!=(const PartitionDigest &o) const { return !(*this == o); }
+  };
+  struct SyncRow {
+    SocialAction action;
+    qint64 reciprocatedAt; // 回馈状态最后修改时间，0 = 未知
+    qint64 addedAt;        // 最初写入的时间，0 = 未知（早于任何删除）
+  };
+  struct Tombstone {
+    qint64 seq; // 本库的墓碑序号，只增不复用
+    QString id;
+    qint64 deletedAt; // 最初删除的时间
+  };
+
+  QList<PartitionDigest> monthDigests() const; // 按 key 升序
+  QList<PartitionDigest> dayDigests(const QString &month) const;
+  QList<SyncRow> partitionRows(const QString &day) const;
+  // 单个事务：缺失的记录插入，已有记录覆盖回馈状态；返回变更条数。
+  // 自己的 handle 跳过；有墓碑的 id 只接受删除之后写入的
+  int applySyncRows(const QList<SyncRow> &rows);
+  // 本库的唯一标识，首次打开时生成；对端按它记墓碑水位
+  QString ledgerId() const { return m_ledgerId; }
+  // 序号大于 afterSeq 的墓碑，按序号升序
+  QList<Tombstone> tombstonesAfter(qint64 afterSeq) const;
+  // 分配过的最大墓碑序号（含已清理的）
+  qint64 lastTombstoneSeq() const;
+  // 已交给对端 peer 的墓碑水位，从未同步过为 0
+  qint64 tombstoneMark(const QString &peer) const;
+  void setTombstoneMark(const QString &peer, qint64 seq);
+  // 删除所有已知对端都已收到的墓碑；返回删除条数
+  int pruneTombstones();
+  // 单个事务：记下本地没有的墓碑并删除对应记录，删除之后本地重新写入的
+  // 保留；返回删除条数
+  int applyTombstones(const QList<Tombstone> &tombstones);
+
+  QString backendName() const override { return "sqlite"; }
+
+  bool addAction(const SocialAction &action) override;
+  QList<SocialAction> loadLikes() const override;
+  QList<SocialAction> loadReplies() const override;
+  void markReciprocated(const QString &actionId, bool reciprocated) override;
+  int removeByHandle(const QString &handle) override;
+  void setSelfHandle(const QString &handle) override;
+  QList<SocialAction> getReciprocatedByDate(const QDate &date) const override;
+
+  int likeCount() const override;
+  int replyCount() const override;
+  int pendingLikeCount() const override;
+  int pendingReplyCount() const override;
+
+  void flush() override;
+  void handOver(QThread *thread) override;
+
+  void scan(const std::function<bool(const SocialAction &)> &visit)
+      const override;
+  QList<SocialAction> searchSnippets(const QString &query,
+                                     int limit = 100) const override;
+
+private:
+  struct Statements; // 预编译语句，打开成功后创建
+
+  bool openDatabase(const QString &filePath, Journal journal);
+  bool createSchema();
+  bool addMissingColumns();
+  bool createPartitionSchema();
+  bool migrateTombstones();
+  bool migrateSnippets();
+  bool loadLedgerId();
+  bool resetStaleDigests();
+  bool backfillDigests();
+  bool exec(const QString &sql);
+  bool insert(const SocialAction &action, qint64 reciprocatedAt,
+              qint64 addedAt);
+  bool isSelf(const QString &handle) const;
+  qint64 deletedAt(const QString &id) const; // 没有墓碑为 -1
+  qint64 addedAt(const QString &id) const;   // 没有记录为 -1
+  void pruneSnippets();
+  static SocialAction rowToAction(const QSqlQuery &query);
+  QList<SocialAction> collect(QSqlQuery &query) const;
+  int scalar(QSqlQuery &query) const;
+  qint64 lookup(QSqlQuery &query, qint64 missing) const;
+  QList<PartitionDigest> readDigests(QSqlQuery &query) const;
+
+  QString m_connection;
+  QString m_filePath;
+  QSqlDatabase m_db;
+  std::unique_ptr<Statements> m_sql;
+  QString m_selfHandle;
+  QString m_ledgerId;
+  bool m_open;
+  bool m_fts;
+};
+
+#endif // SQLITELEDGERSTORE_H
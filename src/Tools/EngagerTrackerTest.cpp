@@ -0,0 +1,105 @@
+// xsl_engagertest - 高频互动用户排行的测试（QTest）
+//
+// 历史记录是点赞、回复分别加载后拼起来的，时间上交错。rebuild 要按时间
+// 重放，精确计数才不会漏掉新跟踪的 handle 在之后的桶里已有的记录。
+// ctest 里注册为 engager_tracker。
+
+#include "Data/EngagerTracker.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QtTest>
+
+namespace {
+
+const qint64 kMinute = 60 * 1000;
+
+SocialAction action(const QString &handle, const QString &type,
+                    qint64 epochMs) {
+  SocialAction a;
+  a.userHandle = handle;
+  a.userName = handle;
+  a.type = type;
+  a.timestamp = QDateTime::fromMSecsSinceEpoch(epochMs, Qt::UTC)
+                    .toString(Qt::ISODateWithMs);
+  a.reciprocated = false;
+  a.id = SocialAction::makeId(a.userHandle, a.type, a.timestamp);
+  return a;
+}
+
+} // namespace
+
+class EngagerTrackerTest : public QObject {
+  Q_OBJECT
+
+private slots:
+  void init();
+  void interleavedHistory();
+  void rebuildIgnoresInputOrder();
+
+private:
+  // 1 小时窗口、每分钟一桶，只精确跟踪 1 个 handle：换人时最容易丢计数
+  static EngagerTracker *makeTracker(QObject *parent) {
+    return new EngagerTracker(parent, {{"1h", kMinute, 60}}, 8, 1);
+  }
+
+  qint64 m_now = 0;
+  QList<SocialAction> m_likes;
+  QList<SocialAction> m_replies;
+};
+
+void EngagerTrackerTest::init() {
+  m_now = QDateTime::currentMSecsSinceEpoch();
+  // alice 先回复 3 次，之后点赞 1 次；bob 最近点赞 2 次
+  m_likes = {action("alice", "like", m_now - 30 * kMinute),
+             action("bob", "like", m_now - 5 * kMinute),
+             action("bob", "like", m_now - 5 * kMinute + 1000)};
+  m_replies.clear();
+  for (int i = 0; i < 3; i++)
+    m_replies.append(action("alice", "reply", m_now - 40 * kMinute + i));
+}
+
+void EngagerTrackerTest::interleavedHistory() {
+  // 与启动时一样：先全部点赞，再全部回复
+  EngagerTracker *tracker = makeTracker(this);
+  tracker->rebuild(m_likes + m_replies);
+
+  const QList<EngagerTracker::Ranked> top = tracker->top(0, 10, m_now);
+  QCOMPARE(top.size(), 2);
+  QCOMPARE(top[0].handle, QString("alice"));
+  QCOMPARE(top[0].count, 4);
+  QVERIFY(top[0].isExact());
+  QCOMPARE(top[1].handle, QString("bob"));
+  QCOMPARE(top[1].count, 2);
+  QVERIFY(top[1].isExact());
+}
+
+void EngagerTrackerTest::rebuildIgnoresInputOrder() {
+  EngagerTracker *sorted = makeTracker(this);
+  QList<SocialAction> history = m_replies + m_likes;
+  std::sort(history.begin(), history.end(),
+            [](const SocialAction &a, const SocialAction &b) {
+              return a.timestamp < b.timestamp;
+            });
+  sorted->rebuild(history);
+
+  EngagerTracker *reversed = makeTracker(this);
+  std::reverse(history.begin(), history.end());
+  reversed->rebuild(history);
+
+  const QList<EngagerTracker::Ranked> expected = sorted->top(0, 10, m_now);
+  const QList<EngagerTracker::Ranked> actual = reversed->top(0, 10, m_now);
+  QCOMPARE(actual.size(), expected.size());
+  for (int i = 0; i < expected.size(); i++) {
+    QCOMPARE(actual[i].handle, expected[i].handle);
+    QCOMPARE(actual[i].count, expected[i].count);
+    QCOMPARE(actual[i].error, expected[i].error);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  EngagerTrackerTest test;
+  return QTest::qExec(&test, argc, argv);
+}
+
+#include "EngagerTrackerTest.moc"
@@ -0,0 +1,261 @@
+// xsl_ingestbench - 采集入口每条记录的分配次数与耗时
+//
+//   xsl_ingestbench --records 100000 --drop-percent 20
+//
+// 用合成的采集消息（与页面脚本 JSON.stringify 的输出同形）比较两条路径：
+//   qjson  旧实现：QJsonDocument::fromJson(toUtf8()) + QJsonObject 取字段
+//   arena  IngestParser：视图 + 每条消息一个单调内存池
+// 两条路径都经过同一条过滤链，并把通过的记录存入预留好的列表，
+// 所以差值就是解析与中间对象的分配。
+//
+// 分配计数：glibc 下替换 malloc/calloc/realloc 转发到 __libc_*；
+// MSVC Debug 下用 _CrtSetAllocHook；其它构建只输出耗时。
+
+#include "Core/IngestFilter.h"
+#include "Core/IngestParser.h"
+#include "Data/SocialAction.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QTextStream>
+#include <atomic>
+#include <cstdlib>
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+#include <crtdbg.h>
+#endif
+
+namespace {
+
+std::atomic<qint64> g_allocs{0};
+std::atomic<qint64> g_allocBytes{0};
+
+void countAlloc(size_t size) {
+  g_allocs.fetch_add(1, std::memory_order_relaxed);
+  g_allocBytes.fetch_add(qint64(size), std::memory_order_relaxed);
+}
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+int allocHook(int type, void *, size_t size, int, long, const unsigned char *,
+              int) {
+  if (type == _HOOK_ALLOC || type == _HOOK_REALLOC)
+    countAlloc(size);
+  return TRUE;
+}
+#endif
+
+} // namespace
+
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) noexcept {
+  countAlloc(size);
+  return __libc_malloc(size);
+}
+void *calloc(size_t count, size_t size) noexcept {
+  countAlloc(count * size);
+  return __libc_calloc(count, size);
+}
+void *realloc(void *ptr, size_t size) noexcept {
+  countAlloc(size);
+  return __libc_realloc(ptr, size);
+}
+}
+#endif
+
+namespace {
+
+bool installAllocCounter() {
+#if defined(__GLIBC__)
+  return true;
+#elif defined(_MSC_VER) && defined(_DEBUG)
+  _CrtSetAllocHook(allocHook);
+  return true;
+#else
+  return false;
+#endif
+}
+
+struct Message {
+  QString json;
+  QLatin1String type;
+};
+
+QList<Message> makeMessages(int count) {
+  QList<Message> messages;
+  messages.reserve(count);
+  for (int i = 0; i < count; i++) {
+    int user = i % 1000;
+    QJsonObject obj;
+    obj["handle"] = QString("bench_user%1").arg(user);
+    obj["name"] = QString::fromUtf8("测试用户 %1").arg(user);
+    obj["timestamp"] = QString("2024-05-%1T%2:%3:07.000Z")
+                           .arg(1 + i % 28, 2, 10, QChar('0'))
+                           .arg(i % 24, 2, 10, QChar('0'))
+                           .arg(i % 60, 2, 10, QChar('0'));
+    // 四分之一带转义（引号、换行），走解码到内存池的分支
+    obj["snippet"] =
+        i % 4 == 0
+            ? QString::fromUtf8("回复 \"%1\"\n第二行 performance").arg(i)
+            : QString::fromUtf8("基准测试片段 #%1 performance ledger").arg(i);
+    obj["statusLink"] = QString("https://x.com/bench_user%1/status/%2")
+                            .arg(user)
+                            .arg(1000000 + i);
+    QByteArray json = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+    messages.append({QString::fromUtf8(json), i % 3 == 0
+                                                  ? QLatin1String("reply")
+                                                  : QLatin1String("like")});
+  }
+  return messages;
+}
+
+void finish(SocialAction &action) {
+  action.reciprocated = false;
+  action.id =
+      SocialAction::makeId(action.userHandle, action.type, action.timestamp);
+}
+
+// 与改动前 NotificationCollector::ingest 相同
+bool ingestQJson(const Message &m, const IngestFilterChain &filters,
+                 QList<SocialAction> &out) {
+  QJsonDocument doc = QJsonDocument::fromJson(m.json.toUtf8());
+  if (!doc.isObject())
+    return false;
+  QJsonObject obj = doc.object();
+  QString handle = obj["handle"].toString();
+  if (!filters.accept(RawRecord::make(m.type, handle)))
+    return false;
+
+  SocialAction action;
+  action.userHandle = handle;
+  action.userName = obj["name"].toString();
+  action.type = m.type;
+  action.timestamp = obj["timestamp"].toString();
+  action.postSnippet = obj["snippet"].toString();
+  action.statusLink = obj["statusLink"].toString();
+  finish(action);
+  out.append(std::move(action));
+  return true;
+}
+
+// 与现在的 NotificationCollector::ingest 相同
+bool ingestArena(const Message &m, IngestParser &parser,
+                 const IngestFilterChain &filters, QList<SocialAction> &out) {
+  static const QString like = QStringLiteral("like");
+  static const QString reply = QStringLiteral("reply");
+  if (!parser.parse(m.json))
+    return false;
+  QStringView handle = parser.value(QLatin1String("handle"));
+  if (!filters.accept(RawRecord::make(m.type, handle)))
+    return false;
+
+  SocialAction action;
+  action.userHandle = handle.toString();
+  action.userName = parser.value(QLatin1String("name")).toString();
+  action.type = m.type == QLatin1String("like") ? like : reply;
+  action.timestamp = parser.value(QLatin1String("timestamp")).toString();
+  action.postSnippet = parser.value(QLatin1String("snippet")).toString();
+  action.statusLink = parser.value(QLatin1String("statusLink")).toString();
+  finish(action);
+  out.append(std::move(action));
+  return true;
+}
+
+struct Result {
+  int accepted = 0;
+  qint64 allocs = 0;
+  qint64 allocBytes = 0;
+  qint64 ns = 0;
+};
+
+template <typename Fn>
+Result measure(const QList<Message> &messages, QList<SocialAction> &out,
+               Fn ingest) {
+  // 预热一遍（静态对象、指标注册），再清空存储、重新计数
+  for (const Message &m : messages)
+    ingest(m);
+  out.clear();
+  out.reserve(messages.size());
+
+  Result r;
+  qint64 allocs = g_allocs.load();
+  qint64 bytes = g_allocBytes.load();
+  QElapsedTimer timer;
+  timer.start();
+  for (const Message &m : messages) {
+    if (ingest(m))
+      r.accepted++;
+  }
+  r.ns = timer.nsecsElapsed();
+  r.allocs = g_allocs.load() - allocs;
+  r.allocBytes = g_allocBytes.load() - bytes;
+  return r;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("xsl_ingestbench");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Allocations and time per record on the collector ingest path");
+  parser.addHelpOption();
+  QCommandLineOption recordsOpt("records", "Synthetic collector messages.",
+                                "n", "100000");
+  QCommandLineOption dropOpt("drop-percent",
+                             "Share of users on the ignore list.", "percent",
+                             "20");
+  parser.addOptions({recordsOpt, dropOpt});
+  parser.process(app);
+
+  int records = qMax(1, parser.value(recordsOpt).toInt());
+  int dropPercent = qBound(0, parser.value(dropOpt).toInt(), 100);
+  bool counting = installAllocCounter();
+
+  IngestFilterChain filters;
+  auto *ignore = filters.append(std::make_unique<HandleSetFilter>("ignore"));
+  filters.append(std::make_unique<TypeFilter>());
+  for (int user = 0; user < 1000; user++) {
+    if (user % 100 < dropPercent)
+      ignore->insert(QString("bench_user%1").arg(user));
+  }
+
+  QList<Message> messages = makeMessages(records);
+  QList<SocialAction> stored;
+
+  Result qjson = measure(messages, stored, [&](const Message &m) {
+    return ingestQJson(m, filters, stored);
+  });
+  IngestParser arena;
+  Result pooled = measure(messages, stored, [&](const Message &m) {
+    return ingestArena(m, arena, filters, stored);
+  });
+
+  QTextStream out(stdout);
+  auto row = [&](const char *name, const Result &r) {
+    double n = double(records);
+    out << qSetFieldWidth(8) << Qt::left << name << qSetFieldWidth(0)
+        << "  allocs/rec "
+        << (counting ? QString::number(r.allocs / n, 'f', 2) : QString("-"))
+        << "  bytes/rec "
+        << (counting ? QString::number(r.allocBytes / n, 'f', 0)
+                     : QString("-"))
+        << "  ns/rec " << QString::number(r.ns / n, 'f', 0) << "\n";
+  };
+  out << "records      " << records << " (accepted " << qjson.accepted
+      << ")\n";
+  row("qjson", qjson);
+  row("arena", pooled);
+  if (!counting)
+    out << "allocation counting needs a glibc or MSVC Debug build\n";
+  return qjson.accepted == pooled.accepted ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+// xsl_ledgersynctest - 两份 SQLite 账本的同步测试（QTest）
+//
+// 临时目录里开两个账本，核对删除、重新写入之后同步能收敛：墓碑不会把
+// 重新写入的记录删掉，第二次同步两边摘要一致；墓碑只交换新增的，所有
+// 对端都收到后清理。ctest 里注册为 ledger_sync。
+
+#include "Data/LedgerSync.h"
+#include "Data/SqliteLedgerStore.h"
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QtTest>
+#include <memory>
+
+namespace {
+
+SocialAction like(const QString &handle, int minute) {
+  SocialAction a;
+  a.userHandle = handle;
+  a.userName = handle;
+  a.type = "like";
+  a.timestamp =
+      QString("2024-05-01T10:%1:00.000Z").arg(minute, 2, 10, QChar('0'));
+  a.postSnippet = "snippet " + handle;
+  a.statusLink = "https://x.com/" + handle + "/status/1";
+  a.reciprocated = false;
+  a.id = SocialAction::makeId(a.userHandle, a.type, a.timestamp);
+  return a;
+}
+
+} // namespace
+
+class LedgerSyncTest : public QObject {
+  Q_OBJECT
+
+private slots:
+  void init();
+  void cleanup();
+  void deleteReAddSync();
+  void reAddBeforeSync();
+  void concurrentDeleteAndAdd();
+  void tombstonesIncremental();
+  void pruneWaitsForEveryPeer();
+
+private:
+  LedgerSync::Report sync() {
+    return LedgerSync::sync(m_local.get(), m_peer.get());
+  }
+  bool converged() const {
+    return m_local->monthDigests() == m_peer->monthDigests();
+  }
+
+  std::unique_ptr<QTemporaryDir> m_dir;
+  std::unique_ptr<SqliteLedgerStore> m_local;
+  std::unique_ptr<SqliteLedgerStore> m_peer;
+};
+
+void LedgerSyncTest::init() {
+  m_dir = std::make_unique<QTemporaryDir>();
+  QVERIFY(m_dir->isValid());
+  m_local =
+      std::make_unique<SqliteLedgerStore>(m_dir->filePath("local.sqlite"));
+  m_peer =
+      std::make_unique<SqliteLedgerStore>(m_dir->filePath("peer.sqlite"));
+  QVERIFY(m_local->isOpen());
+  QVERIFY(m_peer->isOpen());
+}
+
+void LedgerSyncTest::cleanup() {
+  m_local.reset();
+  m_peer.reset();
+  m_dir.reset();
+}
+
+void LedgerSyncTest::deleteReAddSync() {
+  const SocialAction kept = like("alice", 1);
+  const SocialAction readded = like("bob", 2);
+  QVERIFY(m_local->addAction(kept));
+  QVERIFY(m_local->addAction(readded));
+  QCOMPARE(sync().pushed, 2);
+
+  QCOMPARE(m_local->removeByHandle("bob"), 1);
+  LedgerSync::Report report = sync();
+  QCOMPARE(report.removedPeer, 1);
+  QCOMPARE(m_peer->likeCount(), 1);
+
+  // 毫秒时间戳比先后：重新写入要晚于删除
+  QThread::msleep(5);
+  QVERIFY(m_local->addAction(readded));
+  QVERIFY(m_local->tombstonesAfter(0).isEmpty());
+
+  // 对端的墓碑早于重新写入：本地记录保留，并推给对端
+  report = sync();
+  QCOMPARE(report.removedLocal, 0);
+  QCOMPARE(report.pushed, 1);
+  QCOMPARE(m_local->likeCount(), 2);
+  QCOMPARE(m_peer->likeCount(), 2);
+  QVERIFY(m_peer->tombstonesAfter(0).isEmpty());
+  QVERIFY(converged());
+
+  report = sync();
+  QVERIFY(report.alreadyInSync);
+  QCOMPARE(report.removedLocal + report.removedPeer, 0);
+}
+
+void LedgerSyncTest::reAddBeforeSync() {
+  const SocialAction action = like("carol", 3);
+  QVERIFY(m_local->addAction(action));
+  QVERIFY(m_peer->addAction(action));
+
+  // 两次同步之间删除又写回：两边内容相同，墓碑已清除
+  QCOMPARE(m_local->removeByHandle("carol"), 1);
+  QVERIFY(m_local->addAction(action));
+  QVERIFY(m_local->tombstonesAfter(0).isEmpty());
+
+  const LedgerSync::Report report = sync();
+  QVERIFY(report.alreadyInSync);
+  QCOMPARE(m_peer->likeCount(), 1);
+}
+
+void LedgerSyncTest::concurrentDeleteAndAdd() {
+  const SocialAction action = like("dave", 4);
+  QVERIFY(m_peer->addAction(action));
+  QCOMPARE(m_peer->removeByHandle("dave"), 1);
+  QThread::msleep(5);
+  QVERIFY(m_local->addAction(action));
+
+  // 本地写入晚于对端的删除：保留并推过去，对端的墓碑随之清除
+  const LedgerSync::Report report = sync();
+  QCOMPARE(report.removedLocal, 0);
+  QCOMPARE(report.pushed, 1);
+  QCOMPARE(m_peer->likeCount(), 1);
+  QVERIFY(m_peer->tombstonesAfter(0).isEmpty());
+  QVERIFY(converged());
+}
+
+void LedgerSyncTest::tombstonesIncremental() {
+  for (int i = 1; i <= 3; ++i)
+    QVERIFY(m_local->addAction(like(QString("user%1").arg(i), i)));
+  sync();
+
+  QCOMPARE(m_local->removeByHandle("user1"), 1);
+  LedgerSync::Report report = sync();
+  QCOMPARE(report.tombstonesSent, 1);
+  QCOMPARE(report.removedPeer, 1);
+  // 本地的和对端补记的各一条，交换完两边都清理
+  QCOMPARE(report.tombstonesPruned, 2);
+  QVERIFY(m_local->tombstonesAfter(0).isEmpty());
+  QVERIFY(m_peer->tombstonesAfter(0).isEmpty());
+
+  report = sync();
+  QVERIFY(report.alreadyInSync);
+  QCOMPARE(report.tombstonesSent, 0);
+
+  QCOMPARE(m_peer->removeByHandle("user2"), 1);
+  report = sync();
+  QCOMPARE(report.tombstonesSent, 1);
+  QCOMPARE(report.removedLocal, 1);
+  QCOMPARE(m_local->likeCount(), 1);
+  QVERIFY(converged());
+}
+
+void LedgerSyncTest::pruneWaitsForEveryPeer() {
+  SqliteLedgerStore other(m_dir->filePath("other.sqlite"));
+  QVERIFY(other.isOpen());
+  QVERIFY(m_local->addAction(like("erin", 5)));
+  sync();
+  LedgerSync::sync(m_local.get(), &other);
+
+  // 另一个对端还没收到：本地的墓碑留着
+  QCOMPARE(m_local->removeByHandle("erin"), 1);
+  sync();
+  QCOMPARE(m_local->tombstonesAfter(0).size(), 1);
+
+  const LedgerSync::Report report = LedgerSync::sync(m_local.get(), &other);
+  QCOMPARE(report.tombstonesSent, 1);
+  QCOMPARE(report.removedPeer, 1);
+  QVERIFY(m_local->tombstonesAfter(0).isEmpty());
+}
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  LedgerSyncTest test;
+  return QTest::qExec(&test, argc, argv);
+}
+
+#include "LedgerSyncTest.moc"
@@ -0,0 +1,131 @@
+// xsl_query - 命令行账本查询，不启动 GUI / WebView2
+//
+//   xsl_query --type like --handle @someone --since 2026-09-01 --until 2026-09-30
+//   xsl_query --pending --group-by day --since 30d
+//   xsl_query --group-by handle --type reply --format csv > replies.csv
+//   xsl_query --list 20 --format jsonl
+//
+// 只读打开 sqlite 后端的账本文件（默认与应用相同的位置），应用运行时
+// 也可以查询。
+
+#include "Data/LedgerQuery.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QThread>
+
+namespace {
+
+// yyyy-MM-dd，或相对今天的 Nd（N 天前）
+QDate parseDate(const QString &text, bool *ok) {
+  *ok = true;
+  if (text.isEmpty())
+    return QDate();
+  if (text.endsWith('d')) {
+    int days = text.chopped(1).toInt(ok);
+    if (*ok)
+      return QDate::currentDate().addDays(-days);
+  }
+  QDate d = QDate::fromString(text, Qt::ISODate);
+  *ok = d.isValid();
+  return d;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  // 与 GUI 相同，默认账本路径才一致
+  app.setApplicationName("XSocialLedger");
+  app.setOrganizationName("5118Python");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Query the XSocialLedger ledger offline");
+  parser.addHelpOption();
+  QCommandLineOption ledgerOpt("ledger", "Ledger file (sqlite backend).",
+                               "path", LedgerQuery::defaultLedgerPath());
+  QCommandLineOption typeOpt("type", "like, reply or list_like; repeatable.",
+                             "type");
+  QCommandLineOption handleOpt("handle", "Only this user (case-insensitive).",
+                               "handle");
+  QCommandLineOption sinceOpt("since", "From local date, yyyy-MM-dd or Nd.",
+                              "date");
+  QCommandLineOption untilOpt("until", "To local date (inclusive).", "date");
+  QCommandLineOption pendingOpt("pending", "Only records not reciprocated.");
+  QCommandLineOption doneOpt("reciprocated", "Only reciprocated records.");
+  QCommandLineOption groupOpt("group-by",
+                              "day, month, handle, type (comma separated).",
+                              "keys");
+  QCommandLineOption listOpt("list", "List the newest N matching records.",
+                             "n");
+  QCommandLineOption formatOpt("format", "table, csv or jsonl.", "format",
+                               "table");
+  QCommandLineOption threadsOpt("threads", "Scan threads.", "n",
+                                QString::number(QThread::idealThreadCount()));
+  QCommandLineOption timingOpt("timing", "Print elapsed time to stderr.");
+  parser.addOptions({ledgerOpt, typeOpt, handleOpt, sinceOpt, untilOpt,
+                     pendingOpt, doneOpt, groupOpt, listOpt, formatOpt,
+                     threadsOpt, timingOpt});
+  parser.process(app);
+
+  QTextStream err(stderr);
+  LedgerQuerySpec spec;
+  spec.types = parser.values(typeOpt);
+  spec.handle = parser.value(handleOpt);
+  bool sinceOk, untilOk;
+  spec.since = parseDate(parser.value(sinceOpt), &sinceOk);
+  spec.until = parseDate(parser.value(untilOpt), &untilOk);
+  if (!sinceOk || !untilOk) {
+    err << "invalid date\n";
+    return 2;
+  }
+  if (parser.isSet(pendingOpt) && parser.isSet(doneOpt)) {
+    err << "--pending and --reciprocated are exclusive\n";
+    return 2;
+  }
+  if (parser.isSet(pendingOpt))
+    spec.state = LedgerQuerySpec::State::Pending;
+  else if (parser.isSet(doneOpt))
+    spec.state = LedgerQuerySpec::State::Reciprocated;
+
+  const QStringList validKeys = {"day", "month", "handle", "type"};
+  for (const QString &key :
+       parser.value(groupOpt).split(',', Qt::SkipEmptyParts)) {
+    QString k = key.trimmed().toLower();
+    if (!validKeys.contains(k)) {
+      err << "unknown group-by key: " << key << "\n";
+      return 2;
+    }
+    spec.groupBy.append(k);
+  }
+  spec.limit = parser.value(listOpt).toInt();
+
+  QString format = parser.value(formatOpt);
+  if (format != "table" && format != "csv" && format != "jsonl") {
+    err << "unknown format: " << format << "\n";
+    return 2;
+  }
+
+  LedgerQueryResult result;
+  QString error;
+  if (!LedgerQuery::run(parser.value(ledgerOpt), spec,
+                        parser.value(threadsOpt).toInt(), &result, &error)) {
+    err << "query failed: " << error << "\n";
+    return 1;
+  }
+
+  QTextStream out(stdout);
+  out.setEncoding(QStringConverter::Utf8);
+  if (format == "csv")
+    out << result.toCsv();
+  else if (format == "jsonl")
+    out << result.toJsonLines();
+  else
+    out << result.toTable();
+
+  if (parser.isSet(timingOpt)) {
+    err << result.rows.size() << " rows, " << result.partitions
+        << " partitions, " << result.elapsedMs << " ms\n";
+  }
+  return 0;
+}
@@ -0,0 +1,178 @@
+// xsl_loadtest - 本机查询 API 压测客户端
+//
+//   xsl_loadtest --port 8765 --connections 8 --duration 10
+//                --path "/v1/actions?type=like&limit=50"
+//
+// 每个连接保持 keep-alive，收到完整响应后立即发下一个请求（闭环），
+// 结束时输出吞吐 (req/s) 与延迟分位数。
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QTimer>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct Stats {
+  std::vector<qint64> latenciesUs;
+  qint64 bytes = 0;
+  int errors = 0;
+  int reconnects = 0;
+};
+
+class Connection {
+public:
+  Connection(quint16 port, const QByteArray &path, Stats *stats)
+      : m_port(port), m_stats(stats) {
+    // 服务端校验 Host，必须带端口
+    m_request = "GET " + path + " HTTP/1.1\r\nHost: 127.0.0.1:" +
+                QByteArray::number(port) +
+                "\r\nConnection: keep-alive\r\n\r\n";
+    QObject::connect(&m_socket, &QTcpSocket::connected,
+                     [this]() { send(); });
+    QObject::connect(&m_socket, &QTcpSocket::readyRead,
+                     [this]() { onReadyRead(); });
+    QObject::connect(&m_socket, &QTcpSocket::disconnected, [this]() {
+      // 服务端按连接上限关闭：重连继续
+      if (m_running) {
+        m_stats->reconnects++;
+        m_buffer.clear();
+        m_socket.connectToHost(QHostAddress::LocalHost, m_port);
+      }
+    });
+    QObject::connect(&m_socket, &QTcpSocket::errorOccurred,
+                     [this](QAbstractSocket::SocketError error) {
+                       if (error != QAbstractSocket::RemoteHostClosedError)
+                         m_stats->errors++;
+                     });
+  }
+
+  void start() {
+    m_running = true;
+    m_socket.connectToHost(QHostAddress::LocalHost, m_port);
+  }
+  void stop() {
+    m_running = false;
+    m_socket.abort();
+  }
+
+private:
+  void send() {
+    m_timer.start();
+    m_socket.write(m_request);
+  }
+
+  void onReadyRead() {
+    m_buffer += m_socket.readAll();
+    for (;;) {
+      int headerEnd = m_buffer.indexOf("\r\n\r\n");
+      if (headerEnd < 0)
+        return;
+      QByteArray header = m_buffer.left(headerEnd).toLower();
+      int at = header.indexOf("content-length:");
+      if (at < 0) {
+        m_stats->errors++;
+        m_socket.abort();
+        return;
+      }
+      int lineEnd = header.indexOf("\r\n", at);
+      qint64 length =
+          header.mid(at + 15, lineEnd < 0 ? -1 : lineEnd - at - 15)
+              .trimmed()
+              .toLongLong();
+      qint64 total = headerEnd + 4 + length;
+      if (m_buffer.size() < total)
+        return;
+
+      if (!header.startsWith("http/1.1 200"))
+        m_stats->errors++;
+      m_stats->latenciesUs.push_back(m_timer.nsecsElapsed() / 1000);
+      m_stats->bytes += total;
+      m_buffer.remove(0, int(total));
+      if (!m_running)
+        return;
+      send();
+    }
+  }
+
+  QTcpSocket m_socket;
+  QByteArray m_request;
+  QByteArray m_buffer;
+  QElapsedTimer m_timer;
+  quint16 m_port;
+  Stats *m_stats;
+  bool m_running = false;
+};
+
+qint64 percentile(const std::vector<qint64> &sorted, double p) {
+  if (sorted.empty())
+    return 0;
+  size_t i = size_t(p * double(sorted.size() - 1));
+  return sorted[i];
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("xsl_loadtest");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Load test for the local ledger query API");
+  parser.addHelpOption();
+  QCommandLineOption portOpt("port", "Query API port (XSL_QUERY_PORT).",
+                             "port", "8765");
+  QCommandLineOption connOpt("connections", "Concurrent keep-alive "
+                                            "connections.",
+                             "n", "8");
+  QCommandLineOption durationOpt("duration", "Test duration in seconds.",
+                                 "seconds", "10");
+  QCommandLineOption pathOpt("path", "Request path and query.", "path",
+                             "/v1/actions?type=like&limit=50");
+  parser.addOptions({portOpt, connOpt, durationOpt, pathOpt});
+  parser.process(app);
+
+  quint16 port = quint16(parser.value(portOpt).toUInt());
+  int connections = qMax(1, parser.value(connOpt).toInt());
+  int durationSec = qMax(1, parser.value(durationOpt).toInt());
+  QByteArray path = parser.value(pathOpt).toUtf8();
+
+  Stats stats;
+  std::vector<std::unique_ptr<Connection>> pool;
+  for (int i = 0; i < connections; i++)
+    pool.push_back(std::make_unique<Connection>(port, path, &stats));
+
+  QElapsedTimer wall;
+  wall.start();
+  for (auto &c : pool)
+    c->start();
+
+  QTimer::singleShot(durationSec * 1000, &app, [&]() {
+    for (auto &c : pool)
+      c->stop();
+    app.quit();
+  });
+  app.exec();
+
+  double seconds = wall.nsecsElapsed() / 1e9;
+  std::sort(stats.latenciesUs.begin(), stats.latenciesUs.end());
+  QTextStream out(stdout);
+  out << "requests     " << stats.latenciesUs.size() << "\n"
+      << "errors       " << stats.errors << "\n"
+      << "reconnects   " << stats.reconnects << "\n"
+      << "throughput   "
+      << QString::number(double(stats.latenciesUs.size()) / seconds, 'f', 1)
+      << " req/s\n"
+      << "transfer     "
+      << QString::number(double(stats.bytes) / seconds / 1048576.0, 'f', 2)
+      << " MiB/s\n"
+      << "latency p50  " << percentile(stats.latenciesUs, 0.50) << " us\n"
+      << "latency p99  " << percentile(stats.latenciesUs, 0.99) << " us\n"
+      << "latency max  " << percentile(stats.latenciesUs, 1.0) << " us\n";
+  return stats.latenciesUs.empty() ? 1 : 0;
+}
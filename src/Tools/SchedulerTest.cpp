@@ -0,0 +1,101 @@
+// xsl_schedulertest - 时间轮与采集定时的虚拟时钟测试（QTest）
+//
+// VirtualClock 上跑满 24 小时的采集轮询 / 自动刷新周期，核对每种定时器的
+// 触发次数和驱动唤醒次数。唤醒次数由 Scheduler::runUntil() 按真实驱动
+// 定时器的布防规则模拟，布防落在空闲边界上会直接多出唤醒。
+// 浏览器是 src/Tools/Stub 下的替身。ctest 里注册为 scheduler。
+
+#include "App/Scheduler.h"
+#include "Core/NotificationCollector.h"
+#include "Data/SqliteLedgerStore.h"
+#include "UI/WebView2Widget.h"
+#include <QApplication>
+#include <QTemporaryDir>
+#include <QtTest>
+
+namespace {
+const qint64 kSecond = 1000;
+const qint64 kDay = 24 * 3600 * kSecond;
+} // namespace
+
+class SchedulerTest : public QObject {
+  Q_OBJECT
+
+private slots:
+  void sharedTicks();
+  void longIdleTimer();
+  void collectorDay();
+};
+
+void SchedulerTest::sharedTicks() {
+  VirtualClock clock;
+  Scheduler scheduler(&clock);
+  int fast = 0, slow = 0;
+  scheduler.repeating(15 * kSecond, this, [&fast]() { fast++; });
+  scheduler.repeating(30 * kSecond, this, [&slow]() { slow++; });
+  scheduler.runUntil(kDay);
+
+  QCOMPARE(fast, 5760);
+  QCOMPARE(slow, 2880);
+  // 30s 的每次触发都与 15s 同一个 tick
+  QCOMPARE(scheduler.wakeups(), quint64(5760));
+  QCOMPARE(clock.nowMs(), kDay);
+}
+
+void SchedulerTest::longIdleTimer() {
+  VirtualClock clock;
+  Scheduler scheduler(&clock);
+  int fired = 0, canceled = 0;
+  scheduler.singleShot(6 * 3600 * kSecond, this, [&fired]() { fired++; });
+  Scheduler::TimerId id =
+      scheduler.singleShot(kSecond, this, [&canceled]() { canceled++; });
+  QVERIFY(scheduler.cancel(id));
+  scheduler.runUntil(kDay);
+
+  QCOMPARE(fired, 1);
+  QCOMPARE(canceled, 0);
+  // 最高层的定时器只在到期时唤醒一次，取消的不唤醒
+  QCOMPARE(scheduler.wakeups(), quint64(1));
+  QCOMPARE(scheduler.pendingCount(), 0);
+}
+
+void SchedulerTest::collectorDay() {
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  SqliteLedgerStore store(dir.filePath("ledger.sqlite"));
+  QVERIFY(store.isOpen());
+
+  VirtualClock clock;
+  Scheduler scheduler(&clock);
+  WebView2Widget browser;
+  NotificationCollector collector(&browser, &store);
+  collector.setScheduler(&scheduler);
+  // 刷新区间取单点，周期确定：5 次 15s 轮询（前 4 次翻页，第 5 次到页数
+  // 上限）-> 90s 后刷新 -> 3s 后重新开始，共 168s
+  collector.setMaxPages(5);
+  collector.setAutoRefreshRange(90, 90);
+  collector.startCollecting();
+
+  scheduler.runUntil(76 * kSecond);
+  QCOMPARE(collector.refreshRemainingMs(), 89 * kSecond);
+
+  scheduler.runUntil(kDay);
+  // 86400 / 168 = 514 个完整周期，余下 48s 内还有 3 次轮询
+  const int cycles = 514;
+  QCOMPARE(browser.scriptCalls().count("collector.start"), cycles + 1);
+  QCOMPARE(browser.scriptCalls().count("collector.scroll"), cycles * 4 + 3);
+  QCOMPARE(browser.reloadCount(), cycles);
+  QVERIFY(collector.isCollecting());
+  // 每次触发各自一个 tick：每周期 5 次轮询 + 刷新 + 重新开始
+  QCOMPARE(scheduler.wakeups(), quint64(cycles * 7 + 3));
+}
+
+int main(int argc, char *argv[]) {
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  QApplication app(argc, argv);
+  SchedulerTest test;
+  return QTest::qExec(&test, argc, argv);
+}
+
+#include "SchedulerTest.moc"
@@ -0,0 +1,141 @@
+// xsl_startuptest - 主窗口启动测试（QTest，offscreen）
+//
+// 预置一个 sqlite 账本后创建 MainWindow：外壳先显示占位，账本在工作线程
+// 加载，完成后面板、派生索引和按钮接上；加载期间的内存采样不能读到
+// 还在工作线程里重建的索引。浏览器是 src/Tools/Stub 下的替身。
+// ctest 里注册为 startup。
+
+#include "App/AppConfig.h"
+#include "App/MemoryAccounting.h"
+#include "App/StartupProfiler.h"
+#include "Data/EngagerTracker.h"
+#include "Data/LedgerStore.h"
+#include "Data/PostIndex.h"
+#include "Data/SqliteLedgerStore.h"
+#include "UI/ActionListPanel.h"
+#include "UI/MainWindow.h"
+#include "UI/WebView2Widget.h"
+#include <QApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QLabel>
+#include <QPushButton>
+#include <QStandardPaths>
+#include <QTableWidget>
+#include <QtTest>
+
+namespace {
+
+const int kLikes = 30;
+const int kReplies = 20;
+
+SocialAction seedAction(int i, const QString &type) {
+  SocialAction a;
+  a.userHandle = QString("user%1").arg(i % 7);
+  a.userName = a.userHandle;
+  a.type = type;
+  a.timestamp = QDateTime::currentDateTimeUtc()
+                    .addSecs(-60 * (i + 1))
+                    .toString(Qt::ISODateWithMs);
+  a.postSnippet = QString("post %1").arg(i % 5);
+  a.statusLink = QString("https://x.com/me/status/%1").arg(1000 + i % 5);
+  a.reciprocated = false;
+  a.id = SocialAction::makeId(a.userHandle, a.type, a.timestamp);
+  return a;
+}
+
+} // namespace
+
+class StartupTest : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void loadsLedgerInBackground();
+};
+
+void StartupTest::initTestCase() {
+  QStandardPaths::setTestModeEnabled(true);
+  for (auto location : {QStandardPaths::AppDataLocation,
+                        QStandardPaths::AppConfigLocation}) {
+    QDir(QStandardPaths::writableLocation(location)).removeRecursively();
+  }
+
+  AppConfig config(AppConfig::defaultFilePath());
+  StorageSettings storage = config.storage();
+  storage.backend = "sqlite";
+  config.setStorage(storage);
+  config.flush();
+
+  SqliteLedgerStore seed(SqliteLedgerStore::defaultFilePath());
+  QVERIFY(seed.isOpen());
+  QList<SocialAction> actions;
+  for (int i = 0; i < kLikes; i++)
+    actions.append(seedAction(i, "like"));
+  for (int i = 0; i < kReplies; i++)
+    actions.append(seedAction(kLikes + i, "reply"));
+  QCOMPARE(seed.importActions(actions), kLikes + kReplies);
+
+  StartupProfiler::start();
+}
+
+void StartupTest::loadsLedgerInBackground() {
+  MainWindow window;
+  window.show();
+
+  // 外壳：占位可见，依赖账本的按钮未启用，采集浏览器已导航
+  QVERIFY(window.findChild<QLabel *>("ledgerPlaceholder"));
+  QVERIFY(!window.findChild<ActionListPanel *>());
+  QPushButton *exportBtn = nullptr;
+  for (QPushButton *button : window.findChildren<QPushButton *>()) {
+    if (button->text().contains(QString::fromUtf8("导出")))
+      exportBtn = button;
+  }
+  QVERIFY(exportBtn);
+  QVERIFY(!exportBtn->isEnabled());
+  QList<WebView2Widget *> browsers = window.findChildren<WebView2Widget *>();
+  QVERIFY(!browsers.isEmpty());
+  QCOMPARE(browsers.first()->url(), QString("https://x.com/notifications"));
+
+  // 加载期间 GUI 线程照常处理事件和内存采样
+  QElapsedTimer timer;
+  timer.start();
+  while (!window.findChild<ActionListPanel *>() && timer.elapsed() < 20000) {
+    MemoryAccounting::instance()->sample();
+    QTest::qWait(5);
+  }
+  ActionListPanel *panel = window.findChild<ActionListPanel *>();
+  QVERIFY(panel);
+  QVERIFY(!window.findChild<QLabel *>("ledgerPlaceholder"));
+  QVERIFY(exportBtn->isEnabled());
+
+  // 工作线程创建的对象已交给 GUI 线程并挂到窗口上
+  for (QObject *object :
+       {static_cast<QObject *>(window.findChild<LedgerStore *>()),
+        static_cast<QObject *>(window.findChild<PostIndex *>()),
+        static_cast<QObject *>(window.findChild<EngagerTracker *>())}) {
+    QVERIFY(object);
+    QCOMPARE(object->thread(), window.thread());
+  }
+  QCOMPARE(window.findChild<PostIndex *>()->postCount(), 5);
+
+  // 首次填表在下一轮事件循环
+  QList<QTableWidget *> tables = panel->findChildren<QTableWidget *>();
+  QVERIFY(tables.size() >= 2);
+  QTRY_COMPARE(tables[0]->rowCount(), kLikes);
+  QCOMPARE(tables[1]->rowCount(), kReplies);
+
+  MemoryAccounting::instance()->sample();
+  QVERIFY(StartupProfiler::report().contains("ledger load"));
+}
+
+int main(int argc, char *argv[]) {
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  QApplication app(argc, argv);
+  StartupTest test;
+  return QTest::qExec(&test, argc, argv);
+}
+
+#include "StartupTest.moc"
@@ -0,0 +1,46 @@
+#include "WebView2Widget.h"
+#include <QPromise>
+
+WebView2Widget::WebView2Widget(QWidget *parent)
+    : QWidget(parent), m_reloads(0) {}
+
+WebView2Widget::~WebView2Widget() = default;
+
+void WebView2Widget::CreateBrowser(const QString &url) {
+  m_url = url;
+  emit browserCreated();
+}
+
+void WebView2Widget::SetUserDataFolder(const QString &) {}
+
+void WebView2Widget::LoadUrl(const QString &url) {
+  m_url = url;
+  emit urlChanged(url);
+}
+
+void WebView2Widget::ExecuteJavaScript(const QString &) {}
+
+void WebView2Widget::Invoke(const QString &fn, const QJsonArray &) {
+  m_scriptCalls.append(fn);
+}
+
+QFuture<QJsonValue> WebView2Widget::Call(const QString &fn, const QJsonArray &,
+                                         int) {
+  m_scriptCalls.append(fn);
+  QPromise<QJsonValue> promise;
+  promise.start();
+  QFuture<QJsonValue> future = promise.future();
+  future.cancel();
+  promise.finish();
+  return future;
+}
+
+void WebView2Widget::Reload() { m_reloads++; }
+
+void WebView2Widget::GoBack() {}
+
+void WebView2Widget::GoForward() {}
+
+void WebView2Widget::CloseBrowser() {}
+
+void WebView2Widget::DisconnectAll() { disconnect(); }
@@ -0,0 +1,69 @@
+#ifndef WEBVIEW2WIDGET_H
+#define WEBVIEW2WIDGET_H
+
+#include <QFuture>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QString>
+#include <QStringList>
+#include <QWidget>
+
+class WebView2Handler;
+
+// 测试替身：与 src/UI/WebView2Widget.h 同名同接口，不依赖 WebView2。
+// Linux offscreen 测试目标把 src/Tools/Stub 放在 include 路径最前面，
+// "UI/WebView2Widget.h" 就解析到这里。只记录脚本调用与导航，不加载页面。
+class WebView2Widget : public QWidget {
+  Q_OBJECT
+
+public:
+  explicit WebView2Widget(QWidget *parent = nullptr);
+  ~WebView2Widget();
+
+  void CreateBrowser(const QString &url);
+  void SetUserDataFolder(const QString &folder);
+  void LoadUrl(const QString &url);
+  void ExecuteJavaScript(const QString &code);
+  void Invoke(const QString &fn, const QJsonArray &args = QJsonArray());
+  // 总是返回已取消的 future（与真实浏览器还没有 webview 时相同）
+  QFuture<QJsonValue> Call(const QString &fn,
+                           const QJsonArray &args = QJsonArray(),
+                           int timeoutMs = 10000);
+
+  WebView2Handler *GetHandler() const { return nullptr; }
+  WebView2Handler *handler() const { return nullptr; }
+
+  void Reload();
+  void GoBack();
+  void GoForward();
+  void CloseBrowser();
+  void DisconnectAll();
+
+  // ---- 测试用 ----
+  // Invoke/Call 的函数名，按调用顺序
+  const QStringList &scriptCalls() const { return m_scriptCalls; }
+  int reloadCount() const { return m_reloads; }
+  QString url() const { return m_url; }
+
+signals:
+  void browserCreated();
+  void loadStarted();
+  void loadFinished(bool success);
+  void titleChanged(const QString &title);
+  void urlChanged(const QString &url);
+  void jsResultReceived(const QString &result);
+  void popupBlocked(const QString &url);
+
+  void likeFound(const QString &jsonData);
+  void replyFound(const QString &jsonData);
+  void collectProgress(const QString &jsonData);
+  void selfHandleDetected(const QString &handle);
+  void webMessageReceived(const QString &message);
+
+private:
+  QStringList m_scriptCalls;
+  int m_reloads;
+  QString m_url;
+};
+
+#endif // WEBVIEW2WIDGET_H
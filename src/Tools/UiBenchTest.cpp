@@ -0,0 +1,106 @@
+// xsl_uibench - 无窗口界面性能回归（QTest）
+//
+//   xsl_uibench                       默认 offscreen 平台，行数 1k..500k
+//   XSL_UI_BENCH_SIZES=1k,10k         行数档位
+//   XSL_UI_BENCH_OUT=ui-bench.json    结果 JSON
+//   XSL_UI_BENCH_BASELINE=base.json   与基线比较，有回归则 report 失败
+//   XSL_UI_BENCH_TOLERANCE=1.25       均值超过基线的倍数算回归
+//
+// 每个行数档位是一行数据驱动的 panels 用例；report 在最后写出 JSON 并比较
+// 基线。ctest 里注册为 ui_bench（只跑小档位）。
+
+#include "UI/UiBench.h"
+#include <QApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QtTest>
+
+class UiBenchTest : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void panels_data();
+  void panels();
+  void report();
+
+private:
+  QTemporaryDir m_dir;
+  QList<UiBench::Run> m_runs;
+};
+
+void UiBenchTest::initTestCase() {
+  QVERIFY2(m_dir.isValid(), "cannot create temporary directory");
+}
+
+void UiBenchTest::panels_data() {
+  QTest::addColumn<int>("rows");
+  QList<int> sizes = UiBench::defaultSizes();
+  if (qEnvironmentVariableIsSet("XSL_UI_BENCH_SIZES"))
+    sizes = UiBench::parseSizes(qEnvironmentVariable("XSL_UI_BENCH_SIZES"));
+  for (int rows : sizes)
+    QTest::newRow(qPrintable(QString::number(rows))) << rows;
+}
+
+void UiBenchTest::panels() {
+  QFETCH(int, rows);
+  UiBench::Run r = UiBench::run(rows, m_dir.path());
+  QVERIFY2(!r.scenarios.isEmpty(), "cannot open the scratch ledger");
+
+  qDebug().noquote() << QString("[UiBench] %1 rows: load %2 ms, peak RSS %3 MB")
+                            .arg(r.rows)
+                            .arg(r.loadUs / 1000)
+                            .arg(r.peakRssKb / 1024);
+  for (const UiBench::Scenario &s : r.scenarios) {
+    qDebug().noquote() << QString("  %1 mean %2 us, max %3 us")
+                              .arg(s.name, -24)
+                              .arg(s.meanUs())
+                              .arg(s.maxUs);
+  }
+  m_runs.append(r);
+}
+
+void UiBenchTest::report() {
+  QVERIFY(!m_runs.isEmpty());
+  QJsonObject report = UiBench::toJson(m_runs);
+  QString outPath = qEnvironmentVariable("XSL_UI_BENCH_OUT", "ui-bench.json");
+  QFile out(outPath);
+  QVERIFY2(out.open(QIODevice::WriteOnly | QIODevice::Truncate),
+           qPrintable("cannot write " + outPath));
+  out.write(QJsonDocument(report).toJson());
+  out.close();
+
+  QString baselinePath = qEnvironmentVariable("XSL_UI_BENCH_BASELINE");
+  if (baselinePath.isEmpty())
+    return;
+  QFile baseFile(baselinePath);
+  QVERIFY2(baseFile.open(QIODevice::ReadOnly),
+           qPrintable("cannot read baseline " + baselinePath));
+  QJsonObject baseline = QJsonDocument::fromJson(baseFile.readAll()).object();
+
+  double tolerance = 1.25;
+  if (qEnvironmentVariableIsSet("XSL_UI_BENCH_TOLERANCE"))
+    tolerance = qEnvironmentVariable("XSL_UI_BENCH_TOLERANCE").toDouble();
+  QVERIFY2(tolerance > 1.0, "XSL_UI_BENCH_TOLERANCE must be above 1.0");
+
+  QStringList found = UiBench::regressions(report, baseline, tolerance);
+  for (const QString &line : found)
+    qWarning().noquote() << "[UiBench] regression:" << line;
+  QVERIFY2(found.isEmpty(), qPrintable(QString("%1 regression(s) against %2")
+                                           .arg(found.size())
+                                           .arg(baselinePath)));
+}
+
+int main(int argc, char *argv[]) {
+  // 默认走 offscreen 平台插件，CI 上没有显示器
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  QApplication app(argc, argv);
+  app.setApplicationVersion("1.0.0");
+  UiBenchTest test;
+  return QTest::qExec(&test, argc, argv);
+}
+
+#include "UiBenchTest.moc"
@@ -1,6 +1,15 @@
 #include "ActionListPanel.h"
-#include "Data/DataStorage.h"
+#include "App/AppConfig.h"
+#include "App/MemoryAccounting.h"
+#include "App/Metrics.h"
+#include "App/Trace.h"
+#include "Data/LedgerStore.h"
+#include "Data/LedgerViewCache.h"
 #include "Data/SocialAction.h"
+#include "PostsPanel.h"
+#include "RankingPanel.h"
+#include "RenderGovernor.h"
+#include "SnippetItem.h"
 #include "StatsPanel.h"
 #include <QAction>
 #include <QDateTime>
@@ -9,15 +18,14 @@
 #include <QFont>
 #include <QHeaderView>
 #include <QMenu>
-#include <QSettings>
 #include <QUrl>
 #include <QVBoxLayout>
-#include <algorithm>
 
-ActionListPanel::ActionListPanel(DataStorage *storage, QWidget *parent)
-    : QWidget(parent), m_storage(storage) {
+ActionListPanel::ActionListPanel(LedgerStore *storage, LedgerViewCache *views,
+                                 AppConfig *config, QWidget *parent)
+    : QWidget(parent), m_storage(storage), m_views(views), m_config(config) {
   setupUI();
-  refreshAll();
+  // 首次填充由 MainWindow 在窗口显示后调度
 }
 
 ActionListPanel::~ActionListPanel() {}
@@ -38,16 +46,13 @@ void ActionListPanel::setupUI() {
   titleFont.setBold(true);
   titleLabel->setFont(titleFont);
   titleLabel->setAlignment(Qt::AlignCenter);
-  titleLabel->setStyleSheet(
-      "padding: 8px; color: #e0e0e0; background: #1a1a2e;");
+  titleLabel->setObjectName("panelTitle");
   layout->addWidget(titleLabel);
 
   // 统计标签
   m_statsLabel = new QLabel(this);
   m_statsLabel->setAlignment(Qt::AlignCenter);
-  m_statsLabel->setStyleSheet(
-      "padding: 6px; background: #16213e; color: #a0d2db; "
-      "border-radius: 4px; margin: 2px 4px;");
+  m_statsLabel->setObjectName("panelStats");
   layout->addWidget(m_statsLabel);
 
   // Hide reciprocated checkbox
@@ -55,12 +60,9 @@ void ActionListPanel::setupUI() {
       QString::fromUtf8(
           "\xe9\x9a\x90\xe8\x97\x8f\xe5\xb7\xb2\xe5\x9b\x9e\xe9\xa6\x88"),
       this);
-  m_hideReciprocatedCheck->setStyleSheet(
-      "QCheckBox { color: #a0d2db; padding: 4px 8px; }"
-      "QCheckBox::indicator { width: 16px; height: 16px; }");
-  loadHideReciprocatedSetting();
+  m_hideReciprocatedCheck->setChecked(m_config->view().hideReciprocated);
   connect(m_hideReciprocatedCheck, &QCheckBox::toggled, this, [this](bool) {
-    saveHideReciprocatedSetting();
+    saveViewSettings();
     refreshAll();
   });
   layout->addWidget(m_hideReciprocatedCheck);
@@ -71,24 +73,15 @@ void ActionListPanel::setupUI() {
                                       "24"
                                       "\xe5\xb0\x8f\xe6\x97\xb6\xe5\x86\x85"),
                     this);
-  m_only24hCheck->setStyleSheet(
-      "QCheckBox { color: #a0d2db; padding: 4px 8px; }"
-      "QCheckBox::indicator { width: 16px; height: 16px; }");
-  loadOnly24hSetting();
+  m_only24hCheck->setChecked(m_config->view().only24h);
   connect(m_only24hCheck, &QCheckBox::toggled, this, [this](bool) {
-    saveOnly24hSetting();
+    saveViewSettings();
     refreshAll();
   });
   layout->addWidget(m_only24hCheck);
 
   // Tab 页
   m_tabWidget = new QTabWidget(this);
-  m_tabWidget->setStyleSheet(
-      "QTabWidget::pane { border: 1px solid #2a2a4a; background: #0f0f23; }"
-      "QTabBar::tab { background: #1a1a2e; color: #8888aa; padding: 8px 16px; "
-      "  border: 1px solid #2a2a4a; border-bottom: none; margin-right: 2px; }"
-      "QTabBar::tab:selected { background: #16213e; color: #e0e0e0; }"
-      "QTabBar::tab:hover { background: #1f1f3a; }");
 
   // 点赞表格
   m_likeTable = new QTableWidget(this);
@@ -110,13 +103,6 @@ void ActionListPanel::setupUI() {
   m_likeTable->setAlternatingRowColors(true);
   m_likeTable->setContextMenuPolicy(Qt::CustomContextMenu);
   m_likeTable->verticalHeader()->setVisible(false);
-  m_likeTable->setStyleSheet(
-      "QTableWidget { background: #0f0f23; color: #d0d0d0; gridline-color: "
-      "#2a2a4a; "
-      "  selection-background-color: #1e3a5f; }"
-      "QTableWidget::item:alternate { background: #141428; }"
-      "QHeaderView::section { background: #1a1a2e; color: #a0a0c0; "
-      "  padding: 4px; border: 1px solid #2a2a4a; }");
   connect(m_likeTable, &QTableWidget::customContextMenuRequested, this,
           &ActionListPanel::onLikeContextMenu);
   connect(m_likeTable, &QTableWidget::cellDoubleClicked, this,
@@ -139,6 +125,11 @@ void ActionListPanel::setupUI() {
 
   // 回复表格
   m_replyTable = new QTableWidget(this);
+  for (QTableWidget *table : {m_likeTable, m_replyTable}) {
+    MemoryAccounting::instance()->addSource("tables", table, [table]() {
+      return MemoryAccounting::estimateTable(table);
+    });
+  }
   m_replyTable->setColumnCount(4);
   m_replyTable->setHorizontalHeaderLabels(
       {QString::fromUtf8("\xe7\x94\xa8\xe6\x88\xb7"),
@@ -157,21 +148,25 @@ void ActionListPanel::setupUI() {
   m_replyTable->setAlternatingRowColors(true);
   m_replyTable->setContextMenuPolicy(Qt::CustomContextMenu);
   m_replyTable->verticalHeader()->setVisible(false);
-  m_replyTable->setStyleSheet(
-      "QTableWidget { background: #0f0f23; color: #d0d0d0; gridline-color: "
-      "#2a2a4a; "
-      "  selection-background-color: #1e3a5f; }"
-      "QTableWidget::item:alternate { background: #141428; }"
-      "QHeaderView::section { background: #1a1a2e; color: #a0a0c0; "
-      "  padding: 4px; border: 1px solid #2a2a4a; }");
   connect(m_replyTable, &QTableWidget::customContextMenuRequested, this,
           &ActionListPanel::onReplyContextMenu);
   m_tabWidget->addTab(
       m_replyTable,
       QString::fromUtf8("\xf0\x9f\x92\xac \xe5\x9b\x9e\xe5\xa4\x8d"));
 
+  // 帖子页 - 按帖子聚合的互动
+  m_postsPanel = new PostsPanel(this);
+  m_tabWidget->addTab(
+      m_postsPanel, QString::fromUtf8("\xf0\x9f\x93\x9d \xe5\xb8\x96\xe5\xad\x90"));
+
+  // 排行页 - 滑动窗口内的高频互动用户
+  m_rankingPanel = new RankingPanel(this);
+  m_tabWidget->addTab(
+      m_rankingPanel,
+      QString::fromUtf8("\xf0\x9f\x8f\x86 \xe6\x8e\x92\xe8\xa1\x8c"));
+
   // Stats tab
-  m_statsPanel = new StatsPanel(m_storage, this);
+  m_statsPanel = new StatsPanel(m_storage, m_views, this);
   m_tabWidget->addTab(
       m_statsPanel,
       QString::fromUtf8("\xf0\x9f\x93\x8a \xe7\xbb\x9f\xe8\xae\xa1"));
@@ -180,43 +175,28 @@ void ActionListPanel::setupUI() {
 }
 
 void ActionListPanel::populateTable(QTableWidget *table, const QString &type) {
-  QList<SocialAction> actions;
-  if (type == "like") {
-    actions = m_storage->loadLikes();
-  } else {
-    actions = m_storage->loadReplies();
-  }
-
-  // Sort by timestamp descending (newest first)
-  std::sort(actions.begin(), actions.end(),
-            [](const SocialAction &a, const SocialAction &b) {
-              return a.timestamp > b.timestamp;
-            });
-
-  // Filter out reciprocated if checkbox is checked
-  if (m_hideReciprocatedCheck && m_hideReciprocatedCheck->isChecked()) {
-    actions.erase(
-        std::remove_if(actions.begin(), actions.end(),
-                       [](const SocialAction &a) { return a.reciprocated; }),
-        actions.end());
-  }
-
-  // 仅24小时过滤
+  XSL_TRACE_SCOPE("ActionListPanel::populateTable");
+  static Histogram *refreshLatency = Metrics::instance()->histogram(
+      "xsl_table_refresh_seconds", "Duration of ActionListPanel::populateTable");
+  ScopedLatency latency(refreshLatency);
+
+  // 排序/过滤后的视图由缓存提供；账本未变时直接复用
+  bool hide = m_hideReciprocatedCheck && m_hideReciprocatedCheck->isChecked();
+  std::shared_ptr<const LedgerView> view =
+      m_views->view(type, hide ? LedgerViewCache::Filter::Pending
+                               : LedgerViewCache::Filter::All);
+
+  // 仅24小时：视图按时间倒序，取前缀
+  int rows = view->size();
   if (m_only24hCheck && m_only24hCheck->isChecked()) {
-    QDateTime cutoff = QDateTime::currentDateTimeUtc().addSecs(-86400);
-    actions.erase(std::remove_if(actions.begin(), actions.end(),
-                                 [&cutoff](const SocialAction &a) {
-                                   QDateTime dt = QDateTime::fromString(
-                                       a.timestamp, Qt::ISODate);
-                                   return !dt.isValid() || dt < cutoff;
-                                 }),
-                  actions.end());
+    rows = view->countSince(QDateTime::currentMSecsSinceEpoch() -
+                            86400 * 1000LL);
   }
 
-  table->setRowCount(actions.size());
+  table->setRowCount(rows);
 
-  for (int i = 0; i < actions.size(); i++) {
-    const SocialAction &action = actions[i];
+  for (int i = 0; i < rows; i++) {
+    const SocialAction &action = view->at(i);
 
     // Username
     QString displayName =
@@ -236,14 +216,8 @@ void ActionListPanel::populateTable(QTableWidget *table, const QString &type) {
     timeItem->setToolTip(action.timestamp);
     table->setItem(i, 1, timeItem);
 
-    // Post snippet
-    QString snippet = action.postSnippet;
-    if (snippet.length() > 50) {
-      snippet = snippet.left(50) + "...";
-    }
-    QTableWidgetItem *snippetItem = new QTableWidgetItem(snippet);
-    snippetItem->setToolTip(action.postSnippet);
-    table->setItem(i, 2, snippetItem);
+    // Post snippet - 快照里已 intern，同一帖子的所有行共享一份
+    table->setItem(i, 2, new SnippetItem(view->snippet(i)));
 
     // Status
     QString status =
@@ -275,6 +249,23 @@ void ActionListPanel::refreshReplies() {
 void ActionListPanel::refreshAll() {
   refreshLikes();
   refreshReplies();
+  m_statsPanel->refresh();
+}
+
+void ActionListPanel::setPostIndex(PostIndex *index) {
+  m_postsPanel->setIndex(index);
+}
+
+void ActionListPanel::setEngagerTracker(EngagerTracker *tracker) {
+  m_rankingPanel->setTracker(tracker);
+}
+
+void ActionListPanel::postRefreshAll() {
+  RenderGovernor *governor = RenderGovernor::instance();
+  governor->post("actions.likes", this, [this]() { refreshLikes(); });
+  governor->post("actions.replies", this, [this]() { refreshReplies(); });
+  governor->post("actions.stats", m_statsPanel,
+                 [this]() { m_statsPanel->refresh(); });
 }
 
 void ActionListPanel::updateStats() {
@@ -283,6 +274,20 @@ void ActionListPanel::updateStats() {
   int pendingLikes = m_storage->pendingLikeCount();
   int pendingReplies = m_storage->pendingReplyCount();
 
+  Metrics *metrics = Metrics::instance();
+  metrics->gauge("xsl_ledger_rows", "Ledger row count", "type=\"like\"")
+      ->set(likes);
+  metrics->gauge("xsl_ledger_rows", "Ledger row count", "type=\"reply\"")
+      ->set(replies);
+  metrics
+      ->gauge("xsl_ledger_pending", "Rows not yet reciprocated",
+              "type=\"like\"")
+      ->set(pendingLikes);
+  metrics
+      ->gauge("xsl_ledger_pending", "Rows not yet reciprocated",
+              "type=\"reply\"")
+      ->set(pendingReplies);
+
   m_statsLabel->setText(
       QString::fromUtf8("\xe2\x9d\xa4\xef\xb8\x8f \xe7\x82\xb9\xe8\xb5\x9e: %1 "
                         "(\xe5\xbe\x85\xe5\x9b\x9e\xe9\xa6\x88 %2)  |  "
@@ -296,12 +301,14 @@ void ActionListPanel::updateStats() {
 
 void ActionListPanel::onNewLike(const QString &userName,
                                 const QString &timestamp) {
-  refreshLikes();
+  RenderGovernor::instance()->post("actions.likes", this,
+                                   [this]() { refreshLikes(); });
 }
 
 void ActionListPanel::onNewReply(const QString &userName,
                                  const QString &timestamp) {
-  refreshReplies();
+  RenderGovernor::instance()->post("actions.replies", this,
+                                   [this]() { refreshReplies(); });
 }
 
 void ActionListPanel::onLikeContextMenu(const QPoint &pos) {
@@ -318,10 +325,6 @@ void ActionListPanel::onLikeContextMenu(const QPoint &pos) {
   QString userHandle = userItem->data(Qt::UserRole + 1).toString();
 
   QMenu menu(this);
-  menu.setStyleSheet("QMenu { background: #1a1a2e; color: #d0d0d0; border: 1px "
-                     "solid #3a3a5a; }"
-                     "QMenu::item:selected { background: #2a3a5e; }");
-
   QAction *markAction = menu.addAction(QString::fromUtf8(
       "\xe2\x9c\x85 "
       "\xe6\xa0\x87\xe8\xae\xb0\xe5\xb7\xb2\xe5\x9b\x9e\xe9\xa6\x88"));
@@ -339,11 +342,9 @@ void ActionListPanel::onLikeContextMenu(const QPoint &pos) {
 
   if (selected == markAction) {
     onMarkReciprocated(actionId);
-    m_storage->markReciprocated(actionId, true);
-    refreshLikes();
+    setReciprocated(actionId, "like", true);
   } else if (selected == unmarkAction) {
-    m_storage->markReciprocated(actionId, false);
-    refreshLikes();
+    setReciprocated(actionId, "like", false);
   } else if (selected == openProfileAction) {
     QDesktopServices::openUrl(QUrl("https://x.com/" + userHandle));
   }
@@ -363,10 +364,6 @@ void ActionListPanel::onReplyContextMenu(const QPoint &pos) {
   QString userHandle = userItem->data(Qt::UserRole + 1).toString();
 
   QMenu menu(this);
-  menu.setStyleSheet("QMenu { background: #1a1a2e; color: #d0d0d0; border: 1px "
-                     "solid #3a3a5a; }"
-                     "QMenu::item:selected { background: #2a3a5e; }");
-
   QAction *markAction = menu.addAction(QString::fromUtf8(
       "\xe2\x9c\x85 "
       "\xe6\xa0\x87\xe8\xae\xb0\xe5\xb7\xb2\xe5\x9b\x9e\xe9\xa6\x88"));
@@ -383,38 +380,32 @@ void ActionListPanel::onReplyContextMenu(const QPoint &pos) {
   QAction *selected = menu.exec(m_replyTable->viewport()->mapToGlobal(pos));
 
   if (selected == markAction) {
-    m_storage->markReciprocated(actionId, true);
-    refreshReplies();
+    setReciprocated(actionId, "reply", true);
   } else if (selected == unmarkAction) {
-    m_storage->markReciprocated(actionId, false);
-    refreshReplies();
+    setReciprocated(actionId, "reply", false);
   } else if (selected == openProfileAction) {
     QDesktopServices::openUrl(QUrl("https://x.com/" + userHandle));
   }
 }
 
-void ActionListPanel::onMarkReciprocated(const QString &actionId) {
-  // Already handled in context menu
-}
-
-void ActionListPanel::loadHideReciprocatedSetting() {
-  QSettings settings("XSocialLedger", "XSocialLedger");
-  bool hide = settings.value("hideReciprocated", true).toBool();
-  m_hideReciprocatedCheck->setChecked(hide);
-}
-
-void ActionListPanel::saveHideReciprocatedSetting() {
-  QSettings settings("XSocialLedger", "XSocialLedger");
-  settings.setValue("hideReciprocated", m_hideReciprocatedCheck->isChecked());
+void ActionListPanel::setReciprocated(const QString &actionId,
+                                      const QString &type, bool value) {
+  XSL_TRACE_SCOPE("ActionListPanel::markReciprocated");
+  m_storage->markReciprocated(actionId, value);
+  m_views->noteReciprocated(actionId, value);
+  if (type == "reply")
+    refreshReplies();
+  else
+    refreshLikes();
 }
 
-void ActionListPanel::loadOnly24hSetting() {
-  QSettings settings("XSocialLedger", "XSocialLedger");
-  bool only24h = settings.value("only24h", true).toBool();
-  m_only24hCheck->setChecked(only24h);
+void ActionListPanel::onMarkReciprocated(const QString &actionId) {
+  // Already handled in context menu
 }
 
-void ActionListPanel::saveOnly24hSetting() {
-  QSettings settings("XSocialLedger", "XSocialLedger");
-  settings.setValue("only24h", m_only24hCheck->isChecked());
+void ActionListPanel::saveViewSettings() {
+  ViewSettings view = m_config->view();
+  view.hideReciprocated = m_hideReciprocatedCheck->isChecked();
+  view.only24h = m_only24hCheck->isChecked();
+  m_config->setView(view);
 }
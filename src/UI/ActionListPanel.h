@@ -7,7 +7,13 @@
 #include <QTableWidget>
 #include <QWidget>
 
-class DataStorage;
+class AppConfig;
+class LedgerStore;
+class EngagerTracker;
+class LedgerViewCache;
+class PostIndex;
+class PostsPanel;
+class RankingPanel;
 class StatsPanel;
 
 // 社交互动记录面板 (右侧面板)
@@ -15,7 +21,8 @@ class ActionListPanel : public QWidget {
   Q_OBJECT
 
 public:
-  explicit ActionListPanel(DataStorage *storage, QWidget *parent = nullptr);
+  ActionListPanel(LedgerStore *storage, LedgerViewCache *views,
+                  AppConfig *config, QWidget *parent = nullptr);
   ~ActionListPanel();
 
   // 刷新列表
@@ -23,9 +30,20 @@ public:
   void refreshReplies();
   void refreshAll();
 
+  // 帖子页的数据来源（账本加载后由 MainWindow 设置）
+  void setPostIndex(PostIndex *index);
+  void setEngagerTracker(EngagerTracker *tracker);
+
+  // 经 RenderGovernor 刷新：窗口不可见时合并到恢复后执行一次
+  void postRefreshAll();
+
   // 更新统计
   void updateStats();
 
+  // 右键菜单的标记/取消回馈：写存储、通知视图缓存、刷新对应列表
+  void setReciprocated(const QString &actionId, const QString &type,
+                       bool value);
+
 public slots:
   void onNewLike(const QString &userName, const QString &timestamp);
   void onNewReply(const QString &userName, const QString &timestamp);
@@ -40,20 +58,23 @@ private slots:
   void onMarkReciprocated(const QString &actionId);
 
 private:
+  friend class UiBench; // 切换过滤复选框
+
   void setupUI();
   void populateTable(QTableWidget *table, const QString &type);
-  void loadHideReciprocatedSetting();
-  void saveHideReciprocatedSetting();
-  void loadOnly24hSetting();
-  void saveOnly24hSetting();
+  void saveViewSettings();
 
-  DataStorage *m_storage;
+  LedgerStore *m_storage;
+  LedgerViewCache *m_views;
+  AppConfig *m_config;
   QTabWidget *m_tabWidget;
   QTableWidget *m_likeTable;
   QTableWidget *m_replyTable;
   QLabel *m_statsLabel;
   QCheckBox *m_hideReciprocatedCheck;
   QCheckBox *m_only24hCheck;
+  PostsPanel *m_postsPanel;
+  RankingPanel *m_rankingPanel;
   StatsPanel *m_statsPanel;
 };
 
@@ -0,0 +1,302 @@
+#include "DiagnosticsDialog.h"
+#include "App/MemoryAccounting.h"
+#include "App/Metrics.h"
+#include "App/StallWatchdog.h"
+#include "Theme.h"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <algorithm>
+
+namespace {
+
+QString formatMicros(quint64 us) {
+  if (us >= 1000000)
+    return QString::number(us / 1e6, 'f', 2) + " s";
+  if (us >= 1000)
+    return QString::number(us / 1e3, 'f', 2) + " ms";
+  return QString::number(us) + " us";
+}
+
+QString formatBytes(qint64 bytes) {
+  qint64 magnitude = qAbs(bytes);
+  if (magnitude >= 1024 * 1024 * 1024)
+    return QString::number(bytes / 1073741824.0, 'f', 2) + " GB";
+  if (magnitude >= 1024 * 1024)
+    return QString::number(bytes / 1048576.0, 'f', 1) + " MB";
+  if (magnitude >= 1024)
+    return QString::number(bytes / 1024.0, 'f', 1) + " KB";
+  return QString::number(bytes) + " B";
+}
+
+// 最近若干次采样的走势，按区间内最小/最大值归一
+QString sparkline(const QVector<qint64> &values) {
+  static const QString bars = QString::fromUtf8("▁▂▃▄▅▆▇█");
+  if (values.isEmpty())
+    return QString();
+  auto range = std::minmax_element(values.begin(), values.end());
+  qint64 lo = *range.first;
+  qint64 span = *range.second - lo;
+  QString out;
+  for (qint64 v : values)
+    out += bars[span ? int((v - lo) * 7 / span) : 0];
+  return out;
+}
+
+const int kTrendSamples = 24;
+const qint64 kGrowthWindowMs = 3600 * 1000;
+
+} // namespace
+
+DiagnosticsDialog::DiagnosticsDialog(QWidget *parent) : QDialog(parent) {
+  setWindowTitle(QString::fromUtf8("诊断"));
+  resize(760, 520);
+
+  QVBoxLayout *layout = new QVBoxLayout(this);
+  m_tabs = new QTabWidget(this);
+
+  m_metricsTable = new QTableWidget(this);
+  m_metricsTable->setColumnCount(6);
+  m_metricsTable->setHorizontalHeaderLabels(
+      {QString::fromUtf8("指标"), QString::fromUtf8("标签"),
+       QString::fromUtf8("值/次数"), "p50", "p99", "max"});
+  m_metricsTable->horizontalHeader()->setSectionResizeMode(
+      0, QHeaderView::ResizeToContents);
+  m_metricsTable->horizontalHeader()->setStretchLastSection(true);
+  m_metricsTable->verticalHeader()->setVisible(false);
+  m_metricsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  m_metricsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+  m_metricsTable->setAlternatingRowColors(true);
+  m_tabs->addTab(m_metricsTable, QString::fromUtf8("📈 指标"));
+
+  // 卡顿日志：新的在上
+  QWidget *stallPage = new QWidget(this);
+  QVBoxLayout *stallLayout = new QVBoxLayout(stallPage);
+  stallLayout->setContentsMargins(0, 0, 0, 0);
+  QHBoxLayout *stallBar = new QHBoxLayout();
+  m_stallSummary = new QLabel(stallPage);
+  m_stallSummary->setObjectName("diagSummary");
+  QPushButton *clearBtn =
+      new QPushButton(QString::fromUtf8("清空"), stallPage);
+  Theme::setRole(clearBtn, "tool");
+  connect(clearBtn, &QPushButton::clicked, this, [this]() {
+    StallWatchdog::instance()->clearEvents();
+    refreshStalls();
+  });
+  stallBar->addWidget(m_stallSummary, 1);
+  stallBar->addWidget(clearBtn);
+  stallLayout->addLayout(stallBar);
+
+  m_stallTable = new QTableWidget(stallPage);
+  m_stallTable->setColumnCount(6);
+  m_stallTable->setHorizontalHeaderLabels(
+      {QString::fromUtf8("时间"), QString::fromUtf8("时长"),
+       QString::fromUtf8("作用域"), QString::fromUtf8("作用域已运行"),
+       QString::fromUtf8("采样"), QString::fromUtf8("调用链")});
+  m_stallTable->horizontalHeader()->setSectionResizeMode(
+      2, QHeaderView::ResizeToContents);
+  m_stallTable->horizontalHeader()->setStretchLastSection(true);
+  m_stallTable->verticalHeader()->setVisible(false);
+  m_stallTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  m_stallTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+  m_stallTable->setAlternatingRowColors(true);
+  stallLayout->addWidget(m_stallTable);
+  m_tabs->addTab(stallPage, QString::fromUtf8("⏱ 卡顿"));
+
+  // 分子系统内存：当前值来自最近一次采样，变化对比一小时前的采样
+  QWidget *memoryPage = new QWidget(this);
+  QVBoxLayout *memoryLayout = new QVBoxLayout(memoryPage);
+  memoryLayout->setContentsMargins(0, 0, 0, 0);
+  QHBoxLayout *memoryBar = new QHBoxLayout();
+  m_memorySummary = new QLabel(memoryPage);
+  m_memorySummary->setObjectName("diagSummary");
+  QPushButton *sampleBtn =
+      new QPushButton(QString::fromUtf8("立即采样"), memoryPage);
+  Theme::setRole(sampleBtn, "tool");
+  connect(sampleBtn, &QPushButton::clicked, this, [this]() {
+    MemoryAccounting::instance()->sample();
+    refreshMemory();
+  });
+  memoryBar->addWidget(m_memorySummary, 1);
+  memoryBar->addWidget(sampleBtn);
+  memoryLayout->addLayout(memoryBar);
+
+  m_memoryTable = new QTableWidget(memoryPage);
+  m_memoryTable->setColumnCount(6);
+  m_memoryTable->setHorizontalHeaderLabels(
+      {QString::fromUtf8("子系统"), QString::fromUtf8("当前"),
+       QString::fromUtf8("对象数"), QString::fromUtf8("峰值"),
+       QString::fromUtf8("1 小时变化"), QString::fromUtf8("趋势")});
+  m_memoryTable->horizontalHeader()->setSectionResizeMode(
+      0, QHeaderView::ResizeToContents);
+  m_memoryTable->horizontalHeader()->setStretchLastSection(true);
+  m_memoryTable->verticalHeader()->setVisible(false);
+  m_memoryTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  m_memoryTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+  m_memoryTable->setAlternatingRowColors(true);
+  memoryLayout->addWidget(m_memoryTable);
+  m_tabs->addTab(memoryPage, QString::fromUtf8("🧠 内存"));
+  layout->addWidget(m_tabs);
+
+  m_refreshTimer = new QTimer(this);
+  m_refreshTimer->setInterval(1000);
+  connect(m_refreshTimer, &QTimer::timeout, this, &DiagnosticsDialog::refresh);
+}
+
+void DiagnosticsDialog::showEvent(QShowEvent *event) {
+  QDialog::showEvent(event);
+  refresh();
+  m_refreshTimer->start();
+}
+
+void DiagnosticsDialog::hideEvent(QHideEvent *event) {
+  m_refreshTimer->stop();
+  QDialog::hideEvent(event);
+}
+
+void DiagnosticsDialog::refreshStalls() {
+  StallWatchdog *watchdog = StallWatchdog::instance();
+  QList<StallEvent> events = watchdog->events();
+
+  quint64 longest = 0;
+  for (const StallEvent &e : events)
+    longest = qMax(longest, quint64(e.durationMs));
+  m_stallSummary->setText(
+      watchdog->isRunning()
+          ? QString::fromUtf8("阈值 %1 ms · 最近 %2 次卡顿 · 最长 %3 ms")
+                .arg(watchdog->thresholdMs())
+                .arg(events.size())
+                .arg(longest)
+          : QString::fromUtf8("卡顿检测未启用 (XSL_STALL_MS=0)"));
+
+  m_stallTable->setRowCount(events.size());
+  for (int i = 0; i < events.size(); i++) {
+    const StallEvent &e = events[events.size() - 1 - i];
+    QStringList cells = {e.at.toString("MM-dd HH:mm:ss.zzz"),
+                         formatMicros(quint64(e.durationMs) * 1000),
+                         e.scope,
+                         formatMicros(quint64(e.scopeMs) * 1000),
+                         QString::number(e.samples),
+                         e.chain};
+    for (int col = 0; col < cells.size(); col++) {
+      QTableWidgetItem *item = m_stallTable->item(i, col);
+      if (!item) {
+        item = new QTableWidgetItem();
+        m_stallTable->setItem(i, col, item);
+      }
+      if (item->text() != cells[col])
+        item->setText(cells[col]);
+    }
+  }
+}
+
+void DiagnosticsDialog::refreshMemory() {
+  MemoryAccounting *accounting = MemoryAccounting::instance();
+  QList<MemorySample> history = accounting->history();
+  if (history.isEmpty()) {
+    m_memorySummary->setText(
+        QString::fromUtf8("还没有采样 (XSL_MEMORY_SAMPLE_MS=0 时只能手动采样)"));
+    m_memoryTable->setRowCount(0);
+    return;
+  }
+
+  const MemorySample &latest = history.last();
+  int baseline = 0; // 一小时前（或最早）的那次采样
+  while (baseline + 1 < history.size() &&
+         history[baseline + 1].atMs <= latest.atMs - kGrowthWindowMs)
+    baseline++;
+  const MemorySample &before = history[baseline];
+
+  qint64 accounted = 0;
+  for (const MemoryUsage &u : latest.subsystems)
+    accounted += u.bytes;
+  m_memorySummary->setText(
+      QString::fromUtf8("常驻 %1 · 已记账 %2 · 未归属 %3 · %4 次采样%5")
+          .arg(formatBytes(latest.residentBytes), formatBytes(accounted),
+               latest.residentBytes
+                   ? formatBytes(latest.residentBytes - accounted)
+                   : QString("-"))
+          .arg(history.size())
+          .arg(accounting->isRunning()
+                   ? QString::fromUtf8("，每 %1 s")
+                         .arg(accounting->intervalMs() / 1000)
+                   : QString()));
+
+  QStringList names = latest.subsystems.keys();
+  std::sort(names.begin(), names.end(), [&latest](const QString &a,
+                                                  const QString &b) {
+    return latest.subsystems[a].bytes > latest.subsystems[b].bytes;
+  });
+  QHash<QString, qint64> peaks = accounting->peaks();
+  int first = qMax(0, int(history.size()) - kTrendSamples);
+
+  m_memoryTable->setRowCount(names.size());
+  for (int row = 0; row < names.size(); row++) {
+    const QString &name = names[row];
+    const MemoryUsage &now = latest.subsystems[name];
+    QVector<qint64> trend;
+    for (int i = first; i < history.size(); i++)
+      trend.append(history[i].subsystems.value(name).bytes);
+    qint64 growth = now.bytes - before.subsystems.value(name).bytes;
+
+    QStringList cells = {name,
+                         formatBytes(now.bytes),
+                         QString::number(now.objects),
+                         formatBytes(peaks.value(name)),
+                         (growth > 0 ? "+" : "") + formatBytes(growth),
+                         sparkline(trend)};
+    for (int col = 0; col < cells.size(); col++) {
+      QTableWidgetItem *item = m_memoryTable->item(row, col);
+      if (!item) {
+        item = new QTableWidgetItem();
+        m_memoryTable->setItem(row, col, item);
+      }
+      if (item->text() != cells[col])
+        item->setText(cells[col]);
+    }
+  }
+}
+
+void DiagnosticsDialog::refresh() {
+  refreshStalls();
+  refreshMemory();
+  QList<Metrics::Family> families = Metrics::instance()->families();
+
+  int rows = 0;
+  for (const auto &f : families)
+    rows += f.series.size();
+  m_metricsTable->setRowCount(rows);
+
+  auto setCell = [this](int row, int col, const QString &text) {
+    QTableWidgetItem *item = m_metricsTable->item(row, col);
+    if (!item) {
+      item = new QTableWidgetItem();
+      m_metricsTable->setItem(row, col, item);
+    }
+    if (item->text() != text)
+      item->setText(text);
+  };
+
+  int row = 0;
+  for (const auto &f : families) {
+    for (const auto &s : f.series) {
+      setCell(row, 0, f.name);
+      setCell(row, 1, s.labels);
+      if (s.histogram) {
+        setCell(row, 2, QString::number(s.histogram->count()));
+        setCell(row, 3, formatMicros(s.histogram->percentile(0.5)));
+        setCell(row, 4, formatMicros(s.histogram->percentile(0.99)));
+        setCell(row, 5, formatMicros(s.histogram->max()));
+      } else {
+        setCell(row, 2, s.counter ? QString::number(s.counter->value())
+                                  : QString::number(s.gauge->value()));
+        setCell(row, 3, QString());
+        setCell(row, 4, QString());
+        setCell(row, 5, QString());
+      }
+      m_metricsTable->item(row, 0)->setToolTip(f.help);
+      row++;
+    }
+  }
+}
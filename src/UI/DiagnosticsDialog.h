@@ -0,0 +1,37 @@
+#ifndef DIAGNOSTICSDIALOG_H
+#define DIAGNOSTICSDIALOG_H
+
+#include <QDialog>
+#include <QLabel>
+#include <QTabWidget>
+#include <QTableWidget>
+#include <QTimer>
+
+// 诊断面板 - 实时显示 Metrics 注册表中的计数器/仪表/延迟分位数、
+// StallWatchdog 记录的事件循环卡顿，以及 MemoryAccounting 的分子系统内存
+class DiagnosticsDialog : public QDialog {
+  Q_OBJECT
+
+public:
+  explicit DiagnosticsDialog(QWidget *parent = nullptr);
+
+protected:
+  void showEvent(QShowEvent *event) override;
+  void hideEvent(QHideEvent *event) override;
+
+private slots:
+  void refresh();
+  void refreshStalls();
+  void refreshMemory();
+
+private:
+  QTabWidget *m_tabs;
+  QTableWidget *m_metricsTable;
+  QTableWidget *m_stallTable;
+  QLabel *m_stallSummary;
+  QTableWidget *m_memoryTable;
+  QLabel *m_memorySummary;
+  QTimer *m_refreshTimer;
+};
+
+#endif // DIAGNOSTICSDIALOG_H
@@ -0,0 +1,196 @@
+#include "LogConsole.h"
+#include "RenderGovernor.h"
+#include <QColor>
+#include <QDateTime>
+#include <QHBoxLayout>
+#include <QScrollBar>
+#include <QVBoxLayout>
+
+// ==================== LogModel ====================
+
+LogModel::LogModel(LogBuffer *buffer, QObject *parent)
+    : QAbstractListModel(parent), m_buffer(buffer), m_syncedSeq(0),
+      m_minLevel(LogLevel::Debug), m_sourceId(-1) {}
+
+int LogModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || index.row() >= m_rows.size())
+    return QVariant();
+
+  quint64 seq = m_rows[index.row()];
+  if (seq < m_buffer->firstSeq())
+    return QVariant(); // evicted, removed on next sync
+
+  const LogEntry &e = m_buffer->entry(seq);
+  switch (role) {
+  case Qt::DisplayRole:
+    return QString("[%1] [%2] %3")
+        .arg(QDateTime::fromMSecsSinceEpoch(e.timestampMs).toString("HH:mm:ss"),
+             m_buffer->source(e.sourceId), m_buffer->message(e));
+  case Qt::ToolTipRole:
+    return QDateTime::fromMSecsSinceEpoch(e.timestampMs)
+        .toString("yyyy-MM-dd HH:mm:ss.zzz");
+  case Qt::ForegroundRole:
+    switch (e.level) {
+    case LogLevel::Debug:
+      return QColor("#6a6a8a");
+    case LogLevel::Warning:
+      return QColor("#ffcc00");
+    case LogLevel::Error:
+      return QColor("#ff5252");
+    default:
+      return QColor("#88cc88");
+    }
+  default:
+    return QVariant();
+  }
+}
+
+void LogModel::setMinimumLevel(LogLevel level) {
+  if (m_minLevel == level)
+    return;
+  m_minLevel = level;
+  rebuild();
+}
+
+void LogModel::setSourceFilter(int sourceId) {
+  if (m_sourceId == sourceId)
+    return;
+  m_sourceId = sourceId;
+  rebuild();
+}
+
+bool LogModel::accepts(const LogEntry &entry) const {
+  if (entry.level < m_minLevel)
+    return false;
+  return m_sourceId < 0 || entry.sourceId == m_sourceId;
+}
+
+void LogModel::rebuild() {
+  beginResetModel();
+  m_rows.clear();
+  for (quint64 seq = m_buffer->firstSeq(); seq < m_buffer->nextSeq(); seq++) {
+    if (accepts(m_buffer->entry(seq)))
+      m_rows.append(seq);
+  }
+  m_syncedSeq = m_buffer->nextSeq();
+  endResetModel();
+}
+
+void LogModel::sync() {
+  // Drop rows that fell out of the ring
+  quint64 first = m_buffer->firstSeq();
+  int evicted = 0;
+  while (evicted < m_rows.size() && m_rows[evicted] < first)
+    evicted++;
+  if (evicted > 0) {
+    beginRemoveRows(QModelIndex(), 0, evicted - 1);
+    m_rows.remove(0, evicted);
+    endRemoveRows();
+  }
+
+  // Append everything written since the last sync
+  QVector<quint64> added;
+  for (quint64 seq = qMax(m_syncedSeq, first); seq < m_buffer->nextSeq();
+       seq++) {
+    if (accepts(m_buffer->entry(seq)))
+      added.append(seq);
+  }
+  m_syncedSeq = m_buffer->nextSeq();
+
+  if (!added.isEmpty()) {
+    beginInsertRows(QModelIndex(), m_rows.size(),
+                    m_rows.size() + added.size() - 1);
+    m_rows += added;
+    endInsertRows();
+  }
+}
+
+// ==================== LogConsole ====================
+
+LogConsole::LogConsole(LogBuffer *buffer, QWidget *parent)
+    : QWidget(parent), m_buffer(buffer) {
+  QVBoxLayout *layout = new QVBoxLayout(this);
+  layout->setContentsMargins(0, 0, 0, 0);
+  layout->setSpacing(2);
+
+  QHBoxLayout *filterRow = new QHBoxLayout();
+  filterRow->setContentsMargins(2, 0, 2, 0);
+
+  m_levelCombo = new QComboBox(this);
+  m_levelCombo->addItem(QString::fromUtf8("全部级别"),
+                        int(LogLevel::Debug));
+  m_levelCombo->addItem("INFO+", int(LogLevel::Info));
+  m_levelCombo->addItem("WARN+", int(LogLevel::Warning));
+  m_levelCombo->addItem("ERROR", int(LogLevel::Error));
+  filterRow->addWidget(m_levelCombo);
+
+  m_sourceCombo = new QComboBox(this);
+  m_sourceCombo->addItem(QString::fromUtf8("全部来源"), -1);
+  for (int i = 0; i < m_buffer->sources().size(); i++) {
+    m_sourceCombo->addItem(m_buffer->sources().at(i), i);
+  }
+  filterRow->addWidget(m_sourceCombo);
+  filterRow->addStretch();
+  layout->addLayout(filterRow);
+
+  m_model = new LogModel(m_buffer, this);
+
+  m_view = new QListView(this);
+  m_view->setModel(m_model);
+  m_view->setUniformItemSizes(true);
+  m_view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  m_view->setSelectionMode(QAbstractItemView::ExtendedSelection);
+  layout->addWidget(m_view);
+
+  connect(m_levelCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+          this, [this](int) {
+            m_model->setMinimumLevel(
+                LogLevel(m_levelCombo->currentData().toInt()));
+            m_view->scrollToBottom();
+          });
+  connect(m_sourceCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+          this, [this](int) {
+            m_model->setSourceFilter(m_sourceCombo->currentData().toInt());
+            m_view->scrollToBottom();
+          });
+  connect(m_buffer, &LogBuffer::sourceAdded, this,
+          [this](const QString &source) {
+            m_sourceCombo->addItem(source, m_buffer->sources().size() - 1);
+          });
+
+  // Coalesce bursts of appends into at most one repaint per frame
+  m_repaintTimer = new QTimer(this);
+  m_repaintTimer->setSingleShot(true);
+  m_repaintTimer->setInterval(16);
+  connect(m_repaintTimer, &QTimer::timeout, this, &LogConsole::onRepaintTick);
+  connect(m_buffer, &LogBuffer::entriesAppended, this,
+          &LogConsole::onEntriesAppended);
+
+  m_model->sync();
+}
+
+void LogConsole::onEntriesAppended() {
+  // 窗口不可见时不同步模型，恢复后一次拉取
+  RenderGovernor *governor = RenderGovernor::instance();
+  if (governor->isSuspended()) {
+    governor->post("log", this, [this]() { onRepaintTick(); });
+    return;
+  }
+  if (!m_repaintTimer->isActive())
+    m_repaintTimer->start();
+}
+
+void LogConsole::onRepaintTick() {
+  // Only follow the tail if the user has not scrolled up
+  QScrollBar *bar = m_view->verticalScrollBar();
+  bool atBottom = bar->value() >= bar->maximum() - 1;
+
+  m_model->sync();
+
+  if (atBottom)
+    m_view->scrollToBottom();
+}
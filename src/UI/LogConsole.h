@@ -0,0 +1,62 @@
+#ifndef LOGCONSOLE_H
+#define LOGCONSOLE_H
+
+#include <QAbstractListModel>
+#include <QComboBox>
+#include <QListView>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+
+#include "App/LogBuffer.h"
+
+// Virtualized view over LogBuffer - rows hold sequence numbers only
+class LogModel : public QAbstractListModel {
+  Q_OBJECT
+
+public:
+  explicit LogModel(LogBuffer *buffer, QObject *parent = nullptr);
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role) const override;
+
+  void setMinimumLevel(LogLevel level);
+  void setSourceFilter(int sourceId); // -1 = all sources
+
+  // Pull new entries from the buffer and drop evicted ones
+  void sync();
+
+private:
+  bool accepts(const LogEntry &entry) const;
+  void rebuild();
+
+  LogBuffer *m_buffer;
+  QVector<quint64> m_rows;
+  quint64 m_syncedSeq;
+  LogLevel m_minLevel;
+  int m_sourceId;
+};
+
+// 日志控制台 - 替代 QTextEdit 日志框
+class LogConsole : public QWidget {
+  Q_OBJECT
+
+public:
+  explicit LogConsole(LogBuffer *buffer, QWidget *parent = nullptr);
+
+  LogBuffer *buffer() const { return m_buffer; }
+
+private slots:
+  void onEntriesAppended();
+  void onRepaintTick();
+
+private:
+  LogBuffer *m_buffer;
+  LogModel *m_model;
+  QListView *m_view;
+  QComboBox *m_levelCombo;
+  QComboBox *m_sourceCombo;
+  QTimer *m_repaintTimer;
+};
+
+#endif // LOGCONSOLE_H
@@ -2,11 +2,32 @@
 #include "ActionListPanel.h"
 #include "Core/ListMonitorEngine.h"
 #include "Core/NotificationCollector.h"
+#include "App/AppConfig.h"
+#include "App/LocalHttpServer.h"
+#include "App/LogBuffer.h"
+#include "App/MemoryAccounting.h"
+#include "App/Metrics.h"
+#include "App/StartupProfiler.h"
+#include "App/Trace.h"
 #include "Core/ReciprocatorEngine.h"
-#include "Data/DataStorage.h"
+#include "Data/ArrowExporter.h"
+#include "Data/LedgerQueryService.h"
+#include "Data/LedgerStore.h"
+#include "Data/LedgerSync.h"
+#include "Data/SqliteLedgerStore.h"
+#include "Data/EngagerTracker.h"
+#include "Data/LedgerViewCache.h"
+#include "Data/PostIndex.h"
+#include "Data/SnippetStore.h"
 #include "Data/SocialAction.h"
-#include "WebView2Widget.h"
+#include "DiagnosticsDialog.h"
+#include "LogConsole.h"
+#include "RenderGovernor.h"
+#include "StorageBenchDialog.h"
+#include "Theme.h"
+#include "UI/WebView2Widget.h"
 #include <QApplication>
+#include <QCheckBox>
 #include <QCloseEvent>
 #include <QCoreApplication>
 #include <QDateTime>
@@ -14,81 +35,291 @@
 #include <QDialog>
 #include <QFile>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QFormLayout>
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QMessageBox>
-#include <QScrollBar>
 #include <QSettings>
+#include <QSpinBox>
 #include <QStatusBar>
+#include <QThread>
+#include <QTimer>
+#include <QTextEdit>
+#include <QtConcurrent>
 #include <QToolBar>
+#include <QToolButton>
 #include <QVBoxLayout>
 
-MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
+namespace {
 
-  // 初始化数据存储
-  m_storage = new DataStorage(this);
+// SnippetStore 指标的发布间隔（intern/release 本身不发布）
+const int kSnippetMetricsIntervalMs = 5000;
+
+} // namespace
+
+struct MainWindow::LedgerLoad {
+  LedgerStore *storage = nullptr;
+  LedgerViewCache::Loaded likes;
+  LedgerViewCache::Loaded replies;
+  PostIndex *postIndex = nullptr;
+  EngagerTracker *engagerTracker = nullptr;
+};
+
+MainWindow::MainWindow(QWidget *parent)
+    : QMainWindow(parent), m_recipBrowserStarted(false),
+      m_listBrowserStarted(false), m_ledgerPlaceholder(nullptr),
+      m_actionPanel(nullptr), m_diagDialog(nullptr),
+      m_metricsServer(nullptr), m_queryService(nullptr), m_storage(nullptr),
+      m_viewCache(nullptr),
+      m_postIndex(nullptr), m_engagerTracker(nullptr), m_collector(nullptr),
+      m_reciprocator(nullptr), m_listMonitor(nullptr) {
+
+  // 阶段一：只搭界面外壳，让首帧尽快绘制。
+  // 账本在 finishStartup() 里交给工作线程加载（窗口显示之后），
+  // 加载完成后 populateLedger() 接上面板和引擎。
+  m_config = new AppConfig(AppConfig::defaultFilePath(), this);
+  StartupProfiler::mark("config");
 
   setupUI();
   setupToolBar();
-  setupConnections();
 
   // 恢复窗口布局
   restoreLayout();
+  StartupProfiler::mark("shell");
 
-  // 创建浏览器并导航到通知页面
+  // 创建浏览器并导航到通知页面（副浏览器按需创建）
   m_browser->CreateBrowser("https://x.com/notifications");
 
-  qDebug() << "[MainWindow] Initialized";
+  // XSL_METRICS_PORT=端口 启用本机 Prometheus 指标端点 (/metrics)
+  bool portOk = false;
+  int metricsPort = qEnvironmentVariableIntValue("XSL_METRICS_PORT", &portOk);
+  if (portOk && metricsPort > 0 && metricsPort < 65536) {
+    m_metricsServer = new LocalHttpServer(this);
+    m_metricsServer->route("/metrics", [](const QString &) {
+      HttpResponse response;
+      response.contentType = "text/plain; version=0.0.4; charset=utf-8";
+      response.body = Metrics::instance()->renderPrometheus();
+      return response;
+    });
+    m_metricsServer->listen(quint16(metricsPort));
+  }
+
+  // 最小化/隐藏时暂停视图更新
+  RenderGovernor::instance()->watch(this);
+
+  // 首次进入事件循环（窗口已显示）后继续启动
+  QTimer::singleShot(0, this, &MainWindow::finishStartup);
+
+  qDebug() << "[MainWindow] Shell initialized";
 }
 
 MainWindow::~MainWindow() {
+  if (m_queryService) {
+    m_queryService->stop();
+  }
   if (m_collector) {
     m_collector->stopCollecting();
   }
-  m_storage->flush();
+  if (m_storage) {
+    flushStorage();
+  }
+}
+
+void MainWindow::finishStartup() {
+  XSL_TRACE_SCOPE("MainWindow::finishStartup");
+  StartupProfiler::mark("first event loop");
+
+  // 阶段二：工作线程打开账本、读出全部历史、建快照和派生索引，
+  // GUI 线程照常绘制占位和处理输入。对象在工作线程创建（无父对象），
+  // 用完交给 GUI 线程，由续延挂到窗口上
+  QThread *gui = thread();
+  const QString backend = m_config->storage().backend;
+  QtConcurrent::run([gui, backend]() {
+    XSL_TRACE_SCOPE("MainWindow::loadLedger");
+    LedgerLoad load;
+    load.storage = LedgerStore::open(backend);
+    const QList<SocialAction> likes = load.storage->loadLikes();
+    const QList<SocialAction> replies = load.storage->loadReplies();
+    load.likes = LedgerViewCache::load(likes);
+    load.replies = LedgerViewCache::load(replies);
+
+    // 派生索引：从账本重建一次，之后随新记录增量更新
+    const QList<SocialAction> history = likes + replies;
+    load.postIndex = new PostIndex;
+    load.postIndex->rebuild(history);
+    load.engagerTracker = new EngagerTracker;
+    load.engagerTracker->rebuild(history);
+
+    load.storage->handOver(gui);
+    load.postIndex->moveToThread(gui);
+    load.engagerTracker->moveToThread(gui);
+    return load;
+  }).then(this, [this](const LedgerLoad &load) { populateLedger(load); });
+}
+
+void MainWindow::populateLedger(const LedgerLoad &load) {
+  XSL_TRACE_SCOPE("MainWindow::populateLedger");
+  m_storage = load.storage;
+  m_storage->setParent(this);
+  m_viewCache = new LedgerViewCache(m_storage, 8, this);
+  m_viewCache->adopt("like", load.likes);
+  m_viewCache->adopt("reply", load.replies);
+  m_postIndex = load.postIndex;
+  m_postIndex->setParent(this);
+  m_engagerTracker = load.engagerTracker;
+  m_engagerTracker->setParent(this);
+  StartupProfiler::mark("ledger load");
+
+  // XSL_QUERY_PORT=端口 启用本机只读查询 API（独立线程）
+  bool queryPortOk = false;
+  int queryPort = qEnvironmentVariableIntValue("XSL_QUERY_PORT", &queryPortOk);
+  if (queryPortOk && queryPort > 0 && queryPort < 65536) {
+    m_queryService = new LedgerQueryService(m_viewCache, this);
+    m_queryService->start(quint16(queryPort));
+  }
+
+  // 用真正的记录面板替换占位
+  m_actionPanel = new ActionListPanel(m_storage, m_viewCache, m_config);
+  m_actionPanel->setMinimumWidth(300);
+  delete m_middleSplitter->replaceWidget(0, m_actionPanel);
+  m_ledgerPlaceholder = nullptr;
+
+  m_actionPanel->setPostIndex(m_postIndex);
+  m_actionPanel->setEngagerTracker(m_engagerTracker);
+
+  // 片段存储是进程级单例，由主窗口代为登记，并定时发布它的指标
+  MemoryAccounting::instance()->addSource("snippets", this, []() {
+    SnippetStore *snippets = SnippetStore::instance();
+    qint64 blobs = snippets->blobCount();
+    return MemoryUsage{
+        snippets->blobBytes() +
+            blobs * (MemoryAccounting::kHashEntryBytes +
+                     qint64(sizeof(SnippetStore::Blob))),
+        blobs};
+  });
+  QTimer *snippetMetrics = new QTimer(this);
+  connect(snippetMetrics, &QTimer::timeout, this,
+          []() { SnippetStore::instance()->publishMetrics(); });
+  snippetMetrics->start(kSnippetMetricsIntervalMs);
+
+  // 创建引擎（副浏览器此时仍未创建，首次使用时再创建）
+  m_collector = new NotificationCollector(m_browser, m_storage, this);
+  m_collector->setConfig(m_config);
+  m_reciprocator = new ReciprocatorEngine(m_recipBrowser, m_storage, this);
+  m_reciprocator->setConfig(m_config);
+  m_listMonitor = new ListMonitorEngine(m_listBrowser, m_storage, this);
+  m_listMonitor->setConfig(m_config);
+
+  setupConnections();
+  StartupProfiler::mark("engines");
+
+  m_startBtn->setEnabled(true);
+  m_exportBtn->setEnabled(true);
+  m_syncBtn->setEnabled(true);
+  m_batchBtn->setEnabled(true);
+  m_listMonitorBtn->setEnabled(true);
+
+  // 首次填表放到下一轮，先让面板绘制出来
+  QTimer::singleShot(0, this, [this]() {
+    m_actionPanel->refreshAll();
+    StartupProfiler::mark("first table fill");
+    reportStartup();
+  });
+
+  // 启动完成后再创建布局中可见的副浏览器，避免与首屏争抢
+  QTimer::singleShot(1500, this, &MainWindow::createVisibleBrowsers);
+}
+
+void MainWindow::rebuildIndexes() {
+  XSL_TRACE_SCOPE("MainWindow::rebuildIndexes");
+  QList<SocialAction> history =
+      m_storage->loadLikes() + m_storage->loadReplies();
+  m_postIndex->rebuild(history);
+  m_engagerTracker->rebuild(history);
+}
+
+void MainWindow::createVisibleBrowsers() {
+  QList<int> sizes = m_splitter->sizes();
+  if (sizes.size() < 4)
+    return;
+  if (sizes[2] > 0 && m_recipBrowser->isVisible()) {
+    ensureRecipBrowser();
+  }
+  if (sizes[3] > 0 && m_listBrowser->isVisible()) {
+    ensureListBrowser();
+  }
+}
+
+void MainWindow::ensureRecipBrowser() {
+  if (m_recipBrowserStarted)
+    return;
+  m_recipBrowserStarted = true;
+  m_recipBrowser->CreateBrowser("https://x.com");
+}
+
+void MainWindow::ensureListBrowser() {
+  if (m_listBrowserStarted)
+    return;
+  m_listBrowserStarted = true;
+  // 共享用户数据，无需重新登录
+  m_listBrowser->CreateBrowser("https://x.com");
+}
+
+void MainWindow::reportStartup() {
+  QString report = StartupProfiler::report();
+  const QString source = QString::fromUtf8("启动");
+  for (const QString &line : report.split('\n', Qt::SkipEmptyParts)) {
+    m_logBuffer->append(source, LogLevel::Debug, line);
+  }
+  m_logBuffer->append(source, LogLevel::Info,
+                      QString::fromUtf8("启动完成: %1ms")
+                          .arg(StartupProfiler::elapsedMs()));
+
+  // XSL_STARTUP_REPORT=1 打印阶段耗时；=exit 打印后退出（用于脚本计时）
+  QString mode = qEnvironmentVariable("XSL_STARTUP_REPORT");
+  if (!mode.isEmpty()) {
+    qInfo().noquote() << "[Startup]\n" + report;
+    if (mode == "exit") {
+      close();
+    }
+  }
 }
 
 void MainWindow::setupUI() {
   setWindowTitle("XSocialLedger - X.com 社交互动记录");
   resize(1400, 900);
 
-  // 深色窗口样式
-  setStyleSheet("QMainWindow { background: #0a0a1a; }"
-                "QToolBar { background: #12122a; border-bottom: 1px solid "
-                "#2a2a4a; spacing: 6px; padding: 4px; }"
-                "QStatusBar { background: #12122a; color: #8888aa; border-top: "
-                "1px solid #2a2a4a; }");
+  // 深色样式见 Theme（应用级样式表）
 
   // 主布局 - 水平分割
   m_splitter = new QSplitter(Qt::Horizontal, this);
-  m_splitter->setStyleSheet(
-      "QSplitter::handle { background: #2a2a4a; width: 2px; }");
 
   // 左侧 - 浏览器
   m_browser = new WebView2Widget(m_splitter);
   m_browser->setMinimumWidth(400);
 
   // 中间 - 记录面板 + 日志（垂直分割）
-  QSplitter *middleSplitter = new QSplitter(Qt::Vertical, m_splitter);
-  m_actionPanel = new ActionListPanel(m_storage, middleSplitter);
-  m_actionPanel->setMinimumWidth(300);
-
-  m_logBox = new QTextEdit(middleSplitter);
-  m_logBox->setReadOnly(true);
-  m_logBox->setMaximumHeight(200);
-  m_logBox->setStyleSheet(
-      "QTextEdit { background: #0a0a1a; color: #88cc88; border: 1px solid "
-      "#2a2a4a; font-family: 'Consolas', 'Courier New', monospace; "
-      "font-size: 11px; padding: 4px; }");
-  m_logBox->setPlaceholderText(QString::fromUtf8("动作日志将显示在这里..."));
-
-  middleSplitter->addWidget(m_actionPanel);
-  middleSplitter->addWidget(m_logBox);
-  middleSplitter->setStretchFactor(0, 3); // 记录面板 75%
-  middleSplitter->setStretchFactor(1, 1); // 日志 25%
+  // 记录面板在账本加载后替换占位
+  m_middleSplitter = new QSplitter(Qt::Vertical, m_splitter);
+  m_ledgerPlaceholder = new QLabel(
+      QString::fromUtf8("正在加载账本..."), m_middleSplitter);
+  m_ledgerPlaceholder->setAlignment(Qt::AlignCenter);
+  m_ledgerPlaceholder->setMinimumWidth(300);
+  m_ledgerPlaceholder->setObjectName("ledgerPlaceholder");
+
+  // 日志：环形缓冲 + 异步滚动文件，界面只显示缓冲内的记录
+  m_logBuffer = new LogBuffer(20000, this);
+  m_logBuffer->setFileSink(QCoreApplication::applicationDirPath() + "/logs");
+  m_logConsole = new LogConsole(m_logBuffer, m_middleSplitter);
+  m_logConsole->setMaximumHeight(200);
+
+  m_middleSplitter->addWidget(m_ledgerPlaceholder);
+  m_middleSplitter->addWidget(m_logConsole);
+  m_middleSplitter->setStretchFactor(0, 3); // 记录面板 75%
+  m_middleSplitter->setStretchFactor(1, 1); // 日志 25%
 
   // 右侧 - 回馈浏览器
   m_recipBrowser = new WebView2Widget(m_splitter);
@@ -99,7 +330,7 @@ void MainWindow::setupUI() {
   m_listBrowser->setMinimumWidth(350);
 
   m_splitter->addWidget(m_browser);
-  m_splitter->addWidget(middleSplitter);
+  m_splitter->addWidget(m_middleSplitter);
   m_splitter->addWidget(m_recipBrowser);
   m_splitter->addWidget(m_listBrowser);
   m_splitter->setStretchFactor(0, 3); // 采集浏览器 30%
@@ -109,29 +340,17 @@ void MainWindow::setupUI() {
 
   setCentralWidget(m_splitter);
 
-  // 创建采集器
-  m_collector = new NotificationCollector(m_browser, m_storage, this);
-
-  // 创建回馈引擎
-  m_recipBrowser->CreateBrowser("https://x.com");
-  m_reciprocator = new ReciprocatorEngine(m_recipBrowser, m_storage, this);
-
-  // 创建LIST监控浏览器和引擎（共享用户数据，无需重新登录）
-  m_listBrowser->CreateBrowser("https://x.com");
-  m_listMonitor = new ListMonitorEngine(m_listBrowser, m_storage, this);
+  // 副浏览器被拖出可见时再创建
+  connect(m_splitter, &QSplitter::splitterMoved, this,
+          [this](int, int) { createVisibleBrowsers(); });
 
   // 状态栏
   m_statusLabel =
       new QLabel(QString::fromUtf8("\xe5\xb0\xb1\xe7\xbb\xaa"), this);
-  m_statusLabel->setStyleSheet(
-      "QLabel { color: #e0e0e0; font-size: 13px; padding: 2px 8px; }");
+  m_statusLabel->setObjectName("statusLabel");
   m_countdownLabel = new QLabel("", this);
-  m_countdownLabel->setStyleSheet(
-      "QLabel { color: #ffcc00; font-size: 13px; padding: 2px 8px; }");
-  m_refreshCountdown = 0;
-  m_sessionCountdown = 0;
-  statusBar()->setStyleSheet("QStatusBar { background: #0f0f23; color: "
-                             "#e0e0e0; border-top: 1px solid #2a2a4a; }");
+  m_countdownLabel->setObjectName("countdownLabel");
+  m_countdownTick = 0;
   statusBar()->addPermanentWidget(m_countdownLabel);
   statusBar()->addPermanentWidget(m_statusLabel);
 }
@@ -141,114 +360,106 @@ void MainWindow::setupToolBar() {
   toolbar->setMovable(false);
   toolbar->setIconSize(QSize(24, 24));
 
-  QString btnStyle = "QPushButton { background: #1e3a5f; color: #e0e0e0; "
-                     "border: 1px solid #3a5a8a; "
-                     "  border-radius: 6px; padding: 6px 16px; font-size: "
-                     "13px; min-width: 80px; }"
-                     "QPushButton:hover { background: #2a4a7a; }"
-                     "QPushButton:pressed { background: #163050; }"
-                     "QPushButton:disabled { background: #1a1a2e; color: "
-                     "#555566; border-color: #2a2a3a; }";
-
-  QString gearStyle =
-      "QPushButton { background: #2a2a4a; color: #e0e0e0; "
-      "border: 1px solid #3a5a8a; border-radius: 6px; padding: 4px 10px; "
-      "font-size: 14px; min-width: 30px; }"
-      "QPushButton:hover { background: #3a3a6a; }";
-
-  QString spinStyle =
-      "QSpinBox { background: #1a1a2e; color: #e0e0e0; border: 1px solid "
-      "#3a5a8a; border-radius: 4px; padding: 4px 8px; min-width: 60px; "
-      "font-size: 12px; }";
-
   m_startBtn = new QPushButton("▶ 开始采集", this);
-  m_startBtn->setStyleSheet("QPushButton { background: #1b5e20; color: "
-                            "#e0e0e0; border: 1px solid #2e7d32; "
-                            "  border-radius: 6px; padding: 6px 16px; "
-                            "font-size: 13px; min-width: 80px; }"
-                            "QPushButton:hover { background: #2e7d32; }"
-                            "QPushButton:pressed { background: #1b5e20; }"
-                            "QPushButton:disabled { background: #1a1a2e; "
-                            "color: #555566; border-color: #2a2a3a; }");
+  Theme::setRole(m_startBtn, "go");
+  m_startBtn->setEnabled(false); // 账本加载完成后启用
   toolbar->addWidget(m_startBtn);
 
   m_stopBtn = new QPushButton("⏹ 停止", this);
   m_stopBtn->setEnabled(false);
-  m_stopBtn->setStyleSheet("QPushButton { background: #b71c1c; color: #e0e0e0; "
-                           "border: 1px solid #d32f2f; "
-                           "  border-radius: 6px; padding: 6px 16px; "
-                           "font-size: 13px; min-width: 80px; }"
-                           "QPushButton:hover { background: #d32f2f; }"
-                           "QPushButton:pressed { background: #b71c1c; }"
-                           "QPushButton:disabled { background: #1a1a2e; color: "
-                           "#555566; border-color: #2a2a3a; }");
+  Theme::setRole(m_stopBtn, "danger");
   toolbar->addWidget(m_stopBtn);
 
   toolbar->addSeparator();
 
   m_refreshBtn = new QPushButton("🔄 刷新页面", this);
-  m_refreshBtn->setStyleSheet(btnStyle);
+  Theme::setRole(m_refreshBtn, "primary");
   toolbar->addWidget(m_refreshBtn);
 
   m_exportBtn = new QPushButton(
       QString::fromUtf8("\xf0\x9f\x93\xa4 \xe5\xaf\xbc\xe5\x87\xba"), this);
-  m_exportBtn->setStyleSheet(btnStyle);
+  Theme::setRole(m_exportBtn, "primary");
+  m_exportBtn->setEnabled(false);
   toolbar->addWidget(m_exportBtn);
 
+  m_syncBtn = new QPushButton(QString::fromUtf8("🔁 同步"), this);
+  m_syncBtn->setToolTip(
+      QString::fromUtf8("与另一目录（本地或共享盘）中的账本双向同步"));
+  Theme::setRole(m_syncBtn, "primary");
+  m_syncBtn->setEnabled(false);
+  toolbar->addWidget(m_syncBtn);
+
   toolbar->addSeparator();
 
   // ⚙ 采集设置 齿轮按钮
   QPushButton *collectGearBtn =
       new QPushButton(QString::fromUtf8("⚙ 采集"), this);
-  collectGearBtn->setStyleSheet(gearStyle);
+  Theme::setRole(collectGearBtn, "gear");
   toolbar->addWidget(collectGearBtn);
-  connect(collectGearBtn, &QPushButton::clicked, this, [this, spinStyle]() {
+  connect(collectGearBtn, &QPushButton::clicked, this, [this]() {
     QDialog dlg(this);
     dlg.setWindowTitle("采集设置");
-    dlg.setStyleSheet(
-        "QDialog { background: #12122a; }"
-        "QLabel { color: #e0e0e0; font-size: 12px; }"
-        "QGroupBox { color: #ffcc00; border: 1px solid #3a5a8a; "
-        "border-radius: 6px; margin-top: 8px; padding-top: 16px; }"
-        "QGroupBox::title { subcontrol-origin: margin; left: 10px; }");
     QVBoxLayout *layout = new QVBoxLayout(&dlg);
 
     QGroupBox *grp = new QGroupBox("采集参数", &dlg);
     QFormLayout *form = new QFormLayout(grp);
     QSpinBox *pages = new QSpinBox(&dlg);
     pages->setRange(1, 50);
-    pages->setValue(m_pagesSpin->value());
-    pages->setStyleSheet(spinStyle);
+    const CollectorSettings &current = m_config->collector();
+    pages->setValue(current.maxPages);
     form->addRow("采集页数:", pages);
 
     QHBoxLayout *refreshRow = new QHBoxLayout();
     QSpinBox *rMin = new QSpinBox(&dlg);
     rMin->setRange(10, 600);
-    rMin->setValue(m_refreshMinSpin->value());
+    rMin->setValue(current.refreshMin);
     rMin->setSuffix("s");
-    rMin->setStyleSheet(spinStyle);
     QSpinBox *rMax = new QSpinBox(&dlg);
     rMax->setRange(10, 600);
-    rMax->setValue(m_refreshMaxSpin->value());
+    rMax->setValue(current.refreshMax);
     rMax->setSuffix("s");
-    rMax->setStyleSheet(spinStyle);
     refreshRow->addWidget(rMin);
     refreshRow->addWidget(new QLabel("-"));
     refreshRow->addWidget(rMax);
     form->addRow("刷新间隔:", refreshRow);
 
+    QHBoxLayout *typeRow = new QHBoxLayout();
+    QCheckBox *likesCheck = new QCheckBox("点赞", &dlg);
+    likesCheck->setChecked(current.collectLikes);
+    QCheckBox *repliesCheck = new QCheckBox("回复", &dlg);
+    repliesCheck->setChecked(current.collectReplies);
+    for (QCheckBox *check : {likesCheck, repliesCheck})
+      typeRow->addWidget(check);
+    typeRow->addStretch();
+    form->addRow("采集类型:", typeRow);
+
     layout->addWidget(grp);
+
+    // 忽略名单：这些用户的互动在采集入口丢弃
+    QGroupBox *ignoreGrp = new QGroupBox("忽略用户", &dlg);
+    QVBoxLayout *ignoreLayout = new QVBoxLayout(ignoreGrp);
+    QTextEdit *ignoreEdit = new QTextEdit(&dlg);
+    ignoreEdit->setMaximumHeight(80);
+    ignoreEdit->setPlainText(current.ignoredHandles);
+    ignoreEdit->setPlaceholderText(
+        QString::fromUtf8("每行一个用户名，如: @someone"));
+    ignoreLayout->addWidget(ignoreEdit);
+    layout->addWidget(ignoreGrp);
+
     QPushButton *okBtn = new QPushButton("确定", &dlg);
-    okBtn->setStyleSheet(
-        "QPushButton { background: #1b5e20; color: #e0e0e0; border-radius: "
-        "6px; padding: 6px 20px; }QPushButton:hover { background: #2e7d32; }");
+    Theme::setRole(okBtn, "ok");
     layout->addWidget(okBtn);
     connect(okBtn, &QPushButton::clicked, &dlg, &QDialog::accept);
 
     if (dlg.exec() == QDialog::Accepted) {
-      m_pagesSpin->setValue(pages->value());
-      m_refreshMinSpin->setValue(rMin->value());
-      m_refreshMaxSpin->setValue(rMax->value());
+      CollectorSettings c = m_config->collector();
+      c.maxPages = pages->value();
+      c.refreshMin = rMin->value();
+      c.refreshMax = rMax->value();
+      c.collectLikes = likesCheck->isChecked();
+      c.collectReplies = repliesCheck->isChecked();
+      c.ignoredHandles = ignoreEdit->toPlainText();
+      m_config->setCollector(c);
     }
   });
 
@@ -259,82 +470,67 @@ void MainWindow::setupToolBar() {
       QString::fromUtf8(
           "\xf0\x9f\x9a\x80 \xe8\x87\xaa\xe5\x8a\xa8\xe5\x9b\x9e\xe9\xa6\x88"),
       this);
-  m_batchBtn->setStyleSheet(
-      "QPushButton { background: #e65100; color: #e0e0e0; border: 1px solid "
-      "#ff6d00; border-radius: 6px; padding: 6px 16px; font-size: 13px; "
-      "min-width: 80px; }"
-      "QPushButton:hover { background: #ff6d00; }"
-      "QPushButton:pressed { background: #e65100; }"
-      "QPushButton:disabled { background: #1a1a2e; color: #555566; "
-      "border-color: #2a2a3a; }");
+  Theme::setRole(m_batchBtn, "accent");
+  m_batchBtn->setEnabled(false);
   toolbar->addWidget(m_batchBtn);
 
   // ⚙ 回馈设置 齿轮按钮
   QPushButton *recipGearBtn =
       new QPushButton(QString::fromUtf8("⚙ 回馈"), this);
-  recipGearBtn->setStyleSheet(gearStyle);
+  Theme::setRole(recipGearBtn, "gear");
   toolbar->addWidget(recipGearBtn);
-  connect(recipGearBtn, &QPushButton::clicked, this, [this, spinStyle]() {
+  connect(recipGearBtn, &QPushButton::clicked, this, [this]() {
     QDialog dlg(this);
     dlg.setWindowTitle("回馈设置");
-    dlg.setStyleSheet(
-        "QDialog { background: #12122a; }"
-        "QLabel { color: #e0e0e0; font-size: 12px; }"
-        "QGroupBox { color: #ffcc00; border: 1px solid #3a5a8a; "
-        "border-radius: 6px; margin-top: 8px; padding-top: 16px; }"
-        "QGroupBox::title { subcontrol-origin: margin; left: 10px; }");
     QVBoxLayout *layout = new QVBoxLayout(&dlg);
 
     QGroupBox *grp = new QGroupBox("回馈参数", &dlg);
     QFormLayout *form = new QFormLayout(grp);
 
-    auto addRange = [&](const QString &label, QSpinBox *srcMin,
-                        QSpinBox *srcMax, int lo, int hi, const QString &suf,
-                        QSpinBox *&outMin, QSpinBox *&outMax) {
+    auto addRange = [&](const QString &label, int curMin, int curMax, int lo,
+                        int hi, const QString &suf, QSpinBox *&outMin,
+                        QSpinBox *&outMax) {
       QHBoxLayout *row = new QHBoxLayout();
       outMin = new QSpinBox(&dlg);
       outMin->setRange(lo, hi);
-      outMin->setValue(srcMin->value());
+      outMin->setValue(curMin);
       outMin->setSuffix(suf);
-      outMin->setStyleSheet(spinStyle);
       outMax = new QSpinBox(&dlg);
       outMax->setRange(lo, hi);
-      outMax->setValue(srcMax->value());
+      outMax->setValue(curMax);
       outMax->setSuffix(suf);
-      outMax->setStyleSheet(spinStyle);
       row->addWidget(outMin);
       row->addWidget(new QLabel("-"));
       row->addWidget(outMax);
       form->addRow(label, row);
     };
 
+    const ReciprocatorSettings &cur = m_config->reciprocator();
     QSpinBox *sMin, *sMax, *lMin, *lMax, *bMin, *bMax, *rMin, *rMax;
-    addRange("滚动间隔:", m_scrollMinSpin, m_scrollMaxSpin, 1, 60, "s", sMin,
-             sMax);
-    addRange("点赞等待:", m_likeWaitMinSpin, m_likeWaitMaxSpin, 1, 120, "s",
-             lMin, lMax);
-    addRange("浏览时长:", m_browseMinSpin, m_browseMaxSpin, 1, 120, "m", bMin,
+    addRange("滚动间隔:", cur.scrollMin, cur.scrollMax, 1, 60, "s", sMin, sMax);
+    addRange("点赞等待:", cur.likeWaitMin, cur.likeWaitMax, 1, 120, "s", lMin,
+             lMax);
+    addRange("浏览时长:", cur.browseMin, cur.browseMax, 1, 120, "m", bMin,
              bMax);
-    addRange("休息时长:", m_restMinSpin, m_restMaxSpin, 1, 120, "m", rMin,
-             rMax);
+    addRange("休息时长:", cur.restMin, cur.restMax, 1, 120, "m", rMin, rMax);
 
     layout->addWidget(grp);
     QPushButton *okBtn = new QPushButton("确定", &dlg);
-    okBtn->setStyleSheet(
-        "QPushButton { background: #1b5e20; color: #e0e0e0; border-radius: "
-        "6px; padding: 6px 20px; }QPushButton:hover { background: #2e7d32; }");
+    Theme::setRole(okBtn, "ok");
     layout->addWidget(okBtn);
     connect(okBtn, &QPushButton::clicked, &dlg, &QDialog::accept);
 
     if (dlg.exec() == QDialog::Accepted) {
-      m_scrollMinSpin->setValue(sMin->value());
-      m_scrollMaxSpin->setValue(sMax->value());
-      m_likeWaitMinSpin->setValue(lMin->value());
-      m_likeWaitMaxSpin->setValue(lMax->value());
-      m_browseMinSpin->setValue(bMin->value());
-      m_browseMaxSpin->setValue(bMax->value());
-      m_restMinSpin->setValue(rMin->value());
-      m_restMaxSpin->setValue(rMax->value());
+      ReciprocatorSettings r = m_config->reciprocator();
+      r.scrollMin = sMin->value();
+      r.scrollMax = sMax->value();
+      r.likeWaitMin = lMin->value();
+      r.likeWaitMax = lMax->value();
+      r.browseMin = bMin->value();
+      r.browseMax = bMax->value();
+      r.restMin = rMin->value();
+      r.restMax = rMax->value();
+      m_config->setReciprocator(r);
     }
   });
 
@@ -343,26 +539,17 @@ void MainWindow::setupToolBar() {
   // === LIST监控按钮 ===
   m_listMonitorBtn =
       new QPushButton(QString::fromUtf8("🔍 启动LIST监控"), this);
-  m_listMonitorBtn->setStyleSheet(
-      "QPushButton { background: #1565c0; color: #e0e0e0; border: 1px solid "
-      "#1976d2; border-radius: 6px; padding: 6px 12px; font-size: 12px; }"
-      "QPushButton:hover { background: #1976d2; }"
-      "QPushButton:pressed { background: #1565c0; }");
+  Theme::setRole(m_listMonitorBtn, "info");
+  m_listMonitorBtn->setEnabled(false);
   toolbar->addWidget(m_listMonitorBtn);
 
   // ⚙ LIST设置 齿轮按钮
   QPushButton *listGearBtn = new QPushButton(QString::fromUtf8("⚙ LIST"), this);
-  listGearBtn->setStyleSheet(gearStyle);
+  Theme::setRole(listGearBtn, "gear");
   toolbar->addWidget(listGearBtn);
-  connect(listGearBtn, &QPushButton::clicked, this, [this, spinStyle]() {
+  connect(listGearBtn, &QPushButton::clicked, this, [this]() {
     QDialog dlg(this);
     dlg.setWindowTitle("LIST监控设置");
-    dlg.setStyleSheet(
-        "QDialog { background: #12122a; }"
-        "QLabel { color: #e0e0e0; font-size: 12px; }"
-        "QGroupBox { color: #ffcc00; border: 1px solid #3a5a8a; "
-        "border-radius: 6px; margin-top: 8px; padding-top: 16px; }"
-        "QGroupBox::title { subcontrol-origin: margin; left: 10px; }");
     QVBoxLayout *layout = new QVBoxLayout(&dlg);
 
     // List URLs
@@ -370,12 +557,10 @@ void MainWindow::setupToolBar() {
     QVBoxLayout *urlLayout = new QVBoxLayout(urlGrp);
     QTextEdit *urlEdit = new QTextEdit(&dlg);
     urlEdit->setMaximumHeight(80);
-    urlEdit->setPlainText(m_listUrlsEdit->toPlainText());
+    const ListMonitorSettings &cur = m_config->listMonitor();
+    urlEdit->setPlainText(cur.urls);
     urlEdit->setPlaceholderText(QString::fromUtf8(
         "每行一个List URL，如: https://x.com/i/lists/123456"));
-    urlEdit->setStyleSheet(
-        "QTextEdit { background: #1a1a2e; color: #e0e0e0; border: 1px solid "
-        "#3a5a8a; border-radius: 4px; font-size: 11px; padding: 4px; }");
     urlLayout->addWidget(urlEdit);
     layout->addWidget(urlGrp);
 
@@ -383,20 +568,18 @@ void MainWindow::setupToolBar() {
     QGroupBox *grp = new QGroupBox("风控参数", &dlg);
     QFormLayout *form = new QFormLayout(grp);
 
-    auto addRange = [&](const QString &label, QSpinBox *srcMin,
-                        QSpinBox *srcMax, int lo, int hi, const QString &suf,
-                        QSpinBox *&outMin, QSpinBox *&outMax) {
+    auto addRange = [&](const QString &label, int curMin, int curMax, int lo,
+                        int hi, const QString &suf, QSpinBox *&outMin,
+                        QSpinBox *&outMax) {
       QHBoxLayout *row = new QHBoxLayout();
       outMin = new QSpinBox(&dlg);
       outMin->setRange(lo, hi);
-      outMin->setValue(srcMin->value());
+      outMin->setValue(curMin);
       outMin->setSuffix(suf);
-      outMin->setStyleSheet(spinStyle);
       outMax = new QSpinBox(&dlg);
       outMax->setRange(lo, hi);
-      outMax->setValue(srcMax->value());
+      outMax->setValue(curMax);
       outMax->setSuffix(suf);
-      outMax->setStyleSheet(spinStyle);
       row->addWidget(outMin);
       row->addWidget(new QLabel("-"));
       row->addWidget(outMax);
@@ -404,48 +587,46 @@ void MainWindow::setupToolBar() {
     };
 
     QSpinBox *llMin, *llMax, *lsMin, *lsMax, *lstMin, *lstMax;
-    addRange("点赞间隔:", m_listLikeMinSpin, m_listLikeMaxSpin, 5, 300, "s",
-             llMin, llMax);
-    addRange("滚动间隔:", m_listScrollMinSpin, m_listScrollMaxSpin, 1, 60, "s",
-             lsMin, lsMax);
-    addRange("List停留:", m_listStayMinSpin, m_listStayMaxSpin, 1, 60, "m",
-             lstMin, lstMax);
+    addRange("点赞间隔:", cur.likeMin, cur.likeMax, 5, 300, "s", llMin, llMax);
+    addRange("滚动间隔:", cur.scrollMin, cur.scrollMax, 1, 60, "s", lsMin,
+             lsMax);
+    addRange("List停留:", cur.stayMin, cur.stayMax, 1, 60, "m", lstMin,
+             lstMax);
 
     QSpinBox *maxLikes = new QSpinBox(&dlg);
     maxLikes->setRange(1, 500);
-    maxLikes->setValue(m_listMaxLikesSpin->value());
-    maxLikes->setStyleSheet(spinStyle);
+    maxLikes->setValue(cur.maxLikes);
     form->addRow("单次点赞上限:", maxLikes);
 
     QSpinBox *lrMin, *lrMax;
-    addRange("达标后休息:", m_listRestMinSpin, m_listRestMaxSpin, 1, 120, "m",
-             lrMin, lrMax);
+    addRange("达标后休息:", cur.restMin, cur.restMax, 1, 120, "m", lrMin,
+             lrMax);
 
     QSpinBox *lcMin, *lcMax;
-    addRange("同用户冷却:", m_listCooldownMinSpin, m_listCooldownMaxSpin, 60,
-             3600, "s", lcMin, lcMax);
+    addRange("同用户冷却:", cur.cooldownMin, cur.cooldownMax, 60, 3600, "s",
+             lcMin, lcMax);
 
     layout->addWidget(grp);
     QPushButton *okBtn = new QPushButton("确定", &dlg);
-    okBtn->setStyleSheet(
-        "QPushButton { background: #1b5e20; color: #e0e0e0; border-radius: "
-        "6px; padding: 6px 20px; }QPushButton:hover { background: #2e7d32; }");
+    Theme::setRole(okBtn, "ok");
     layout->addWidget(okBtn);
     connect(okBtn, &QPushButton::clicked, &dlg, &QDialog::accept);
 
     if (dlg.exec() == QDialog::Accepted) {
-      m_listUrlsEdit->setPlainText(urlEdit->toPlainText());
-      m_listLikeMinSpin->setValue(llMin->value());
-      m_listLikeMaxSpin->setValue(llMax->value());
-      m_listScrollMinSpin->setValue(lsMin->value());
-      m_listScrollMaxSpin->setValue(lsMax->value());
-      m_listStayMinSpin->setValue(lstMin->value());
-      m_listStayMaxSpin->setValue(lstMax->value());
-      m_listMaxLikesSpin->setValue(maxLikes->value());
-      m_listRestMinSpin->setValue(lrMin->value());
-      m_listRestMaxSpin->setValue(lrMax->value());
-      m_listCooldownMinSpin->setValue(lcMin->value());
-      m_listCooldownMaxSpin->setValue(lcMax->value());
+      ListMonitorSettings l = m_config->listMonitor();
+      l.urls = urlEdit->toPlainText();
+      l.likeMin = llMin->value();
+      l.likeMax = llMax->value();
+      l.scrollMin = lsMin->value();
+      l.scrollMax = lsMax->value();
+      l.stayMin = lstMin->value();
+      l.stayMax = lstMax->value();
+      l.maxLikes = maxLikes->value();
+      l.restMin = lrMin->value();
+      l.restMax = lrMax->value();
+      l.cooldownMin = lcMin->value();
+      l.cooldownMax = lcMax->value();
+      m_config->setListMonitor(l);
     }
   });
 
@@ -454,105 +635,48 @@ void MainWindow::setupToolBar() {
   spacer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
   toolbar->addWidget(spacer);
 
-  // === 隐藏的存储SpinBox（不在界面上显示，仅用于存储值和触发信号） ===
-  // 采集
-  m_pagesSpin = new QSpinBox(this);
-  m_pagesSpin->setRange(1, 50);
-  m_pagesSpin->setValue(5);
-  m_pagesSpin->hide();
-  m_refreshMinSpin = new QSpinBox(this);
-  m_refreshMinSpin->setRange(10, 600);
-  m_refreshMinSpin->setValue(60);
-  m_refreshMinSpin->hide();
-  m_refreshMaxSpin = new QSpinBox(this);
-  m_refreshMaxSpin->setRange(10, 600);
-  m_refreshMaxSpin->setValue(120);
-  m_refreshMaxSpin->hide();
-  // 回馈
-  m_scrollMinSpin = new QSpinBox(this);
-  m_scrollMinSpin->setRange(1, 30);
-  m_scrollMinSpin->setValue(3);
-  m_scrollMinSpin->hide();
-  m_scrollMaxSpin = new QSpinBox(this);
-  m_scrollMaxSpin->setRange(1, 60);
-  m_scrollMaxSpin->setValue(8);
-  m_scrollMaxSpin->hide();
-  m_likeWaitMinSpin = new QSpinBox(this);
-  m_likeWaitMinSpin->setRange(1, 60);
-  m_likeWaitMinSpin->setValue(3);
-  m_likeWaitMinSpin->hide();
-  m_likeWaitMaxSpin = new QSpinBox(this);
-  m_likeWaitMaxSpin->setRange(1, 120);
-  m_likeWaitMaxSpin->setValue(8);
-  m_likeWaitMaxSpin->hide();
-  m_browseMinSpin = new QSpinBox(this);
-  m_browseMinSpin->setRange(1, 120);
-  m_browseMinSpin->setValue(10);
-  m_browseMinSpin->hide();
-  m_browseMaxSpin = new QSpinBox(this);
-  m_browseMaxSpin->setRange(1, 120);
-  m_browseMaxSpin->setValue(30);
-  m_browseMaxSpin->hide();
-  m_restMinSpin = new QSpinBox(this);
-  m_restMinSpin->setRange(1, 120);
-  m_restMinSpin->setValue(15);
-  m_restMinSpin->hide();
-  m_restMaxSpin = new QSpinBox(this);
-  m_restMaxSpin->setRange(1, 120);
-  m_restMaxSpin->setValue(45);
-  m_restMaxSpin->hide();
-  // LIST
-  m_listLikeMinSpin = new QSpinBox(this);
-  m_listLikeMinSpin->setRange(5, 120);
-  m_listLikeMinSpin->setValue(15);
-  m_listLikeMinSpin->hide();
-  m_listLikeMaxSpin = new QSpinBox(this);
-  m_listLikeMaxSpin->setRange(5, 300);
-  m_listLikeMaxSpin->setValue(45);
-  m_listLikeMaxSpin->hide();
-  m_listScrollMinSpin = new QSpinBox(this);
-  m_listScrollMinSpin->setRange(1, 30);
-  m_listScrollMinSpin->setValue(3);
-  m_listScrollMinSpin->hide();
-  m_listScrollMaxSpin = new QSpinBox(this);
-  m_listScrollMaxSpin->setRange(1, 60);
-  m_listScrollMaxSpin->setValue(8);
-  m_listScrollMaxSpin->hide();
-  m_listStayMinSpin = new QSpinBox(this);
-  m_listStayMinSpin->setRange(1, 60);
-  m_listStayMinSpin->setValue(3);
-  m_listStayMinSpin->hide();
-  m_listStayMaxSpin = new QSpinBox(this);
-  m_listStayMaxSpin->setRange(1, 60);
-  m_listStayMaxSpin->setValue(8);
-  m_listStayMaxSpin->hide();
-  m_listMaxLikesSpin = new QSpinBox(this);
-  m_listMaxLikesSpin->setRange(1, 500);
-  m_listMaxLikesSpin->setValue(50);
-  m_listMaxLikesSpin->hide();
-  m_listRestMinSpin = new QSpinBox(this);
-  m_listRestMinSpin->setRange(1, 120);
-  m_listRestMinSpin->setValue(10);
-  m_listRestMinSpin->hide();
-  m_listRestMaxSpin = new QSpinBox(this);
-  m_listRestMaxSpin->setRange(1, 120);
-  m_listRestMaxSpin->setValue(30);
-  m_listRestMaxSpin->hide();
-  m_listCooldownMinSpin = new QSpinBox(this);
-  m_listCooldownMinSpin->setRange(60, 3600);
-  m_listCooldownMinSpin->setValue(600);
-  m_listCooldownMinSpin->hide();
-  m_listCooldownMaxSpin = new QSpinBox(this);
-  m_listCooldownMaxSpin->setRange(60, 7200);
-  m_listCooldownMaxSpin->setValue(1200);
-  m_listCooldownMaxSpin->hide();
-  m_listUrlsEdit = new QTextEdit(this);
-  m_listUrlsEdit->hide();
-
-  loadSettings();
+  // 🩺 诊断菜单
+  QToolButton *diagBtn = new QToolButton(this);
+  diagBtn->setText(QString::fromUtf8("🩺 诊断"));
+  diagBtn->setPopupMode(QToolButton::InstantPopup);
+  Theme::setRole(diagBtn, "gear");
+  m_diagMenu = new QMenu(diagBtn);
+  QAction *traceAction =
+      m_diagMenu->addAction(QString::fromUtf8("导出性能追踪 (trace.json)..."));
+  connect(traceAction, &QAction::triggered, this, &MainWindow::onExportTrace);
+  QAction *metricsAction =
+      m_diagMenu->addAction(QString::fromUtf8("指标面板..."));
+  connect(metricsAction, &QAction::triggered, this,
+          &MainWindow::onShowDiagnostics);
+  QAction *benchAction =
+      m_diagMenu->addAction(QString::fromUtf8("存储引擎基准..."));
+  connect(benchAction, &QAction::triggered, this, [this]() {
+    if (!m_storage)
+      return;
+    StorageBenchDialog *dlg = new StorageBenchDialog(m_storage, m_config, this);
+    dlg->setAttribute(Qt::WA_DeleteOnClose);
+    dlg->show();
+  });
+  diagBtn->setMenu(m_diagMenu);
+  toolbar->addWidget(diagBtn);
 }
 
 void MainWindow::setupConnections() {
+  // 视图缓存：已知的账本变更推进代数，缓存据此打补丁或失效。
+  // 面板刷新可能同步执行，这些连接必须先于面板的连接建立
+  connect(m_collector, &NotificationCollector::actionAdded, m_viewCache,
+          &LedgerViewCache::noteAdded);
+  connect(m_collector, &NotificationCollector::selfRecordsCleaned, m_viewCache,
+          [this](int) { m_viewCache->invalidate(); });
+  connect(m_reciprocator, &ReciprocatorEngine::likedUser, m_viewCache,
+          [this](const QString &, const QString &actionId) {
+            m_viewCache->noteReciprocated(actionId, true);
+          });
+  connect(m_listMonitor, &ListMonitorEngine::likedPost, m_viewCache,
+          [this](const QString &, const QString &) {
+            m_viewCache->invalidate("like");
+          });
+
   connect(m_startBtn, &QPushButton::clicked, this,
           &MainWindow::onStartCollecting);
   connect(m_stopBtn, &QPushButton::clicked, this,
@@ -560,6 +684,7 @@ void MainWindow::setupConnections() {
   connect(m_refreshBtn, &QPushButton::clicked, this,
           &MainWindow::onRefreshPage);
   connect(m_exportBtn, &QPushButton::clicked, this, &MainWindow::onExportData);
+  connect(m_syncBtn, &QPushButton::clicked, this, &MainWindow::onSyncLedger);
 
   // 采集器信号
   connect(m_collector, &NotificationCollector::statusMessage, this,
@@ -571,14 +696,20 @@ void MainWindow::setupConnections() {
   connect(m_collector, &NotificationCollector::newReplyCollected, m_actionPanel,
           &ActionListPanel::onNewReply);
   connect(m_collector, &NotificationCollector::selfRecordsCleaned,
-          m_actionPanel, [this](int) { m_actionPanel->refreshAll(); });
+          m_actionPanel, [this](int) { m_actionPanel->postRefreshAll(); });
+  connect(m_collector, &NotificationCollector::actionAdded, m_postIndex,
+          &PostIndex::add);
+  connect(m_collector, &NotificationCollector::actionAdded, m_engagerTracker,
+          &EngagerTracker::add);
+  connect(m_collector, &NotificationCollector::selfRecordsCleaned, this,
+          [this](int) { rebuildIndexes(); });
 
   // 回馈引擎信号
   connect(m_reciprocator, &ReciprocatorEngine::statusMessage, this,
           &MainWindow::onStatusMessage);
   connect(m_reciprocator, &ReciprocatorEngine::likedUser, this,
           [this](const QString &, const QString &) {
-            m_actionPanel->refreshAll();
+            m_actionPanel->postRefreshAll();
           });
 
   // 双击回馈
@@ -592,52 +723,34 @@ void MainWindow::setupConnections() {
               m_batchBtn->setText(QString::fromUtf8(
                   "\xf0\x9f\x9a\x80 "
                   "\xe8\x87\xaa\xe5\x8a\xa8\xe5\x9b\x9e\xe9\xa6\x88"));
-              m_batchBtn->setStyleSheet(
-                  "QPushButton { background: #e65100; color: #e0e0e0; border: "
-                  "1px solid #ff6d00; border-radius: 6px; padding: 6px 16px; "
-                  "font-size: 13px; min-width: 80px; }"
-                  "QPushButton:hover { background: #ff6d00; }");
-              m_sessionCountdown = 0;
-              updateCountdownLabel();
+              Theme::setState(m_batchBtn, "running", false);
             }
           });
 
-  // 会话倒计时
-  connect(m_reciprocator, &ReciprocatorEngine::sessionCountdown, this,
-          [this](int sec) {
-            m_sessionCountdown = sec;
-            updateCountdownLabel();
-          });
-
-  // Countdown signals -> combined label (refresh)
-  connect(m_collector, &NotificationCollector::refreshCountdown, this,
-          [this](int sec) {
-            m_refreshCountdown = sec;
-            updateCountdownLabel();
-          });
+  // 倒计时由引擎的截止时间推算，截止时间变化时刷新
+  connect(m_reciprocator, &ReciprocatorEngine::countdownChanged, this,
+          &MainWindow::updateCountdownLabel);
+  connect(m_collector, &NotificationCollector::countdownChanged, this,
+          &MainWindow::updateCountdownLabel);
 
   // Batch button - toggle start/stop
   connect(m_batchBtn, &QPushButton::clicked, this, [this]() {
     // If browsing is running, stop it
     if (m_reciprocator->isBusy()) {
       m_reciprocator->stopBrowsing();
-      m_sessionCountdown = 0;
-      updateCountdownLabel();
       onStatusMessage(QString::fromUtf8("⏹ 已停止自动回馈"));
       return;
     }
 
     // Collect pending reciprocations (仅最近24小时)
-    auto likes = m_storage->loadLikes();
+    auto likes = m_viewCache->view("like", LedgerViewCache::Filter::Pending);
+    int recent =
+        likes->countSince(QDateTime::currentMSecsSinceEpoch() - 86400 * 1000LL);
     QList<QPair<QString, QString>> pending;
-    QDateTime cutoff = QDateTime::currentDateTimeUtc().addSecs(-86400);
-    for (const auto &a : likes) {
-      if (!a.reciprocated) {
-        QDateTime dt = QDateTime::fromString(a.timestamp, Qt::ISODate);
-        if (dt.isValid() && dt >= cutoff) {
-          pending.append({a.userHandle, a.id});
-        }
-      }
+    pending.reserve(recent);
+    for (int i = 0; i < recent; i++) {
+      const SocialAction &a = likes->at(i);
+      pending.append({a.userHandle, a.id});
     }
     if (pending.isEmpty()) {
       onStatusMessage(QString::fromUtf8(
@@ -646,25 +759,13 @@ void MainWindow::setupConnections() {
       return;
     }
 
-    // Apply current settings
-    m_reciprocator->setScrollInterval(m_scrollMinSpin->value(),
-                                      m_scrollMaxSpin->value());
-    m_reciprocator->setLikeWaitInterval(m_likeWaitMinSpin->value(),
-                                        m_likeWaitMaxSpin->value());
-    m_reciprocator->setBrowseRestCycle(
-        m_browseMinSpin->value(), m_browseMaxSpin->value(),
-        m_restMinSpin->value(), m_restMaxSpin->value());
-
+    ensureRecipBrowser();
     m_reciprocator->startBrowsing(pending);
 
     // Toggle button to stop mode
     m_batchBtn->setText(QString::fromUtf8(
         "\xe2\x8f\xb9 \xe5\x81\x9c\xe6\xad\xa2\xe5\x9b\x9e\xe9\xa6\x88"));
-    m_batchBtn->setStyleSheet(
-        "QPushButton { background: #b71c1c; color: #e0e0e0; border: 1px solid "
-        "#d32f2f; border-radius: 6px; padding: 6px 16px; font-size: 13px; "
-        "min-width: 80px; }"
-        "QPushButton:hover { background: #d32f2f; }");
+    Theme::setState(m_batchBtn, "running", true);
     onStatusMessage(
         QString::fromUtf8(
             "\xf0\x9f\x9a\x80 "
@@ -673,56 +774,12 @@ void MainWindow::setupConnections() {
             .arg(pending.size()));
   });
 
-  // Spinbox value changes -> save settings and apply immediately
-  connect(m_pagesSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          [this](int val) {
-            m_collector->setMaxPages(val);
-            saveSettings();
-          });
-  auto updateRefreshRange = [this]() {
-    m_collector->setAutoRefreshRange(m_refreshMinSpin->value(),
-                                     m_refreshMaxSpin->value());
-    saveSettings();
-  };
-  connect(m_refreshMinSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateRefreshRange);
-  connect(m_refreshMaxSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateRefreshRange);
-
-  // 回馈配置 SpinBox 变化 -> 实时生效 + 保存
-  auto updateRecipConfig = [this]() {
-    m_reciprocator->setScrollInterval(m_scrollMinSpin->value(),
-                                      m_scrollMaxSpin->value());
-    m_reciprocator->setLikeWaitInterval(m_likeWaitMinSpin->value(),
-                                        m_likeWaitMaxSpin->value());
-    m_reciprocator->setBrowseRestCycle(
-        m_browseMinSpin->value(), m_browseMaxSpin->value(),
-        m_restMinSpin->value(), m_restMaxSpin->value());
-    saveSettings();
-  };
-  connect(m_scrollMinSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateRecipConfig);
-  connect(m_scrollMaxSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateRecipConfig);
-  connect(m_likeWaitMinSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateRecipConfig);
-  connect(m_likeWaitMaxSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateRecipConfig);
-  connect(m_browseMinSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateRecipConfig);
-  connect(m_browseMaxSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateRecipConfig);
-  connect(m_restMinSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateRecipConfig);
-  connect(m_restMaxSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateRecipConfig);
-
   // === LIST监控信号 ===
   connect(m_listMonitor, &ListMonitorEngine::statusMessage, this,
           &MainWindow::onStatusMessage);
   connect(m_listMonitor, &ListMonitorEngine::likedPost, this,
           [this](const QString &, const QString &) {
-            m_actionPanel->refreshAll();
+            m_actionPanel->postRefreshAll();
           });
 
   // LIST监控启停按钮
@@ -730,89 +787,26 @@ void MainWindow::setupConnections() {
     if (m_listMonitor->isRunning()) {
       m_listMonitor->stop();
       m_listMonitorBtn->setText(QString::fromUtf8("🔍 启动LIST监控"));
-      m_listMonitorBtn->setStyleSheet(
-          "QPushButton { background: #1565c0; color: #e0e0e0; border: 1px "
-          "solid #1976d2; border-radius: 6px; padding: 6px 12px; font-size: "
-          "12px; }QPushButton:hover { background: #1976d2; }");
+      Theme::setState(m_listMonitorBtn, "running", false);
       onStatusMessage(QString::fromUtf8("⏹ LIST监控已停止"));
       return;
     }
 
     // 解析URL列表
-    QString text = m_listUrlsEdit->toPlainText().trimmed();
-    QStringList urls;
-    for (const QString &line : text.split('\n')) {
-      QString url = line.trimmed();
-      if (!url.isEmpty() && url.startsWith("http")) {
-        urls.append(url);
-      }
-    }
+    QStringList urls = m_config->listMonitor().urlList();
     if (urls.isEmpty()) {
       onStatusMessage(QString::fromUtf8("⚠️ 请输入至少一个List URL"));
       return;
     }
 
-    // 应用风控设置
-    m_listMonitor->setLikeInterval(m_listLikeMinSpin->value(),
-                                   m_listLikeMaxSpin->value());
-    m_listMonitor->setScrollInterval(m_listScrollMinSpin->value(),
-                                     m_listScrollMaxSpin->value());
-    m_listMonitor->setListStayDuration(m_listStayMinSpin->value(),
-                                       m_listStayMaxSpin->value());
-    m_listMonitor->setMaxLikesPerSession(m_listMaxLikesSpin->value());
-    m_listMonitor->setRestInterval(m_listRestMinSpin->value(),
-                                   m_listRestMaxSpin->value());
-    m_listMonitor->setUserCooldown(m_listCooldownMinSpin->value(),
-                                   m_listCooldownMaxSpin->value());
-
-    saveSettings();
+    ensureListBrowser();
     m_listMonitor->start(urls);
 
     m_listMonitorBtn->setText(QString::fromUtf8("⏹ 停止LIST监控"));
-    m_listMonitorBtn->setStyleSheet(
-        "QPushButton { background: #b71c1c; color: #e0e0e0; border: 1px solid "
-        "#d32f2f; border-radius: 6px; padding: 6px 12px; font-size: 12px; }"
-        "QPushButton:hover { background: #d32f2f; }");
+    Theme::setState(m_listMonitorBtn, "running", true);
   });
-
-  // LIST风控SpinBox变化 -> 实时生效 + 保存
-  auto updateListConfig = [this]() {
-    m_listMonitor->setLikeInterval(m_listLikeMinSpin->value(),
-                                   m_listLikeMaxSpin->value());
-    m_listMonitor->setScrollInterval(m_listScrollMinSpin->value(),
-                                     m_listScrollMaxSpin->value());
-    m_listMonitor->setListStayDuration(m_listStayMinSpin->value(),
-                                       m_listStayMaxSpin->value());
-    m_listMonitor->setMaxLikesPerSession(m_listMaxLikesSpin->value());
-    m_listMonitor->setRestInterval(m_listRestMinSpin->value(),
-                                   m_listRestMaxSpin->value());
-    m_listMonitor->setUserCooldown(m_listCooldownMinSpin->value(),
-                                   m_listCooldownMaxSpin->value());
-    saveSettings();
-  };
-  connect(m_listLikeMinSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateListConfig);
-  connect(m_listLikeMaxSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateListConfig);
-  connect(m_listScrollMinSpin, QOverload<int>::of(&QSpinBox::valueChanged),
-          this, updateListConfig);
-  connect(m_listScrollMaxSpin, QOverload<int>::of(&QSpinBox::valueChanged),
-          this, updateListConfig);
-  connect(m_listStayMinSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateListConfig);
-  connect(m_listStayMaxSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateListConfig);
-  connect(m_listMaxLikesSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateListConfig);
-  connect(m_listRestMinSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateListConfig);
-  connect(m_listRestMaxSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
-          updateListConfig);
-  connect(m_listCooldownMinSpin, QOverload<int>::of(&QSpinBox::valueChanged),
-          this, updateListConfig);
-  connect(m_listCooldownMaxSpin, QOverload<int>::of(&QSpinBox::valueChanged),
-          this, updateListConfig);
 }
+
 void MainWindow::onStartCollecting() { m_collector->startCollecting(); }
 
 void MainWindow::onStopCollecting() { m_collector->stopCollecting(); }
@@ -822,24 +816,46 @@ void MainWindow::onRefreshPage() {
 }
 
 void MainWindow::onExportData() {
+  XSL_TRACE_SCOPE("MainWindow::onExportData");
+  const QString arrowFilter = "Arrow IPC / Feather v2 (*.arrow *.feather)";
+  QString selectedFilter;
   QString filename = QFileDialog::getSaveFileName(
-      this, "导出社交互动数据", "social_actions.json", "JSON Files (*.json)");
+      this, "导出社交互动数据", "social_actions.json",
+      "JSON Files (*.json);;" + arrowFilter, &selectedFilter);
   if (filename.isEmpty())
     return;
 
+  // 列式导出：流式扫描存储，不经过视图缓存
+  QString suffix = QFileInfo(filename).suffix().toLower();
+  if (suffix == "arrow" || suffix == "feather" ||
+      (suffix != "json" && selectedFilter == arrowFilter)) {
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QString error;
+    qint64 rows = ArrowExporter::write(m_storage, filename, &error);
+    QApplication::restoreOverrideCursor();
+    if (rows < 0) {
+      QMessageBox::warning(this, "导出失败", "无法写入文件: " + error);
+      return;
+    }
+    onStatusMessage(QString("已导出 %1 条记录到: %2").arg(rows).arg(filename));
+    return;
+  }
+
   QJsonObject root;
 
   // 导出点赞
   QJsonArray likesArray;
-  for (const auto &action : m_storage->loadLikes()) {
-    likesArray.append(action.toJson());
+  auto likes = m_viewCache->view("like", LedgerViewCache::Filter::All);
+  for (int i = 0; i < likes->size(); i++) {
+    likesArray.append(likes->at(i).toJson());
   }
   root["likes"] = likesArray;
 
   // 导出回复
   QJsonArray repliesArray;
-  for (const auto &action : m_storage->loadReplies()) {
-    repliesArray.append(action.toJson());
+  auto replies = m_viewCache->view("reply", LedgerViewCache::Filter::All);
+  for (int i = 0; i < replies->size(); i++) {
+    repliesArray.append(replies->at(i).toJson());
   }
   root["replies"] = repliesArray;
 
@@ -854,8 +870,9 @@ void MainWindow::onExportData() {
 
   QFile file(filename);
   if (file.open(QIODevice::WriteOnly)) {
-    QJsonDocument doc(root);
-    file.write(doc.toJson(QJsonDocument::Indented));
+    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    MemoryAccounting::Charge charge("export", json.size());
+    file.write(json);
     file.close();
     onStatusMessage("数据已导出到: " + filename);
   } else {
@@ -863,27 +880,111 @@ void MainWindow::onExportData() {
   }
 }
 
+void MainWindow::onSyncLedger() {
+  XSL_TRACE_SCOPE("MainWindow::onSyncLedger");
+  auto *local = qobject_cast<SqliteLedgerStore *>(m_storage);
+  if (!local) {
+    QMessageBox::information(
+        this, "同步账本",
+        "分区同步需要 sqlite 存储后端，请在“诊断 → 存储引擎基准”中切换后重启。");
+    return;
+  }
+  QString dir = QFileDialog::getExistingDirectory(this, "选择对端账本目录");
+  if (dir.isEmpty())
+    return;
+
+  QString peerFile = LedgerSync::ledgerFileIn(dir);
+  if (QFileInfo(peerFile).absoluteFilePath() == local->filePath()) {
+    QMessageBox::warning(this, "同步账本", "对端就是当前账本。");
+    return;
+  }
+  if (!QFileInfo::exists(peerFile) &&
+      QMessageBox::question(this, "同步账本",
+                            "该目录下没有账本，是否新建并写入全部记录？") !=
+          QMessageBox::Yes)
+    return;
+
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+  // 对端通常在挂载的共享目录上：不用 WAL
+  SqliteLedgerStore peer(peerFile, SqliteLedgerStore::Journal::Rollback);
+  LedgerSync::Report report;
+  if (peer.isOpen())
+    report = LedgerSync::sync(local, &peer);
+  QApplication::restoreOverrideCursor();
+  if (!peer.isOpen()) {
+    QMessageBox::warning(this, "同步账本", "无法打开对端账本: " + peerFile);
+    return;
+  }
+
+  // 本地有写入或删除时，缓存和索引整体失效
+  if (report.pulled > 0 || report.removedLocal > 0) {
+    m_viewCache->invalidate();
+    rebuildIndexes();
+    m_actionPanel->postRefreshAll();
+  }
+  if (report.alreadyInSync) {
+    onStatusMessage(QString("账本已一致，按墓碑删除 %1/%2 条（%3 ms）")
+                        .arg(report.removedLocal)
+                        .arg(report.removedPeer)
+                        .arg(report.elapsedMs));
+    return;
+  }
+  onStatusMessage(QString("同步完成：%1 个日分区不同，拉取 %2 条，推送 %3 条，"
+                          "按墓碑删除 %4/%5 条（%6 ms）")
+                      .arg(report.daysDiffering)
+                      .arg(report.pulled)
+                      .arg(report.pushed)
+                      .arg(report.removedLocal)
+                      .arg(report.removedPeer)
+                      .arg(report.elapsedMs));
+}
+
+void MainWindow::onExportTrace() {
+  QString filename = QFileDialog::getSaveFileName(
+      this, "导出性能追踪", "xsl_trace.json", "Chrome Trace (*.json)");
+  if (filename.isEmpty())
+    return;
+
+  if (Trace::exportChromeJson(filename)) {
+    onStatusMessage("性能追踪已导出到: " + filename +
+                    " (chrome://tracing 或 Perfetto 打开)");
+  } else {
+    QMessageBox::warning(this, "导出失败", "无法写入文件: " + filename);
+  }
+}
+
+void MainWindow::onShowDiagnostics() {
+  if (!m_diagDialog) {
+    m_diagDialog = new DiagnosticsDialog(this);
+  }
+  m_diagDialog->show();
+  m_diagDialog->raise();
+  m_diagDialog->activateWindow();
+}
+
 void MainWindow::onStatusMessage(const QString &message) {
   m_statusLabel->setText(message);
 
-  // 追加到日志文本框（带时间戳）
-  QString timestamp = QDateTime::currentDateTime().toString("HH:mm:ss");
-  m_logBox->append(QString("[%1] %2").arg(timestamp, message));
-
-  // 限制日志行数避免内存增长
-  QTextDocument *doc = m_logBox->document();
-  if (doc->blockCount() > 500) {
-    QTextCursor cursor(doc);
-    cursor.movePosition(QTextCursor::Start);
-    cursor.movePosition(QTextCursor::Down, QTextCursor::KeepAnchor, 100);
-    cursor.removeSelectedText();
+  // 按信号来源归类
+  QString source = QString::fromUtf8("主窗口");
+  QObject *origin = sender();
+  if (origin && origin == m_collector) {
+    source = QString::fromUtf8("采集");
+  } else if (origin && origin == m_reciprocator) {
+    source = QString::fromUtf8("回馈");
+  } else if (origin && origin == m_listMonitor) {
+    source = "LIST";
   }
 
-  // 自动滚动到底部
-  m_logBox->verticalScrollBar()->setValue(
-      m_logBox->verticalScrollBar()->maximum());
+  LogLevel level = LogLevel::Info;
+  if (message.contains(QString::fromUtf8("❌")) ||
+      message.contains(QString::fromUtf8("失败"))) {
+    level = LogLevel::Error;
+  } else if (message.contains(QString::fromUtf8("⚠"))) {
+    level = LogLevel::Warning;
+  }
 
-  qDebug() << "[Status]" << message;
+  m_logBuffer->append(source, level, message);
 }
 
 void MainWindow::onCollectingStateChanged(bool collecting) {
@@ -898,8 +999,9 @@ void MainWindow::onCollectingStateChanged(bool collecting) {
 }
 
 void MainWindow::closeEvent(QCloseEvent *event) {
-  // 保存窗口布局
+  // 保存窗口布局和未落盘的配置
   saveLayout();
+  m_config->flush();
 
   if (m_collector && m_collector->isCollecting()) {
     m_collector->stopCollecting();
@@ -910,7 +1012,7 @@ void MainWindow::closeEvent(QCloseEvent *event) {
   }
 
   if (m_storage) {
-    m_storage->flush();
+    flushStorage();
   }
 
   if (m_listMonitor && m_listMonitor->isRunning()) {
@@ -932,13 +1034,7 @@ void MainWindow::onReciprocateLike(const QString &userHandle,
   // 单个回馈：启动浏览模式只针对这一个用户
   QList<QPair<QString, QString>> single;
   single.append({userHandle, actionId});
-  m_reciprocator->setScrollInterval(m_scrollMinSpin->value(),
-                                    m_scrollMaxSpin->value());
-  m_reciprocator->setLikeWaitInterval(m_likeWaitMinSpin->value(),
-                                      m_likeWaitMaxSpin->value());
-  m_reciprocator->setBrowseRestCycle(
-      m_browseMinSpin->value(), m_browseMaxSpin->value(),
-      m_restMinSpin->value(), m_restMaxSpin->value());
+  ensureRecipBrowser();
   m_reciprocator->startBrowsing(single);
 }
 
@@ -964,112 +1060,57 @@ void MainWindow::restoreLayout() {
   qDebug() << "[MainWindow] Layout restored";
 }
 
-void MainWindow::loadSettings() {
-  QSettings settings("XSocialLedger", "XSocialLedger");
-  int pages = settings.value("maxPages", 5).toInt();
-  int refreshMin = settings.value("refreshMin", 60).toInt();
-  int refreshMax = settings.value("refreshMax", 120).toInt();
-
-  // 回馈配置
-  int scrollMin = settings.value("scrollMin", 3).toInt();
-  int scrollMax = settings.value("scrollMax", 8).toInt();
-  int likeWaitMin = settings.value("likeWaitMin", 3).toInt();
-  int likeWaitMax = settings.value("likeWaitMax", 8).toInt();
-  int browseMin = settings.value("browseMin", 10).toInt();
-  int browseMax = settings.value("browseMax", 30).toInt();
-  int restMin = settings.value("restMin", 15).toInt();
-  int restMax = settings.value("restMax", 45).toInt();
-
-  m_pagesSpin->setValue(pages);
-  m_refreshMinSpin->setValue(refreshMin);
-  m_refreshMaxSpin->setValue(refreshMax);
-
-  m_scrollMinSpin->setValue(scrollMin);
-  m_scrollMaxSpin->setValue(scrollMax);
-  m_likeWaitMinSpin->setValue(likeWaitMin);
-  m_likeWaitMaxSpin->setValue(likeWaitMax);
-  m_browseMinSpin->setValue(browseMin);
-  m_browseMaxSpin->setValue(browseMax);
-  m_restMinSpin->setValue(restMin);
-  m_restMaxSpin->setValue(restMax);
-
-  m_collector->setMaxPages(pages);
-  m_collector->setAutoRefreshRange(refreshMin, refreshMax);
-  m_reciprocator->setScrollInterval(scrollMin, scrollMax);
-  m_reciprocator->setLikeWaitInterval(likeWaitMin, likeWaitMax);
-  m_reciprocator->setBrowseRestCycle(browseMin, browseMax, restMin, restMax);
-
-  // LIST监控配置
-  m_listLikeMinSpin->setValue(settings.value("listLikeMin", 15).toInt());
-  m_listLikeMaxSpin->setValue(settings.value("listLikeMax", 45).toInt());
-  m_listScrollMinSpin->setValue(settings.value("listScrollMin", 3).toInt());
-  m_listScrollMaxSpin->setValue(settings.value("listScrollMax", 8).toInt());
-  m_listStayMinSpin->setValue(settings.value("listStayMin", 3).toInt());
-  m_listStayMaxSpin->setValue(settings.value("listStayMax", 8).toInt());
-  m_listMaxLikesSpin->setValue(settings.value("listMaxLikes", 50).toInt());
-  m_listUrlsEdit->setPlainText(settings.value("listUrls", "").toString());
-
-  m_listMonitor->setLikeInterval(m_listLikeMinSpin->value(),
-                                 m_listLikeMaxSpin->value());
-  m_listMonitor->setScrollInterval(m_listScrollMinSpin->value(),
-                                   m_listScrollMaxSpin->value());
-  m_listMonitor->setListStayDuration(m_listStayMinSpin->value(),
-                                     m_listStayMaxSpin->value());
-  m_listMonitor->setMaxLikesPerSession(m_listMaxLikesSpin->value());
-  m_listRestMinSpin->setValue(settings.value("listRestMin", 10).toInt());
-  m_listRestMaxSpin->setValue(settings.value("listRestMax", 30).toInt());
-  m_listMonitor->setRestInterval(m_listRestMinSpin->value(),
-                                 m_listRestMaxSpin->value());
-  m_listCooldownMinSpin->setValue(
-      settings.value("listCooldownMin", 600).toInt());
-  m_listCooldownMaxSpin->setValue(
-      settings.value("listCooldownMax", 1200).toInt());
-  m_listMonitor->setUserCooldown(m_listCooldownMinSpin->value(),
-                                 m_listCooldownMaxSpin->value());
-}
+void MainWindow::updateCountdownLabel() {
+  // 不可见时停掉每秒重绘，恢复时重新推算
+  RenderGovernor *governor = RenderGovernor::instance();
+  if (governor->isSuspended()) {
+    Scheduler::instance()->cancel(m_countdownTick);
+    m_countdownTick = 0;
+    governor->post("countdown", this, [this]() { updateCountdownLabel(); });
+    return;
+  }
 
-void MainWindow::saveSettings() {
-  QSettings settings("XSocialLedger", "XSocialLedger");
-  settings.setValue("maxPages", m_pagesSpin->value());
-  settings.setValue("refreshMin", m_refreshMinSpin->value());
-  settings.setValue("refreshMax", m_refreshMaxSpin->value());
-
-  settings.setValue("scrollMin", m_scrollMinSpin->value());
-  settings.setValue("scrollMax", m_scrollMaxSpin->value());
-  settings.setValue("likeWaitMin", m_likeWaitMinSpin->value());
-  settings.setValue("likeWaitMax", m_likeWaitMaxSpin->value());
-  settings.setValue("browseMin", m_browseMinSpin->value());
-  settings.setValue("browseMax", m_browseMaxSpin->value());
-  settings.setValue("restMin", m_restMinSpin->value());
-  settings.setValue("restMax", m_restMaxSpin->value());
-
-  // LIST监控配置
-  settings.setValue("listLikeMin", m_listLikeMinSpin->value());
-  settings.setValue("listLikeMax", m_listLikeMaxSpin->value());
-  settings.setValue("listScrollMin", m_listScrollMinSpin->value());
-  settings.setValue("listScrollMax", m_listScrollMaxSpin->value());
-  settings.setValue("listStayMin", m_listStayMinSpin->value());
-  settings.setValue("listStayMax", m_listStayMaxSpin->value());
-  settings.setValue("listMaxLikes", m_listMaxLikesSpin->value());
-  settings.setValue("listRestMin", m_listRestMinSpin->value());
-  settings.setValue("listRestMax", m_listRestMaxSpin->value());
-  settings.setValue("listCooldownMin", m_listCooldownMinSpin->value());
-  settings.setValue("listCooldownMax", m_listCooldownMaxSpin->value());
-  settings.setValue("listUrls", m_listUrlsEdit->toPlainText());
-}
+  // 向上取整，与原先逐秒递减的显示一致
+  int refreshSec =
+      m_collector ? int((m_collector->refreshRemainingMs() + 999) / 1000) : 0;
+  int sessionSec =
+      m_reciprocator ? int((m_reciprocator->sessionRemainingMs() + 999) / 1000)
+                     : 0;
+
+  // 只在有截止时间时才每秒重绘一次
+  Scheduler *scheduler = Scheduler::instance();
+  if (refreshSec > 0 || sessionSec > 0) {
+    if (!scheduler->isActive(m_countdownTick)) {
+      m_countdownTick = scheduler->repeating(
+          1000, this, [this]() { updateCountdownLabel(); });
+    }
+  } else if (m_countdownTick) {
+    scheduler->cancel(m_countdownTick);
+    m_countdownTick = 0;
+  }
 
-void MainWindow::updateCountdownLabel() {
   QStringList parts;
-  if (m_refreshCountdown > 0) {
+  if (refreshSec > 0) {
     parts << QString::fromUtf8("\xe2\x8f\xb3\xe5\x88\xb7\xe6\x96\xb0:%1s")
-                 .arg(m_refreshCountdown);
+                 .arg(refreshSec);
   }
-  if (m_sessionCountdown > 0) {
-    int min = m_sessionCountdown / 60;
-    int sec = m_sessionCountdown % 60;
+  if (sessionSec > 0) {
+    int min = sessionSec / 60;
+    int sec = sessionSec % 60;
     parts << QString::fromUtf8("\xe2\x8f\xb3\xe4\xbc\x9a\xe8\xaf\x9d:%1:%2")
                  .arg(min)
                  .arg(sec, 2, 10, QChar('0'));
   }
-  m_countdownLabel->setText(parts.join("  "));
+  QString text = parts.join("  ");
+  if (m_countdownLabel->text() != text) {
+    m_countdownLabel->setText(text);
+  }
+}
+
+void MainWindow::flushStorage() {
+  XSL_TRACE_SCOPE("LedgerStore::flush");
+  static Histogram *flushLatency = Metrics::instance()->histogram(
+      "xsl_storage_flush_seconds", "Duration of LedgerStore::flush");
+  ScopedLatency latency(flushLatency);
+  m_storage->flush();
 }
@@ -1,16 +1,25 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include "App/Scheduler.h"
 #include <QLabel>
 #include <QMainWindow>
+#include <QMenu>
 #include <QPushButton>
-#include <QSpinBox>
 #include <QSplitter>
-#include <QTextEdit>
 
 class WebView2Widget;
 class ActionListPanel;
-class DataStorage;
+class AppConfig;
+class LogBuffer;
+class LogConsole;
+class DiagnosticsDialog;
+class LocalHttpServer;
+class LedgerStore;
+class EngagerTracker;
+class LedgerViewCache;
+class LedgerQueryService;
+class PostIndex;
 class NotificationCollector;
 class ReciprocatorEngine;
 class ListMonitorEngine;
@@ -30,70 +39,70 @@ private slots:
   void onStopCollecting();
   void onRefreshPage();
   void onExportData();
+  void onSyncLedger();
+  void onExportTrace();
+  void onShowDiagnostics();
   void onStatusMessage(const QString &message);
   void onCollectingStateChanged(bool collecting);
   void onReciprocateLike(const QString &userHandle, const QString &actionId);
+  void finishStartup();
+  void createVisibleBrowsers();
 
 private:
+  struct LedgerLoad; // 工作线程加载的账本、快照与派生索引
+
+  void populateLedger(const LedgerLoad &load);
   void setupUI();
   void setupToolBar();
   void setupConnections();
   void saveLayout();
   void restoreLayout();
-  void loadSettings();
-  void saveSettings();
   void updateCountdownLabel();
+  void flushStorage();
+  void ensureRecipBrowser();
+  void ensureListBrowser();
+  void reportStartup();
+  void rebuildIndexes();
 
   // UI 组件
   QSplitter *m_splitter;
   WebView2Widget *m_browser;
   WebView2Widget *m_recipBrowser;
   WebView2Widget *m_listBrowser;
+  bool m_recipBrowserStarted; // 副浏览器首次使用/可见时才创建
+  bool m_listBrowserStarted;
+  QSplitter *m_middleSplitter;
+  QLabel *m_ledgerPlaceholder; // 账本加载完成前占位
   ActionListPanel *m_actionPanel;
-  QTextEdit *m_logBox;
+  LogBuffer *m_logBuffer;
+  LogConsole *m_logConsole;
 
   QPushButton *m_startBtn;
   QPushButton *m_stopBtn;
   QPushButton *m_refreshBtn;
   QPushButton *m_exportBtn;
+  QPushButton *m_syncBtn;
   QPushButton *m_batchBtn;
-  QSpinBox *m_pagesSpin;
-  QSpinBox *m_refreshMinSpin;
-  QSpinBox *m_refreshMaxSpin;
-
-  // 自动回馈配置控件
-  QSpinBox *m_scrollMinSpin;   // 滚动间隔最小(秒)
-  QSpinBox *m_scrollMaxSpin;   // 滚动间隔最大(秒)
-  QSpinBox *m_likeWaitMinSpin; // 点赞等待最小(秒)
-  QSpinBox *m_likeWaitMaxSpin; // 点赞等待最大(秒)
-  QSpinBox *m_browseMinSpin;   // 浏览时长最小(分钟)
-  QSpinBox *m_browseMaxSpin;   // 浏览时长最大(分钟)
-  QSpinBox *m_restMinSpin;     // 休息时长最小(分钟)
-  QSpinBox *m_restMaxSpin;     // 休息时长最大(分钟)
+  QMenu *m_diagMenu;
+  DiagnosticsDialog *m_diagDialog;
+  LocalHttpServer *m_metricsServer;
+  LedgerQueryService *m_queryService;
 
-  // LIST监控控件
+  // LIST监控按钮
   QPushButton *m_listMonitorBtn;
-  QTextEdit *m_listUrlsEdit;
-  QSpinBox *m_listLikeMinSpin;     // 点赞间隔最小(秒)
-  QSpinBox *m_listLikeMaxSpin;     // 点赞间隔最大(秒)
-  QSpinBox *m_listScrollMinSpin;   // 滚动间隔最小(秒)
-  QSpinBox *m_listScrollMaxSpin;   // 滚动间隔最大(秒)
-  QSpinBox *m_listStayMinSpin;     // List停留最小(分钟)
-  QSpinBox *m_listStayMaxSpin;     // List停留最大(分钟)
-  QSpinBox *m_listMaxLikesSpin;    // 单次最大点赞数
-  QSpinBox *m_listRestMinSpin;     // 休息间隔最小(分钟)
-  QSpinBox *m_listRestMaxSpin;     // 休息间隔最大(分钟)
-  QSpinBox *m_listCooldownMinSpin; // 同用户冷却最小(秒)
-  QSpinBox *m_listCooldownMaxSpin; // 同用户冷却最大(秒)
 
   // Status bar
   QLabel *m_statusLabel;
   QLabel *m_countdownLabel;
-  int m_refreshCountdown;
-  int m_sessionCountdown;
+  Scheduler::TimerId m_countdownTick; // 有倒计时时每秒重绘
 
   // Data and logic
-  DataStorage *m_storage;
+  AppConfig *m_config;
+  LedgerStore *m_storage;
+  LedgerViewCache *m_viewCache; // 排序/过滤后的账本视图
+  // 随新记录增量更新的派生索引
+  PostIndex *m_postIndex;
+  EngagerTracker *m_engagerTracker;
   NotificationCollector *m_collector;
   ReciprocatorEngine *m_reciprocator;
   ListMonitorEngine *m_listMonitor;
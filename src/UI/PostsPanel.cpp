@@ -0,0 +1,111 @@
+#include "PostsPanel.h"
+#include "App/MemoryAccounting.h"
+#include "App/Trace.h"
+#include "Data/PostIndex.h"
+#include "RenderGovernor.h"
+#include "SnippetItem.h"
+#include <QDateTime>
+#include <QDesktopServices>
+#include <QHeaderView>
+#include <QTimer>
+#include <QUrl>
+#include <QVBoxLayout>
+
+namespace {
+const int kMaxRows = 500;
+}
+
+PostsPanel::PostsPanel(QWidget *parent)
+    : QWidget(parent), m_index(nullptr), m_dirty(true),
+      m_refreshPending(false) {
+  QVBoxLayout *layout = new QVBoxLayout(this);
+  layout->setContentsMargins(0, 0, 0, 0);
+
+  m_table = new QTableWidget(this);
+  MemoryAccounting::instance()->addSource("tables", m_table, [this]() {
+    return MemoryAccounting::estimateTable(m_table);
+  });
+  m_table->setColumnCount(5);
+  m_table->setHorizontalHeaderLabels(
+      {QString::fromUtf8("帖子片段"), QString::fromUtf8("点赞"),
+       QString::fromUtf8("回复"), QString::fromUtf8("用户"),
+       QString::fromUtf8("最近")});
+  m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+  for (int col = 1; col < 5; col++) {
+    m_table->horizontalHeader()->setSectionResizeMode(
+        col, QHeaderView::ResizeToContents);
+  }
+  m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+  m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  m_table->setAlternatingRowColors(true);
+  m_table->verticalHeader()->setVisible(false);
+  // 双击打开帖子
+  connect(m_table, &QTableWidget::cellDoubleClicked, this, [this](int row, int) {
+    QTableWidgetItem *item = m_table->item(row, 0);
+    if (item)
+      QDesktopServices::openUrl(QUrl(item->data(Qt::UserRole).toString()));
+  });
+  layout->addWidget(m_table);
+}
+
+void PostsPanel::setIndex(PostIndex *index) {
+  m_index = index;
+  connect(m_index, &PostIndex::postUpdated, this,
+          [this](quint64) { scheduleRefresh(); });
+  connect(m_index, &PostIndex::rebuilt, this, &PostsPanel::scheduleRefresh);
+  scheduleRefresh();
+}
+
+void PostsPanel::scheduleRefresh() {
+  if (m_refreshPending)
+    return;
+  m_refreshPending = true;
+  QTimer::singleShot(250, this, [this]() {
+    m_refreshPending = false;
+    RenderGovernor::instance()->post("actions.posts", this,
+                                     [this]() { refresh(); });
+  });
+}
+
+void PostsPanel::refresh() {
+  if (!isVisible() || !m_index) {
+    m_dirty = true;
+    return;
+  }
+  XSL_TRACE_SCOPE("PostsPanel::refresh");
+  m_dirty = false;
+
+  QList<const PostStats *> posts = m_index->topPosts(kMaxRows);
+  m_table->setRowCount(posts.size());
+  for (int i = 0; i < posts.size(); i++) {
+    const PostStats *post = posts[i];
+
+    SnippetItem *snippetItem = new SnippetItem(post->snippet);
+    snippetItem->setData(Qt::UserRole, post->statusLink);
+    snippetItem->setToolTipSuffix(
+        QString("\n%1\n%2 %3")
+            .arg(post->statusLink, QString::fromUtf8("首次:"),
+                 QDateTime::fromMSecsSinceEpoch(post->firstSeenMs)
+                     .toString("yyyy-MM-dd HH:mm")));
+    m_table->setItem(i, 0, snippetItem);
+
+    // 数值列按数值排序显示
+    auto number = [](int v) {
+      QTableWidgetItem *item = new QTableWidgetItem();
+      item->setData(Qt::DisplayRole, v);
+      return item;
+    };
+    m_table->setItem(i, 1, number(post->likes));
+    m_table->setItem(i, 2, number(post->replies));
+    m_table->setItem(i, 3, number(post->handles.size()));
+
+    QDateTime last = QDateTime::fromMSecsSinceEpoch(post->lastSeenMs);
+    m_table->setItem(i, 4, new QTableWidgetItem(last.toString("MM-dd HH:mm")));
+  }
+}
+
+void PostsPanel::showEvent(QShowEvent *event) {
+  QWidget::showEvent(event);
+  if (m_dirty)
+    refresh();
+}
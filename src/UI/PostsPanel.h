@@ -0,0 +1,31 @@
+#ifndef POSTSPANEL_H
+#define POSTSPANEL_H
+
+#include <QTableWidget>
+#include <QWidget>
+
+class PostIndex;
+
+// 帖子视图 - 按互动量列出自己的帖子（由 PostIndex 提供数据）
+class PostsPanel : public QWidget {
+  Q_OBJECT
+
+public:
+  explicit PostsPanel(QWidget *parent = nullptr);
+
+  void setIndex(PostIndex *index);
+  void refresh();
+
+protected:
+  void showEvent(QShowEvent *event) override;
+
+private:
+  void scheduleRefresh();
+
+  PostIndex *m_index;
+  QTableWidget *m_table;
+  bool m_dirty;          // 隐藏时只标记，显示时再填充
+  bool m_refreshPending; // 采集突发时合并刷新
+};
+
+#endif // POSTSPANEL_H
@@ -0,0 +1,125 @@
+#include "RankingPanel.h"
+#include "App/MemoryAccounting.h"
+#include "App/Trace.h"
+#include "Data/EngagerTracker.h"
+#include "RenderGovernor.h"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QTimer>
+#include <QVBoxLayout>
+
+namespace {
+const int kTopK = 50;
+}
+
+RankingPanel::RankingPanel(QWidget *parent)
+    : QWidget(parent), m_tracker(nullptr), m_slideTimer(0), m_dirty(true),
+      m_refreshPending(false) {
+  QVBoxLayout *layout = new QVBoxLayout(this);
+  layout->setContentsMargins(4, 4, 4, 4);
+  layout->setSpacing(4);
+
+  QHBoxLayout *row = new QHBoxLayout();
+  QLabel *label = new QLabel(QString::fromUtf8("时间窗口:"), this);
+  row->addWidget(label);
+  m_windowCombo = new QComboBox(this);
+  row->addWidget(m_windowCombo);
+  row->addStretch();
+  layout->addLayout(row);
+
+  m_table = new QTableWidget(this);
+  MemoryAccounting::instance()->addSource("tables", m_table, [this]() {
+    return MemoryAccounting::estimateTable(m_table);
+  });
+  m_table->setColumnCount(3);
+  m_table->setHorizontalHeaderLabels({QString::fromUtf8("排名"),
+                                      QString::fromUtf8("用户"),
+                                      QString::fromUtf8("互动")});
+  m_table->horizontalHeader()->setSectionResizeMode(
+      0, QHeaderView::ResizeToContents);
+  m_table->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+  m_table->horizontalHeader()->setSectionResizeMode(
+      2, QHeaderView::ResizeToContents);
+  m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+  m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  m_table->setAlternatingRowColors(true);
+  m_table->verticalHeader()->setVisible(false);
+  layout->addWidget(m_table);
+
+  connect(m_windowCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+          this, [this](int) { refresh(); });
+}
+
+void RankingPanel::setTracker(EngagerTracker *tracker) {
+  m_tracker = tracker;
+  m_windowCombo->blockSignals(true);
+  m_windowCombo->clear();
+  for (const auto &spec : m_tracker->windows()) {
+    m_windowCombo->addItem(spec.label);
+  }
+  m_windowCombo->setCurrentIndex(qMin(1, m_windowCombo->count() - 1));
+  m_windowCombo->blockSignals(false);
+  connect(m_tracker, &EngagerTracker::updated, this,
+          &RankingPanel::scheduleRefresh);
+  scheduleRefresh();
+}
+
+void RankingPanel::scheduleRefresh() {
+  if (m_refreshPending)
+    return;
+  m_refreshPending = true;
+  QTimer::singleShot(250, this, [this]() {
+    m_refreshPending = false;
+    RenderGovernor::instance()->post("actions.ranking", this,
+                                     [this]() { refresh(); });
+  });
+}
+
+void RankingPanel::refresh() {
+  if (!isVisible() || !m_tracker) {
+    m_dirty = true;
+    return;
+  }
+  XSL_TRACE_SCOPE("RankingPanel::refresh");
+  m_dirty = false;
+
+  QList<EngagerTracker::Ranked> ranked =
+      m_tracker->top(m_windowCombo->currentIndex(), kTopK);
+  m_table->setRowCount(ranked.size());
+  for (int i = 0; i < ranked.size(); i++) {
+    const EngagerTracker::Ranked &r = ranked[i];
+
+    QTableWidgetItem *rankItem = new QTableWidgetItem();
+    rankItem->setData(Qt::DisplayRole, i + 1);
+    m_table->setItem(i, 0, rankItem);
+
+    QString display = r.name.isEmpty() ? ("@" + r.handle) : r.name;
+    QTableWidgetItem *userItem = new QTableWidgetItem(display);
+    userItem->setToolTip("@" + r.handle);
+    m_table->setItem(i, 1, userItem);
+
+    // 估算值标出下界
+    QString count = r.isExact() ? QString::number(r.count)
+                                : QString("%1~%2")
+                                      .arg(r.count - r.error)
+                                      .arg(r.count);
+    m_table->setItem(i, 2, new QTableWidgetItem(count));
+  }
+}
+
+void RankingPanel::showEvent(QShowEvent *event) {
+  QWidget::showEvent(event);
+  if (!m_slideTimer) {
+    m_slideTimer = Scheduler::instance()->repeating(60 * 1000, this,
+                                                    [this]() { refresh(); });
+  }
+  if (m_dirty)
+    refresh();
+}
+
+void RankingPanel::hideEvent(QHideEvent *event) {
+  QWidget::hideEvent(event);
+  Scheduler::instance()->cancel(m_slideTimer);
+  m_slideTimer = 0;
+}
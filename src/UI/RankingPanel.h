@@ -0,0 +1,36 @@
+#ifndef RANKINGPANEL_H
+#define RANKINGPANEL_H
+
+#include "App/Scheduler.h"
+#include <QComboBox>
+#include <QTableWidget>
+#include <QWidget>
+
+class EngagerTracker;
+
+// 互动排行 - 滑动窗口内的高频互动用户（由 EngagerTracker 提供数据）
+class RankingPanel : public QWidget {
+  Q_OBJECT
+
+public:
+  explicit RankingPanel(QWidget *parent = nullptr);
+
+  void setTracker(EngagerTracker *tracker);
+  void refresh();
+
+protected:
+  void showEvent(QShowEvent *event) override;
+  void hideEvent(QHideEvent *event) override;
+
+private:
+  void scheduleRefresh();
+
+  EngagerTracker *m_tracker;
+  QComboBox *m_windowCombo;
+  QTableWidget *m_table;
+  Scheduler::TimerId m_slideTimer; // 可见时每分钟随窗口滑动刷新
+  bool m_dirty;
+  bool m_refreshPending;
+};
+
+#endif // RANKINGPANEL_H
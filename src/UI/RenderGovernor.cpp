@@ -0,0 +1,139 @@
+#include "RenderGovernor.h"
+#include "App/Metrics.h"
+#include <QDebug>
+#include <QEvent>
+
+namespace {
+
+Gauge *suspendedGauge() {
+  static Gauge *g = Metrics::instance()->gauge(
+      "xsl_render_suspended", "1 while the main window is not visible");
+  return g;
+}
+
+} // namespace
+
+RenderGovernor *RenderGovernor::instance() {
+  static RenderGovernor s_instance;
+  return &s_instance;
+}
+
+void RenderGovernor::watch(QWidget *window) {
+  if (m_window)
+    m_window->removeEventFilter(this);
+  m_window = window;
+  window->installEventFilter(this);
+  updateState();
+}
+
+void RenderGovernor::post(const QString &key, QObject *context,
+                          std::function<void()> apply) {
+  if (!m_suspended) {
+    run(key, apply);
+    return;
+  }
+
+  static Counter *deferred = Metrics::instance()->counter(
+      "xsl_render_updates_deferred_total",
+      "View updates postponed while the window was not visible");
+  deferred->inc();
+
+  auto it = m_pending.find(key);
+  if (it == m_pending.end()) {
+    m_order.append(key);
+    it = m_pending.insert(key, Pending());
+  }
+  it->context = context;
+  it->apply = std::move(apply);
+  it->requests++;
+}
+
+bool RenderGovernor::eventFilter(QObject *watched, QEvent *event) {
+  switch (event->type()) {
+  case QEvent::Show:
+  case QEvent::Hide:
+  case QEvent::WindowStateChange:
+  case QEvent::Expose:
+    // 原生窗口在首次 show 时才创建，届时再监听 Expose
+    if (watched == m_window && !m_handle && m_window->windowHandle()) {
+      m_handle = m_window->windowHandle();
+      m_handle->installEventFilter(this);
+    }
+    updateState();
+    break;
+  default:
+    break;
+  }
+  return QObject::eventFilter(watched, event);
+}
+
+void RenderGovernor::updateState() {
+  bool hidden = !m_window || !m_window->isVisible() ||
+                m_window->isMinimized() ||
+                (m_handle && !m_handle->isExposed());
+  if (hidden == m_suspended)
+    return;
+
+  m_suspended = hidden;
+  suspendedGauge()->set(hidden ? 1 : 0);
+  if (hidden) {
+    m_suspendedFor.start();
+    qDebug() << "[RenderGovernor] Window not visible, suspending view updates";
+  } else {
+    resume();
+  }
+  emit suspendedChanged(hidden);
+}
+
+void RenderGovernor::resume() {
+  static Counter *coalesced = Metrics::instance()->counter(
+      "xsl_render_updates_coalesced_total",
+      "Postponed view updates merged into a later one");
+  static Counter *saved = Metrics::instance()->counter(
+      "xsl_render_saved_microseconds_total",
+      "Estimated UI thread time saved by skipping hidden view updates");
+
+  QStringList order;
+  QHash<QString, Pending> pending;
+  order.swap(m_order);
+  pending.swap(m_pending);
+
+  int requests = 0;
+  qint64 savedUs = 0;
+  // 一次批处理：期间不重绘，结束后整体刷新一次
+  if (m_window)
+    m_window->setUpdatesEnabled(false);
+  for (const QString &key : order) {
+    const Pending &p = pending[key];
+    requests += p.requests;
+    if (!p.context)
+      continue;
+    run(key, p.apply);
+    savedUs += m_costUs.value(key) * (p.requests - 1);
+    coalesced->inc(p.requests - 1);
+  }
+  if (m_window)
+    m_window->setUpdatesEnabled(true);
+  saved->inc(quint64(savedUs));
+
+  qDebug().noquote()
+      << QString("[RenderGovernor] Resumed after %1s: %2 updates -> %3, "
+                 "~%4 ms saved")
+             .arg(m_suspendedFor.elapsed() / 1000)
+             .arg(requests)
+             .arg(order.size())
+             .arg(savedUs / 1000);
+}
+
+void RenderGovernor::run(const QString &key,
+                         const std::function<void()> &apply) {
+  QElapsedTimer timer;
+  timer.start();
+  apply();
+  qint64 us = timer.nsecsElapsed() / 1000;
+  auto it = m_costUs.find(key);
+  if (it == m_costUs.end())
+    m_costUs.insert(key, us);
+  else
+    *it = (*it * 7 + us) / 8;
+}
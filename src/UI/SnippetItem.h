@@ -0,0 +1,37 @@
+#ifndef SNIPPETITEM_H
+#define SNIPPETITEM_H
+
+#include "Data/SnippetStore.h"
+#include <QTableWidgetItem>
+
+// 表格中的帖子片段单元格 - 只持有 SnippetRef，显示/提示文本在
+// data() 被调用时才生成；取文本是共享的 QString，绘制时不加锁、不解码
+class SnippetItem : public QTableWidgetItem {
+public:
+  static const int kDisplayChars = 50;
+
+  explicit SnippetItem(const SnippetRef &snippet) : m_snippet(snippet) {}
+
+  void setToolTipSuffix(const QString &suffix) { m_suffix = suffix; }
+  SnippetId snippetId() const { return m_snippet.id(); }
+
+  QVariant data(int role) const override {
+    if (role == Qt::DisplayRole) {
+      QString text = m_snippet.text();
+      if (text.length() > kDisplayChars)
+        text = text.left(kDisplayChars) + "...";
+      return text;
+    }
+    if (role == Qt::ToolTipRole)
+      return m_snippet.text() + m_suffix;
+    return QTableWidgetItem::data(role);
+  }
+
+  QTableWidgetItem *clone() const override { return new SnippetItem(*this); }
+
+private:
+  SnippetRef m_snippet;
+  QString m_suffix;
+};
+
+#endif // SNIPPETITEM_H
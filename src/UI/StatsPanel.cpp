@@ -1,12 +1,22 @@
 #include "StatsPanel.h"
-#include "Data/DataStorage.h"
+#include "App/Trace.h"
+#include "Data/LedgerStore.h"
+#include "Data/LedgerViewCache.h"
 #include "Data/SocialAction.h"
+#include "Theme.h"
 #include <QDateTime>
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QLabel>
 #include <QMap>
+#include <QMessageBox>
 #include <QVBoxLayout>
 
-StatsPanel::StatsPanel(DataStorage *storage, QWidget *parent)
-    : QWidget(parent), m_storage(storage) {
+StatsPanel::StatsPanel(LedgerStore *storage, LedgerViewCache *views,
+                       QWidget *parent)
+    : QWidget(parent), m_storage(storage), m_views(views), m_rangeMode(false),
+      m_rangeRunning(false), m_rangeStale(false), m_dirty(true) {
 
   QVBoxLayout *layout = new QVBoxLayout(this);
   layout->setContentsMargins(4, 4, 4, 4);
@@ -15,40 +25,131 @@ StatsPanel::StatsPanel(DataStorage *storage, QWidget *parent)
   m_calendar = new QCalendarWidget(this);
   m_calendar->setMaximumHeight(200);
   m_calendar->setSelectedDate(QDate::currentDate());
-  m_calendar->setStyleSheet(
-      "QCalendarWidget { background: #0f0f23; color: #d0d0d0; }"
-      "QCalendarWidget QToolButton { color: #d0d0d0; background: #1a1a2e; "
-      "  border: 1px solid #2a2a4a; padding: 4px; }"
-      "QCalendarWidget QMenu { background: #1a1a2e; color: #d0d0d0; }"
-      "QCalendarWidget QSpinBox { background: #1a1a2e; color: #d0d0d0; "
-      "  border: 1px solid #2a2a4a; }"
-      "QCalendarWidget QAbstractItemView { background: #0f0f23; color: "
-      "#d0d0d0; "
-      "  selection-background-color: #1e3a5f; selection-color: white; }"
-      "QCalendarWidget QAbstractItemView:enabled { color: #d0d0d0; }"
-      "QCalendarWidget QWidget#qt_calendar_navigationbar { background: "
-      "#1a1a2e; }");
   connect(m_calendar, &QCalendarWidget::selectionChanged, this,
           [this]() { onDateSelected(m_calendar->selectedDate()); });
   layout->addWidget(m_calendar);
 
+  // 区间报告：起止日期 + 生成 / 导出 CSV
+  QHBoxLayout *rangeRow = new QHBoxLayout();
+  m_fromEdit = new QDateEdit(QDate::currentDate().addMonths(-1), this);
+  m_toEdit = new QDateEdit(QDate::currentDate(), this);
+  for (QDateEdit *edit : {m_fromEdit, m_toEdit}) {
+    edit->setCalendarPopup(true);
+    edit->setDisplayFormat("yyyy-MM-dd");
+  }
+  m_rangeBtn = new QPushButton(QString::fromUtf8("区间报告"), this);
+  m_csvBtn = new QPushButton(QString::fromUtf8("导出CSV"), this);
+  m_csvBtn->setEnabled(false);
+  rangeRow->addWidget(m_fromEdit);
+  rangeRow->addWidget(new QLabel("~", this));
+  rangeRow->addWidget(m_toEdit);
+  rangeRow->addWidget(m_rangeBtn);
+  rangeRow->addWidget(m_csvBtn);
+  rangeRow->addStretch();
+  layout->addLayout(rangeRow);
+  connect(m_rangeBtn, &QPushButton::clicked, this, &StatsPanel::onRangeReport);
+  connect(m_csvBtn, &QPushButton::clicked, this, &StatsPanel::onExportCsv);
+
   m_textEdit = new QTextEdit(this);
   m_textEdit->setReadOnly(true);
-  m_textEdit->setStyleSheet(
-      "QTextEdit { background: #0f0f23; color: #d0d0d0; "
-      "  border: 1px solid #2a2a4a; font-family: 'Consolas', monospace; "
-      "  font-size: 12px; padding: 8px; }");
+  Theme::setRole(m_textEdit, "report");
   layout->addWidget(m_textEdit);
 
-  // Initial load
-  generateMarkdown(QDate::currentDate());
+  // 首次显示时才生成（统计页默认不在前台）
+}
+
+void StatsPanel::refresh() {
+  if (!isVisible()) {
+    m_dirty = true;
+    return;
+  }
+  regenerate();
+}
+
+void StatsPanel::showEvent(QShowEvent *event) {
+  QWidget::showEvent(event);
+  if (m_dirty)
+    regenerate();
 }
 
-void StatsPanel::refresh() { generateMarkdown(m_calendar->selectedDate()); }
+void StatsPanel::regenerate() {
+  if (m_rangeMode)
+    runRangeReport();
+  else
+    generateMarkdown(m_calendar->selectedDate());
+}
 
-void StatsPanel::onDateSelected(const QDate &date) { generateMarkdown(date); }
+void StatsPanel::onDateSelected(const QDate &date) {
+  // 回到单日视图；CSV 只导出正在显示的区间报告
+  m_rangeMode = false;
+  m_csvBtn->setEnabled(false);
+  generateMarkdown(date);
+}
+
+void StatsPanel::onRangeReport() {
+  m_rangeFrom = qMin(m_fromEdit->date(), m_toEdit->date());
+  m_rangeTo = qMax(m_fromEdit->date(), m_toEdit->date());
+  m_rangeMode = true;
+  m_csvBtn->setEnabled(false);
+  m_textEdit->setPlainText(QString::fromUtf8("正在生成 %1 ~ %2 的报告...")
+                               .arg(m_rangeFrom.toString("yyyy-MM-dd"),
+                                    m_rangeTo.toString("yyyy-MM-dd")));
+  runRangeReport();
+}
+
+void StatsPanel::runRangeReport() {
+  m_dirty = false;
+  if (m_rangeRunning) {
+    m_rangeStale = true;
+    return;
+  }
+
+  // 快照取自视图缓存：不可变、与表格共享，工作线程只读
+  const ReportEngine::Snapshots snapshots = {m_views->snapshot("like"),
+                                             m_views->snapshot("reply")};
+  m_rangeRunning = true;
+  m_rangeBtn->setEnabled(false);
+  ReportEngine::run(snapshots, m_rangeFrom, m_rangeTo)
+      .then(this, [this](const RangeReport &report) {
+        m_rangeRunning = false;
+        m_rangeBtn->setEnabled(true);
+        const bool stale = m_rangeStale;
+        m_rangeStale = false;
+        if (!m_rangeMode)
+          return; // 计算期间切回了单日视图
+        m_lastReport = report;
+        m_textEdit->setPlainText(report.toMarkdown());
+        m_csvBtn->setEnabled(true);
+        if (stale)
+          refresh();
+      });
+}
+
+void StatsPanel::onExportCsv() {
+  QString filename = QFileDialog::getSaveFileName(
+      this, QString::fromUtf8("导出区间报告"),
+      QString("report_%1_%2.csv")
+          .arg(m_lastReport.from.toString("yyyyMMdd"),
+               m_lastReport.to.toString("yyyyMMdd")),
+      "CSV Files (*.csv)");
+  if (filename.isEmpty())
+    return;
+
+  QFile file(filename);
+  if (!file.open(QIODevice::WriteOnly)) {
+    QMessageBox::warning(this, QString::fromUtf8("导出失败"),
+                         QString::fromUtf8("无法写入文件: ") + filename);
+    return;
+  }
+  // 带 BOM，Excel 直接打开不乱码
+  file.write("\xEF\xBB\xBF");
+  file.write(m_lastReport.toCsv().toUtf8());
+}
 
 void StatsPanel::generateMarkdown(const QDate &date) {
+  XSL_TRACE_SCOPE("StatsPanel::generateMarkdown");
+  m_dirty = false;
+
   QList<SocialAction> actions = m_storage->getReciprocatedByDate(date);
 
   // Group by user
@@ -1,28 +1,54 @@
 #ifndef STATSPANEL_H
 #define STATSPANEL_H
 
+#include "Data/ReportEngine.h"
 #include <QCalendarWidget>
+#include <QDateEdit>
+#include <QPushButton>
 #include <QTextEdit>
 #include <QWidget>
 
-class DataStorage;
+class LedgerStore;
+class LedgerViewCache;
 
 class StatsPanel : public QWidget {
   Q_OBJECT
 
 public:
-  explicit StatsPanel(DataStorage *storage, QWidget *parent = nullptr);
+  StatsPanel(LedgerStore *storage, LedgerViewCache *views,
+             QWidget *parent = nullptr);
   void refresh();
 
+protected:
+  void showEvent(QShowEvent *event) override;
+
 private slots:
   void onDateSelected(const QDate &date);
+  void onRangeReport();
+  void onExportCsv();
 
 private:
+  friend class UiBench; // 模拟日历选择
+
+  void regenerate(); // 按当前模式重新生成
+  void runRangeReport();
   void generateMarkdown(const QDate &date);
 
-  DataStorage *m_storage;
+  LedgerStore *m_storage;
+  LedgerViewCache *m_views;
   QCalendarWidget *m_calendar;
   QTextEdit *m_textEdit;
+  QDateEdit *m_fromEdit;
+  QDateEdit *m_toEdit;
+  QPushButton *m_rangeBtn;
+  QPushButton *m_csvBtn;
+  RangeReport m_lastReport; // 最近一次区间报告（导出 CSV 用）
+  QDate m_rangeFrom;        // 区间模式下报告的起止日期
+  QDate m_rangeTo;
+  bool m_rangeMode;    // 显示的是区间报告；选日期回到单日
+  bool m_rangeRunning; // 区间报告正在工作线程上计算
+  bool m_rangeStale;   // 计算期间账本又变了，完成后重算
+  bool m_dirty;        // 隐藏时只标记，显示时再生成
 };
 
 #endif // STATSPANEL_H
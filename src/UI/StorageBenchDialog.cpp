@@ -0,0 +1,142 @@
+#include "StorageBenchDialog.h"
+#include "App/AppConfig.h"
+#include "App/Trace.h"
+#include "Data/LedgerStore.h"
+#include "Data/LedgerStoreBench.h"
+#include "Data/SqliteLedgerStore.h"
+#include "Theme.h"
+#include <QApplication>
+#include <QHBoxLayout>
+#include <QTemporaryDir>
+#include <QVBoxLayout>
+#include <memory>
+
+namespace {
+const int kSyntheticRows = 2000;
+}
+
+StorageBenchDialog::StorageBenchDialog(LedgerStore *store, AppConfig *config,
+                                       QWidget *parent)
+    : QDialog(parent), m_store(store), m_config(config) {
+  setWindowTitle(QString::fromUtf8("存储引擎基准"));
+  resize(640, 560);
+
+  QVBoxLayout *layout = new QVBoxLayout(this);
+
+  QHBoxLayout *row = new QHBoxLayout();
+  row->addWidget(new QLabel(QString::fromUtf8("存储后端:"), this));
+  m_backendCombo = new QComboBox(this);
+  m_backendCombo->addItems(LedgerStore::backends());
+  m_backendCombo->setCurrentText(m_config->storage().backend);
+  row->addWidget(m_backendCombo);
+  m_backendHint = new QLabel(this);
+  m_backendHint->setObjectName("backendHint");
+  row->addWidget(m_backendHint);
+  row->addStretch();
+
+  m_runBtn = new QPushButton(QString::fromUtf8("▶ 运行"), this);
+  m_runBtn->setObjectName("benchRun");
+  Theme::setRole(m_runBtn, "ok");
+  row->addWidget(m_runBtn);
+  m_useBtn = new QPushButton(QString::fromUtf8("使用此后端"), this);
+  m_useBtn->setObjectName("benchUseBackend");
+  row->addWidget(m_useBtn);
+  layout->addLayout(row);
+
+  m_report = new QTextEdit(this);
+  m_report->setReadOnly(true);
+  Theme::setRole(m_report, "report");
+  m_report->setPlainText(QString::fromUtf8(
+      "当前后端: %1\n\n"
+      "运行内容:\n"
+      "- 当前账本: 只读负载\n"
+      "- 每个后端的临时空库: 同一套一致性检查和写负载\n"
+      "- sqlite 临时库（当前账本副本）: 同一只读负载\n\n"
+      "一致性检查会写入和删除记录，只在临时库上运行；建不了临时库的后端"
+      "（如文件位置固定的 datastorage）标为未检查。\n"
+      "在下拉框里选中后端只是查看，点“使用此后端”才写入设置，重启后生效。")
+                             .arg(m_store->backendName()));
+  layout->addWidget(m_report);
+
+  connect(m_runBtn, &QPushButton::clicked, this,
+          &StorageBenchDialog::runBenchmark);
+  connect(m_useBtn, &QPushButton::clicked, this,
+          &StorageBenchDialog::useChosenBackend);
+  connect(m_backendCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+          this, &StorageBenchDialog::onBackendChosen);
+  onBackendChosen(m_backendCombo->currentIndex());
+}
+
+void StorageBenchDialog::onBackendChosen(int) {
+  // 只更新提示；设置要等用户点“使用此后端”
+  const QString backend = m_backendCombo->currentText();
+  const bool configured = backend == m_config->storage().backend;
+  m_useBtn->setEnabled(!configured);
+  if (backend == m_store->backendName())
+    m_backendHint->setText(QString::fromUtf8("使用中"));
+  else if (configured)
+    m_backendHint->setText(QString::fromUtf8("重启后生效"));
+  else
+    m_backendHint->setText(QString());
+}
+
+void StorageBenchDialog::useChosenBackend() {
+  StorageSettings storage = m_config->storage();
+  storage.backend = m_backendCombo->currentText();
+  m_config->setStorage(storage);
+  onBackendChosen(m_backendCombo->currentIndex());
+}
+
+void StorageBenchDialog::runBenchmark() {
+  XSL_TRACE_SCOPE("StorageBenchDialog::runBenchmark");
+  m_runBtn->setEnabled(false);
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+
+  QList<LedgerStoreBench::Result> results;
+  QList<SocialAction> ledger = m_store->loadLikes() + m_store->loadReplies();
+
+  LedgerStoreBench::Result live;
+  live.backend = m_store->backendName();
+  live.dataset = QString::fromUtf8("当前账本（只读）");
+  live.rows = ledger.size();
+  live.timings = LedgerStoreBench::readWorkload(m_store);
+  results.append(live);
+
+  QTemporaryDir dir;
+  if (dir.isValid()) {
+    for (const QString &backend : LedgerStore::backends()) {
+      std::unique_ptr<LedgerStore> owned(
+          LedgerStore::openScratch(backend, dir.path()));
+      LedgerStoreBench::Result r;
+      r.backend = backend;
+      if (owned) {
+        r.dataset = QString::fromUtf8("临时空库，合成记录");
+        r.rows = kSyntheticRows;
+        r.checks = LedgerStoreBench::conformance(owned.get());
+        r.timings =
+            LedgerStoreBench::writeWorkload(owned.get(), kSyntheticRows);
+        auto *sqlite = qobject_cast<SqliteLedgerStore *>(owned.get());
+        if (sqlite && !sqlite->hasFullTextIndex()) {
+          r.dataset += QString::fromUtf8("，FTS5 不可用");
+        }
+      } else {
+        // 一致性检查会写入和删除记录：建不了临时库就不查，不碰用户的账本
+        r.dataset = QString::fromUtf8("无法建临时库，未检查");
+      }
+      results.append(r);
+    }
+    {
+      SqliteLedgerStore copy(dir.filePath("copy.sqlite"));
+      LedgerStoreBench::Result r;
+      r.backend = copy.backendName();
+      r.dataset = QString::fromUtf8("当前账本副本");
+      r.rows = copy.importActions(ledger);
+      r.timings = LedgerStoreBench::readWorkload(&copy);
+      results.append(r);
+    }
+  }
+
+  m_report->setPlainText(LedgerStoreBench::toMarkdown(results));
+  QApplication::restoreOverrideCursor();
+  m_runBtn->setEnabled(true);
+}
@@ -0,0 +1,37 @@
+#ifndef STORAGEBENCHDIALOG_H
+#define STORAGEBENCHDIALOG_H
+
+#include <QComboBox>
+#include <QDialog>
+#include <QLabel>
+#include <QPushButton>
+#include <QTextEdit>
+
+class AppConfig;
+class LedgerStore;
+
+// 存储引擎基准 - 在各后端的临时库上运行一致性检查与读写负载，
+// 并可切换后端（写入设置，重启后生效）
+class StorageBenchDialog : public QDialog {
+  Q_OBJECT
+
+public:
+  StorageBenchDialog(LedgerStore *store, AppConfig *config,
+                     QWidget *parent = nullptr);
+
+private slots:
+  void runBenchmark();
+  void onBackendChosen(int index);
+  void useChosenBackend();
+
+private:
+  LedgerStore *m_store;
+  AppConfig *m_config;
+  QTextEdit *m_report;
+  QPushButton *m_runBtn;
+  QPushButton *m_useBtn;
+  QComboBox *m_backendCombo;
+  QLabel *m_backendHint;
+};
+
+#endif // STORAGEBENCHDIALOG_H
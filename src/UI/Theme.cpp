@@ -0,0 +1,170 @@
+#include "Theme.h"
+#include "App/Trace.h"
+#include <QApplication>
+#include <QStyle>
+#include <QWidget>
+
+namespace {
+
+// 规则按 CSS 优先级叠加：具体的 [role]/#name 规则覆盖通用的类型规则，
+// 同优先级时后写的生效（running 态写在 hover 之后）
+const char kStyleSheet[] = R"css(
+QMainWindow { background: #0a0a1a; }
+QToolBar { background: #12122a; border-bottom: 1px solid #2a2a4a;
+  spacing: 6px; padding: 4px; }
+QStatusBar { background: #0f0f23; color: #e0e0e0;
+  border-top: 1px solid #2a2a4a; }
+QSplitter::handle { background: #2a2a4a; width: 2px; }
+
+QLabel#ledgerPlaceholder { background: #0f0f23; color: #8888aa;
+  font-size: 13px; }
+QLabel#statusLabel { color: #e0e0e0; font-size: 13px; padding: 2px 8px; }
+QLabel#countdownLabel { color: #ffcc00; font-size: 13px; padding: 2px 8px; }
+
+/* 工具栏按钮 */
+QPushButton[role="primary"], QPushButton[role="go"],
+QPushButton[role="danger"], QPushButton[role="accent"] {
+  color: #e0e0e0; border-radius: 6px; padding: 6px 16px; font-size: 13px;
+  min-width: 80px; }
+QPushButton[role="primary"] { background: #1e3a5f; border: 1px solid #3a5a8a; }
+QPushButton[role="primary"]:hover { background: #2a4a7a; }
+QPushButton[role="primary"]:pressed { background: #163050; }
+QPushButton[role="go"] { background: #1b5e20; border: 1px solid #2e7d32; }
+QPushButton[role="go"]:hover { background: #2e7d32; }
+QPushButton[role="go"]:pressed { background: #1b5e20; }
+QPushButton[role="danger"] { background: #b71c1c; border: 1px solid #d32f2f; }
+QPushButton[role="danger"]:hover { background: #d32f2f; }
+QPushButton[role="danger"]:pressed { background: #b71c1c; }
+QPushButton[role="accent"] { background: #e65100; border: 1px solid #ff6d00; }
+QPushButton[role="accent"]:hover { background: #ff6d00; }
+QPushButton[role="accent"]:pressed { background: #e65100; }
+QPushButton[role="info"] { background: #1565c0; color: #e0e0e0;
+  border: 1px solid #1976d2; border-radius: 6px; padding: 6px 12px;
+  font-size: 12px; }
+QPushButton[role="info"]:hover { background: #1976d2; }
+QPushButton[role="info"]:pressed { background: #1565c0; }
+QPushButton[role="accent"][running="true"],
+QPushButton[role="info"][running="true"] {
+  background: #b71c1c; border-color: #d32f2f; }
+QPushButton[role="accent"][running="true"]:hover,
+QPushButton[role="info"][running="true"]:hover { background: #d32f2f; }
+QPushButton[role="primary"]:disabled, QPushButton[role="go"]:disabled,
+QPushButton[role="danger"]:disabled, QPushButton[role="accent"]:disabled,
+QPushButton[role="info"]:disabled {
+  background: #1a1a2e; color: #555566; border-color: #2a2a3a; }
+
+QPushButton[role="gear"] { background: #2a2a4a; color: #e0e0e0;
+  border: 1px solid #3a5a8a; border-radius: 6px; padding: 4px 10px;
+  font-size: 14px; min-width: 30px; }
+QPushButton[role="gear"]:hover { background: #3a3a6a; }
+QToolButton[role="gear"] { background: #2a2a4a; color: #e0e0e0;
+  border: 1px solid #3a5a8a; border-radius: 6px; padding: 4px 10px;
+  font-size: 13px; }
+QToolButton[role="gear"]:hover { background: #3a3a6a; }
+QToolButton[role="gear"]::menu-indicator { image: none; }
+
+/* 对话框 */
+QDialog { background: #12122a; }
+QDialog QLabel { color: #e0e0e0; font-size: 12px; }
+QDialog QGroupBox { color: #ffcc00; border: 1px solid #3a5a8a;
+  border-radius: 6px; margin-top: 8px; padding-top: 16px; }
+QDialog QGroupBox::title { subcontrol-origin: margin; left: 10px; }
+QDialog QSpinBox { background: #1a1a2e; color: #e0e0e0;
+  border: 1px solid #3a5a8a; border-radius: 4px; padding: 4px 8px;
+  min-width: 60px; font-size: 12px; }
+QDialog QCheckBox { color: #e0e0e0; font-size: 12px; }
+QDialog QTextEdit { background: #1a1a2e; color: #e0e0e0;
+  border: 1px solid #3a5a8a; border-radius: 4px; font-size: 11px;
+  padding: 4px; }
+QPushButton[role="ok"] { background: #1b5e20; color: #e0e0e0;
+  border-radius: 6px; padding: 6px 20px; }
+QPushButton[role="ok"]:hover { background: #2e7d32; }
+QPushButton[role="ok"]:disabled { background: #1a1a2e; color: #555566; }
+QPushButton#benchRun { padding: 4px 16px; }
+QPushButton[role="tool"] { background: #2a2a4a; color: #e0e0e0;
+  border: 1px solid #3a5a8a; border-radius: 4px; padding: 3px 12px; }
+QPushButton[role="tool"]:hover { background: #3a3a6a; }
+QLabel#backendHint { color: #8888aa; }
+QLabel#diagSummary { color: #a0a0c0; padding: 4px; }
+
+/* 列表与表格 */
+QTabWidget::pane { border: 1px solid #2a2a4a; background: #0f0f23; }
+QTabBar::tab { background: #1a1a2e; color: #8888aa; padding: 8px 16px;
+  border: 1px solid #2a2a4a; border-bottom: none; margin-right: 2px; }
+QTabBar::tab:selected { background: #16213e; color: #e0e0e0; }
+QTabBar::tab:hover { background: #1f1f3a; }
+DiagnosticsDialog QTabBar::tab { padding: 6px 14px; }
+QTableWidget { background: #0f0f23; color: #d0d0d0; gridline-color: #2a2a4a;
+  selection-background-color: #1e3a5f; }
+QTableWidget::item:alternate { background: #141428; }
+QHeaderView::section { background: #1a1a2e; color: #a0a0c0; padding: 4px;
+  border: 1px solid #2a2a4a; }
+DiagnosticsDialog QTableWidget { font-family: 'Consolas', monospace;
+  font-size: 11px; }
+QMenu { background: #1a1a2e; color: #d0d0d0; border: 1px solid #3a3a5a; }
+QMenu::item:selected { background: #2a3a5e; }
+QComboBox { background: #1a1a2e; color: #a0d2db; border: 1px solid #2a2a4a;
+  padding: 1px 6px; }
+QTextEdit[role="report"] { background: #0f0f23; color: #d0d0d0;
+  border: 1px solid #2a2a4a; font-family: 'Consolas', monospace;
+  font-size: 12px; }
+
+/* 记录面板 */
+QLabel#panelTitle { padding: 8px; color: #e0e0e0; background: #1a1a2e; }
+QLabel#panelStats { padding: 6px; background: #16213e; color: #a0d2db;
+  border-radius: 4px; margin: 2px 4px; }
+ActionListPanel QCheckBox { color: #a0d2db; padding: 4px 8px; }
+ActionListPanel QCheckBox::indicator { width: 16px; height: 16px; }
+RankingPanel QLabel { color: #a0d2db; }
+
+/* 统计页 */
+QCalendarWidget { background: #0f0f23; color: #d0d0d0; }
+QCalendarWidget QToolButton { color: #d0d0d0; background: #1a1a2e;
+  border: 1px solid #2a2a4a; padding: 4px; }
+QCalendarWidget QMenu { background: #1a1a2e; color: #d0d0d0; }
+QCalendarWidget QSpinBox { background: #1a1a2e; color: #d0d0d0;
+  border: 1px solid #2a2a4a; }
+QCalendarWidget QAbstractItemView { background: #0f0f23; color: #d0d0d0;
+  selection-background-color: #1e3a5f; selection-color: white; }
+QCalendarWidget QAbstractItemView:enabled { color: #d0d0d0; }
+QCalendarWidget QWidget#qt_calendar_navigationbar { background: #1a1a2e; }
+StatsPanel QDateEdit, StatsPanel QPushButton { background: #1a1a2e;
+  color: #d0d0d0; border: 1px solid #2a2a4a; padding: 2px 6px; }
+StatsPanel QPushButton:disabled { color: #555577; }
+StatsPanel QTextEdit { padding: 8px; }
+
+/* 日志 */
+LogConsole QComboBox { font-size: 11px; }
+LogConsole QListView { background: #0a0a1a; color: #88cc88;
+  border: 1px solid #2a2a4a;
+  font-family: 'Consolas', 'Courier New', monospace; font-size: 11px;
+  padding: 4px; }
+)css";
+
+} // namespace
+
+namespace Theme {
+
+QString styleSheet() { return QString::fromUtf8(kStyleSheet); }
+
+void apply(QApplication *app) {
+  XSL_TRACE_SCOPE("Theme::apply");
+  app->setStyleSheet(styleSheet());
+}
+
+void setRole(QWidget *widget, const char *role) {
+  widget->setProperty("role", QString::fromLatin1(role));
+}
+
+void setState(QWidget *widget, const char *name, const QVariant &value) {
+  if (widget->property(name) == value)
+    return;
+  widget->setProperty(name, value);
+  // 动态属性变化不会自动触发样式重新匹配
+  QStyle *style = widget->style();
+  style->unpolish(widget);
+  style->polish(widget);
+  widget->update();
+}
+
+} // namespace Theme
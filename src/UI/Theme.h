@@ -0,0 +1,32 @@
+#ifndef THEME_H
+#define THEME_H
+
+#include <QString>
+#include <QVariant>
+
+class QApplication;
+class QWidget;
+
+// 深色主题 - 整个程序只有一份应用级样式表，QApplication 创建后解析一次。
+//
+// 控件不再各自 setStyleSheet（每次调用都要重新解析并 polish 整棵子树），
+// 而是用 objectName 或动态属性选择规则：
+//   role     按钮/文本框的外观种类: primary go danger accent info gear ok
+//            tool report
+//   running  开关类按钮的运行态（true 时显示为红色“停止”）
+// 运行时改变属性用 setState()，只重新 polish 这一个控件。
+namespace Theme {
+
+QString styleSheet();
+
+void apply(QApplication *app);
+
+// 构造时设置外观种类；首次显示前设置，无需 repolish
+void setRole(QWidget *widget, const char *role);
+
+// 修改动态属性并让样式重新匹配；值不变时什么也不做
+void setState(QWidget *widget, const char *name, const QVariant &value);
+
+} // namespace Theme
+
+#endif // THEME_H
@@ -0,0 +1,188 @@
+#include "UiBench.h"
+#include "App/AppConfig.h"
+#include "App/MemoryAccounting.h"
+#include "Data/LedgerStoreBench.h"
+#include "Data/LedgerViewCache.h"
+#include "Data/SqliteLedgerStore.h"
+#include "UI/ActionListPanel.h"
+#include "UI/StatsPanel.h"
+#include <QCheckBox>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <functional>
+
+namespace {
+
+const int kReciprocatedPercent = 40;
+const int kHistoryDays = 90;
+
+UiBench::Scenario measure(const QString &name, int iterations,
+                          const std::function<void(int)> &body) {
+  UiBench::Scenario s;
+  s.name = name;
+  s.iterations = iterations;
+  QElapsedTimer timer;
+  for (int i = 0; i < iterations; i++) {
+    timer.start();
+    body(i);
+    // 排队的刷新、布局、重绘都算进本次交互
+    QCoreApplication::processEvents();
+    qint64 us = timer.nsecsElapsed() / 1000;
+    s.totalUs += us;
+    s.maxUs = qMax(s.maxUs, us);
+  }
+  return s;
+}
+
+} // namespace
+
+QList<int> UiBench::parseSizes(const QString &text) {
+  QList<int> sizes;
+  for (const QString &part : text.split(',', Qt::SkipEmptyParts)) {
+    QString p = part.trimmed().toLower();
+    int scale = 1;
+    if (p.endsWith('k')) {
+      scale = 1000;
+      p.chop(1);
+    }
+    bool ok = false;
+    int n = p.toInt(&ok);
+    if (ok && n > 0)
+      sizes.append(n * scale);
+  }
+  return sizes;
+}
+
+UiBench::Run UiBench::run(int rows, const QString &workDir) {
+  Run result;
+  result.rows = rows;
+
+  QDateTime newest = QDateTime::currentDateTimeUtc();
+  SqliteLedgerStore store(workDir + QString("/ui-bench-%1.sqlite").arg(rows));
+  if (!store.isOpen()) {
+    qWarning() << "[UiBench] Cannot open scratch ledger in" << workDir;
+    return result;
+  }
+  QList<SocialAction> actions = LedgerStoreBench::syntheticActions(
+      rows, newest, kHistoryDays, kReciprocatedPercent);
+  store.importActions(actions);
+  store.flush();
+
+  AppConfig config(workDir + QString("/ui-bench-%1.json").arg(rows));
+  LedgerViewCache views(&store);
+
+  QElapsedTimer timer;
+  timer.start();
+  ActionListPanel panel(&store, &views, &config);
+  panel.setAttribute(Qt::WA_DontShowOnScreen);
+  panel.resize(480, 900);
+  panel.show();
+  panel.refreshAll();
+  QCoreApplication::processEvents();
+  result.loadUs = timer.nsecsElapsed() / 1000;
+
+  result.scenarios.append(
+      measure("refreshAll", 5, [&panel](int) { panel.refreshAll(); }));
+
+  // 监听到新点赞：写存储 -> 打补丁 -> 面板刷新
+  result.scenarios.append(measure("onNewLike", 50, [&](int i) {
+    SocialAction a;
+    a.userHandle = QString("ui_bench_live%1").arg(i);
+    a.userName = QString("Live %1").arg(i);
+    a.type = "like";
+    a.timestamp = newest.addMSecs(1000 + i).toString(Qt::ISODateWithMs);
+    a.postSnippet = QString::fromUtf8("界面基准 #%1").arg(i);
+    a.id = SocialAction::makeId(a.userHandle, a.type, a.timestamp);
+    a.reciprocated = false;
+    store.addAction(a);
+    views.noteAdded(a);
+    panel.onNewLike(a.userName, a.timestamp);
+  }));
+
+  result.scenarios.append(
+      measure("toggleHideReciprocated", 10, [&panel](int) {
+        panel.m_hideReciprocatedCheck->toggle();
+      }));
+  result.scenarios.append(measure("toggleOnly24h", 10, [&panel](int) {
+    panel.m_only24hCheck->toggle();
+  }));
+
+  // 最新的记录都未回馈；来回标记同一批，数据量不变
+  int marks = qMin(20, actions.size());
+  result.scenarios.append(measure("setReciprocated", marks * 2, [&](int i) {
+    const SocialAction &a = actions[actions.size() - 1 - i % marks];
+    panel.setReciprocated(a.id, a.type, i < marks);
+  }));
+
+  // 回馈记录集中在最早的 40% 区间；逐日翻日历
+  QDate firstDay = newest.addDays(-kHistoryDays).toLocalTime().date();
+  result.scenarios.append(measure("statsDateSelected", 10, [&](int i) {
+    panel.m_statsPanel->onDateSelected(firstDay.addDays(1 + i));
+  }));
+
+  result.peakRssKb = MemoryAccounting::peakResidentBytes() / 1024;
+  return result;
+}
+
+QJsonObject UiBench::toJson(const QList<Run> &runs) {
+  QJsonArray runArray;
+  for (const Run &r : runs) {
+    QJsonObject scenarios;
+    for (const Scenario &s : r.scenarios) {
+      scenarios[s.name] = QJsonObject{{"iterations", s.iterations},
+                                      {"meanUs", s.meanUs()},
+                                      {"maxUs", s.maxUs}};
+    }
+    runArray.append(QJsonObject{{"rows", r.rows},
+                                {"loadUs", r.loadUs},
+                                {"peakRssKb", r.peakRssKb},
+                                {"scenarios", scenarios}});
+  }
+  return QJsonObject{
+      {"version", QCoreApplication::applicationVersion()},
+      {"createdAt", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+      {"runs", runArray}};
+}
+
+QStringList UiBench::regressions(const QJsonObject &current,
+                                 const QJsonObject &baseline, double tolerance,
+                                 qint64 minUs) {
+  QHash<int, QJsonObject> baseRuns;
+  for (const QJsonValue &v : baseline["runs"].toArray())
+    baseRuns.insert(v["rows"].toInt(), v.toObject());
+
+  QStringList out;
+  for (const QJsonValue &v : current["runs"].toArray()) {
+    int rows = v["rows"].toInt();
+    if (!baseRuns.contains(rows))
+      continue;
+    QJsonObject baseScenarios = baseRuns[rows].value("scenarios").toObject();
+    QJsonObject scenarios = v["scenarios"].toObject();
+    for (auto it = scenarios.begin(); it != scenarios.end(); ++it) {
+      if (!baseScenarios.contains(it.key()))
+        continue;
+      qint64 base = baseScenarios.value(it.key())
+                        .toObject()
+                        .value("meanUs")
+                        .toVariant()
+                        .toLongLong();
+      qint64 now =
+          it.value().toObject().value("meanUs").toVariant().toLongLong();
+      if (qMax(base, now) < minUs)
+        continue;
+      if (now > base * tolerance) {
+        out.append(QString("%1 @ %2 rows: %3 us -> %4 us (x%5)")
+                       .arg(it.key())
+                       .arg(rows)
+                       .arg(base)
+                       .arg(now)
+                       .arg(base ? double(now) / base : 0.0, 0, 'f', 2));
+      }
+    }
+  }
+  return out;
+}
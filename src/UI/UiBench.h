@@ -0,0 +1,47 @@
+#ifndef UIBENCH_H
+#define UIBENCH_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+// 界面性能回归 - 不显示窗口（QT_QPA_PLATFORM=offscreen 或
+// WA_DontShowOnScreen）构造真实的 ActionListPanel/StatsPanel，用合成账本
+// 计时关键交互，结果写成 JSON，可与基线比较。
+//
+// 由 QTest 套件 xsl_uibench 驱动（src/Tools/UiBenchTest.cpp，ctest 中的
+// ui_bench），不依赖 WebView2，可在 Linux CI 上运行。
+class UiBench {
+public:
+  struct Scenario {
+    QString name;
+    int iterations = 0;
+    qint64 totalUs = 0;
+    qint64 maxUs = 0;
+    qint64 meanUs() const { return iterations ? totalUs / iterations : 0; }
+  };
+  struct Run {
+    int rows = 0;
+    qint64 loadUs = 0;     // 构造面板并完成首次刷新
+    qint64 peakRssKb = 0;  // 进程峰值常驻内存（累计值，不单属本轮）
+    QList<Scenario> scenarios;
+  };
+
+  static QList<int> defaultSizes() { return {1000, 10000, 100000, 500000}; }
+  // "1k,10k,500000" -> {1000, 10000, 500000}；无效项忽略
+  static QList<int> parseSizes(const QString &text);
+
+  static Run run(int rows, const QString &workDir);
+
+  static QJsonObject toJson(const QList<Run> &runs);
+
+  // 与基线比较：任一场景均值超过 baseline * tolerance 即为回归。
+  // 基线里缺少的行数/场景忽略；均值低于 minUs 的场景噪声太大，不比较。
+  static QStringList regressions(const QJsonObject &current,
+                                 const QJsonObject &baseline,
+                                 double tolerance = 1.25,
+                                 qint64 minUs = 500);
+};
+
+#endif // UIBENCH_H
@@ -4,6 +4,7 @@
 #include <QCloseEvent>
 #include <QDebug>
 #include <QDir>
+#include <QPromise>
 #include <QResizeEvent>
 #include <QTimer>
 #include <windows.h>
@@ -90,9 +91,10 @@ void WebView2Widget::CreateBrowserInternal(const QString &url) {
   if (hwnd == 0 || width() <= 0 || height() <= 0 || !isVisible()) {
     m_pendingUrl = url;
     m_browserCreating = true;
-    QTimer::singleShot(100, this, [this, url]() {
+    // 重试时取最新的 m_pendingUrl：等待期间的 LoadUrl 不能被覆盖
+    QTimer::singleShot(100, this, [this]() {
       m_browserCreating = false;
-      CreateBrowserInternal(url);
+      CreateBrowserInternal(m_pendingUrl);
     });
     return;
   }
@@ -232,6 +234,26 @@ void WebView2Widget::ExecuteJavaScript(const QString &code) {
   }
 }
 
+void WebView2Widget::Invoke(const QString &fn, const QJsonArray &args) {
+  if (m_handler) {
+    m_handler->invoke(fn, args);
+  }
+}
+
+QFuture<QJsonValue> WebView2Widget::Call(const QString &fn,
+                                         const QJsonArray &args,
+                                         int timeoutMs) {
+  if (m_handler)
+    return m_handler->call(fn, args, timeoutMs);
+  // 还没有 handler：与 handler 无 webview 时一样，返回已取消的 future
+  QPromise<QJsonValue> promise;
+  promise.start();
+  QFuture<QJsonValue> future = promise.future();
+  future.cancel();
+  promise.finish();
+  return future;
+}
+
 void WebView2Widget::Reload() {
   if (m_handler && m_handler->webview()) {
     m_handler->webview()->Reload();
@@ -1,6 +1,9 @@
 #ifndef WEBVIEW2WIDGET_H
 #define WEBVIEW2WIDGET_H
 
+#include <QFuture>
+#include <QJsonArray>
+#include <QJsonValue>
 #include <QString>
 #include <QWidget>
 #include <WebView2.h>
@@ -31,6 +34,15 @@ public:
   // Execute JavaScript
   void ExecuteJavaScript(const QString &code);
 
+  // Call a registered script module function, e.g. Invoke("list.scroll", {300})
+  void Invoke(const QString &fn, const QJsonArray &args = QJsonArray());
+
+  // Call and await the result (see WebView2Handler::call). Canceled on
+  // timeout, script error, navigation, or when no browser exists yet.
+  QFuture<QJsonValue> Call(const QString &fn,
+                           const QJsonArray &args = QJsonArray(),
+                           int timeoutMs = 10000);
+
   // Get handler
   WebView2Handler *GetHandler() const { return m_handler; }
   WebView2Handler *handler() const { return m_handler; }
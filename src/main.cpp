@@ -2,14 +2,21 @@
 #include <QDebug>
 #include <QDir>
 #include <QMessageBox>
+#include "App/MemoryAccounting.h"
+#include "App/StallWatchdog.h"
+#include "App/StartupProfiler.h"
+#include "App/Trace.h"
 #include "App/WebView2App.h"
 #include "UI/MainWindow.h"
+#include "UI/Theme.h"
 
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
 int main(int argc, char* argv[]) {
+    StartupProfiler::start();
+
     // Set console output to UTF-8
 #ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
@@ -22,6 +29,26 @@ int main(int argc, char* argv[]) {
     app.setApplicationName("XSocialLedger");
     app.setOrganizationName("5118Python");
     app.setApplicationVersion("1.0.0");
+    StartupProfiler::mark("QApplication");
+
+    // 应用级样式表只解析一次，控件按 objectName / 动态属性匹配
+    Theme::apply(&app);
+    StartupProfiler::mark("theme");
+
+    // 事件循环卡顿检测；XSL_STALL_MS=毫秒 调整阈值，0 关闭
+    bool stallOk = false;
+    int stallMs = qEnvironmentVariableIntValue("XSL_STALL_MS", &stallOk);
+    if (!stallOk)
+        stallMs = StallWatchdog::kDefaultThresholdMs;
+    if (stallMs > 0)
+        StallWatchdog::instance()->start(stallMs);
+
+    // 按子系统的内存采样；XSL_MEMORY_SAMPLE_MS=毫秒 调整间隔，0 关闭
+    bool memoryOk = false;
+    int memoryMs =
+        qEnvironmentVariableIntValue("XSL_MEMORY_SAMPLE_MS", &memoryOk);
+    if (!memoryOk)
+        memoryMs = MemoryAccounting::kDefaultIntervalMs;
 
     qDebug() << "[INFO] XSocialLedger 启动中...";
 
@@ -41,16 +68,34 @@ int main(int argc, char* argv[]) {
         }
     });
 
-    // Create main window
+    StartupProfiler::mark("WebView2 env requested");
+
+    // Create main window (shell only; ledger loads after first paint)
     MainWindow* window = new MainWindow();
     window->show();
+    StartupProfiler::mark("window shown");
+
+    if (memoryMs > 0)
+        MemoryAccounting::instance()->start(memoryMs);
 
     qDebug() << "[INFO] 主窗口已显示";
 
     // Run Qt event loop
     int result = app.exec();
 
+    MemoryAccounting::instance()->stop();
     delete window;
+    StallWatchdog::instance()->stop();
+
+    // XSL_TRACE_FILE=path 退出时导出 Chrome trace_event JSON
+    QString traceFile = qEnvironmentVariable("XSL_TRACE_FILE");
+    if (!traceFile.isEmpty()) {
+        if (Trace::exportChromeJson(traceFile)) {
+            qDebug() << "[INFO] Trace exported to" << traceFile;
+        } else {
+            qWarning() << "[WARN] Failed to export trace to" << traceFile;
+        }
+    }
 
     // Cleanup WebView2
     WebView2App::cleanup();